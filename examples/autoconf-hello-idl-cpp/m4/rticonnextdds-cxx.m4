@@ -121,12 +121,6 @@ AC_ARG_ENABLE(target,
 ])
 
 
-if test -z `${CONNEXT_CONFIG} --list-installed | grep ${NDDSARCH}`; then
-    AC_MSG_ERROR(invalid or unsupported target type);
-fi
-if test $? -ne 0; then
-    AC_MSG_ERROR(error invoking connext-config, check log for details)
-fi
 AC_MSG_RESULT(Using connext-config to get compiler and linker settings...)
 if test "$DEBUG_ENABLED" = 1; then
     AC_MSG_RESULT(Using RTI ConnextDDS DEBUG libraries)
@@ -135,26 +129,38 @@ else
     AC_MSG_RESULT(Using RTI ConnextDDS RELEASE libraries)
     RTICFG_DEBUG=""
 fi
-CC="`${CONNEXT_CONFIG} --cxxcomp ${NDDSARCH}`"
-LD="`${CONNEXT_CONFIG} --cxxlink ${NDDSARCH}`"
-CFLAGS="$CFLAGS `${CONNEXT_CONFIG} $RTICFG_STATIC $RTICFG_DEBUG --cxxflags ${NDDSARCH}`"
-LDFLAGS="`${CONNEXT_CONFIG} $RTICFG_STATIC $RTICFG_DEBUG --ldxxflags ${NDDSARCH}`"
-LIBS="$LDFLAGS `${CONNEXT_CONFIG} $RTICFG_STATIC $RTICFG_DEBUG --ldxxlibs ${NDDSARCH}`"
+
+dnl A single invocation of connext-config provides all the settings (as shell
+dnl assignments of CC, LD, CFLAGS, LDFLAGS, LIBS, RTI_LIB_SUFFIX) and whether
+dnl the target is installed. If it fails, tell an unknown target apart from
+dnl the other errors, which are reported with the message of connext-config
+RTICFG_SETTINGS="`${CONNEXT_CONFIG} $RTICFG_STATIC $RTICFG_DEBUG --api=cxx --emit-sh ${NDDSARCH} 2>conftest.err`"
+RTICFG_STATUS=$?
+RTICFG_ERROR="`cat conftest.err`"
+rm -f conftest.err
+if test $RTICFG_STATUS -ne 0; then
+    echo "$RTICFG_ERROR" >&AS_MESSAGE_LOG_FD
+    if ${CONNEXT_CONFIG} --list-installed | grep -x -F "${NDDSARCH}" >/dev/null; then
+        AC_MSG_ERROR([error invoking connext-config (exit code $RTICFG_STATUS): $RTICFG_ERROR])
+    else
+        AC_MSG_ERROR(invalid or unsupported target type);
+    fi
+fi
+RTICFG_CFLAGS="$CFLAGS"
+eval "$RTICFG_SETTINGS"
+if test "$RTI_TARGET_INSTALLED" != "yes"; then
+    AC_MSG_ERROR(invalid or unsupported target type);
+fi
+CFLAGS="$RTICFG_CFLAGS $CFLAGS"
+LIBS="$LDFLAGS $LIBS"
 
 dnl ****************************************************************************
-dnl Defines the env variable 'RTI_LIB_SUFFIX' to match the suffix to any 
-dnl additional library your application may require.
+dnl Exports the variable 'RTI_LIB_SUFFIX' (set by connext-config) to match
+dnl the suffix to any additional library your application may require.
 dnl For example, if you need to add the request/reply messaging library, in your
 dnl Makefile, add:
 dnl     myApp_LDADD = $(LDADD) -lrticonnextmsgcpp@RTI_LIB_SUFFIX@
 
-RTI_LIB_SUFFIX=""
-if test ! -z ${RTICFG_STATIC}; then
-    RTI_LIB_SUFFIX="z"
-fi
-if test ! -z ${RTICFG_DEBUG}; then
-    RTI_LIB_SUFFIX="${RTI_LIB_SUFFIX}d"
-fi
 AC_SUBST(RTI_LIB_SUFFIX)
 
 
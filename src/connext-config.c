@@ -38,9 +38,25 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>   /* For stat() */
+#include <dirent.h>     /* For opendir() */
 
 #include <unistd.h>
 #include <limits.h>
+#include <fcntl.h>      /* For open() */
+#include <stdint.h>
+#include <time.h>       /* For clock_gettime() */
+#include <sys/wait.h>   /* For waitpid() */
+#include <sys/mman.h>   /* For mmap() */
+
+#ifdef ENABLE_STATS
+#include <sys/resource.h>   /* For getrusage() */
+#ifdef __linux__
+#define STATS_PERF_AVAILABLE
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#endif
 
 #include <ndds/reda/reda_inlineList.h>
 
@@ -75,6 +91,48 @@ const char * VALID_WHAT[] = {
     NULL
 };
 
+/* Describes the operations that provide the build settings of each API */
+static const struct {
+    const char  *name;          /* Short name of the API */
+    const char  *description;   /* Human-readable name of the API */
+    const char  *comp;          /* Operation for the compiler */
+    const char  *flags;         /* Operation for the compiler flags */
+    const char  *link;          /* Operation for the linker */
+    const char  *ldflags;       /* Operation for the linker flags */
+    const char  *ldlibs;        /* Operation for the libraries */
+} API_OPERATIONS[] = {
+    { "c",      "C API", 
+        "--ccomp", "--cflags", "--clink", "--ldflags", "--ldlibs" },
+    { "cxx",    "Traditional C++ API",
+        "--cxxcomp", "--cxxflags", "--cxxlink", "--ldxxflags", "--ldxxlibs" },
+    { "cxx03",  "Modern C++ API (C++03)",
+        "--cxx03comp", "--cxx03flags", "--cxx03link", "--ldxx03flags", "--ldxx03libs" },
+    { "cxx11",  "Modern C++ API (C++11)",
+        "--cxx11comp", "--cxx11flags", "--cxx11link", "--ldxx11flags", "--ldxx11libs" },
+    { NULL, NULL, NULL, NULL, NULL, NULL, NULL }
+};
+
+/* The combinations of library modifiers (--static, --debug, --libmsg) used
+ * when generating the settings for all the variants of a target
+ */
+static const struct {
+    const char  *name;          /* Name of the variant */
+    const char  *fileSuffix;    /* Suffix used for generated file names */
+    RTIBool     isStatic;
+    RTIBool     isDebug;
+    RTIBool     libMsg;
+} LIB_VARIANTS[] = {
+    { "shared",              "",                     RTI_FALSE, RTI_FALSE, RTI_FALSE },
+    { "static",              "-static",              RTI_TRUE,  RTI_FALSE, RTI_FALSE },
+    { "debug",               "-debug",               RTI_FALSE, RTI_TRUE,  RTI_FALSE },
+    { "static-debug",        "-static-debug",        RTI_TRUE,  RTI_TRUE,  RTI_FALSE },
+    { "shared-libmsg",       "-libmsg",              RTI_FALSE, RTI_FALSE, RTI_TRUE },
+    { "static-libmsg",       "-static-libmsg",       RTI_TRUE,  RTI_FALSE, RTI_TRUE },
+    { "debug-libmsg",        "-debug-libmsg",        RTI_FALSE, RTI_TRUE,  RTI_TRUE },
+    { "static-debug-libmsg", "-static-debug-libmsg", RTI_TRUE,  RTI_TRUE,  RTI_TRUE },
+    { NULL,                  NULL,                   RTI_FALSE, RTI_FALSE, RTI_FALSE }
+};
+
 /* State machine used when parsing the project file */
 typedef enum {
     RSM_TOPLEVEL,           /* Parsing top level of the file */
@@ -99,6 +157,696 @@ typedef enum {
 #define MAX_CMDLINEARG_SIZE 1024
 
 
+/***************************************************************************
+ * Statistics
+ **************************************************************************/
+/* Phase timings and counters printed to stderr with --stats (or when the
+ * environment variable CONNEXT_CONFIG_STATS is set to a value other than 0).
+ *
+ * The instrumentation is built only when ENABLE_STATS is defined (configure
+ * with --enable-stats): otherwise all the STATS_* macros expand to nothing.
+ *
+ * Phases can be nested: the time of the read phase (I/O of the platform 
+ * file) is part of the parse phase, and is subtracted when reported.
+ *
+ * On Linux, --stats=perf (or CONNEXT_CONFIG_STATS=perf) also reports the
+ * hardware counters (perf_event_open) of the parse, lookup and compose
+ * phases. Counters that cannot be opened (i.e. perf_event_paranoid, 
+ * containers, virtual machines without PMU) are reported as n/a.
+ */
+#define STATS_ENV_VARIABLE      "CONNEXT_CONFIG_STATS"
+
+#ifdef ENABLE_STATS
+typedef enum {
+    StatsPhase_Total = 0,
+    StatsPhase_NddsHome,
+    StatsPhase_Read,
+    StatsPhase_Parse,
+    StatsPhase_Lookup,
+    StatsPhase_Compose,
+    StatsPhase_Output,
+    StatsPhase_Count
+} StatsPhase;
+
+typedef enum {
+    StatsCounter_Lines = 0,
+    StatsCounter_ArchParsed,
+    StatsCounter_ArchSkipped,
+    StatsCounter_Params,
+    StatsCounter_Compositions,
+    StatsCounter_BytesAllocated,
+    StatsCounter_Count
+} StatsCounter;
+
+static const char * const STATS_PHASE_NAMES[] = {
+    "total", "nddshome", "read", "parse", "lookup", "compose", "output"
+};
+static const char * const STATS_COUNTER_NAMES[] = {
+    "lines", "arches-parsed", "arches-skipped", "params", "compositions", 
+    "bytes-allocated"
+};
+
+#ifdef STATS_PERF_AVAILABLE
+typedef enum {
+    StatsPerf_Cycles = 0,
+    StatsPerf_Instructions,
+    StatsPerf_CacheMisses,
+    StatsPerf_BranchMisses,
+    StatsPerf_PageFaults,
+    StatsPerf_Count
+} StatsPerf;
+
+static const struct {
+    const char  *name;
+    __u32       type;
+    __u64       config;
+} STATS_PERF_EVENTS[] = {
+    { "cycles",         PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { "instructions",   PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { "cache-misses",   PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { "branch-misses",  PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { "page-faults",    PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS }
+};
+
+/* Returns RTI_TRUE if the hardware counters are measured for the phase */
+#define STATS_PERF_PHASE(phase)     \
+        (((phase) == StatsPhase_Parse) || \
+         ((phase) == StatsPhase_Lookup) || \
+         ((phase) == StatsPhase_Compose))
+#endif
+
+struct Stats {
+    RTIBool                     enabled;
+    RTIBool                     running[StatsPhase_Count];
+    struct timespec             start[StatsPhase_Count];
+    unsigned long long          elapsedNs[StatsPhase_Count];
+    unsigned long long          counter[StatsCounter_Count];
+#ifdef STATS_PERF_AVAILABLE
+    RTIBool                     perfEnabled;
+    int                         perfFd[StatsPerf_Count];    /* -1 if n/a */
+    int                         perfErrno;  /* Error of the first failure */
+    unsigned long long          perfStart[StatsPhase_Count][StatsPerf_Count];
+    unsigned long long          perfValue[StatsPhase_Count][StatsPerf_Count];
+#endif
+};
+
+static struct Stats theStats;
+
+#ifdef STATS_PERF_AVAILABLE
+/* {{{ Stats_openPerfCounters
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Opens the hardware counters of the process (user space only, so it works
+ * with the default perf_event_paranoid=2). Each counter is opened on its
+ * own, so the ones not supported do not prevent the others from working.
+ */
+static void Stats_openPerfCounters(void) {
+    struct perf_event_attr attr;
+    int i;
+
+    theStats.perfEnabled = RTI_TRUE;
+    theStats.perfErrno = 0;
+    for (i = 0; i < StatsPerf_Count; ++i) {
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = STATS_PERF_EVENTS[i].type;
+        attr.config = STATS_PERF_EVENTS[i].config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        theStats.perfFd[i] = (int)syscall(SYS_perf_event_open, 
+                &attr, 
+                0,          /* This process */
+                -1,         /* Any CPU */
+                -1,         /* No group */
+                0);
+        if ((theStats.perfFd[i] == -1) && (theStats.perfErrno == 0)) {
+            theStats.perfErrno = errno;
+        }
+    }
+}
+
+/* }}} */
+/* {{{ Stats_closePerfCounters
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void Stats_closePerfCounters(void) {
+    int i;
+    for (i = 0; i < StatsPerf_Count; ++i) {
+        if (theStats.perfFd[i] != -1) {
+            close(theStats.perfFd[i]);
+            theStats.perfFd[i] = -1;
+        }
+    }
+}
+
+/* }}} */
+/* {{{ Stats_readPerfCounters
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Reads the current value of all the counters (0 for the ones n/a)
+ */
+static void Stats_readPerfCounters(unsigned long long *valuesOut) {
+    int i;
+    for (i = 0; i < StatsPerf_Count; ++i) {
+        valuesOut[i] = 0;
+        if ((theStats.perfFd[i] != -1) && 
+                (read(theStats.perfFd[i], &valuesOut[i], sizeof(valuesOut[i])) != 
+                    (ssize_t)sizeof(valuesOut[i]))) {
+            valuesOut[i] = 0;
+        }
+    }
+}
+
+/* }}} */
+#endif
+
+/* {{{ Stats_beginPhase
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void Stats_beginPhase(StatsPhase phase) {
+    if (theStats.enabled) {
+        theStats.running[phase] = RTI_TRUE;
+#ifdef STATS_PERF_AVAILABLE
+        if (theStats.perfEnabled && STATS_PERF_PHASE(phase)) {
+            Stats_readPerfCounters(theStats.perfStart[phase]);
+        }
+#endif
+        clock_gettime(CLOCK_MONOTONIC, &theStats.start[phase]);
+    }
+}
+
+/* }}} */
+/* {{{ Stats_endPhase
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Adds the time elapsed since the last Stats_beginPhase to the phase
+ */
+static void Stats_endPhase(StatsPhase phase) {
+    struct timespec now;
+    if (theStats.enabled && theStats.running[phase]) {
+        theStats.running[phase] = RTI_FALSE;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        theStats.elapsedNs[phase] += 
+                (unsigned long long)(now.tv_sec - theStats.start[phase].tv_sec) * 1000000000ULL + 
+                (unsigned long long)now.tv_nsec - 
+                (unsigned long long)theStats.start[phase].tv_nsec;
+#ifdef STATS_PERF_AVAILABLE
+        if (theStats.perfEnabled && STATS_PERF_PHASE(phase)) {
+            unsigned long long values[StatsPerf_Count];
+            int i;
+            Stats_readPerfCounters(values);
+            for (i = 0; i < StatsPerf_Count; ++i) {
+                theStats.perfValue[phase][i] += 
+                        values[i] - theStats.perfStart[phase][i];
+            }
+        }
+#endif
+    }
+}
+
+/* }}} */
+/* {{{ Stats_enable
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Enables the statistics if requested (by argument or env variable) and
+ * starts measuring the total time.
+ *
+ * \param requested     RTI_TRUE if --stats was specified
+ * \param perf          RTI_TRUE if --stats=perf was specified
+ */
+static void Stats_enable(RTIBool requested, RTIBool perf) {
+    const char *env = getenv(STATS_ENV_VARIABLE);
+    if ((env != NULL) && (env[0] != '\0') && (strcmp(env, "0") != 0)) {
+        requested = RTI_TRUE;
+        if (strcmp(env, "perf") == 0) {
+            perf = RTI_TRUE;
+        }
+    }
+    if (requested || perf) {
+        theStats.enabled = RTI_TRUE;
+    }
+#ifdef STATS_PERF_AVAILABLE
+    if (perf) {
+        Stats_openPerfCounters();
+    }
+#else
+    if (perf) {
+        fprintf(stderr, "Warning: hardware counters not available on this platform\n");
+    }
+#endif
+    Stats_beginPhase(StatsPhase_Total);
+}
+
+/* }}} */
+/* {{{ Stats_report
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Prints the collected statistics (if enabled) to the given stream.
+ * The phases still running (i.e. interrupted by an error) are ended.
+ */
+static void Stats_report(FILE *fp) {
+    struct rusage usage;
+    int i;
+
+    if (!theStats.enabled) {
+        return;
+    }
+    for (i = 0; i < StatsPhase_Count; ++i) {
+        Stats_endPhase((StatsPhase)i);
+    }
+    theStats.elapsedNs[StatsPhase_Parse] -= theStats.elapsedNs[StatsPhase_Read];
+
+    fprintf(fp, "%s stats:\n", APPLICATION_NAME);
+    for (i = 0; i < StatsPhase_Count; ++i) {
+        fprintf(fp, "  time.%-18s %10.3f ms\n", 
+                STATS_PHASE_NAMES[i],
+                (double)theStats.elapsedNs[i] / 1e6);
+    }
+    for (i = 0; i < StatsCounter_Count; ++i) {
+        fprintf(fp, "  count.%-17s %10llu\n", 
+                STATS_COUNTER_NAMES[i],
+                theStats.counter[i]);
+    }
+#ifdef STATS_PERF_AVAILABLE
+    if (theStats.perfEnabled) {
+        int p, c;
+
+        if (theStats.perfErrno != 0) {
+            fprintf(fp, "  perf: some counters not available: %s\n", 
+                    strerror(theStats.perfErrno));
+        }
+        fprintf(fp, "  %-8s", "perf");
+        for (c = 0; c < StatsPerf_Count; ++c) {
+            fprintf(fp, " %14s", STATS_PERF_EVENTS[c].name);
+        }
+        fprintf(fp, " %6s\n", "IPC");
+        for (p = 0; p < StatsPhase_Count; ++p) {
+            if (!STATS_PERF_PHASE(p)) {
+                continue;
+            }
+            fprintf(fp, "  %-8s", STATS_PHASE_NAMES[p]);
+            for (c = 0; c < StatsPerf_Count; ++c) {
+                if (theStats.perfFd[c] == -1) {
+                    fprintf(fp, " %14s", "n/a");
+                } else {
+                    fprintf(fp, " %14llu", theStats.perfValue[p][c]);
+                }
+            }
+            if (theStats.perfValue[p][StatsPerf_Cycles] != 0) {
+                fprintf(fp, " %6.2f\n", 
+                        (double)theStats.perfValue[p][StatsPerf_Instructions] / 
+                        (double)theStats.perfValue[p][StatsPerf_Cycles]);
+            } else {
+                fprintf(fp, " %6s\n", "n/a");
+            }
+        }
+        Stats_closePerfCounters();
+    }
+#endif
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        /* ru_maxrss is in kilobytes on Linux (bytes on Darwin) */
+        fprintf(fp, "  peak-rss               %10ld kB\n", 
+#ifdef __APPLE__
+                usage.ru_maxrss / 1024
+#else
+                usage.ru_maxrss
+#endif
+                );
+    }
+}
+
+/* }}} */
+
+#define STATS_ENABLE(requested, perf)   Stats_enable(requested, perf)
+#define STATS_BEGIN(phase)          Stats_beginPhase(StatsPhase_##phase)
+#define STATS_END(phase)            Stats_endPhase(StatsPhase_##phase)
+#define STATS_ADD(name, n)          \
+        (theStats.counter[StatsCounter_##name] += (unsigned long long)(n))
+#define STATS_REPORT()              Stats_report(stderr)
+
+#else
+
+#define STATS_ENABLE(requested, perf)
+#define STATS_BEGIN(phase)
+#define STATS_END(phase)
+#define STATS_ADD(name, n)
+#define STATS_REPORT()
+
+#endif  /* ENABLE_STATS */
+
+
+/***************************************************************************
+ * Memory Accounting
+ **************************************************************************/
+/* All the heap allocations of this file go through the MEM_* macros, that
+ * tag each block with the call site (MemSite) that allocated it.
+ *
+ * When the tool is built with ENABLE_STATS and --mem-report is specified,
+ * every live block is recorded in a hash table indexed by address, and at
+ * exit a report with the count and bytes allocated for each site, the
+ * high-water mark of the live bytes and the blocks still allocated (leaks)
+ * is printed to stderr.
+ *
+ * Buffers allocated by the C library (getline, open_memstream) are recorded
+ * with MEM_TRACK right after they are obtained. Releasing a block that is
+ * not recorded (i.e. before --mem-report is enabled) is allowed.
+ *
+ * Without ENABLE_STATS the macros call directly the C library functions.
+ */
+typedef enum {
+    MemSite_ArchParameter = 0,
+    MemSite_Architecture,
+    MemSite_ArchList,           /* Head of the list of architectures */
+    MemSite_Line,               /* Lines read from the platform file */
+    MemSite_LogicalLine,        /* Lines joined for multi-line values */
+    MemSite_ParseScratch,       /* Copy of the line being parsed */
+    MemSite_Path,               /* NDDSHOME, platform file path */
+    MemSite_Compose,            /* Compose context and output buffer */
+    MemSite_InstalledTargets,
+    MemSite_Generated,          /* Content of generated files */
+    MemSite_Trace,              /* Trace report */
+    MemSite_Symbols,            /* Symbol tables of --ldlibs-minimal */
+    MemSite_Count
+} MemSite;
+
+#ifdef ENABLE_STATS
+static const char * const MEM_SITE_NAMES[] = {
+    "ArchParameter", "Architecture", "ArchList", "Line", "LogicalLine",
+    "ParseScratch", "Path", "Compose", "InstalledTargets", "Generated",
+    "Trace", "Symbols"
+};
+
+/* Initial size of the table of live blocks (must be a power of 2) */
+#define MEM_TABLE_INITIAL_SIZE      1024
+
+/* Max number of leaked blocks listed individually by the report */
+#define MEM_MAX_LEAKS_LISTED        20
+
+struct MemBlock {
+    void                        *ptr;       /* NULL if the slot is free */
+    size_t                      size;
+    MemSite                     site;
+};
+
+struct MemSiteInfo {
+    unsigned long long          allocCount;
+    unsigned long long          freeCount;
+    unsigned long long          allocBytes;
+    unsigned long long          liveBytes;
+    unsigned long long          peakLiveBytes;
+};
+
+struct Mem {
+    RTIBool                     enabled;
+    struct MemBlock             *blocks;    /* Open addressing, linear probing */
+    size_t                      size;
+    size_t                      count;
+    unsigned long long          liveBytes;
+    unsigned long long          peakLiveBytes;
+    struct MemSiteInfo          site[MemSite_Count];
+};
+
+static struct Mem theMem;
+
+/* {{{ Mem_slotOf
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the preferred slot of the given address in the table
+ */
+static size_t Mem_slotOf(const void *ptr, size_t tableSize) {
+    /* The low bits of the address are always 0 because of the alignment */
+    uintptr_t key = (uintptr_t)ptr >> 4;
+    return (size_t)(key * 0x9E3779B97F4A7C15ULL) & (tableSize-1);
+}
+
+/* }}} */
+/* {{{ Mem_insert
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Records a live block. The table grows when half full.
+ * If the table cannot grow the accounting is disabled.
+ */
+static void Mem_insert(void *ptr, size_t size, MemSite site) {
+    size_t i;
+
+    if (theMem.count * 2 >= theMem.size) {
+        size_t newSize = (theMem.size == 0) ? MEM_TABLE_INITIAL_SIZE : theMem.size * 2;
+        struct MemBlock *newBlocks = calloc(newSize, sizeof(*newBlocks));
+        if (newBlocks == NULL) {
+            fprintf(stderr, "Warning: out of memory, memory report disabled\n");
+            theMem.enabled = RTI_FALSE;
+            return;
+        }
+        for (i = 0; i < theMem.size; ++i) {
+            if (theMem.blocks[i].ptr != NULL) {
+                size_t j = Mem_slotOf(theMem.blocks[i].ptr, newSize);
+                while (newBlocks[j].ptr != NULL) {
+                    j = (j + 1) & (newSize-1);
+                }
+                newBlocks[j] = theMem.blocks[i];
+            }
+        }
+        free(theMem.blocks);
+        theMem.blocks = newBlocks;
+        theMem.size = newSize;
+    }
+    i = Mem_slotOf(ptr, theMem.size);
+    while (theMem.blocks[i].ptr != NULL) {
+        i = (i + 1) & (theMem.size-1);
+    }
+    theMem.blocks[i].ptr = ptr;
+    theMem.blocks[i].size = size;
+    theMem.blocks[i].site = site;
+    ++theMem.count;
+}
+
+/* }}} */
+/* {{{ Mem_remove
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Removes the record of a block, shifting back the following entries of
+ * the same cluster (so no tombstones are needed).
+ *
+ * \return          RTI_TRUE if the block was recorded (blockOut is set)
+ */
+static RTIBool Mem_remove(const void *ptr, struct MemBlock *blockOut) {
+    size_t i, j;
+
+    if (theMem.size == 0) {
+        return RTI_FALSE;
+    }
+    i = Mem_slotOf(ptr, theMem.size);
+    while (theMem.blocks[i].ptr != ptr) {
+        if (theMem.blocks[i].ptr == NULL) {
+            return RTI_FALSE;
+        }
+        i = (i + 1) & (theMem.size-1);
+    }
+    *blockOut = theMem.blocks[i];
+    theMem.blocks[i].ptr = NULL;
+    --theMem.count;
+
+    for (j = (i + 1) & (theMem.size-1); 
+            theMem.blocks[j].ptr != NULL; 
+            j = (j + 1) & (theMem.size-1)) {
+        size_t k = Mem_slotOf(theMem.blocks[j].ptr, theMem.size);
+        /* Move the entry in the hole if its slot is not in (i, j] */
+        if ((i <= j) ? ((k <= i) || (k > j)) : ((k <= i) && (k > j))) {
+            theMem.blocks[i] = theMem.blocks[j];
+            theMem.blocks[j].ptr = NULL;
+            i = j;
+        }
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ Mem_track
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Records a block allocated by the given site (no-op if not enabled)
+ */
+static void Mem_track(MemSite site, void *ptr, size_t size) {
+    struct MemSiteInfo *info = &theMem.site[site];
+
+    if (!theMem.enabled || (ptr == NULL)) {
+        return;
+    }
+    Mem_insert(ptr, size, site);
+    ++info->allocCount;
+    info->allocBytes += size;
+    info->liveBytes += size;
+    if (info->liveBytes > info->peakLiveBytes) {
+        info->peakLiveBytes = info->liveBytes;
+    }
+    theMem.liveBytes += size;
+    if (theMem.liveBytes > theMem.peakLiveBytes) {
+        theMem.peakLiveBytes = theMem.liveBytes;
+    }
+}
+
+/* }}} */
+/* {{{ Mem_untrack
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Removes the record of a block that is about to be released.
+ * Returns the size of the block (0 if not recorded).
+ */
+static size_t Mem_untrack(void *ptr) {
+    struct MemBlock block;
+
+    if (!theMem.enabled || (ptr == NULL) || !Mem_remove(ptr, &block)) {
+        return 0;
+    }
+    ++theMem.site[block.site].freeCount;
+    theMem.site[block.site].liveBytes -= block.size;
+    theMem.liveBytes -= block.size;
+    return block.size;
+}
+
+/* }}} */
+/* {{{ Mem_calloc
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void *Mem_calloc(MemSite site, size_t count, size_t size) {
+    void *retVal = calloc(count, size);
+    Mem_track(site, retVal, count * size);
+    return retVal;
+}
+
+/* }}} */
+/* {{{ Mem_malloc
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void *Mem_malloc(MemSite site, size_t size) {
+    void *retVal = malloc(size);
+    Mem_track(site, retVal, size);
+    return retVal;
+}
+
+/* }}} */
+/* {{{ Mem_realloc
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * If the reallocation fails the original block is recorded again (as it
+ * is still allocated).
+ */
+static void *Mem_realloc(MemSite site, void *ptr, size_t size) {
+    size_t oldSize = Mem_untrack(ptr);
+    void *retVal = realloc(ptr, size);
+    if (retVal == NULL) {
+        Mem_track(site, ptr, oldSize);
+    } else {
+        Mem_track(site, retVal, size);
+    }
+    return retVal;
+}
+
+/* }}} */
+/* {{{ Mem_strdup
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static char *Mem_strdup(MemSite site, const char *str) {
+    char *retVal = strdup(str);
+    if (retVal != NULL) {
+        Mem_track(site, retVal, strlen(retVal)+1);
+    }
+    return retVal;
+}
+
+/* }}} */
+/* {{{ Mem_free
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void Mem_free(void *ptr) {
+    Mem_untrack(ptr);
+    free(ptr);
+}
+
+/* }}} */
+/* {{{ Mem_enable
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Starts recording the allocations if requested (--mem-report)
+ */
+static void Mem_enable(RTIBool requested) {
+    theMem.enabled = requested;
+}
+
+/* }}} */
+/* {{{ Mem_report
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Prints (if enabled) the allocations of each site, the high-water mark of
+ * the live bytes and the blocks still allocated, then releases the table.
+ * Must be called after all the memory has been released.
+ */
+static void Mem_report(FILE *fp) {
+    unsigned long long allocCount = 0;
+    unsigned long long allocBytes = 0;
+    size_t listed = 0;
+    size_t i;
+
+    if (!theMem.enabled) {
+        return;
+    }
+    fprintf(fp, "%s memory report:\n", APPLICATION_NAME);
+    fprintf(fp, "  %-18s %10s %12s %12s %10s %12s\n",
+            "site", "allocs", "bytes", "peak-live", "leaks", "leaked-bytes");
+    for (i = 0; i < MemSite_Count; ++i) {
+        const struct MemSiteInfo *info = &theMem.site[i];
+        if (info->allocCount == 0) {
+            continue;
+        }
+        fprintf(fp, "  %-18s %10llu %12llu %12llu %10llu %12llu\n",
+                MEM_SITE_NAMES[i],
+                info->allocCount,
+                info->allocBytes,
+                info->peakLiveBytes,
+                info->allocCount - info->freeCount,
+                info->liveBytes);
+        allocCount += info->allocCount;
+        allocBytes += info->allocBytes;
+    }
+    fprintf(fp, "  %-18s %10llu %12llu %12llu %10lu %12llu\n",
+            "total",
+            allocCount,
+            allocBytes,
+            theMem.peakLiveBytes,
+            (unsigned long)theMem.count,
+            theMem.liveBytes);
+
+    for (i = 0; i < theMem.size; ++i) {
+        const struct MemBlock *block = &theMem.blocks[i];
+        if (block->ptr == NULL) {
+            continue;
+        }
+        if (listed++ == MEM_MAX_LEAKS_LISTED) {
+            fprintf(fp, "  ... %lu more leaked blocks\n", 
+                    (unsigned long)(theMem.count - MEM_MAX_LEAKS_LISTED));
+            break;
+        }
+        fprintf(fp, "  leak: %lu bytes at %p allocated by %s\n",
+                (unsigned long)block->size,
+                block->ptr,
+                MEM_SITE_NAMES[block->site]);
+    }
+    free(theMem.blocks);
+    memset(&theMem, 0, sizeof(theMem));
+}
+
+/* }}} */
+
+#define MEM_ENABLE(requested)       Mem_enable(requested)
+#define MEM_CALLOC(site, n, size)   Mem_calloc(MemSite_##site, (n), (size))
+#define MEM_MALLOC(site, size)      Mem_malloc(MemSite_##site, (size))
+#define MEM_REALLOC(site, ptr, size) Mem_realloc(MemSite_##site, (ptr), (size))
+#define MEM_STRDUP(site, str)       Mem_strdup(MemSite_##site, (str))
+#define MEM_TRACK(site, ptr, size)  Mem_track(MemSite_##site, (ptr), (size))
+#define MEM_FREE(ptr)               Mem_free(ptr)
+#define MEM_REPORT()                Mem_report(stderr)
+
+#else
+
+#define MEM_ENABLE(requested)
+#define MEM_CALLOC(site, n, size)   calloc((n), (size))
+#define MEM_MALLOC(site, size)      malloc(size)
+#define MEM_REALLOC(site, ptr, size) realloc((ptr), (size))
+#define MEM_STRDUP(site, str)       strdup(str)
+#define MEM_TRACK(site, ptr, size)
+#define MEM_FREE(ptr)               free(ptr)
+#define MEM_REPORT()
+
+#endif  /* ENABLE_STATS */
+
+
 /***************************************************************************
  * ArchParameter
  **************************************************************************/
@@ -156,10 +904,11 @@ void ArchParameter_init(struct ArchParameter *me) {
  * The constructor for the ArchParameter object
  */
 struct ArchParameter * ArchParameter_new() {
-    struct ArchParameter *retVal = calloc(1, sizeof(*retVal));
+    struct ArchParameter *retVal = MEM_CALLOC(ArchParameter, 1, sizeof(*retVal));
     if (retVal == NULL) {
         return NULL;
     }
+    STATS_ADD(BytesAllocated, sizeof(*retVal));
     ArchParameter_init(retVal);
     return retVal;
 }
@@ -171,7 +920,7 @@ struct ArchParameter * ArchParameter_new() {
  */
 void ArchParameter_delete(struct ArchParameter *me) {
     memset(me, 0, sizeof(*me));
-    free(me);
+    MEM_FREE(me);
 }
 
 /* }}} */
@@ -210,10 +959,11 @@ void Architecture_init(struct Architecture *me) {
  * Architecture constructor
  */
 struct Architecture * Architecture_new() {
-    struct Architecture *retVal = calloc(1, sizeof(*retVal));
+    struct Architecture *retVal = MEM_CALLOC(Architecture, 1, sizeof(*retVal));
     if (retVal == NULL) {
         return NULL;
     }
+    STATS_ADD(BytesAllocated, sizeof(*retVal));
     Architecture_init(retVal);
     return retVal;
 }
@@ -243,30 +993,74 @@ void Architecture_finalize(struct Architecture *me) {
  */
 void Architecture_delete(struct Architecture *me) {
     Architecture_finalize(me);
-    free(me);
+    MEM_FREE(me);
 }
 
 /* }}} */
 
 
 /***************************************************************************
- * Local Utility Functions
+ * PlatformFileInfo
  **************************************************************************/
-/* {{{ calcNDDSHOME
- * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
- * Determines the root directory where RTI Connext DDS is installed (NDDEHOME)
- * The logic is the following:
- * - Look up the environment variable NDDSHOME. If is defined, good, make
- *   a copy and return
+/* Information collected while reading the platform file, independent from
+ * the parsed content: the number of lines read and a hash of the raw content
+ * of the file (used to identify the platform file in the exported data).
  *
- * - If is not defined, retrieve the absolute path where connext-config is
- *   invoked by looking at argv[0] and the current working directory
- *
- * - Then go one level up (assumes the connext-config is installed under
- *   NDDSHOME/bin) and use that directory as NDDSHOME
- *
- *
- * \return a malloc-allocated string containing NDDSHOME or NULL if an
+ * The hash is a 64-bit FNV-1a computed over all the bytes read from the file.
+ */
+#define FNV1A64_OFFSET_BASIS    0xcbf29ce484222325ULL
+#define FNV1A64_PRIME           0x100000001b3ULL
+
+struct PlatformFileInfo {
+    unsigned int                lineCount;
+    unsigned long long          hash;
+};
+
+/* {{{ PlatformFileInfo_init
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * PlatformFileInfo initializer
+ */
+void PlatformFileInfo_init(struct PlatformFileInfo *me) {
+    me->lineCount = 0;
+    me->hash = FNV1A64_OFFSET_BASIS;
+}
+
+/* }}} */
+/* {{{ PlatformFileInfo_hashData
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Adds the given raw data to the hash of the platform file
+ */
+void PlatformFileInfo_hashData(struct PlatformFileInfo *me,
+        const char *data,
+        size_t len) {
+    size_t i;
+    for (i = 0; i < len; ++i) {
+        me->hash ^= (unsigned char)data[i];
+        me->hash *= FNV1A64_PRIME;
+    }
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * Local Utility Functions
+ **************************************************************************/
+/* {{{ calcNDDSHOME
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Determines the root directory where RTI Connext DDS is installed (NDDEHOME)
+ * The logic is the following:
+ * - Look up the environment variable NDDSHOME. If is defined, good, make
+ *   a copy and return
+ *
+ * - If is not defined, retrieve the absolute path where connext-config is
+ *   invoked by looking at argv[0] and the current working directory
+ *
+ * - Then go one level up (assumes the connext-config is installed under
+ *   NDDSHOME/bin) and use that directory as NDDSHOME
+ *
+ *
+ * \return a malloc-allocated string containing NDDSHOME or NULL if an
  *         error occurred
  *
  *
@@ -275,7 +1069,7 @@ static char *calcNDDSHOME(const char *argv0) {
     char *tmp;
     char *retVal = NULL;
 
-    retVal = calloc(PATH_MAX+1, 1);
+    retVal = MEM_CALLOC(Path, PATH_MAX+1, 1);
     if (retVal == NULL) {
         fprintf(stderr, "Out of memory allocating NDDSHOME path\n");
         goto err;
@@ -355,7 +1149,7 @@ static char *calcNDDSHOME(const char *argv0) {
 
 err:
     if (retVal != NULL) {
-        free(retVal);
+        MEM_FREE(retVal);
     }
     return NULL;
 }
@@ -415,15 +1209,16 @@ err:
 #ifndef NDEBUG
 /* {{{ dumpArch
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
- * Prints to stdout a dump of the list of architectures.
+ * Prints to the given stream a dump of the list of architectures.
  *
  * This function is used when user specify --dump-all parameter and is meant
  * for debugging/testing ony.
  *
+ * \param fp        The output stream
  * \param list      The list of Architecture objects
  *
  */
-static void dumpArch(struct REDAInlineList *list) {
+static void dumpArch(FILE *fp, struct REDAInlineList *list) {
     struct REDAInlineListNode *archNode = NULL;
 
     for (archNode = REDAInlineList_getFirst(list); 
@@ -431,7 +1226,7 @@ static void dumpArch(struct REDAInlineList *list) {
             archNode = REDAInlineListNode_getNext(archNode)) {
         struct REDAInlineListNode *paramNode;
         struct Architecture *arch = (struct Architecture *)archNode;
-        printf("arch='%s':\n", arch->target);
+        fprintf(fp, "arch='%s':\n", arch->target);
 
         for (paramNode = REDAInlineList_getFirst(&arch->paramList); 
                 paramNode; 
@@ -439,19 +1234,19 @@ static void dumpArch(struct REDAInlineList *list) {
             struct ArchParameter *param = (struct ArchParameter *)paramNode;
             switch(param->valueType) {
                 case APVT_Boolean:
-                    printf("\t\t%s=%s\n",
+                    fprintf(fp, "\t\t%s=%s\n",
                             param->key,
                             (param->value.as_bool ? "TRUE" : "FALSE"));
                     break;
 
                 case APVT_String:
-                    printf("\t\t%s=\"%s\"\n",
+                    fprintf(fp, "\t\t%s=\"%s\"\n",
                             param->key,
                             param->value.as_string);
                     break;
 
                 case APVT_EnvVariable:
-                    printf("\t\t%s=%s\n",
+                    fprintf(fp, "\t\t%s=%s\n",
                             param->key,
                             param->value.as_string);
                     break;
@@ -459,22 +1254,22 @@ static void dumpArch(struct REDAInlineList *list) {
                 case APVT_ArrayOfStrings: {
                     size_t i;
                     const char *sep = "";
-                    printf("\t\t%s=[", param->key);
+                    fprintf(fp, "\t\t%s=[", param->key);
                     for (i = 0; i < MAX_ARRAY_SIZE; ++i) {
                         if (param->value.as_arrayOfStrings[i][0] == '\0') {
                             break;
                         }
-                        printf("%s\"%s\"",
+                        fprintf(fp, "%s\"%s\"",
                                 sep,
                                 param->value.as_arrayOfStrings[i]);
                         sep = ", ";
                     }
-                    printf("]\n");
+                    fprintf(fp, "]\n");
                     break;
                 }
 
                 default:
-                    printf("** Error: unknow how to display type=%d\n",
+                    fprintf(fp, "** Error: unknow how to display type=%d\n",
                             param->valueType);
             }
         }
@@ -657,25 +1452,41 @@ static char * expandEnvVar(const char *inStr) {
 }
 
 /* }}} */
-/* {{{ printStringProperty
+/* Result of the composition of the value of an operation for a target */
+typedef enum {
+    ComposeResult_Ok,               /* Success, value composed */
+    ComposeResult_NotDefined,       /* Property not defined for the target */
+    ComposeResult_Unsupported,      /* Target does not support the API */
+    ComposeResult_Error             /* Error (already printed to stderr) */
+} ComposeResult;
+
+/* {{{ composeStringProperty
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
- * Prints to stdout the value of the given string property for the 
+ * Copies into bufOut the value of the given string property for the 
  * specified architecture, optionally expanding the environment variables.
  *
  * \param arch      a pointer to the Architecture object
  * \param propName  the name of the property to lookup
  * \param expandVar the boolean that tells whether to expand the env 
  *                  variables or not.
- * \return          RTI_TRUE if success, RTI_FALSE if failed
+ * \param bufOut    a pointer to the string buffer where to write the result
+ * \param bufSize   the size of bufOut
+ * \return          ComposeResult_Ok if success, ComposeResult_NotDefined if
+ *                  the property is not defined for the target (bufOut is
+ *                  set to empty string), ComposeResult_Error if failed
  */
-RTIBool printStringProperty(struct Architecture *arch,
+ComposeResult composeStringProperty(struct Architecture *arch,
         const char *propName,
-        RTIBool expandVar) {
+        RTIBool expandVar,
+        char *bufOut,
+        int bufSize) {
     char *toPrint;
     struct ArchParameter *ap = archGetParam(arch, propName);
+
+    bufOut[0] = '\0';
     if (ap == NULL) {
         /* Variable not defined */
-        return RTI_TRUE;
+        return ComposeResult_NotDefined;
     }
     if (ap->valueType == APVT_String) {
         toPrint = &ap->value.as_string[0];
@@ -683,7 +1494,7 @@ RTIBool printStringProperty(struct Architecture *arch,
             toPrint = expandEnvVar(toPrint);
             if (toPrint == NULL) {
                 /* Error message has been already printed in expandEnvVar */
-                return RTI_FALSE;
+                return ComposeResult_Error;
             }
         }
 
@@ -695,19 +1506,31 @@ RTIBool printStringProperty(struct Architecture *arch,
                 "Property '%s' is not a string or env variable for target %s\n", 
                 propName, 
                 arch->target);
-        return RTI_FALSE;
+        return ComposeResult_Error;
     }
-    puts(toPrint);
-    return RTI_TRUE;
+    if (snprintf(bufOut, (size_t)bufSize, "%s", toPrint) >= bufSize) {
+        fprintf(stderr,
+                "Value of property '%s' too long for target %s\n",
+                propName,
+                arch->target);
+        return ComposeResult_Error;
+    }
+    return ComposeResult_Ok;
 }
 
 /* }}} */
+/* Type mismatches found by getBooleanProperty. When theCountTypeErrors is
+ * set (--verify-all) a mismatch is only counted, also in debug mode.
+ */
+static RTIBool theCountTypeErrors = RTI_FALSE;
+static unsigned int theTypeErrors = 0;
+
 /* {{{ getBooleanProperty
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  * Look for the given property and if set returns its boolean value.
  * Returns FALSE if the property is not defined.
  * If the property is not a boolean, prints an error and return FALSE (Release
- * mode), or abort (Debug mode).
+ * mode or theCountTypeErrors set), or abort (Debug mode).
  *
  * \param arch      a pointer to the Architecture object
  * \param propName  the name of the property to lookup
@@ -727,45 +1550,15 @@ RTIBool getBooleanProperty(struct Architecture *arch,
                 propName,
                 ap->valueType,
                 arch->target);
+        ++theTypeErrors;
 #ifndef NDEBUG
-        abort();
-#else
-        return RTI_FALSE;
+        if (!theCountTypeErrors) {
+            abort();
+        }
 #endif
-    }
-    return ap->value.as_bool;
-}
-
-/* }}} */
-/* {{{ ensureTargetSupportsCxx03
- * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
- * \param arch      a pointer to the Architecture object
- * \return          RTI_TRUE if the architecture supports Cxx03, FALSE otherwise
- */
-RTIBool ensureTargetSupportsCxx03(struct Architecture *arch) {
-    if (!getBooleanProperty(arch, "$SUPPORTS_CPP03")) {
-        fprintf(stderr,
-                "Error: target '%s' does not support C++03\n",
-                arch->target);
-        return RTI_FALSE;
-    }
-    return RTI_TRUE;
-}
-
-/* }}} */
-/* {{{ ensureTargetSupportsCxx11
- * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
- * \param arch      a pointer to the Architecture object
- * \return          RTI_TRUE if the architecture supports Cxx03, FALSE otherwise
- */
-RTIBool ensureTargetSupportsCxx11(struct Architecture *arch) {
-    if (!getBooleanProperty(arch, "$SUPPORTS_CPP11")) {
-        fprintf(stderr,
-                "Error: target '%s' does not support C++11\n",
-                arch->target);
         return RTI_FALSE;
     }
-    return RTI_TRUE;
+    return ap->value.as_bool;
 }
 
 /* }}} */
@@ -831,9 +1624,9 @@ static int joinStringArrayProperties(struct Architecture *arch,
 }
 
 /* }}} */
-/* {{{ printCompositeFlagsProperties
+/* {{{ composeCompositeFlagsProperties
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
- * Given an architecture, prints the flags composed by getting the values of 
+ * Given an architecture, composes the flags obtained by getting the values of 
  * more than one properties.
  *
  * \param arch      Pointer to the architecture to use
@@ -852,12 +1645,17 @@ static int joinStringArrayProperties(struct Architecture *arch,
  *                  that variables are using the form ${...} (with braces).
  *                  If envShell==RTI_FALSE, the variables are using a 
  *                  Makefile-style form: $(...) (with the parentheses)
- * \return return   RTI_FALSE if an error occurred, or RTI_TRUE if success
+ * \param bufOut    a pointer to the string buffer where to write the result
+ * \param bufSize   the size of bufOut
+ * \return          ComposeResult_Ok if success, ComposeResult_Error if an
+ *                  error occurred
  */
-RTIBool printCompositeFlagsProperties(struct Architecture *arch, 
+ComposeResult composeCompositeFlagsProperties(struct Architecture *arch, 
         const char **props, 
         RTIBool expandVar,
-        RTIBool envShell) {
+        RTIBool envShell,
+        char *bufOut,
+        int bufSize) {
     char line[MAX_CMDLINEARG_SIZE];
     int wr = 0;
     int rc = 0;
@@ -866,6 +1664,8 @@ RTIBool printCompositeFlagsProperties(struct Architecture *arch,
     const char *prefix;
 
     memset(line, 0, sizeof(line));
+    bufOut[0] = '\0';
+    STATS_ADD(Compositions, 1);
 
     for (propIdx = 0; props[propIdx] != NULL; ++propIdx) {
         /* Just a convenience alias */
@@ -883,7 +1683,7 @@ RTIBool printCompositeFlagsProperties(struct Architecture *arch,
                     propName, 
                     prefix);
             if (rc == -1) {
-                return RTI_FALSE;
+                return ComposeResult_Error;
             }
         } else {
             /* Copy verbatim the propName */
@@ -894,7 +1694,7 @@ RTIBool printCompositeFlagsProperties(struct Architecture *arch,
             if (rc > MAX_CMDLINEARG_SIZE-wr) {
                 fprintf(stderr, 
                         "Command line string too long while appending static flags\n");
-                return RTI_FALSE;
+                return ComposeResult_Error;
             }
         }
         wr += rc;
@@ -904,7 +1704,7 @@ RTIBool printCompositeFlagsProperties(struct Architecture *arch,
     if (expandVar == RTI_TRUE) {
         toPrint = expandEnvVar(toPrint);
         if (toPrint == NULL) {
-            return RTI_FALSE;
+            return ComposeResult_Error;
         }
     } else {
         /* 
@@ -926,7 +1726,7 @@ RTIBool printCompositeFlagsProperties(struct Architecture *arch,
                     fprintf(stderr, 
                             "Cannot find end of env variable in line=%s\n",
                             toPrint);
-                    return RTI_FALSE;
+                    return ComposeResult_Error;
                 }
                 *ptr = close_to;
             }
@@ -939,11 +1739,16 @@ RTIBool printCompositeFlagsProperties(struct Architecture *arch,
      * with the javascript version)
      */
     wr = strlen(toPrint)-1;
-    while (isspace(toPrint[wr])) {
+    while ((wr >= 0) && isspace(toPrint[wr])) {
         toPrint[wr--] = '\0';
     }
-    puts(unescapeString(toPrint));
-    return RTI_TRUE;
+    if (snprintf(bufOut, (size_t)bufSize, "%s", unescapeString(toPrint)) >= bufSize) {
+        fprintf(stderr,
+                "Composed flags too long for target %s\n",
+                arch->target);
+        return ComposeResult_Error;
+    }
+    return ComposeResult_Ok;
 }
 
 /* }}} */
@@ -1281,8 +2086,13 @@ ProcessLineResult processKeyValuePairLine(char *line, struct ArchParameter *para
 /* }}} */
 /* {{{ appendNextLine
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Reads the next non-empty line (comments removed) and appends it to currLine.
+ * Returns NULL at the end of file (if currLine is NULL) or if out of memory
+ * (currLine is released).
  */
-char *appendNextLine(FILE *fp, char *currLine, unsigned int *pLineCount) {
+char *appendNextLine(FILE *fp, 
+        char *currLine, 
+        struct PlatformFileInfo *info) {
     char *line = NULL;
     size_t lineLen;
     size_t currLineLen = 0;
@@ -1295,17 +2105,25 @@ char *appendNextLine(FILE *fp, char *currLine, unsigned int *pLineCount) {
 
     for (;;) {
         if (line) {
-            free(line);
+            MEM_FREE(line);
             line = NULL;
         }
         lineLen = 0;
 
         /* Always allocate a new buffer */
-        if (getline(&line, &lineLen, fp) == -1) {
-            /* EOF */
+        STATS_BEGIN(Read);
+        nRead = getline(&line, &lineLen, fp);
+        STATS_END(Read);
+        MEM_TRACK(Line, line, lineLen);
+        if (nRead == -1) {
+            /* EOF: getline could have allocated the buffer anyway */
+            MEM_FREE(line);
             break;
         }
-        ++*pLineCount;
+        STATS_ADD(BytesAllocated, lineLen);
+        STATS_ADD(Lines, 1);
+        ++info->lineCount;
+        PlatformFileInfo_hashData(info, line, (size_t)nRead);
 
         /* Identify multi-line comments */
         if ((tmp = strstr(line, "#*")) != NULL) {
@@ -1362,22 +2180,26 @@ char *appendNextLine(FILE *fp, char *currLine, unsigned int *pLineCount) {
 
         /* Append trimLine to currLine, reallocating its space */
         currLineLen += strlen(trimLine)+1;
+        STATS_ADD(BytesAllocated, strlen(trimLine)+1);
         if (currLine) {
-            currLine = realloc(currLine, currLineLen);
+            tmp = MEM_REALLOC(LogicalLine, currLine, currLineLen);
         } else {
             /* Note: realloc(NULL) behaves like malloc() not like calloc(), we
              *       still need to set the string to empty after allocation
              */
-            currLine = calloc(1, currLineLen);
+            tmp = MEM_CALLOC(LogicalLine, 1, currLineLen);
         }
-        if (!currLine) {
+        if (!tmp) {
             fprintf(stderr, "realloc failed, size=%lu\n", currLineLen);
+            MEM_FREE(currLine);
+            MEM_FREE(line);
             return NULL;
         }
+        currLine = tmp;
         strncat(currLine, trimLine, currLineLen - 1);
 
         /* Free line */
-        free(line);
+        MEM_FREE(line);
         return currLine;
     }
     /* Reached the end of file */
@@ -1395,10 +2217,13 @@ char *appendNextLine(FILE *fp, char *currLine, unsigned int *pLineCount) {
  *
  * \param filePath      pointer to the full path of the platform file
  * \param archDef       pointer to the list where to store the parsed arches
+ * \param info          pointer to the object that receives the line count
+ *                      and the hash of the platform file
  * \return              RTI_TRUE if success, RTI_FALSE if an error occurred
  */
 RTIBool readPlatformFile(const char *filePath, 
-        struct REDAInlineList *archDef) {
+        struct REDAInlineList *archDef,
+        struct PlatformFileInfo *info) {
     RTIBool ok = RTI_FALSE;
     FILE *fp;
     char *line = NULL;
@@ -1408,9 +2233,10 @@ RTIBool readPlatformFile(const char *filePath,
     char target[MAX_STRING_SIZE];
     char compiler[MAX_STRING_SIZE];
     RTIBool concatLines = RTI_FALSE;        /* Value spans multiple lines */
-    unsigned int lineCount = 0;
     char *origLine;
 
+    PlatformFileInfo_init(info);
+
     fp = fopen(filePath, "r");
     if (fp == NULL) {
         fprintf(stderr, "Platform file not found: %s\n", filePath);
@@ -1419,14 +2245,15 @@ RTIBool readPlatformFile(const char *filePath,
 
     for (;;) {
         if (!concatLines) {
-            free(line);
+            MEM_FREE(line);
             line = NULL;
             concatLines = RTI_FALSE;
         }
-        line = appendNextLine(fp, line, &lineCount);
+        line = appendNextLine(fp, line, info);
         if (!line) {
-            /* Out of memory */
-            return RTI_FALSE;
+            /* End of file, or out of memory */
+            ok = feof(fp) ? RTI_TRUE : RTI_FALSE;
+            goto done;
         }
 
         /* Skip empty lines */
@@ -1538,8 +2365,10 @@ RTIBool readPlatformFile(const char *filePath,
 
                 if (skipArch == RTI_TRUE) {
                     /* Drop skipped architectures */
+                    STATS_ADD(ArchSkipped, 1);
                     Architecture_delete(currentArch);
                 } else {
+                    STATS_ADD(ArchParsed, 1);
                     /* Valid, push the arch to the archDef */
                     REDAInlineList_addNodeToBackEA(archDef, 
                             &currentArch->parent);
@@ -1559,10 +2388,14 @@ RTIBool readPlatformFile(const char *filePath,
                 fprintf(stderr, "Out of memory allocating currentParam\n");
                 goto done;
             }
-            origLine = strdup(line);
+            origLine = MEM_STRDUP(ParseScratch, line);
+            if (origLine == NULL) {
+                fprintf(stderr, "Out of memory copying line\n");
+                goto done;
+            }
             plres = processKeyValuePairLine(line, currentParam);
             if (plres == ProcessLineResult_Error) {
-                free(origLine);
+                MEM_FREE(origLine);
                 goto done;
             }
             if (plres == ProcessLineResult_Continue) {
@@ -1571,11 +2404,13 @@ RTIBool readPlatformFile(const char *filePath,
                 //currentParam = NULL;
                 concatLines = RTI_TRUE;
                 memcpy(line, origLine, strlen(origLine)+1);
-                free(origLine);
+                MEM_FREE(origLine);
                 continue;
             }
 
             /* Got a valid line: */
+            MEM_FREE(origLine);
+            STATS_ADD(Params, 1);
             REDAInlineList_addNodeToBackEA(&currentArch->paramList, 
                     &currentParam->parent);
             currentParam = NULL;
@@ -1593,7 +2428,7 @@ done:
         fclose(fp);
     }
     if (line != NULL) {
-        free(line);
+        MEM_FREE(line);
     }
     if (currentArch != NULL) {
         Architecture_delete(currentArch);
@@ -1604,158 +2439,8610 @@ done:
     if (ok == RTI_FALSE) {
         fprintf(stderr, 
                 "Error occurred while parsing line %u\n", 
-                lineCount);
+                info->lineCount);
     }
     return ok;
 }
 /* }}} */
-/* {{{ usage
- * -----------------------------------------------------------------------------
+/***************************************************************************
+ * Compiler Launchers
+ **************************************************************************/
+/* With --launcher=MODE the compiler operations are prefixed by a compiler
+ * cache (ccache or sccache), and the compiler flags are made stable across
+ * installations to improve the hit rate:
+ *  - the NDDSHOME prefix is remapped (-ffile-prefix-map, or 
+ *    -fdebug-prefix-map for older compilers) so __FILE__ and the debug 
+ *    info do not depend on where Connext DDS is installed
+ *  - white spaces are normalized and duplicated -I and -D flags removed 
+ *    (keeping the first), so the same settings always produce the same
+ *    command line. The relative order of the flags is never changed, as 
+ *    it is significant for the include directories.
+ *
+ * The launcher is searched on the PATH only once per invocation.
  */
-void usage() {
-    printf("RTI Connext DDS Config version %s\n", 
-            APPLICATION_VERSION); 
-    printf("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
-    printf("Usage:\n");
-    printf("    %s -h|--help        Show this help\n", 
-            APPLICATION_NAME);
-    printf("    %s -V|--version     Prints version number\n", 
-            APPLICATION_NAME);
-    printf("    %s --list-all       List all platform architectures supported\n", 
-            APPLICATION_NAME);
-    printf("    %s --list-installed List the installed architectures\n",
-            APPLICATION_NAME);
-#ifndef NDEBUG
-    printf("    %s --dump-all       Dump all platforms and all settings (testing only)\n", 
-            APPLICATION_NAME);
-#endif
-    printf("    %s [modifiers] <what> [targetArch]\n", 
-            APPLICATION_NAME);
-    printf("\n");
-    /*      0        1         2         3         4         5         6         7         8 */
-    /*      12345678901234567890123456789012345678901234567890123456789012345678901234567890 */
-    printf("Where [modifiers] are:\n");
-    printf("    --static      use static linking against RTI Connext DDS\n");
-    printf("    --debug       use debug version of the RTI Connext DDS libraries\n");
-    printf("    --sh          use shell-like variable expansion (vs. make-like variables)\n");
-    printf("    --noexpand    do not expand environment variables in output\n");
-    printf("    --libmsg      include libraries for building request/reply apps\n");
-/*    printf("    --librs       include libraries for building Routing Service apps/plugins\n"); */
-/*    printf("    --libsecurity include libraries for building security applications\n"); */
-    printf("\n");
-    printf("Required argument <what> is one of:\n");
-    printf("  C API:\n");
-    printf("    --ccomp       output the C compiler to use\n");
-    printf("    --cflags      output all pre-processor and compiler flags\n");
-    printf("    --clink       output the C linker to use\n");
-    printf("    --ldflags     output the linker flags\n");
-    printf("    --ldlibs      output the required libraries\n");
-    printf("  Traditional C++ API:\n");
-    printf("    --cxxcomp     output the C++ compiler to use\n");
-    printf("    --cxxflags    output all pre-processor and compiler flags\n");
-    printf("    --cxxlink     output the C++ linker to use\n");
-    printf("    --ldxxflags   output the linker flags\n");
-    printf("    --ldxxlibs    output the required libraries\n");
-    printf("  Modern C++ API (C++-03):\n");
-    printf("    --cxx03comp   output the C++ compiler to use\n");
-    printf("    --cxx03flags  output all pre-processor and compiler flags\n");
-    printf("    --cxx03link   output the C++ linker to use\n");
-    printf("    --ldxx03flags output the linker flags\n");
-    printf("    --ldxx03libs  output the required libraries\n");
-    printf("  Modern C++ API (C++-11):\n");
-    printf("    --cxx11comp   output the C++ compiler to use\n");
-    printf("    --cxx11flags  output all pre-processor and compiler flags\n");
-    printf("    --cxx11link   output the C++ linker to use\n");
-    printf("    --ldxx11flags output the linker flags\n");
-    printf("    --ldxx11libs  output the required libraries\n");
-    printf("  Miscellaneous:\n");
-    printf("    --os          output the OS (i.e. UNIX, ANDROID, IOS, ...)\n");
-    printf("    --platform    output the Platform (i.e. i86, x64, armv7a, ...)\n");
-    printf("\n");
-    printf("Optional argument [targetArch] is one of the supported target architectures.\n");
-    printf("If not specified, uses environment variable NDDSARCH.\n");
-    printf("Use `--list-all` or `--list-installed` to print a list of architectures\n");
+#define LAUNCHER_PREFIX_MAP_DIR     "/NDDSHOME"
+
+static const struct {
+    const char  *name;          /* Name of the executable */
+    const char  *statsArg;      /* Argument to print the statistics */
+} LAUNCHERS[] = {
+    { "ccache",     "--show-stats" },
+    { "sccache",    "--show-stats" },
+    { NULL,         NULL }
+};
+
+/* The family of a compiler, see getCompilerFamily */
+typedef enum {
+    CompilerFamily_Other = 0,
+    CompilerFamily_Gcc,
+    CompilerFamily_Clang
+} CompilerFamily;
+
+/* Result of the PATH lookup of each launcher (empty string if not found) */
+#define LAUNCHER_COUNT              (sizeof(LAUNCHERS)/sizeof(*LAUNCHERS))
+static RTIBool theLauncherLookedUp[LAUNCHER_COUNT];
+static char theLauncherPaths[LAUNCHER_COUNT][PATH_MAX+1];
+
+/* {{{ isValidLauncherMode
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns RTI_TRUE if the given value of --launcher is valid: auto, none or
+ * the name of one of the LAUNCHERS.
+ */
+static RTIBool isValidLauncherMode(const char *mode) {
+    int i;
+    if ((strcmp(mode, "auto") == 0) || (strcmp(mode, "none") == 0)) {
+        return RTI_TRUE;
+    }
+    for (i = 0; LAUNCHERS[i].name != NULL; ++i) {
+        if (strcmp(LAUNCHERS[i].name, mode) == 0) {
+            return RTI_TRUE;
+        }
+    }
+    return RTI_FALSE;
 }
 
 /* }}} */
-/* {{{ main
- * -----------------------------------------------------------------------------
+/* {{{ findExecutable
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Searches an executable on the PATH, the same way execvp does. A name 
+ * containing a '/' is not searched.
+ *
+ * \param name      the name of the executable
+ * \param pathOut   receives the path of the executable
+ * \param pathSize  the size of pathOut
+ * \return          RTI_TRUE if found, RTI_FALSE otherwise
  */
-int main(int argc, char **argv) {
-    const char *argOp = NULL;
-    const char *argTarget = NULL;
-    RTIBool argStatic = RTI_FALSE;
-    RTIBool argDebug = RTI_FALSE;
-    RTIBool argShell = RTI_FALSE;
-    RTIBool argExpandEnvVar = RTI_TRUE;
-    RTIBool argMsg = RTI_FALSE;
-    /*
-    RTIBool argRs = RTI_FALSE;
-    RTIBool argSec = RTI_FALSE;
-    */
-    char *NDDSHOME = NULL;
-    char *platformFile = NULL;
-    int retCode = APPLICATION_EXIT_UNKNOWN;
-    struct REDAInlineList *archDef = NULL;
-    struct Architecture *archTarget;
-    char *nddsExtraLib = NULL;
-    char *nddsExtraLibCPP = NULL;
-    char *nddsExtraLibCPP03 = NULL;
-    char *nddsFlags = NULL;
-    char *nddsCPP03Flags = NULL;
-    char *nddsCLibs = NULL;
-    char *nddsCPPLibs = NULL;
-    char *nddsCPP03Libs = NULL;
-    const char *libSuffix;
-
-    if (argc <= 1) {
-        usage();
-        retCode = APPLICATION_EXIT_INVALID_ARGS;
-        goto done;
+static RTIBool findExecutable(const char *name, char *pathOut, size_t pathSize) {
+    const char *path;
+    const char *dir;
+    const char *end;
+
+    if (strchr(name, '/') != NULL) {
+        return (access(name, X_OK) == 0) && 
+                (snprintf(pathOut, pathSize, "%s", name) < (int)pathSize);
     }
-    if ((argc == 2) && ((strcmp(argv[1], "-h") == 0) ||
-                (strcmp(argv[1], "--help") == 0) )) {
-        usage();
-        retCode = APPLICATION_EXIT_SUCCESS;
-        goto done;
+    path = getenv("PATH");
+    for (dir = path; (dir != NULL) && (*dir != '\0'); dir = end) {
+        size_t len;
+        end = strchr(dir, ':');
+        len = (end != NULL) ? (size_t)(end - dir) : strlen(dir);
+        if (end != NULL) {
+            ++end;
+        }
+        /* An empty entry is the current directory */
+        if (snprintf(pathOut, pathSize, "%.*s/%s", 
+                    (int)len, 
+                    (len > 0) ? dir : ".", 
+                    name) >= (int)pathSize) {
+            continue;
+        }
+        if (access(pathOut, X_OK) == 0) {
+            return RTI_TRUE;
+        }
     }
-    if ((argc == 2) && ((strcmp(argv[1], "-V") == 0) ||
-                (strcmp(argv[1], "--version") == 0))) {
-        printf("%s v.%s\n", APPLICATION_NAME, APPLICATION_VERSION);
-        retCode = APPLICATION_EXIT_SUCCESS;
-        goto done;
+    return RTI_FALSE;
+}
+
+/* }}} */
+/* {{{ findLauncher
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Searches the executable of the launcher with the given index on the 
+ * PATH. The result is remembered for the following calls.
+ *
+ * \return          the path of the launcher as found in PATH, or NULL if 
+ *                  not found
+ */
+static const char * findLauncher(int idx) {
+    if (!theLauncherLookedUp[idx]) {
+        theLauncherLookedUp[idx] = RTI_TRUE;
+        if (!findExecutable(LAUNCHERS[idx].name, 
+                    theLauncherPaths[idx], 
+                    sizeof(theLauncherPaths[idx]))) {
+            theLauncherPaths[idx][0] = '\0';
+        }
     }
-    if ((argc == 2) && (
-#ifndef NDEBUG
-                (strcmp(argv[1], "--dump-all") == 0) ||
-#endif
-                (strcmp(argv[1], "--list-installed") == 0) ||
-                (strcmp(argv[1], "--list-all") == 0))) {
-        argOp = argv[1];
+    return (theLauncherPaths[idx][0] != '\0') ? theLauncherPaths[idx] : NULL;
+}
 
-    } else {
-        int i;
+/* }}} */
+/* {{{ resolveLauncher
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Resolves the value of --launcher into the launcher to use.
+ *
+ * \param mode      auto, none or the name of one of the LAUNCHERS
+ * \param pathOut   receives the path of the launcher or NULL if no 
+ *                  launcher is used
+ * \param idxOut    receives the index in LAUNCHERS of the launcher (if not
+ *                  NULL)
+ * \return          RTI_TRUE if success, RTI_FALSE if an explicitly 
+ *                  requested launcher cannot be found on the PATH. With 
+ *                  auto, no launcher is used if none is found.
+ */
+static RTIBool resolveLauncher(const char *mode, const char **pathOut, int *idxOut) {
+    int i;
 
-        /* Parse command line with at least 1 arguments */
-        if (argc < 2) {
-            usage();
-            retCode = APPLICATION_EXIT_INVALID_ARGS;
-            goto done;
+    *pathOut = NULL;
+    if (strcmp(mode, "none") == 0) {
+        return RTI_TRUE;
+    }
+    for (i = 0; LAUNCHERS[i].name != NULL; ++i) {
+        if ((strcmp(mode, "auto") != 0) && (strcmp(mode, LAUNCHERS[i].name) != 0)) {
+            continue;
         }
-
-        for (i = 1; i < argc; ++i) {
-            if ((strcmp(argv[i], "--static") == 0)) {
-                argStatic = RTI_TRUE;
-                continue;
-            }
-            if ((strcmp(argv[i], "--debug") == 0)) {
-                argDebug = RTI_TRUE;
-                continue;
-            }
-            if ((strcmp(argv[i], "--shell") == 0) || 
-                    (strcmp(argv[i], "--sh") == 0)) {
-                argShell = RTI_TRUE;
-                continue;
+        *pathOut = findLauncher(i);
+        if (*pathOut != NULL) {
+            if (idxOut != NULL) {
+                *idxOut = i;
+            }
+            return RTI_TRUE;
+        }
+        if (strcmp(mode, "auto") != 0) {
+            fprintf(stderr, "Error: compiler launcher '%s' not found in PATH\n", mode);
+            return RTI_FALSE;
+        }
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ getToolsetVersion
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the major version of the given toolset (i.e. "gcc") from the name
+ * of the target (i.e. 7 for armv8Linux4gcc7.3.0), or -1 if the target 
+ * is not built with that toolset.
+ */
+static int getToolsetVersion(const char *target, const char *toolset) {
+    const char *ptr = target;
+    size_t len = strlen(toolset);
+
+    while ((ptr = strstr(ptr, toolset)) != NULL) {
+        ptr += len;
+        if (isdigit((unsigned char)*ptr)) {
+            return atoi(ptr);
+        }
+    }
+    return -1;
+}
+
+/* }}} */
+/* {{{ getCompilerFamily
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Identifies the family of a compiler from the name of its executable 
+ * (the first word of the composed compiler, i.e. "arm-linux-g++").
+ *
+ * \param compiler  the composed compiler (i.e. the output of --cxxcomp)
+ * \param target    the name of the target, used to get the version
+ * \param versionOut receives the major version of the toolset of the 
+ *                  target, or -1 if the target name does not tell it
+ * \return          the CompilerFamily
+ */
+static CompilerFamily getCompilerFamily(const char *compiler, 
+        const char *target,
+        int *versionOut) {
+    char name[MAX_STRING_SIZE];
+    const char *start = compiler;
+    const char *end;
+    const char *base;
+
+    while (isspace((unsigned char)*start)) {
+        ++start;
+    }
+    end = start + strcspn(start, " \t");
+    snprintf(name, sizeof(name), "%.*s", (int)(end - start), start);
+    base = strrchr(name, '/');
+    base = (base != NULL) ? base+1 : name;
+
+    if (strstr(base, "clang") != NULL) {
+        *versionOut = getToolsetVersion(target, "clang");
+        return CompilerFamily_Clang;
+    }
+    if ((strstr(base, "g++") != NULL) || (strstr(base, "gcc") != NULL) ||
+            (strcmp(base, "c++") == 0) || (strcmp(base, "cc") == 0)) {
+        *versionOut = getToolsetVersion(target, "gcc");
+        return CompilerFamily_Gcc;
+    }
+    *versionOut = -1;
+    return CompilerFamily_Other;
+}
+
+/* }}} */
+/* {{{ hashStrings
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the 64-bit FNV-1a hash of the given strings (terminators 
+ * included, so the boundaries between the strings are significant).
+ */
+static unsigned long long hashStrings(const char * const *strings, int count) {
+    unsigned long long hash = FNV1A64_OFFSET_BASIS;
+    const char *ptr;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        for (ptr = strings[i]; ; ++ptr) {
+            hash ^= (unsigned char)*ptr;
+            hash *= FNV1A64_PRIME;
+            if (*ptr == '\0') {
+                break;
+            }
+        }
+    }
+    return hash;
+}
+
+/* }}} */
+/* {{{ getPrefixMapOption
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the option used to remap a path prefix supported by the compiler
+ * of the target: -ffile-prefix-map (gcc 8, clang 10 and later) also covers
+ * __FILE__, -fdebug-prefix-map (older gcc and clang) only the debug 
+ * information. Returns NULL for the other toolsets.
+ */
+static const char * getPrefixMapOption(const char *target) {
+    int gccVersion = getToolsetVersion(target, "gcc");
+    int clangVersion = getToolsetVersion(target, "clang");
+
+    if ((gccVersion >= 8) || (clangVersion >= 10)) {
+        return "-ffile-prefix-map";
+    }
+    if ((gccVersion != -1) || (clangVersion != -1)) {
+        return "-fdebug-prefix-map";
+    }
+    return NULL;
+}
+
+/* }}} */
+/* {{{ normalizeLauncherFlags
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Normalizes in place composed compiler flags: words are separated by a 
+ * single space and the repeated -I and -D flags are removed. Quoted 
+ * strings are never split.
+ */
+static void normalizeLauncherFlags(char *flags) {
+    char *rd = flags;
+    char *wr = flags;
+
+    for (;;) {
+        char *word;
+        char *prev;
+        char quote = '\0';
+        size_t len;
+        RTIBool duplicate = RTI_FALSE;
+
+        while (isspace((unsigned char)*rd)) {
+            ++rd;
+        }
+        if (*rd == '\0') {
+            break;
+        }
+        word = rd;
+        for (; *rd != '\0'; ++rd) {
+            if ((quote == '\0') && isspace((unsigned char)*rd)) {
+                break;
+            }
+            if (*rd == quote) {
+                quote = '\0';
+            } else if ((quote == '\0') && ((*rd == '\'') || (*rd == '"'))) {
+                quote = *rd;
+            }
+        }
+        len = (size_t)(rd - word);
+
+        /* Look for the same -I or -D among the words already written */
+        if ((len > 2) && (word[0] == '-') && ((word[1] == 'I') || (word[1] == 'D'))) {
+            for (prev = flags; prev < wr; ) {
+                size_t prevLen = 0;
+                while ((prev + prevLen < wr) && (prev[prevLen] != ' ')) {
+                    ++prevLen;
+                }
+                if ((prevLen == len) && (memcmp(prev, word, len) == 0)) {
+                    duplicate = RTI_TRUE;
+                    break;
+                }
+                prev += prevLen + 1;
+            }
+        }
+        if (!duplicate) {
+            if (wr != flags) {
+                *wr++ = ' ';
+            }
+            memmove(wr, word, len);
+            wr += len;
+        }
+    }
+    *wr = '\0';
+}
+
+/* }}} */
+/* {{{ launcherStats
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Runs the launcher selected by the given mode to print its statistics 
+ * (hits, misses, cache size) to stdout. These are the global counters of
+ * the cache: neither ccache nor sccache keeps them per target.
+ *
+ * \return          the exit code of the application
+ */
+static int launcherStats(const char *mode) {
+    const char *path;
+    char pathArg[PATH_MAX+1];
+    char statsArg[MAX_STRING_SIZE];
+    char *args[3];
+    int idx = -1;
+    int status;
+    pid_t pid;
+
+    if (!resolveLauncher(mode, &path, &idx)) {
+        return APPLICATION_EXIT_FAILURE;
+    }
+    if (path == NULL) {
+        fprintf(stderr, "Error: no compiler launcher found in PATH\n");
+        return APPLICATION_EXIT_FAILURE;
+    }
+    printf("Launcher: %s\n", path);
+    fflush(stdout);
+
+    snprintf(pathArg, sizeof(pathArg), "%s", path);
+    snprintf(statsArg, sizeof(statsArg), "%s", LAUNCHERS[idx].statsArg);
+    args[0] = pathArg;
+    args[1] = statsArg;
+    args[2] = NULL;
+    pid = fork();
+    if (pid == -1) {
+        fprintf(stderr, "Error: fork failed: %s\n", strerror(errno));
+        return APPLICATION_EXIT_FAILURE;
+    }
+    if (pid == 0) {
+        execv(path, args);
+        fprintf(stderr, "Error: failed to execute '%s': %s\n", path, strerror(errno));
+        _exit(APPLICATION_EXIT_FAILURE);
+    }
+    if ((waitpid(pid, &status, 0) == -1) || 
+            !WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+        return APPLICATION_EXIT_FAILURE;
+    }
+    return APPLICATION_EXIT_SUCCESS;
+}
+
+/* }}} */
+/***************************************************************************
+ * Composition of the operations
+ **************************************************************************/
+/* Defines the NDDS-related flags and libraries that are composed together
+ * with the properties of the target architecture to build the output of
+ * the operations.
+ *
+ * The content depends on the modifiers (--static, --debug, --libmsg,
+ * --noexpand, --sh) and on the target, so the same context can be re-used
+ * for multiple operations of the same target.
+ */
+
+/* Options added to the operations by the modifiers that change how the
+ * toolchain builds the application (i.e. --profile), see 
+ * ComposeContext_addFlags
+ */
+struct ToolchainFlags {
+    char                        cflags[MAX_STRING_SIZE+PATH_MAX];  /* All APIs */
+    char                        ldflags[MAX_STRING_SIZE+PATH_MAX];
+    char                        ldlibs[MAX_STRING_SIZE];
+    /* Archiver and symbol lister, with the variables not expanded as in
+     * the platform file ($(VAR)). Empty for the default ones.
+     */
+    char                        ar[MAX_STRING_SIZE];
+    char                        nm[MAX_STRING_SIZE];
+};
+
+struct ComposeContext {
+    const char                  *NDDSHOME;
+    RTIBool                     expandEnvVar;
+    RTIBool                     shell;
+    const char                  *libSuffix;
+    char                        nddsFlags[MAX_CMDLINEARG_SIZE+1];
+    char                        nddsCPP03Flags[MAX_CMDLINEARG_SIZE+1];
+    char                        nddsCLibs[MAX_CMDLINEARG_SIZE+1];
+    char                        nddsCPPLibs[MAX_CMDLINEARG_SIZE+1];
+    char                        nddsCPP03Libs[MAX_CMDLINEARG_SIZE+1];
+    const char                  *launcher;      /* NULL if none */
+    char                        launcherFlags[MAX_STRING_SIZE+PATH_MAX];
+    struct ToolchainFlags       extra;
+};
+
+/* {{{ getLibSuffix
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the suffix of the RTI Connext DDS libraries for the given 
+ * combination of static and debug modifiers.
+ */
+const char * getLibSuffix(RTIBool isStatic, RTIBool isDebug) {
+    if ((isStatic == RTI_TRUE) && (isDebug == RTI_FALSE)) {
+        return "z";
+    }
+    if ((isStatic == RTI_FALSE) && (isDebug == RTI_TRUE)) {
+        return "d";
+    }
+    if ((isStatic == RTI_TRUE) && (isDebug == RTI_TRUE)) {
+        return "zd";
+    }
+    return "";
+}
+
+/* }}} */
+/* {{{ ComposeContext_init
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Compose the NDDS-related includes and libraries for the given target
+ * and modifiers.
+ *
+ * \param me            the ComposeContext to initialize
+ * \param NDDSHOME      the NDDSHOME directory (used when expanding variables)
+ * \param target        the name of the target architecture
+ * \param isStatic      RTI_TRUE to link against the static libraries
+ * \param isDebug       RTI_TRUE to link against the debug libraries
+ * \param libMsg        RTI_TRUE to include the request/reply libraries
+ * \param expandEnvVar  RTI_TRUE to expand the environment variables
+ * \param shell         RTI_TRUE to use shell-style variables (${...}) when
+ *                      variables are not expanded
+ */
+void ComposeContext_init(struct ComposeContext *me,
+        const char *NDDSHOME,
+        const char *target,
+        RTIBool isStatic,
+        RTIBool isDebug,
+        RTIBool libMsg,
+        RTIBool expandEnvVar,
+        RTIBool shell) {
+    char nddsExtraLib[MAX_STRING_SIZE];
+    char nddsExtraLibCPP[MAX_STRING_SIZE];
+    char nddsExtraLibCPP03[MAX_STRING_SIZE];
+    const char *libSuffix = getLibSuffix(isStatic, isDebug);
+    const char *home = NDDSHOME;
+
+    me->NDDSHOME = NDDSHOME;
+    me->expandEnvVar = expandEnvVar;
+    me->shell = shell;
+    me->libSuffix = libSuffix;
+    me->launcher = NULL;
+    me->launcherFlags[0] = '\0';
+    memset(&me->extra, 0, sizeof(me->extra));
+
+    if (libMsg == RTI_TRUE) {
+        snprintf(nddsExtraLib,
+                MAX_STRING_SIZE,
+                "-lrticonnextmsgc%s ",
+                libSuffix);
+        snprintf(nddsExtraLibCPP,
+                MAX_STRING_SIZE,
+                "-lrticonnextmsgcpp%s ",
+                libSuffix);
+        snprintf(nddsExtraLibCPP03,
+                MAX_STRING_SIZE,
+                "-lrticonnextmsgcpp2%s ",
+                libSuffix);
+    } else {
+        nddsExtraLib[0] = '\0';
+        nddsExtraLibCPP[0] = '\0';
+        nddsExtraLibCPP03[0] = '\0';
+    }
+
+    if (expandEnvVar == RTI_FALSE) {
+        /* Do not expand variables, use shell or makefile style */
+        home = (shell == RTI_TRUE) ? "${NDDSHOME}" : "$(NDDSHOME)";
+    }
+    snprintf(me->nddsFlags,
+            MAX_CMDLINEARG_SIZE,
+            "-I%s/include -I%s/include/ndds",
+            home,
+            home);
+    snprintf(me->nddsCPP03Flags,
+            MAX_CMDLINEARG_SIZE,
+            ((expandEnvVar == RTI_FALSE) && (shell == RTI_FALSE)) ?
+                "-I%s/include -I%s/include/ndds, -I%s/include/ndds/hpp" :
+                "-I%s/include -I%s/include/ndds -I%s/include/ndds/hpp",
+            home,
+            home,
+            home);
+    snprintf(me->nddsCLibs,
+            MAX_CMDLINEARG_SIZE,
+            "-L%s/lib/%s %s-lnddsc%s -lnddscore%s",
+            home,
+            target,
+            nddsExtraLib,
+            libSuffix,
+            libSuffix);
+    snprintf(me->nddsCPPLibs,
+            MAX_CMDLINEARG_SIZE,
+            "-L%s/lib/%s %s-lnddscpp%s -lnddsc%s -lnddscore%s",
+            home,
+            target,
+            nddsExtraLibCPP,
+            libSuffix,
+            libSuffix,
+            libSuffix);
+    snprintf(me->nddsCPP03Libs,
+            MAX_CMDLINEARG_SIZE,
+            "-L%s/lib/%s %s-lnddscpp2%s -lnddsc%s -lnddscore%s",
+            home,
+            target,
+            nddsExtraLibCPP03,
+            libSuffix,
+            libSuffix,
+            libSuffix);
+}
+
+/* }}} */
+/* {{{ ComposeContext_setLauncher
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Sets the compiler launcher (see resolveLauncher) that prefixes the 
+ * compiler operations, and the flags that make the compiler flags stable
+ * for the launcher cache.
+ *
+ * \param me            the ComposeContext, already initialized
+ * \param target        the name of the target architecture
+ * \param launcher      the path of the launcher, or NULL for none
+ */
+void ComposeContext_setLauncher(struct ComposeContext *me,
+        const char *target,
+        const char *launcher) {
+    const char *option = getPrefixMapOption(target);
+    const char *home = me->NDDSHOME;
+
+    me->launcher = launcher;
+    me->launcherFlags[0] = '\0';
+    if ((launcher == NULL) || (option == NULL)) {
+        return;
+    }
+    if (me->expandEnvVar == RTI_FALSE) {
+        home = (me->shell == RTI_TRUE) ? "${NDDSHOME}" : "$(NDDSHOME)";
+    }
+    snprintf(me->launcherFlags,
+            sizeof(me->launcherFlags),
+            "%s=%s=%s",
+            option,
+            home,
+            LAUNCHER_PREFIX_MAP_DIR);
+}
+
+/* }}} */
+/* {{{ appendFlags
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Appends the given flags to a string of flags, separated by a space.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if the result does not 
+ *                  fit in buf
+ */
+static RTIBool appendFlags(char *buf, size_t bufSize, const char *flags) {
+    size_t len = strlen(buf);
+
+    if (flags[0] == '\0') {
+        return RTI_TRUE;
+    }
+    return snprintf(buf + len, 
+            bufSize - len, 
+            "%s%s", 
+            (len > 0) ? " " : "", 
+            flags) < (int)(bufSize - len);
+}
+
+/* }}} */
+/* {{{ ToolchainFlags_add
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Appends the options of other to the ones of me. The archiver and the 
+ * symbol lister of other (if not empty) replace the ones of me.
+ *
+ * \return              RTI_TRUE if success, RTI_FALSE if the options are
+ *                      too long
+ */
+RTIBool ToolchainFlags_add(struct ToolchainFlags *me,
+        const struct ToolchainFlags *other) {
+    if (!appendFlags(me->cflags, sizeof(me->cflags), other->cflags) ||
+            !appendFlags(me->ldflags, sizeof(me->ldflags), other->ldflags) ||
+            !appendFlags(me->ldlibs, sizeof(me->ldlibs), other->ldlibs)) {
+        fprintf(stderr, "Error: too many toolchain options\n");
+        return RTI_FALSE;
+    }
+    if (other->ar[0] != '\0') {
+        strcpy(me->ar, other->ar);
+    }
+    if (other->nm[0] != '\0') {
+        strcpy(me->nm, other->nm);
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ ComposeContext_addFlags
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Adds the given options to the compiler flags, linker flags and libraries
+ * operations of all the APIs (see ToolchainFlags_add).
+ *
+ * \param me            the ComposeContext, already initialized
+ * \param flags         the options to add, NULL for none
+ * \return              RTI_TRUE if success, RTI_FALSE if the options are
+ *                      too long
+ */
+RTIBool ComposeContext_addFlags(struct ComposeContext *me,
+        const struct ToolchainFlags *flags) {
+    return (flags == NULL) || ToolchainFlags_add(&me->extra, flags);
+}
+
+/* }}} */
+/* {{{ composeBaseOperation
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes the output of the given operation (one of VALID_WHAT) for the
+ * given architecture, without the compiler launcher.
+ *
+ * \param arch      pointer to the target Architecture
+ * \param op        the operation (i.e. "--cflags")
+ * \param ctx       the composition context built for the same target
+ * \param bufOut    a pointer to the string buffer where to write the result
+ * \param bufSize   the size of bufOut
+ * \return          ComposeResult_Ok if success, ComposeResult_NotDefined if
+ *                  the property is not defined, ComposeResult_Unsupported
+ *                  if the target does not support the API of the operation
+ *                  (no error is printed), ComposeResult_Error if failed.
+ */
+static ComposeResult composeBaseOperation(struct Architecture *arch,
+        const char *op,
+        const struct ComposeContext *ctx,
+        char *bufOut,
+        int bufSize) {
+    bufOut[0] = '\0';
+
+    /* The Modern C++ operations are available only on some targets */
+    if ((strncmp(op, "--cxx03", 7) == 0) || (strncmp(op, "--ldxx03", 8) == 0)) {
+        if (!getBooleanProperty(arch, "$SUPPORTS_CPP03")) {
+            return ComposeResult_Unsupported;
+        }
+    }
+    if ((strncmp(op, "--cxx11", 7) == 0) || (strncmp(op, "--ldxx11", 8) == 0)) {
+        if (!getBooleanProperty(arch, "$SUPPORTS_CPP11")) {
+            return ComposeResult_Unsupported;
+        }
+    }
+
+    /******************* C API ***************************/
+    if ((strcmp(op, "--ccomp") == 0)) {
+        return composeStringProperty(arch, 
+                "$C_COMPILER", 
+                ctx->expandEnvVar,
+                bufOut,
+                bufSize);
+
+    } else if ((strcmp(op, "--cflags") == 0)) {
+        const char *FLAGS[] = {
+            "$C_COMPILER_FLAGS",
+            "$DEFINES",
+            "$INCLUDES",
+            ctx->nddsFlags,
+            NULL
+        };
+        return composeCompositeFlagsProperties(arch,
+                FLAGS,
+                ctx->expandEnvVar,
+                ctx->shell,
+                bufOut,
+                bufSize);
+
+    } else if ((strcmp(op, "--clink") == 0)) {
+        return composeStringProperty(arch,
+                "$C_LINKER",
+                ctx->expandEnvVar,
+                bufOut,
+                bufSize);
+
+    } else if ((strcmp(op, "--ldflags") == 0)) {
+        const char *FLAGS[] = {
+            "$C_LINKER_FLAGS",
+            NULL
+        };
+        return composeCompositeFlagsProperties(arch,
+                FLAGS,
+                ctx->expandEnvVar,
+                ctx->shell,
+                bufOut,
+                bufSize);
+
+    } else if ((strcmp(op, "--ldlibs") == 0)) {
+        const char *FLAGS[] = {
+            ctx->nddsCLibs,
+            "$SYSLIBS",
+            "$C_SYSLIBS",
+            NULL
+        };
+        return composeCompositeFlagsProperties(arch,
+                FLAGS,
+                ctx->expandEnvVar,
+                ctx->shell,
+                bufOut,
+                bufSize);
+
+
+    /*************** Traditional C++ API *****************/
+    
+    } else if ((strcmp(op, "--cxxcomp") == 0) ||
+            (strcmp(op, "--cxx03comp") == 0) ||
+            (strcmp(op, "--cxx11comp") == 0)) {
+        return composeStringProperty(arch,
+                "$CXX_COMPILER",
+                ctx->expandEnvVar,
+                bufOut,
+                bufSize);
+
+    } else if ((strcmp(op, "--cxxflags") == 0)) {
+        const char *FLAGS[] = {
+            "$CXX_COMPILER_FLAGS",
+            "$DEFINES",
+            "$INCLUDES",
+            ctx->nddsFlags,
+            NULL
+        };
+        return composeCompositeFlagsProperties(arch,
+                FLAGS,
+                ctx->expandEnvVar,
+                ctx->shell,
+                bufOut,
+                bufSize);
+
+    } else if ((strcmp(op, "--cxxlink") == 0) ||
+            (strcmp(op, "--cxx03link") == 0) ||
+            (strcmp(op, "--cxx11link") == 0)) {
+        return composeStringProperty(arch,
+                "$CXX_LINKER",
+                ctx->expandEnvVar,
+                bufOut,
+                bufSize);
+
+    } else if ((strcmp(op, "--ldxxflags") == 0) ||
+            (strcmp(op, "--ldxx03flags") == 0) ||
+            (strcmp(op, "--ldxx11flags") == 0)) {
+        const char *FLAGS[] = {
+            "$CXX_LINKER_FLAGS",
+            NULL
+        };
+        return composeCompositeFlagsProperties(arch,
+                FLAGS,
+                ctx->expandEnvVar,
+                ctx->shell,
+                bufOut,
+                bufSize);
+
+    } else if ((strcmp(op, "--ldxxlibs") == 0)) {
+        const char *FLAGS[] = {
+            ctx->nddsCPPLibs,
+            "$SYSLIBS",
+            "$CXX_SYSLIBS",
+            NULL
+        };
+        return composeCompositeFlagsProperties(arch,
+                FLAGS,
+                ctx->expandEnvVar,
+                ctx->shell,
+                bufOut,
+                bufSize);
+
+
+    /***************** Modern C++ API *******************/
+
+    } else if ((strcmp(op, "--cxx03flags") == 0)) {
+        const char *FLAGS[] = {
+            "$CXX_COMPILER_FLAGS",
+            "$CPP03_COMPILER_FLAGS",
+            "$DEFINES",
+            "$INCLUDES",
+            ctx->nddsCPP03Flags,
+            NULL
+        };
+        return composeCompositeFlagsProperties(arch,
+                FLAGS,
+                ctx->expandEnvVar,
+                ctx->shell,
+                bufOut,
+                bufSize);
+
+    } else if ((strcmp(op, "--ldxx03libs") == 0) ||
+            (strcmp(op, "--ldxx11libs") == 0)) {
+        const char *FLAGS[] = {
+            ctx->nddsCPP03Libs,
+            "$SYSLIBS",
+            "$CXX_SYSLIBS",
+            NULL
+        };
+        return composeCompositeFlagsProperties(arch,
+                FLAGS,
+                ctx->expandEnvVar,
+                ctx->shell,
+                bufOut,
+                bufSize);
+
+
+    /************ Ultra Modern C++ API *****************/
+
+    } else if ((strcmp(op, "--cxx11flags") == 0)) {
+        const char *FLAGS[] = {
+            "$CXX_COMPILER_FLAGS",
+            "$CPP11_COMPILER_FLAGS",
+            "$DEFINES",
+            "$INCLUDES",
+            ctx->nddsCPP03Flags,     // Use same as CPP03 flags
+            NULL
+        };
+        return composeCompositeFlagsProperties(arch,
+                FLAGS,
+                ctx->expandEnvVar,
+                ctx->shell,
+                bufOut,
+                bufSize);
+
+
+    /****************** Miscellaneous *******************/
+
+    } else if ((strcmp(op, "--os") == 0)) {
+        return composeStringProperty(arch,
+                "$OS",
+                ctx->expandEnvVar,
+                bufOut,
+                bufSize);
+
+    } else if ((strcmp(op, "--platform") == 0)) {
+        return composeStringProperty(arch,
+                "$PLATFORM",
+                ctx->expandEnvVar,
+                bufOut,
+                bufSize);
+    }
+
+    fprintf(stderr, "Error: invalid operation: %s\n", op);
+    return ComposeResult_Error;
+}
+
+/* }}} */
+/* {{{ composeOperation
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes the output of the given operation (one of VALID_WHAT) for the
+ * given architecture, followed by the toolchain options of the context 
+ * (see ComposeContext_addFlags). If the context has a compiler launcher, 
+ * the compiler operations are prefixed by the launcher and the compiler 
+ * flags are normalized for the launcher cache.
+ *
+ * \param arch      pointer to the target Architecture
+ * \param op        the operation (i.e. "--cflags")
+ * \param ctx       the composition context built for the same target
+ * \param bufOut    a pointer to the string buffer where to write the result
+ * \param bufSize   the size of bufOut
+ * \return          ComposeResult_Ok if success, ComposeResult_NotDefined if
+ *                  the property is not defined, ComposeResult_Unsupported
+ *                  if the target does not support the API of the operation
+ *                  (no error is printed), ComposeResult_Error if failed.
+ */
+ComposeResult composeOperation(struct Architecture *arch,
+        const char *op,
+        const struct ComposeContext *ctx,
+        char *bufOut,
+        int bufSize) {
+    ComposeResult rc = composeBaseOperation(arch, op, ctx, bufOut, bufSize);
+    const char *extra = NULL;
+    int len;
+    int i;
+
+    for (i = 0; (extra == NULL) && (API_OPERATIONS[i].name != NULL); ++i) {
+        if (strcmp(op, API_OPERATIONS[i].flags) == 0) {
+            extra = ctx->extra.cflags;
+        } else if (strcmp(op, API_OPERATIONS[i].ldflags) == 0) {
+            extra = ctx->extra.ldflags;
+        } else if (strcmp(op, API_OPERATIONS[i].ldlibs) == 0) {
+            extra = ctx->extra.ldlibs;
+        }
+    }
+    if ((extra != NULL) && (extra[0] != '\0')) {
+        /* The options are added even if the property is not defined */
+        if (rc == ComposeResult_NotDefined) {
+            bufOut[0] = '\0';
+            rc = ComposeResult_Ok;
+        }
+        if ((rc == ComposeResult_Ok) && !appendFlags(bufOut, (size_t)bufSize, extra)) {
+            goto tooLong;
+        }
+    }
+    if ((rc != ComposeResult_Ok) || (ctx->launcher == NULL)) {
+        return rc;
+    }
+    len = (int)strlen(bufOut);
+    for (i = 0; API_OPERATIONS[i].name != NULL; ++i) {
+        if (strcmp(op, API_OPERATIONS[i].comp) == 0) {
+            int prefixLen = (int)strlen(ctx->launcher) + 1;
+            if (len + prefixLen >= bufSize) {
+                goto tooLong;
+            }
+            memmove(bufOut + prefixLen, bufOut, (size_t)(len + 1));
+            memcpy(bufOut, ctx->launcher, (size_t)(prefixLen - 1));
+            bufOut[prefixLen - 1] = ' ';
+            break;
+        }
+        if (strcmp(op, API_OPERATIONS[i].flags) == 0) {
+            if (snprintf(bufOut + len, 
+                        (size_t)(bufSize - len), 
+                        " %s", 
+                        ctx->launcherFlags) >= bufSize - len) {
+                goto tooLong;
+            }
+            normalizeLauncherFlags(bufOut);
+            break;
+        }
+    }
+    return ComposeResult_Ok;
+
+tooLong:
+    fprintf(stderr,
+            "Composed %s too long for target %s\n",
+            op,
+            arch->target);
+    return ComposeResult_Error;
+}
+
+/* }}} */
+/* {{{ ApiSettings
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * The complete set of build settings of one API (one entry of 
+ * API_OPERATIONS) for a target, as composed by composeApiSettings.
+ */
+struct ApiSettings {
+    char                        comp[MAX_CMDLINEARG_SIZE+1];
+    char                        flags[MAX_CMDLINEARG_SIZE+1];
+    char                        link[MAX_CMDLINEARG_SIZE+1];
+    char                        ldflags[MAX_CMDLINEARG_SIZE+1];
+    char                        ldlibs[MAX_CMDLINEARG_SIZE+1];
+};
+
+/* }}} */
+/* {{{ composeApiSettings
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes all the settings (compiler, flags, linker, linker flags and 
+ * libraries) of the given API for a target.
+ * Properties not defined for the target result in empty strings.
+ *
+ * \param arch      pointer to the target Architecture
+ * \param apiIdx    the index of the API in API_OPERATIONS
+ * \param ctx       the composition context built for the same target
+ * \param settings  pointer to the object that receives the settings
+ * \return          ComposeResult_Ok if success, ComposeResult_Unsupported
+ *                  if the target does not support the API, 
+ *                  ComposeResult_Error if failed.
+ */
+ComposeResult composeApiSettings(struct Architecture *arch,
+        int apiIdx,
+        const struct ComposeContext *ctx,
+        struct ApiSettings *settings) {
+    const char *ops[5];
+    char *out[5];
+    int i;
+
+    ops[0] = API_OPERATIONS[apiIdx].comp;       out[0] = settings->comp;
+    ops[1] = API_OPERATIONS[apiIdx].flags;      out[1] = settings->flags;
+    ops[2] = API_OPERATIONS[apiIdx].link;       out[2] = settings->link;
+    ops[3] = API_OPERATIONS[apiIdx].ldflags;    out[3] = settings->ldflags;
+    ops[4] = API_OPERATIONS[apiIdx].ldlibs;     out[4] = settings->ldlibs;
+
+    for (i = 0; i < 5; ++i) {
+        ComposeResult rc = composeOperation(arch, 
+                ops[i], 
+                ctx, 
+                out[i], 
+                MAX_CMDLINEARG_SIZE+1);
+        if ((rc == ComposeResult_Unsupported) || (rc == ComposeResult_Error)) {
+            return rc;
+        }
+    }
+    return ComposeResult_Ok;
+}
+
+/* }}} */
+/* {{{ getOperationApiName
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the name of the API required by a Modern C++ operation. Used
+ * to report the error when composeOperation returns 
+ * ComposeResult_Unsupported.
+ */
+const char * getOperationApiName(const char *op) {
+    return (strstr(op, "11") != NULL) ? "C++11" : "C++03";
+}
+
+/* }}} */
+/* {{{ findArchitecture
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Search the list of parsed architectures for the given target.
+ *
+ * \param archDef   the list of Architecture objects
+ * \param target    the name of the target to find
+ * \return          a pointer to the Architecture or NULL if not found
+ */
+struct Architecture * findArchitecture(struct REDAInlineList *archDef,
+        const char *target) {
+    struct REDAInlineListNode *node;
+    for (node = REDAInlineList_getFirst(archDef); 
+            node != NULL; 
+            node = REDAInlineListNode_getNext(node)) {
+        struct Architecture *arch = (struct Architecture *)node;
+        if ((strcmp(arch->target, target) == 0)) {
+            return arch;
+        }
+    }
+    return NULL;
+}
+
+/* }}} */
+/* {{{ isTargetInstalled
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Checks whether the libraries of the given target are installed (the 
+ * directory $NDDSHOME/lib/<target> exists).
+ *
+ * Use InstalledTargets to check multiple targets: this function performs
+ * one stat() for each invocation.
+ *
+ * \param NDDSHOME      the NDDSHOME directory
+ * \param target        the target architecture
+ * \param installedOut  pointer to the boolean that receives the result
+ * \return              RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+RTIBool isTargetInstalled(const char *NDDSHOME,
+        const char *target,
+        RTIBool *installedOut) {
+    char path[PATH_MAX+1];
+    struct stat statbuf;
+
+    *installedOut = RTI_FALSE;
+    snprintf(path, PATH_MAX, "%s/lib/%s", NDDSHOME, target);
+    if (stat(path, &statbuf) != 0) {
+        if (errno == ENOENT) {
+            // target is not installed
+            return RTI_TRUE;
+        }
+        fprintf(stderr, "Error stat() failed: %s (errno=%d)\n", strerror(errno), errno);
+        return RTI_FALSE;
+    }
+    // if it is a file, ignore it
+    *installedOut = S_ISDIR(statbuf.st_mode) ? RTI_TRUE : RTI_FALSE;
+    return RTI_TRUE;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * InstalledTargets
+ **************************************************************************/
+/* The index of the targets installed under $NDDSHOME/lib, built with a
+ * single scan of the directory (instead of one stat() for each target of
+ * the platform file, expensive on network file systems).
+ *
+ * The names of the sub-directories are stored in an open addressing hash
+ * table (FNV-1a, linear probing) that is joined with the list of targets.
+ */
+struct InstalledTargets {
+    char                        **slots;
+    unsigned int                size;       /* Always a power of 2 */
+    unsigned int                count;
+};
+
+#define INSTALLED_TARGETS_INITIAL_SIZE  64
+
+/* {{{ hashString
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the 64-bit FNV-1a hash of the given string
+ */
+unsigned long long hashString(const char *str) {
+    unsigned long long hash = FNV1A64_OFFSET_BASIS;
+    for (; *str != '\0'; ++str) {
+        hash ^= (unsigned char)*str;
+        hash *= FNV1A64_PRIME;
+    }
+    return hash;
+}
+
+/* }}} */
+/* {{{ InstalledTargets_init
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * InstalledTargets initializer: the index is empty
+ */
+void InstalledTargets_init(struct InstalledTargets *me) {
+    me->slots = NULL;
+    me->size = 0;
+    me->count = 0;
+}
+
+/* }}} */
+/* {{{ InstalledTargets_finalize
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Releases all the memory associated with the index
+ */
+void InstalledTargets_finalize(struct InstalledTargets *me) {
+    unsigned int i;
+    if (me->slots != NULL) {
+        for (i = 0; i < me->size; ++i) {
+            MEM_FREE(me->slots[i]);
+        }
+        MEM_FREE(me->slots);
+    }
+    InstalledTargets_init(me);
+}
+
+/* }}} */
+/* {{{ InstalledTargets_findSlot
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the slot containing the given name, or the empty slot where it
+ * should be inserted. The table must have at least one empty slot.
+ */
+static char **InstalledTargets_findSlot(char **slots,
+        unsigned int size,
+        const char *name) {
+    unsigned int i = (unsigned int)hashString(name) & (size-1);
+    while ((slots[i] != NULL) && (strcmp(slots[i], name) != 0)) {
+        i = (i+1) & (size-1);
+    }
+    return &slots[i];
+}
+
+/* }}} */
+/* {{{ InstalledTargets_add
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Adds a name to the index, growing the table to keep the load factor 
+ * below 1/2.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if out of memory
+ */
+RTIBool InstalledTargets_add(struct InstalledTargets *me, const char *name) {
+    char **slot;
+
+    if ((me->count+1)*2 > me->size) {
+        unsigned int newSize = (me->size == 0) ? 
+                INSTALLED_TARGETS_INITIAL_SIZE : me->size*2;
+        char **newSlots = MEM_CALLOC(InstalledTargets, newSize, sizeof(*newSlots));
+        unsigned int i;
+
+        if (newSlots == NULL) {
+            fprintf(stderr, "Out of memory allocating installed targets\n");
+            return RTI_FALSE;
+        }
+        for (i = 0; i < me->size; ++i) {
+            if (me->slots[i] != NULL) {
+                *InstalledTargets_findSlot(newSlots, newSize, me->slots[i]) = 
+                        me->slots[i];
+            }
+        }
+        MEM_FREE(me->slots);
+        me->slots = newSlots;
+        me->size = newSize;
+    }
+    slot = InstalledTargets_findSlot(me->slots, me->size, name);
+    if (*slot != NULL) {
+        return RTI_TRUE;
+    }
+    *slot = MEM_STRDUP(InstalledTargets, name);
+    if (*slot == NULL) {
+        fprintf(stderr, "Out of memory allocating installed targets\n");
+        return RTI_FALSE;
+    }
+    ++me->count;
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ InstalledTargets_contains
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns RTI_TRUE if the given target is installed
+ */
+RTIBool InstalledTargets_contains(const struct InstalledTargets *me, 
+        const char *target) {
+    if (me->count == 0) {
+        return RTI_FALSE;
+    }
+    return (*InstalledTargets_findSlot(me->slots, me->size, target) != NULL) ?
+            RTI_TRUE : RTI_FALSE;
+}
+
+/* }}} */
+/* {{{ InstalledTargets_scan
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Builds the index with one pass over the directory $NDDSHOME/lib: all its
+ * sub-directories are considered installed targets.
+ *
+ * The type of the entries is taken from the directory entry itself, stat() 
+ * is used only for symbolic links and file systems that do not report it.
+ * A missing lib directory is not an error (no target is installed).
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+RTIBool InstalledTargets_scan(struct InstalledTargets *me, 
+        const char *NDDSHOME) {
+    char path[PATH_MAX+1];
+    struct dirent *entry;
+    struct stat statbuf;
+    RTIBool ok = RTI_TRUE;
+    DIR *dir;
+
+    snprintf(path, PATH_MAX, "%s/lib", NDDSHOME);
+    dir = opendir(path);
+    if (dir == NULL) {
+        if (errno == ENOENT) {
+            return RTI_TRUE;
+        }
+        fprintf(stderr, "Error opendir() failed: %s (errno=%d)\n", strerror(errno), errno);
+        return RTI_FALSE;
+    }
+    while (ok && ((entry = readdir(dir)) != NULL)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        if ((entry->d_type == DT_LNK) || (entry->d_type == DT_UNKNOWN)) {
+            if ((fstatat(dirfd(dir), entry->d_name, &statbuf, 0) != 0) ||
+                    !S_ISDIR(statbuf.st_mode)) {
+                continue;
+            }
+        } else if (entry->d_type != DT_DIR) {
+            continue;
+        }
+        ok = InstalledTargets_add(me, entry->d_name);
+    }
+    closedir(dir);
+    return ok;
+}
+
+/* }}} */
+/* {{{ scanInstalledVariants
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Determines which library variants (LIB_VARIANTS) are installed for the 
+ * given target with one pass over the directory $NDDSHOME/lib/<target>.
+ *
+ * A variant is installed if its core library ([lib]nddscore<suffix>.<ext>)
+ * is present. The libmsg variants also need [lib]rticonnextmsgc<suffix>.
+ *
+ * \param variantsOut   receives a bit mask: bit i set if LIB_VARIANTS[i]
+ *                      is installed
+ * \return              RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+RTIBool scanInstalledVariants(const char *NDDSHOME,
+        const char *target,
+        unsigned int *variantsOut) {
+    static const char * const LIB_EXTENSIONS[] = {
+        "so", "a", "dylib", "lib", "dll", NULL
+    };
+    char path[PATH_MAX+1];
+    struct dirent *entry;
+    unsigned int coreMask = 0;      /* Bit mask of the suffixes found */
+    unsigned int msgMask = 0;
+    const char *suffixes[4];
+    DIR *dir;
+    int i;
+
+    suffixes[0] = getLibSuffix(RTI_FALSE, RTI_FALSE);
+    suffixes[1] = getLibSuffix(RTI_TRUE, RTI_FALSE);
+    suffixes[2] = getLibSuffix(RTI_FALSE, RTI_TRUE);
+    suffixes[3] = getLibSuffix(RTI_TRUE, RTI_TRUE);
+
+    *variantsOut = 0;
+    snprintf(path, PATH_MAX, "%s/lib/%s", NDDSHOME, target);
+    dir = opendir(path);
+    if (dir == NULL) {
+        fprintf(stderr, "Error opendir() failed: %s (errno=%d)\n", strerror(errno), errno);
+        return RTI_FALSE;
+    }
+    while ((entry = readdir(dir)) != NULL) {
+        const char *name = entry->d_name;
+        const char *ext;
+        unsigned int *mask;
+        size_t len;
+
+        if (strncmp(name, "lib", 3) == 0) {
+            name += 3;
+        }
+        if (strncmp(name, "nddscore", 8) == 0) {
+            name += 8;
+            mask = &coreMask;
+        } else if (strncmp(name, "rticonnextmsgc", 14) == 0) {
+            name += 14;
+            mask = &msgMask;
+        } else {
+            continue;
+        }
+        ext = strchr(name, '.');
+        if (ext == NULL) {
+            continue;
+        }
+        len = (size_t)(ext - name);
+        ++ext;
+        for (i = 0; LIB_EXTENSIONS[i] != NULL; ++i) {
+            size_t extLen = strlen(LIB_EXTENSIONS[i]);
+            if ((strncmp(ext, LIB_EXTENSIONS[i], extLen) == 0) && 
+                    ((ext[extLen] == '\0') || (ext[extLen] == '.'))) {
+                break;
+            }
+        }
+        if (LIB_EXTENSIONS[i] == NULL) {
+            continue;
+        }
+        for (i = 0; i < 4; ++i) {
+            if ((strlen(suffixes[i]) == len) && 
+                    (strncmp(name, suffixes[i], len) == 0)) {
+                *mask |= 1u << i;
+            }
+        }
+    }
+    closedir(dir);
+
+    for (i = 0; LIB_VARIANTS[i].name != NULL; ++i) {
+        unsigned int bit = 1u << ((LIB_VARIANTS[i].isStatic ? 1 : 0) + 
+                (LIB_VARIANTS[i].isDebug ? 2 : 0));
+        if ((coreMask & bit) && (!LIB_VARIANTS[i].libMsg || (msgMask & bit))) {
+            *variantsOut |= 1u << i;
+        }
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * JsonWriter
+ **************************************************************************/
+/* A minimal streaming JSON writer: values are written directly to the
+ * output stream as they are produced (no document is built in memory).
+ *
+ * The writer only keeps track, for each nesting level, whether a separator
+ * is required before the next value.
+ */
+#define JSON_MAX_DEPTH      16
+
+struct JsonWriter {
+    FILE                        *fp;
+    int                         depth;
+    RTIBool                     afterKey;
+    RTIBool                     hasItems[JSON_MAX_DEPTH];
+};
+
+/* {{{ JsonWriter_init
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * JsonWriter initializer
+ */
+void JsonWriter_init(struct JsonWriter *me, FILE *fp) {
+    memset(me, 0, sizeof(*me));
+    me->fp = fp;
+}
+
+/* }}} */
+/* {{{ JsonWriter_beginValue
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the separator required before a new value or key
+ */
+static void JsonWriter_beginValue(struct JsonWriter *me) {
+    if (me->afterKey) {
+        me->afterKey = RTI_FALSE;
+        return;
+    }
+    if (me->hasItems[me->depth]) {
+        fputc(',', me->fp);
+    }
+    me->hasItems[me->depth] = RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ JsonWriter_writeEscaped
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the given string in double quotes, escaping the characters that
+ * are not allowed in a JSON string.
+ */
+static void JsonWriter_writeEscaped(struct JsonWriter *me, const char *str) {
+    const char *ptr;
+    fputc('"', me->fp);
+    for (ptr = str; *ptr != '\0'; ++ptr) {
+        unsigned char ch = (unsigned char)*ptr;
+        switch(ch) {
+            case '"':   fputs("\\\"", me->fp); break;
+            case '\\':  fputs("\\\\", me->fp); break;
+            case '\n':  fputs("\\n", me->fp); break;
+            case '\r':  fputs("\\r", me->fp); break;
+            case '\t':  fputs("\\t", me->fp); break;
+            case '\b':  fputs("\\b", me->fp); break;
+            case '\f':  fputs("\\f", me->fp); break;
+            default:
+                if (ch < 0x20) {
+                    fprintf(me->fp, "\\u%04x", ch);
+                } else {
+                    fputc(ch, me->fp);
+                }
+        }
+    }
+    fputc('"', me->fp);
+}
+
+/* }}} */
+/* {{{ JsonWriter_beginObject
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+RTIBool JsonWriter_beginObject(struct JsonWriter *me) {
+    if (me->depth == JSON_MAX_DEPTH-1) {
+        fprintf(stderr, "Error: JSON nesting too deep\n");
+        return RTI_FALSE;
+    }
+    JsonWriter_beginValue(me);
+    fputc('{', me->fp);
+    me->hasItems[++me->depth] = RTI_FALSE;
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ JsonWriter_endObject
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+void JsonWriter_endObject(struct JsonWriter *me) {
+    fputc('}', me->fp);
+    --me->depth;
+}
+
+/* }}} */
+/* {{{ JsonWriter_beginArray
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+RTIBool JsonWriter_beginArray(struct JsonWriter *me) {
+    if (me->depth == JSON_MAX_DEPTH-1) {
+        fprintf(stderr, "Error: JSON nesting too deep\n");
+        return RTI_FALSE;
+    }
+    JsonWriter_beginValue(me);
+    fputc('[', me->fp);
+    me->hasItems[++me->depth] = RTI_FALSE;
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ JsonWriter_endArray
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+void JsonWriter_endArray(struct JsonWriter *me) {
+    fputc(']', me->fp);
+    --me->depth;
+}
+
+/* }}} */
+/* {{{ JsonWriter_key
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the key of the next member of the current object
+ */
+void JsonWriter_key(struct JsonWriter *me, const char *key) {
+    JsonWriter_beginValue(me);
+    JsonWriter_writeEscaped(me, key);
+    fputc(':', me->fp);
+    me->afterKey = RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ JsonWriter_string
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+void JsonWriter_string(struct JsonWriter *me, const char *val) {
+    JsonWriter_beginValue(me);
+    JsonWriter_writeEscaped(me, val);
+}
+
+/* }}} */
+/* {{{ JsonWriter_boolean
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+void JsonWriter_boolean(struct JsonWriter *me, RTIBool val) {
+    JsonWriter_beginValue(me);
+    fputs(val ? "true" : "false", me->fp);
+}
+
+/* }}} */
+/* {{{ JsonWriter_null
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+void JsonWriter_null(struct JsonWriter *me) {
+    JsonWriter_beginValue(me);
+    fputs("null", me->fp);
+}
+
+/* }}} */
+/* {{{ JsonWriter_unsigned
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+void JsonWriter_unsigned(struct JsonWriter *me, unsigned long val) {
+    JsonWriter_beginValue(me);
+    fprintf(me->fp, "%lu", val);
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * JSON Export
+ **************************************************************************/
+/* The forms of env variable expansion composed by --export-json:
+ *  - "expand": env variables expanded (default)
+ *  - "make":   --noexpand (make-style $(VAR) references)
+ *  - "sh":     --noexpand --sh (shell-style ${VAR} references)
+ */
+static const struct {
+    const char  *name;
+    RTIBool     expandEnvVar;
+    RTIBool     shell;
+} EXPORT_EXPANSIONS[] = {
+    { "expand",     RTI_TRUE,   RTI_FALSE },
+    { "make",       RTI_FALSE,  RTI_FALSE },
+    { "sh",         RTI_FALSE,  RTI_TRUE },
+    { NULL,         RTI_FALSE,  RTI_FALSE }
+};
+
+/* {{{ exportJsonProperties
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the raw properties parsed for the given architecture as a JSON
+ * object. Each property is an object with the type and the value of the
+ * property.
+ */
+static void exportJsonProperties(struct JsonWriter *jw,
+        struct Architecture *arch) {
+    struct REDAInlineListNode *paramNode;
+
+    JsonWriter_beginObject(jw);
+    for (paramNode = REDAInlineList_getFirst(&arch->paramList); 
+            paramNode; 
+            paramNode = REDAInlineListNode_getNext(paramNode)) {
+        struct ArchParameter *param = (struct ArchParameter *)paramNode;
+        JsonWriter_key(jw, param->key);
+        JsonWriter_beginObject(jw);
+        JsonWriter_key(jw, "type");
+        switch(param->valueType) {
+            case APVT_Boolean:
+                JsonWriter_string(jw, "boolean");
+                JsonWriter_key(jw, "value");
+                JsonWriter_boolean(jw, param->value.as_bool);
+                break;
+
+            case APVT_String:
+                JsonWriter_string(jw, "string");
+                JsonWriter_key(jw, "value");
+                JsonWriter_string(jw, param->value.as_string);
+                break;
+
+            case APVT_EnvVariable:
+                JsonWriter_string(jw, "env");
+                JsonWriter_key(jw, "value");
+                JsonWriter_string(jw, param->value.as_string);
+                break;
+
+            case APVT_ArrayOfStrings: {
+                size_t i;
+                JsonWriter_string(jw, "array");
+                JsonWriter_key(jw, "value");
+                JsonWriter_beginArray(jw);
+                for (i = 0; i < MAX_ARRAY_SIZE; ++i) {
+                    if (param->value.as_arrayOfStrings[i][0] == '\0') {
+                        break;
+                    }
+                    JsonWriter_string(jw, param->value.as_arrayOfStrings[i]);
+                }
+                JsonWriter_endArray(jw);
+                break;
+            }
+
+            default:
+                JsonWriter_string(jw, "invalid");
+        }
+        JsonWriter_endObject(jw);
+    }
+    JsonWriter_endObject(jw);
+}
+
+/* }}} */
+/* {{{ exportJsonTarget
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the JSON object describing a target: installed status, raw 
+ * properties and the composed output of all the operations for all the
+ * combinations of modifiers.
+ *
+ * Operations not supported by the target are omitted, operations that
+ * refers to a property not defined for the target are null.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred 
+ *                  while composing any value (the document is still 
+ *                  completed)
+ */
+static RTIBool exportJsonTarget(struct JsonWriter *jw,
+        struct Architecture *arch,
+        const char *NDDSHOME,
+        RTIBool installed) {
+    struct ComposeContext ctx;
+    char value[MAX_CMDLINEARG_SIZE+1];
+    RTIBool ok = RTI_TRUE;
+    int v, e, w;
+
+    JsonWriter_beginObject(jw);
+    JsonWriter_key(jw, "name");
+    JsonWriter_string(jw, arch->target);
+    JsonWriter_key(jw, "installed");
+    JsonWriter_boolean(jw, installed);
+    JsonWriter_key(jw, "properties");
+    exportJsonProperties(jw, arch);
+
+    JsonWriter_key(jw, "outputs");
+    JsonWriter_beginObject(jw);
+    for (v = 0; LIB_VARIANTS[v].name != NULL; ++v) {
+        JsonWriter_key(jw, LIB_VARIANTS[v].name);
+        JsonWriter_beginObject(jw);
+        for (e = 0; EXPORT_EXPANSIONS[e].name != NULL; ++e) {
+            ComposeContext_init(&ctx,
+                    NDDSHOME,
+                    arch->target,
+                    LIB_VARIANTS[v].isStatic,
+                    LIB_VARIANTS[v].isDebug,
+                    LIB_VARIANTS[v].libMsg,
+                    EXPORT_EXPANSIONS[e].expandEnvVar,
+                    EXPORT_EXPANSIONS[e].shell);
+            JsonWriter_key(jw, EXPORT_EXPANSIONS[e].name);
+            JsonWriter_beginObject(jw);
+            for (w = 0; VALID_WHAT[w] != NULL; ++w) {
+                switch(composeOperation(arch, 
+                            VALID_WHAT[w], 
+                            &ctx, 
+                            value, 
+                            sizeof(value))) {
+                    case ComposeResult_Ok:
+                        JsonWriter_key(jw, VALID_WHAT[w]);
+                        JsonWriter_string(jw, value);
+                        break;
+
+                    case ComposeResult_Unsupported:
+                        break;
+
+                    case ComposeResult_Error:
+                        ok = RTI_FALSE;
+                        /* Fall through */
+                    default:
+                        JsonWriter_key(jw, VALID_WHAT[w]);
+                        JsonWriter_null(jw);
+                }
+            }
+            JsonWriter_endObject(jw);
+        }
+        JsonWriter_endObject(jw);
+    }
+    JsonWriter_endObject(jw);
+    JsonWriter_endObject(jw);
+    return ok;
+}
+
+/* }}} */
+/* {{{ exportJson
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes to stdout the JSON document with all the settings of the requested
+ * targets (or all the targets if targetCount is zero).
+ *
+ * \param archDef       the list of parsed Architecture objects
+ * \param NDDSHOME      the NDDSHOME directory
+ * \param platformFile  the path of the parsed platform file
+ * \param info          the information collected while reading the file
+ * \param targets       the array of requested targets
+ * \param targetCount   the number of elements in targets
+ * \return              RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+RTIBool exportJson(struct REDAInlineList *archDef,
+        const char *NDDSHOME,
+        const char *platformFile,
+        const struct PlatformFileInfo *info,
+        char **targets,
+        int targetCount) {
+    struct JsonWriter jw;
+    struct InstalledTargets installed;
+    char hash[MAX_STRING_SIZE];
+    RTIBool ok = RTI_TRUE;
+    int i;
+
+    /* Validate all the requested targets before writing anything */
+    for (i = 0; i < targetCount; ++i) {
+        if (findArchitecture(archDef, targets[i]) == NULL) {
+            fprintf(stderr,
+                    "Error: requested architecture '%s' is not supported\n",
+                    targets[i]);
+            return RTI_FALSE;
+        }
+    }
+    InstalledTargets_init(&installed);
+    if (!InstalledTargets_scan(&installed, NDDSHOME)) {
+        InstalledTargets_finalize(&installed);
+        return RTI_FALSE;
+    }
+
+    JsonWriter_init(&jw, stdout);
+    JsonWriter_beginObject(&jw);
+    JsonWriter_key(&jw, "version");
+    JsonWriter_string(&jw, APPLICATION_VERSION);
+    JsonWriter_key(&jw, "nddshome");
+    JsonWriter_string(&jw, NDDSHOME);
+    JsonWriter_key(&jw, "platformFile");
+    JsonWriter_beginObject(&jw);
+    JsonWriter_key(&jw, "path");
+    JsonWriter_string(&jw, platformFile);
+    JsonWriter_key(&jw, "hash");
+    snprintf(hash, sizeof(hash), "fnv1a64:%016llx", info->hash);
+    JsonWriter_string(&jw, hash);
+    JsonWriter_key(&jw, "lines");
+    JsonWriter_unsigned(&jw, info->lineCount);
+    JsonWriter_endObject(&jw);
+
+    JsonWriter_key(&jw, "targets");
+    JsonWriter_beginArray(&jw);
+    if (targetCount == 0) {
+        struct REDAInlineListNode *archNode;
+        for (archNode = REDAInlineList_getFirst(archDef); 
+                archNode != NULL; 
+                archNode = REDAInlineListNode_getNext(archNode)) {
+            struct Architecture *arch = (struct Architecture *)archNode;
+            if (!exportJsonTarget(&jw, 
+                        arch, 
+                        NDDSHOME,
+                        InstalledTargets_contains(&installed, arch->target))) {
+                ok = RTI_FALSE;
+            }
+        }
+    } else {
+        for (i = 0; i < targetCount; ++i) {
+            if (!exportJsonTarget(&jw, 
+                        findArchitecture(archDef, targets[i]), 
+                        NDDSHOME,
+                        InstalledTargets_contains(&installed, targets[i]))) {
+                ok = RTI_FALSE;
+            }
+        }
+    }
+    JsonWriter_endArray(&jw);
+    JsonWriter_endObject(&jw);
+    fputc('\n', stdout);
+    InstalledTargets_finalize(&installed);
+    return ok;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * Generated Files
+ **************************************************************************/
+/* {{{ VarRefList
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * A list of the (unique) names of the variables referenced in the form
+ * ${NAME} by the settings written in a generated file.
+ */
+struct VarRefList {
+    int                         count;
+    char                        names[MAX_ARRAY_SIZE][MAX_STRING_SIZE];
+};
+
+/* }}} */
+/* {{{ VarRefList_collect
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Adds to the list all the variables referenced as ${NAME} in the given
+ * string.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if the list is full or 
+ *                  a variable reference is malformed
+ */
+RTIBool VarRefList_collect(struct VarRefList *me, const char *str) {
+    const char *start;
+    const char *end;
+    int i;
+
+    for (start = strstr(str, "${"); start != NULL; start = strstr(end, "${")) {
+        size_t len;
+        start += 2;
+        end = strchr(start, '}');
+        len = (end != NULL) ? (size_t)(end - start) : 0;
+        if ((end == NULL) || (len == 0) || (len >= MAX_STRING_SIZE)) {
+            fprintf(stderr, "Invalid env variable reference in: %s\n", str);
+            return RTI_FALSE;
+        }
+        for (i = 0; i < me->count; ++i) {
+            if ((strncmp(me->names[i], start, len) == 0) && 
+                    (me->names[i][len] == '\0')) {
+                break;
+            }
+        }
+        if (i == me->count) {
+            if (me->count == MAX_ARRAY_SIZE) {
+                fprintf(stderr, 
+                        "Error: too many env variables referenced, increase MAX_ARRAY_SIZE and rebuild\n");
+                return RTI_FALSE;
+            }
+            memcpy(me->names[me->count], start, len);
+            me->names[me->count][len] = '\0';
+            ++me->count;
+        }
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ convertVarRefsToShell
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Converts in place all the make-style variable references $(...) of the
+ * given string into the shell-style ${...}.
+ *
+ * String properties (i.e. the compiler) are always printed as defined 
+ * in the platform file, this function allows to have all the settings in 
+ * the same form.
+ */
+void convertVarRefsToShell(char *str) {
+    char *ptr;
+    for (ptr = str; *ptr != '\0'; ++ptr) {
+        if ((*ptr == '$') && (*(ptr+1) == '(')) {
+            char *end = strchr(ptr+2, ')');
+            if (end == NULL) {
+                return;
+            }
+            *(ptr+1) = '{';
+            *end = '}';
+            ptr = end;
+        }
+    }
+}
+
+/* }}} */
+/* {{{ getConnextVersion
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Determines the version of RTI Connext DDS from the name of the 
+ * installation directory (i.e. 'rti_connext_dds-6.0.1').
+ * If it cannot be determined, the version is "0".
+ */
+void getConnextVersion(const char *NDDSHOME, char *bufOut, int bufSize) {
+    const char *base = strrchr(NDDSHOME, '/');
+    const char *ver;
+
+    base = (base != NULL) ? base+1 : NDDSHOME;
+    ver = strrchr(base, '-');
+    if ((ver != NULL) && isdigit((unsigned char)ver[1])) {
+        snprintf(bufOut, (size_t)bufSize, "%s", ver+1);
+    } else {
+        snprintf(bufOut, (size_t)bufSize, "0");
+    }
+}
+
+/* }}} */
+/* {{{ ensureDirectory
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Creates the given directory if it does not exist (parent directory must
+ * exist).
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+RTIBool ensureDirectory(const char *dir) {
+    struct stat info;
+    if (stat(dir, &info) == 0) {
+        if (!S_ISDIR(info.st_mode)) {
+            fprintf(stderr, "Error: '%s' is not a directory\n", dir);
+            return RTI_FALSE;
+        }
+        return RTI_TRUE;
+    }
+    if (mkdir(dir, 0755) != 0) {
+        fprintf(stderr,
+                "Error: failed to create directory '%s': %s (errno=%d)\n",
+                dir,
+                strerror(errno),
+                errno);
+        return RTI_FALSE;
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ writeFileIfChanged
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the given content to a file only if the file does not exist or
+ * its content is different, so the modification time of the generated
+ * files (and the build steps depending on them) are not affected when 
+ * the content does not change.
+ *
+ * The file is written in a temporary file first, then renamed.
+ *
+ * \param path          the path of the file to write
+ * \param content       the content of the file
+ * \param len           the length of the content
+ * \param writtenOut    if not NULL receives RTI_TRUE if the file has been
+ *                      written, RTI_FALSE if it was unchanged
+ * \return              RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+RTIBool writeFileIfChanged(const char *path, 
+        const char *content, 
+        size_t len,
+        RTIBool *writtenOut) {
+    char tmpPath[PATH_MAX+1];
+    struct stat info;
+    FILE *fp;
+
+    if (writtenOut != NULL) {
+        *writtenOut = RTI_FALSE;
+    }
+    if ((stat(path, &info) == 0) && ((size_t)info.st_size == len)) {
+        RTIBool same = RTI_FALSE;
+        char *existing = MEM_MALLOC(Generated, len+1);
+        fp = fopen(path, "r");
+        if ((existing != NULL) && (fp != NULL) && 
+                (fread(existing, 1, len, fp) == len)) {
+            same = (memcmp(existing, content, len) == 0) ? RTI_TRUE : RTI_FALSE;
+        }
+        if (fp != NULL) {
+            fclose(fp);
+        }
+        MEM_FREE(existing);
+        if (same) {
+            return RTI_TRUE;
+        }
+    }
+
+    if (snprintf(tmpPath, PATH_MAX, "%s.tmp%ld", path, (long)getpid()) >= PATH_MAX) {
+        fprintf(stderr, "Path too long: %s\n", path);
+        return RTI_FALSE;
+    }
+    fp = fopen(tmpPath, "w");
+    if (fp == NULL) {
+        fprintf(stderr, 
+                "Error: cannot write file '%s': %s (errno=%d)\n",
+                tmpPath,
+                strerror(errno),
+                errno);
+        return RTI_FALSE;
+    }
+    if ((fwrite(content, 1, len, fp) != len) || (fclose(fp) != 0)) {
+        fprintf(stderr, "Error: failed writing file '%s'\n", tmpPath);
+        unlink(tmpPath);
+        return RTI_FALSE;
+    }
+    if (rename(tmpPath, path) != 0) {
+        fprintf(stderr, 
+                "Error: cannot rename '%s' to '%s': %s (errno=%d)\n",
+                tmpPath,
+                path,
+                strerror(errno),
+                errno);
+        unlink(tmpPath);
+        return RTI_FALSE;
+    }
+    if (writtenOut != NULL) {
+        *writtenOut = RTI_TRUE;
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ commitGeneratedFile
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Closes the memory stream used to compose the content of a generated file
+ * and writes the content (if changed) to the given path.
+ * The content buffer is always released.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+RTIBool commitGeneratedFile(FILE *fp,
+        char **content,
+        size_t *contentLen,
+        const char *path,
+        int *writtenCount) {
+    RTIBool ok = RTI_FALSE;
+    RTIBool written = RTI_FALSE;
+
+    if (fclose(fp) != 0) {
+        fprintf(stderr, "Error composing file '%s'\n", path);
+    } else {
+        MEM_TRACK(Generated, *content, *contentLen+1);
+        ok = writeFileIfChanged(path, *content, *contentLen, &written);
+    }
+    MEM_FREE(*content);
+    *content = NULL;
+    *contentLen = 0;
+    if (written) {
+        ++*writtenCount;
+    }
+    return ok;
+}
+
+/* }}} */
+/* {{{ discardGeneratedFile
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Closes the memory stream used to compose the content of a generated file
+ * and releases the content without writing it (i.e. when the composition 
+ * fails), recording the buffer like commitGeneratedFile.
+ */
+void discardGeneratedFile(FILE *fp, char **content, size_t *contentLen) {
+    if (fclose(fp) == 0) {
+        MEM_TRACK(Generated, *content, *contentLen+1);
+    }
+    MEM_FREE(*content);
+    *content = NULL;
+    *contentLen = 0;
+}
+
+/* }}} */
+/* {{{ selectGeneratedTargets
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Resolves the list of targets the generators (i.e. --generate-pkgconfig) 
+ * operate on: the targets given in the command line (that must be valid),
+ * or all the installed targets if none is specified.
+ *
+ * \param archDef       the list of parsed Architecture objects
+ * \param NDDSHOME      the NDDSHOME directory
+ * \param targets       the array of requested targets
+ * \param targetCount   the number of elements in targets
+ * \param archOut       array that receives the selected architectures
+ * \param archOutMax    the size of archOut
+ * \return              the number of architectures selected or -1 if 
+ *                      an error occurred
+ */
+int selectGeneratedTargets(struct REDAInlineList *archDef,
+        const char *NDDSHOME,
+        char **targets,
+        int targetCount,
+        struct Architecture **archOut,
+        int archOutMax) {
+    struct REDAInlineListNode *archNode;
+    struct InstalledTargets installed;
+    int count = 0;
+    int i;
+
+    if (targetCount > 0) {
+        if (targetCount > archOutMax) {
+            fprintf(stderr, "Error: too many targets specified\n");
+            return -1;
+        }
+        for (i = 0; i < targetCount; ++i) {
+            archOut[i] = findArchitecture(archDef, targets[i]);
+            if (archOut[i] == NULL) {
+                fprintf(stderr,
+                        "Error: requested architecture '%s' is not supported\n",
+                        targets[i]);
+                return -1;
+            }
+        }
+        return targetCount;
+    }
+
+    InstalledTargets_init(&installed);
+    if (!InstalledTargets_scan(&installed, NDDSHOME)) {
+        count = -1;
+        goto done;
+    }
+    for (archNode = REDAInlineList_getFirst(archDef); 
+            archNode != NULL; 
+            archNode = REDAInlineListNode_getNext(archNode)) {
+        struct Architecture *arch = (struct Architecture *)archNode;
+        if (!InstalledTargets_contains(&installed, arch->target)) {
+            continue;
+        }
+        if (count == archOutMax) {
+            fprintf(stderr, "Error: too many installed targets\n");
+            count = -1;
+            goto done;
+        }
+        archOut[count++] = arch;
+    }
+
+done:
+    InstalledTargets_finalize(&installed);
+    return count;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * pkg-config Generator
+ **************************************************************************/
+/* Maximum number of targets processed by the generators */
+#define MAX_GENERATED_TARGETS   1024
+
+/* {{{ generatePkgConfigFile
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Generates one pkg-config file for the given target, API and variant.
+ *
+ * The settings are composed without expanding the environment variables
+ * (same as --noexpand --sh), and each referenced variable is defined in 
+ * the .pc file with its current value (NDDSHOME is always defined), so 
+ * they can be overridden through `pkg-config --define-variable`.
+ *
+ * \return          ComposeResult_Ok if the file has been generated (or it
+ *                  is unchanged), ComposeResult_Unsupported if the target 
+ *                  does not support the API, ComposeResult_Error if failed.
+ */
+static ComposeResult generatePkgConfigFile(struct Architecture *arch,
+        int apiIdx,
+        int variantIdx,
+        const char *NDDSHOME,
+        const char *version,
+        const char *dir,
+        int *writtenCount) {
+    struct ComposeContext ctx;
+    struct ApiSettings settings;
+    struct VarRefList vars;
+    char path[PATH_MAX+1];
+    char name[MAX_CMDLINEARG_SIZE];
+    char *content = NULL;
+    size_t contentLen = 0;
+    FILE *fp;
+    ComposeResult rc;
+    int i;
+
+    ComposeContext_init(&ctx,
+            NDDSHOME,
+            arch->target,
+            LIB_VARIANTS[variantIdx].isStatic,
+            LIB_VARIANTS[variantIdx].isDebug,
+            LIB_VARIANTS[variantIdx].libMsg,
+            RTI_FALSE,
+            RTI_TRUE);
+    rc = composeApiSettings(arch, apiIdx, &ctx, &settings);
+    if (rc != ComposeResult_Ok) {
+        return rc;
+    }
+    convertVarRefsToShell(settings.comp);
+    convertVarRefsToShell(settings.link);
+
+    memset(&vars, 0, sizeof(vars));
+    strcpy(vars.names[vars.count++], "NDDSHOME");
+    if (!VarRefList_collect(&vars, settings.comp) ||
+            !VarRefList_collect(&vars, settings.flags) ||
+            !VarRefList_collect(&vars, settings.link) ||
+            !VarRefList_collect(&vars, settings.ldflags) ||
+            !VarRefList_collect(&vars, settings.ldlibs)) {
+        return ComposeResult_Error;
+    }
+
+    snprintf(name, sizeof(name), "connextdds-%s-%s%s",
+            API_OPERATIONS[apiIdx].name,
+            arch->target,
+            LIB_VARIANTS[variantIdx].fileSuffix);
+    if (snprintf(path, PATH_MAX, "%s/%s.pc", dir, name) >= PATH_MAX) {
+        fprintf(stderr, "Path too long for pkg-config file '%s'\n", name);
+        return ComposeResult_Error;
+    }
+
+    fp = open_memstream(&content, &contentLen);
+    if (fp == NULL) {
+        fprintf(stderr, "Out of memory allocating pkg-config file content\n");
+        return ComposeResult_Error;
+    }
+    fprintf(fp, "# Generated by %s v.%s - do not edit\n", 
+            APPLICATION_NAME, 
+            APPLICATION_VERSION);
+    for (i = 0; i < vars.count; ++i) {
+        const char *val = (i == 0) ? NDDSHOME : getenv(vars.names[i]);
+        fprintf(fp, "%s=%s\n", vars.names[i], (val != NULL) ? val : "");
+    }
+    fprintf(fp, "includedir=${NDDSHOME}/include\n");
+    fprintf(fp, "libdir=${NDDSHOME}/lib/%s\n", arch->target);
+    fprintf(fp, "compiler=%s\n", settings.comp);
+    fprintf(fp, "linker=%s\n", settings.link);
+    fprintf(fp, "libsuffix=%s\n", ctx.libSuffix);
+    fprintf(fp, "\n");
+    fprintf(fp, "Name: %s\n", name);
+    fprintf(fp, "Description: RTI Connext DDS %s for %s (%s)\n",
+            API_OPERATIONS[apiIdx].description,
+            arch->target,
+            LIB_VARIANTS[variantIdx].name);
+    fprintf(fp, "Version: %s\n", version);
+    fprintf(fp, "Cflags: %s\n", settings.flags);
+    fprintf(fp, "Libs: %s%s%s\n", 
+            settings.ldflags, 
+            (settings.ldflags[0] != '\0') ? " " : "",
+            settings.ldlibs);
+    return commitGeneratedFile(fp, &content, &contentLen, path, writtenCount) ?
+            ComposeResult_Ok : ComposeResult_Error;
+}
+
+/* }}} */
+/* {{{ generatePkgConfig
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Generates the pkg-config files for all the APIs supported and all the 
+ * variants of the given targets (or all the installed targets if 
+ * targetCount is zero) in the given directory.
+ *
+ * Files are named: connextdds-<api>-<target>[-static][-debug][-libmsg].pc
+ *
+ * \return              RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+RTIBool generatePkgConfig(struct REDAInlineList *archDef,
+        const char *NDDSHOME,
+        const char *dir,
+        char **targets,
+        int targetCount) {
+    struct Architecture **arches;
+    char version[MAX_STRING_SIZE];
+    int archCount;
+    int fileCount = 0;
+    int writtenCount = 0;
+    RTIBool ok = RTI_FALSE;
+    int t, a, v;
+
+    arches = MEM_CALLOC(Generated, MAX_GENERATED_TARGETS, sizeof(*arches));
+    if (arches == NULL) {
+        fprintf(stderr, "Out of memory allocating target list\n");
+        return RTI_FALSE;
+    }
+    archCount = selectGeneratedTargets(archDef,
+            NDDSHOME,
+            targets,
+            targetCount,
+            arches,
+            MAX_GENERATED_TARGETS);
+    if ((archCount < 0) || !ensureDirectory(dir)) {
+        goto done;
+    }
+    getConnextVersion(NDDSHOME, version, sizeof(version));
+
+    for (t = 0; t < archCount; ++t) {
+        for (a = 0; API_OPERATIONS[a].name != NULL; ++a) {
+            for (v = 0; LIB_VARIANTS[v].name != NULL; ++v) {
+                ComposeResult rc = generatePkgConfigFile(arches[t],
+                        a,
+                        v,
+                        NDDSHOME,
+                        version,
+                        dir,
+                        &writtenCount);
+                if (rc == ComposeResult_Unsupported) {
+                    /* Skip all the variants of this API */
+                    break;
+                }
+                if (rc != ComposeResult_Ok) {
+                    goto done;
+                }
+                ++fileCount;
+            }
+        }
+    }
+    printf("Generated %d pkg-config files for %d targets in %s (%d updated)\n",
+            fileCount,
+            archCount,
+            dir,
+            writtenCount);
+    ok = RTI_TRUE;
+
+done:
+    MEM_FREE(arches);
+    return ok;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * CMake Package Generator
+ **************************************************************************/
+/* The imported targets defined by the generated CMake package, and the API
+ * they are composed from. The "cpp2" targets use the C++11 settings when
+ * supported by the target, the C++03 settings otherwise.
+ */
+static const struct {
+    const char  *name;          /* Name of the imported target */
+    const char  *api;           /* Name of the API in API_OPERATIONS */
+    const char  *altApi;        /* API to use if the first is unsupported */
+    RTIBool     libMsg;         /* Include the request/reply library */
+} CMAKE_TARGETS[] = {
+    { "ConnextDDS::c",          "c",        NULL,       RTI_FALSE },
+    { "ConnextDDS::cpp",        "cxx",      NULL,       RTI_FALSE },
+    { "ConnextDDS::cpp2",       "cxx11",    "cxx03",    RTI_FALSE },
+    { "ConnextDDS::msgc",       "c",        NULL,       RTI_TRUE },
+    { "ConnextDDS::msgcpp",     "cxx",      NULL,       RTI_TRUE },
+    { "ConnextDDS::msgcpp2",    "cxx11",    "cxx03",    RTI_TRUE },
+    { NULL,                     NULL,       NULL,       RTI_FALSE }
+};
+
+/* {{{ getApiIndex
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the index in API_OPERATIONS of the given API or -1 if not found
+ */
+int getApiIndex(const char *api) {
+    int i;
+    for (i = 0; API_OPERATIONS[i].name != NULL; ++i) {
+        if (strcmp(API_OPERATIONS[i].name, api) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* }}} */
+/* {{{ substituteVarRefs
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Copies the input string (composed with shell-style variable references)
+ * into bufOut, replacing the reference ${NDDSHOME} with the given string,
+ * and expanding all the other ${VARIABLE} with their current value.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if the output is too long
+ *                  or a variable reference is not terminated
+ */
+RTIBool substituteVarRefs(const char *in,
+        const char *nddsHomeRef,
+        char *bufOut,
+        int bufSize) {
+    char varName[MAX_STRING_SIZE];
+    int wr = 0;
+    const char *rd;
+
+    for (rd = in; *rd != '\0'; ++rd) {
+        const char *val;
+        const char *end;
+        if ((*rd != '$') || (*(rd+1) != '{')) {
+            if (wr >= bufSize-1) {
+                goto tooLong;
+            }
+            bufOut[wr++] = *rd;
+            continue;
+        }
+        end = strchr(rd+2, '}');
+        if ((end == NULL) || (end-rd-2 >= MAX_STRING_SIZE)) {
+            fprintf(stderr, "Invalid env variable reference in: %s\n", in);
+            return RTI_FALSE;
+        }
+        memcpy(varName, rd+2, (size_t)(end-rd-2));
+        varName[end-rd-2] = '\0';
+        val = (strcmp(varName, "NDDSHOME") == 0) ? nddsHomeRef : getenv(varName);
+        if (val != NULL) {
+            int rc = snprintf(&bufOut[wr], (size_t)(bufSize-wr), "%s", val);
+            if (rc >= bufSize-wr) {
+                goto tooLong;
+            }
+            wr += rc;
+        }
+        rd = end;
+    }
+    bufOut[wr] = '\0';
+    return RTI_TRUE;
+
+tooLong:
+    fprintf(stderr, "Expanded string too long: %s\n", in);
+    return RTI_FALSE;
+}
+
+/* }}} */
+/* {{{ writeCMakeList
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes to fp the flags of the given space-separated string as the 
+ * elements of a quoted CMake list.
+ *
+ * \param fp        the stream where to write
+ * \param flags     the space-separated flags
+ * \param prefix    if not NULL, only the flags starting with the prefix
+ *                  are written (without the prefix)
+ * \param exclude   if not NULL, the flags starting with any of the strings
+ *                  of this NULL-terminated array are skipped
+ */
+void writeCMakeList(FILE *fp,
+        const char *flags,
+        const char *prefix,
+        const char **exclude) {
+    const char *ptr = flags;
+    const char *sep = "";
+    size_t prefixLen = (prefix != NULL) ? strlen(prefix) : 0;
+
+    fputc('"', fp);
+    while (*ptr != '\0') {
+        const char *end;
+        size_t len;
+        int i;
+        while (isspace((unsigned char)*ptr)) {
+            ++ptr;
+        }
+        if (*ptr == '\0') {
+            break;
+        }
+        for (end = ptr; (*end != '\0') && !isspace((unsigned char)*end); ++end) {
+        }
+        len = (size_t)(end - ptr);
+        if (prefix != NULL) {
+            if ((len <= prefixLen) || (strncmp(ptr, prefix, prefixLen) != 0)) {
+                ptr = end;
+                continue;
+            }
+            ptr += prefixLen;
+            len -= prefixLen;
+        } else if (exclude != NULL) {
+            for (i = 0; exclude[i] != NULL; ++i) {
+                if (strncmp(ptr, exclude[i], strlen(exclude[i])) == 0) {
+                    break;
+                }
+            }
+            if (exclude[i] != NULL) {
+                ptr = end;
+                continue;
+            }
+        }
+        fputs(sep, fp);
+        for (; ptr < end; ++ptr) {
+            if ((*ptr == '"') || (*ptr == '\\') || (*ptr == ';')) {
+                fputc('\\', fp);
+            }
+            fputc(*ptr, fp);
+        }
+        sep = ";";
+    }
+    fputc('"', fp);
+}
+
+/* }}} */
+/* {{{ writeCMakeImportedTarget
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the definition of an INTERFACE IMPORTED target with the usage 
+ * requirements from the given API settings.
+ * The compiler flags are split into definitions (-D), include 
+ * directories (-I) and compile options. The linker flags are split in the
+ * same way into link directories (-L) and link options, while the link 
+ * libraries contain only the libraries (in order).
+ */
+static void writeCMakeImportedTarget(FILE *fp,
+        const char *name,
+        const struct ApiSettings *settings) {
+    const char *COMPILE_OPTIONS_EXCLUDE[] = { "-D", "-I", NULL };
+    const char *LINK_OPTIONS_EXCLUDE[] = { "-L", NULL };
+    char linkFlags[2*MAX_CMDLINEARG_SIZE+2];
+
+    snprintf(linkFlags, sizeof(linkFlags), "%s %s", 
+            settings->ldflags, 
+            settings->ldlibs);
+
+    fprintf(fp, "if(NOT TARGET %s)\n", name);
+    fprintf(fp, "    add_library(%s INTERFACE IMPORTED)\n", name);
+    fprintf(fp, "    set_target_properties(%s PROPERTIES\n", name);
+    fprintf(fp, "        INTERFACE_COMPILE_OPTIONS ");
+    writeCMakeList(fp, settings->flags, NULL, COMPILE_OPTIONS_EXCLUDE);
+    fprintf(fp, "\n        INTERFACE_COMPILE_DEFINITIONS ");
+    writeCMakeList(fp, settings->flags, "-D", NULL);
+    fprintf(fp, "\n        INTERFACE_INCLUDE_DIRECTORIES ");
+    writeCMakeList(fp, settings->flags, "-I", NULL);
+    fprintf(fp, "\n        INTERFACE_LINK_OPTIONS ");
+    writeCMakeList(fp, settings->ldflags, NULL, LINK_OPTIONS_EXCLUDE);
+    fprintf(fp, "\n        INTERFACE_LINK_DIRECTORIES ");
+    writeCMakeList(fp, linkFlags, "-L", NULL);
+    fprintf(fp, "\n        INTERFACE_LINK_LIBRARIES ");
+    writeCMakeList(fp, settings->ldlibs, NULL, LINK_OPTIONS_EXCLUDE);
+    fprintf(fp, ")\nendif()\n");
+}
+
+/* }}} */
+/* {{{ composeCMakeApiSettings
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes the settings of an API for the generated CMake files: NDDSHOME
+ * is referenced through the CMake variable CONNEXTDDS_HOME, all the other
+ * env variables are expanded at generation time.
+ */
+static ComposeResult composeCMakeApiSettings(struct Architecture *arch,
+        int apiIdx,
+        const struct ComposeContext *ctx,
+        struct ApiSettings *settings) {
+    char tmp[MAX_CMDLINEARG_SIZE+1];
+    char *fields[5];
+    ComposeResult rc;
+    int i;
+
+    rc = composeApiSettings(arch, apiIdx, ctx, settings);
+    if (rc != ComposeResult_Ok) {
+        return rc;
+    }
+    fields[0] = settings->comp;
+    fields[1] = settings->flags;
+    fields[2] = settings->link;
+    fields[3] = settings->ldflags;
+    fields[4] = settings->ldlibs;
+    for (i = 0; i < 5; ++i) {
+        convertVarRefsToShell(fields[i]);
+        if (!substituteVarRefs(fields[i], 
+                    "${CONNEXTDDS_HOME}", 
+                    tmp, 
+                    sizeof(tmp))) {
+            return ComposeResult_Error;
+        }
+        strcpy(fields[i], tmp);
+    }
+    return ComposeResult_Ok;
+}
+
+/* }}} */
+/* {{{ generateCMakeTargetFiles
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Generates the files of a target: the toolchain file and one file for each
+ * variant (static, debug) defining the imported targets.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+static RTIBool generateCMakeTargetFiles(struct Architecture *arch,
+        const char *NDDSHOME,
+        const char *dir,
+        int *fileCount,
+        int *writtenCount) {
+    struct ComposeContext ctx;
+    struct ApiSettings settings;
+    char path[PATH_MAX+1];
+    char *content = NULL;
+    size_t contentLen = 0;
+    FILE *fp;
+    int v, t;
+
+    /* Toolchain file */
+    if (snprintf(path, PATH_MAX, "%s/ConnextDDS-%s-toolchain.cmake", 
+                dir, 
+                arch->target) >= PATH_MAX) {
+        fprintf(stderr, "Path too long for target '%s'\n", arch->target);
+        return RTI_FALSE;
+    }
+    ComposeContext_init(&ctx, NDDSHOME, arch->target, 
+            RTI_FALSE, RTI_FALSE, RTI_FALSE, RTI_FALSE, RTI_TRUE);
+    fp = open_memstream(&content, &contentLen);
+    if (fp == NULL) {
+        fprintf(stderr, "Out of memory allocating CMake file content\n");
+        return RTI_FALSE;
+    }
+    fprintf(fp, "# Generated by %s v.%s - do not edit\n", 
+            APPLICATION_NAME, 
+            APPLICATION_VERSION);
+    fprintf(fp, "# Toolchain for RTI Connext DDS target %s\n", arch->target);
+    if (composeCMakeApiSettings(arch, 
+                getApiIndex("c"), 
+                &ctx, 
+                &settings) != ComposeResult_Ok) {
+        discardGeneratedFile(fp, &content, &contentLen);
+        return RTI_FALSE;
+    }
+    if (settings.comp[0] != '\0') {
+        fprintf(fp, "set(CMAKE_C_COMPILER \"%s\")\n", settings.comp);
+    }
+    if (composeCMakeApiSettings(arch, 
+                getApiIndex("cxx"), 
+                &ctx, 
+                &settings) != ComposeResult_Ok) {
+        discardGeneratedFile(fp, &content, &contentLen);
+        return RTI_FALSE;
+    }
+    if (settings.comp[0] != '\0') {
+        fprintf(fp, "set(CMAKE_CXX_COMPILER \"%s\")\n", settings.comp);
+    }
+    if (!commitGeneratedFile(fp, &content, &contentLen, path, writtenCount)) {
+        return RTI_FALSE;
+    }
+    ++*fileCount;
+
+    /* One file for each variant: libmsg is provided by the msg* targets */
+    for (v = 0; LIB_VARIANTS[v].name != NULL; ++v) {
+        if (LIB_VARIANTS[v].libMsg) {
+            continue;
+        }
+        if (snprintf(path, PATH_MAX, "%s/ConnextDDS-%s%s.cmake", 
+                    dir, 
+                    arch->target,
+                    LIB_VARIANTS[v].fileSuffix) >= PATH_MAX) {
+            fprintf(stderr, "Path too long for target '%s'\n", arch->target);
+            return RTI_FALSE;
+        }
+        fp = open_memstream(&content, &contentLen);
+        if (fp == NULL) {
+            fprintf(stderr, "Out of memory allocating CMake file content\n");
+            return RTI_FALSE;
+        }
+        fprintf(fp, "# Generated by %s v.%s - do not edit\n", 
+                APPLICATION_NAME, 
+                APPLICATION_VERSION);
+        fprintf(fp, "# RTI Connext DDS imported targets for %s (%s)\n", 
+                arch->target,
+                LIB_VARIANTS[v].name);
+        fprintf(fp, "set(CONNEXTDDS_LIB_SUFFIX \"%s\")\n", 
+                getLibSuffix(LIB_VARIANTS[v].isStatic, LIB_VARIANTS[v].isDebug));
+
+        for (t = 0; CMAKE_TARGETS[t].name != NULL; ++t) {
+            ComposeResult rc;
+            ComposeContext_init(&ctx, 
+                    NDDSHOME, 
+                    arch->target, 
+                    LIB_VARIANTS[v].isStatic,
+                    LIB_VARIANTS[v].isDebug,
+                    CMAKE_TARGETS[t].libMsg,
+                    RTI_FALSE, 
+                    RTI_TRUE);
+            rc = composeCMakeApiSettings(arch, 
+                    getApiIndex(CMAKE_TARGETS[t].api), 
+                    &ctx, 
+                    &settings);
+            if ((rc == ComposeResult_Unsupported) && 
+                    (CMAKE_TARGETS[t].altApi != NULL)) {
+                rc = composeCMakeApiSettings(arch, 
+                        getApiIndex(CMAKE_TARGETS[t].altApi), 
+                        &ctx, 
+                        &settings);
+            }
+            if (rc == ComposeResult_Unsupported) {
+                /* API not available on this target: no imported target */
+                continue;
+            }
+            if (rc != ComposeResult_Ok) {
+                discardGeneratedFile(fp, &content, &contentLen);
+                return RTI_FALSE;
+            }
+            writeCMakeImportedTarget(fp, CMAKE_TARGETS[t].name, &settings);
+        }
+        if (!commitGeneratedFile(fp, &content, &contentLen, path, writtenCount)) {
+            return RTI_FALSE;
+        }
+        ++*fileCount;
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ generateCMakeConfigFiles
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Generates the ConnextDDSConfig.cmake and ConnextDDSConfigVersion.cmake
+ * files that select and include the file of the requested target/variant.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+static RTIBool generateCMakeConfigFiles(struct Architecture **arches,
+        int archCount,
+        const char *NDDSHOME,
+        const char *dir,
+        int *fileCount,
+        int *writtenCount) {
+    char path[PATH_MAX+1];
+    char version[MAX_STRING_SIZE];
+    char *content = NULL;
+    size_t contentLen = 0;
+    FILE *fp;
+    int t;
+
+    getConnextVersion(NDDSHOME, version, sizeof(version));
+
+    /* ConnextDDSConfigVersion.cmake */
+    snprintf(path, PATH_MAX, "%s/ConnextDDSConfigVersion.cmake", dir);
+    fp = open_memstream(&content, &contentLen);
+    if (fp == NULL) {
+        fprintf(stderr, "Out of memory allocating CMake file content\n");
+        return RTI_FALSE;
+    }
+    fprintf(fp, 
+            "# Generated by %s v.%s - do not edit\n"
+            "set(PACKAGE_VERSION \"%s\")\n"
+            "if(PACKAGE_FIND_VERSION VERSION_GREATER PACKAGE_VERSION)\n"
+            "    set(PACKAGE_VERSION_COMPATIBLE FALSE)\n"
+            "else()\n"
+            "    set(PACKAGE_VERSION_COMPATIBLE TRUE)\n"
+            "    if(PACKAGE_FIND_VERSION STREQUAL PACKAGE_VERSION)\n"
+            "        set(PACKAGE_VERSION_EXACT TRUE)\n"
+            "    endif()\n"
+            "endif()\n",
+            APPLICATION_NAME, 
+            APPLICATION_VERSION,
+            version);
+    if (!commitGeneratedFile(fp, &content, &contentLen, path, writtenCount)) {
+        return RTI_FALSE;
+    }
+    ++*fileCount;
+
+    /* ConnextDDSConfig.cmake */
+    snprintf(path, PATH_MAX, "%s/ConnextDDSConfig.cmake", dir);
+    fp = open_memstream(&content, &contentLen);
+    if (fp == NULL) {
+        fprintf(stderr, "Out of memory allocating CMake file content\n");
+        return RTI_FALSE;
+    }
+    fprintf(fp, 
+            "# Generated by %s v.%s - do not edit\n"
+            "#\n"
+            "# Defines the imported targets ConnextDDS::c, ConnextDDS::cpp,\n"
+            "# ConnextDDS::cpp2 (and ConnextDDS::msgc, ConnextDDS::msgcpp,\n"
+            "# ConnextDDS::msgcpp2 for request/reply) for the target selected by:\n"
+            "#   CONNEXTDDS_ARCH     the target architecture (default: $ENV{NDDSARCH},\n"
+            "#                       or the only target available)\n"
+            "#   CONNEXTDDS_STATIC   use the static libraries\n"
+            "#   CONNEXTDDS_DEBUG    use the debug libraries\n"
+            "#   CONNEXTDDS_HOME     the location of RTI Connext DDS\n"
+            "#\n"
+            "# To use the compilers of the target, configure with:\n"
+            "#   -DCMAKE_TOOLCHAIN_FILE=<dir>/ConnextDDS-<target>-toolchain.cmake\n"
+            "\n",
+            APPLICATION_NAME, 
+            APPLICATION_VERSION);
+    fprintf(fp, "if(CMAKE_VERSION VERSION_LESS 3.13)\n"
+            "    set(ConnextDDS_FOUND FALSE)\n"
+            "    set(ConnextDDS_NOT_FOUND_MESSAGE\n"
+            "        \"CMake 3.13 or later is required for the link options\")\n"
+            "    return()\n"
+            "endif()\n");
+    fprintf(fp, "if(NOT DEFINED CONNEXTDDS_HOME)\n"
+            "    set(CONNEXTDDS_HOME \"%s\")\n"
+            "endif()\n", 
+            NDDSHOME);
+    fprintf(fp, "set(CONNEXTDDS_VERSION \"%s\")\n", version);
+    fprintf(fp, "set(CONNEXTDDS_AVAILABLE_ARCHS \"");
+    for (t = 0; t < archCount; ++t) {
+        fprintf(fp, "%s%s", (t > 0) ? ";" : "", arches[t]->target);
+    }
+    fprintf(fp, "\")\n\n");
+    fprintf(fp,
+            "if(NOT CONNEXTDDS_ARCH)\n"
+            "    if(DEFINED ENV{NDDSARCH})\n"
+            "        set(CONNEXTDDS_ARCH \"$ENV{NDDSARCH}\")\n"
+            "    else()\n"
+            "        list(LENGTH CONNEXTDDS_AVAILABLE_ARCHS _connextdds_count)\n"
+            "        if(_connextdds_count EQUAL 1)\n"
+            "            set(CONNEXTDDS_ARCH \"${CONNEXTDDS_AVAILABLE_ARCHS}\")\n"
+            "        endif()\n"
+            "    endif()\n"
+            "endif()\n"
+            "set(_connextdds_file \"${CMAKE_CURRENT_LIST_DIR}/ConnextDDS-${CONNEXTDDS_ARCH}\")\n"
+            "if(CONNEXTDDS_STATIC)\n"
+            "    set(_connextdds_file \"${_connextdds_file}-static\")\n"
+            "endif()\n"
+            "if(CONNEXTDDS_DEBUG)\n"
+            "    set(_connextdds_file \"${_connextdds_file}-debug\")\n"
+            "endif()\n"
+            "if(NOT CONNEXTDDS_ARCH OR NOT EXISTS \"${_connextdds_file}.cmake\")\n"
+            "    set(ConnextDDS_FOUND FALSE)\n"
+            "    set(ConnextDDS_NOT_FOUND_MESSAGE\n"
+            "        \"Invalid CONNEXTDDS_ARCH '${CONNEXTDDS_ARCH}', "
+                    "available targets: ${CONNEXTDDS_AVAILABLE_ARCHS}\")\n"
+            "    return()\n"
+            "endif()\n"
+            "include(\"${_connextdds_file}.cmake\")\n");
+    if (!commitGeneratedFile(fp, &content, &contentLen, path, writtenCount)) {
+        return RTI_FALSE;
+    }
+    ++*fileCount;
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ generateCMake
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Generates the CMake package configuration for the given targets (or all
+ * the installed targets if targetCount is zero) in the given directory.
+ *
+ * \return              RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+RTIBool generateCMake(struct REDAInlineList *archDef,
+        const char *NDDSHOME,
+        const char *dir,
+        char **targets,
+        int targetCount) {
+    struct Architecture **arches;
+    int archCount;
+    int fileCount = 0;
+    int writtenCount = 0;
+    RTIBool ok = RTI_FALSE;
+    int t;
+
+    arches = MEM_CALLOC(Generated, MAX_GENERATED_TARGETS, sizeof(*arches));
+    if (arches == NULL) {
+        fprintf(stderr, "Out of memory allocating target list\n");
+        return RTI_FALSE;
+    }
+    archCount = selectGeneratedTargets(archDef,
+            NDDSHOME,
+            targets,
+            targetCount,
+            arches,
+            MAX_GENERATED_TARGETS);
+    if ((archCount < 0) || !ensureDirectory(dir)) {
+        goto done;
+    }
+    for (t = 0; t < archCount; ++t) {
+        if (!generateCMakeTargetFiles(arches[t], 
+                    NDDSHOME, 
+                    dir, 
+                    &fileCount, 
+                    &writtenCount)) {
+            goto done;
+        }
+    }
+    if (!generateCMakeConfigFiles(arches, 
+                archCount, 
+                NDDSHOME, 
+                dir, 
+                &fileCount, 
+                &writtenCount)) {
+        goto done;
+    }
+    printf("Generated %d CMake files for %d targets in %s (%d updated)\n",
+            fileCount,
+            archCount,
+            dir,
+            writtenCount);
+    ok = RTI_TRUE;
+
+done:
+    MEM_FREE(arches);
+    return ok;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * Build System Fragments
+ **************************************************************************/
+/* Names of the make variables defined for the settings of each API, in the
+ * same order as API_OPERATIONS
+ */
+static const struct {
+    const char  *comp;
+    const char  *flags;
+    const char  *link;
+    const char  *ldflags;
+    const char  *ldlibs;
+} MAKE_VARIABLES[] = {
+    { "RTI_CC",     "RTI_CFLAGS",       "RTI_LD",     "RTI_LDFLAGS",      "RTI_LDLIBS" },
+    { "RTI_CXX",    "RTI_CXXFLAGS",     "RTI_LDXX",   "RTI_LDXXFLAGS",    "RTI_LDXXLIBS" },
+    { "RTI_CXX03",  "RTI_CXX03FLAGS",   "RTI_LDXX03", "RTI_LDXX03FLAGS",  "RTI_LDXX03LIBS" },
+    { "RTI_CXX11",  "RTI_CXX11FLAGS",   "RTI_LDXX11", "RTI_LDXX11FLAGS",  "RTI_LDXX11LIBS" },
+    { NULL,         NULL,               NULL,         NULL,               NULL }
+};
+
+/* {{{ convertVarRefsToMake
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Converts in place all the shell-style variable references ${...} of the
+ * given string into the make-style $(...).
+ */
+void convertVarRefsToMake(char *str) {
+    char *ptr;
+    for (ptr = str; *ptr != '\0'; ++ptr) {
+        if ((*ptr == '$') && (*(ptr+1) == '{')) {
+            char *end = strchr(ptr+2, '}');
+            if (end == NULL) {
+                return;
+            }
+            *(ptr+1) = '(';
+            *end = ')';
+            ptr = end;
+        }
+    }
+}
+
+/* }}} */
+/* {{{ writeOutput
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Completes an output composed in a memory stream: if outFile is NULL the
+ * content is printed to stdout, otherwise it is written to the file only if
+ * changed. The content buffer is always released.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+RTIBool writeOutput(FILE *fp, 
+        char **content, 
+        size_t *contentLen, 
+        const char *outFile) {
+    int writtenCount = 0;
+
+    if (outFile != NULL) {
+        return commitGeneratedFile(fp, content, contentLen, outFile, &writtenCount);
+    }
+    if (fclose(fp) != 0) {
+        fprintf(stderr, "Error composing output\n");
+        MEM_FREE(*content);
+        *content = NULL;
+        return RTI_FALSE;
+    }
+    MEM_TRACK(Generated, *content, *contentLen+1);
+    fwrite(*content, 1, *contentLen, stdout);
+    MEM_FREE(*content);
+    *content = NULL;
+    *contentLen = 0;
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ emitMakeFragment
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Emits a GNU make fragment defining all the build settings of the target
+ * (RTI_CC, RTI_CFLAGS, RTI_LD, RTI_LDFLAGS, RTI_LDLIBS and the equivalent
+ * variables for the C++ APIs) relative to $(NDDSHOME), so a Makefile can
+ * include it instead of invoking connext-config for every variable.
+ *
+ * The variables of the APIs not supported by the target are not defined.
+ * RTI_AR and RTI_NM are defined only if the toolchain options require a 
+ * specific archiver and symbol lister (i.e. --profile=lto).
+ * The compilers are prefixed by the launcher, as in the compiler 
+ * operations.
+ *
+ * \param extra     the toolchain options added by the modifiers, or NULL
+ * \param launcher  the path of the compiler launcher, or NULL for none
+ * \param outFile   the file to write (only if changed), NULL for stdout
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+RTIBool emitMakeFragment(struct Architecture *arch,
+        const char *NDDSHOME,
+        RTIBool isStatic,
+        RTIBool isDebug,
+        RTIBool libMsg,
+        const struct ToolchainFlags *extra,
+        const char *launcher,
+        const char *outFile) {
+    struct ComposeContext ctx;
+    struct ApiSettings settings;
+    char *content = NULL;
+    size_t contentLen = 0;
+    FILE *fp;
+    int i;
+
+    /* Compose using the shell style (that is not affected by the stray
+     * comma of the make style C++03 flags) and convert it afterwards
+     */
+    ComposeContext_init(&ctx, 
+            NDDSHOME, 
+            arch->target, 
+            isStatic, 
+            isDebug, 
+            libMsg, 
+            RTI_FALSE, 
+            RTI_TRUE);
+    ComposeContext_setLauncher(&ctx, arch->target, launcher);
+    if (!ComposeContext_addFlags(&ctx, extra)) {
+        return RTI_FALSE;
+    }
+
+    fp = open_memstream(&content, &contentLen);
+    if (fp == NULL) {
+        fprintf(stderr, "Out of memory allocating make fragment\n");
+        return RTI_FALSE;
+    }
+    fprintf(fp, "# Generated by %s v.%s - do not edit\n", 
+            APPLICATION_NAME, 
+            APPLICATION_VERSION);
+    fprintf(fp, "# RTI Connext DDS build settings for %s%s%s%s\n",
+            arch->target,
+            isStatic ? " --static" : "",
+            isDebug ? " --debug" : "",
+            libMsg ? " --libmsg" : "");
+    fprintf(fp, "NDDSHOME ?= %s\n", NDDSHOME);
+    fprintf(fp, "RTI_TARGET = %s\n", arch->target);
+    fprintf(fp, "RTI_LIB_SUFFIX = %s\n", ctx.libSuffix);
+    if (ctx.extra.ar[0] != '\0') {
+        fprintf(fp, "RTI_AR = %s\n", ctx.extra.ar);
+    }
+    if (ctx.extra.nm[0] != '\0') {
+        fprintf(fp, "RTI_NM = %s\n", ctx.extra.nm);
+    }
+    for (i = 0; API_OPERATIONS[i].name != NULL; ++i) {
+        switch(composeApiSettings(arch, i, &ctx, &settings)) {
+            case ComposeResult_Ok:
+                break;
+            case ComposeResult_Unsupported:
+                fprintf(fp, "# %s not supported\n", API_OPERATIONS[i].description);
+                continue;
+            default:
+                discardGeneratedFile(fp, &content, &contentLen);
+                return RTI_FALSE;
+        }
+        convertVarRefsToMake(settings.comp);
+        convertVarRefsToMake(settings.flags);
+        convertVarRefsToMake(settings.link);
+        convertVarRefsToMake(settings.ldflags);
+        convertVarRefsToMake(settings.ldlibs);
+        fprintf(fp, "%s = %s\n", MAKE_VARIABLES[i].comp, settings.comp);
+        fprintf(fp, "%s = %s\n", MAKE_VARIABLES[i].flags, settings.flags);
+        fprintf(fp, "%s = %s\n", MAKE_VARIABLES[i].link, settings.link);
+        fprintf(fp, "%s = %s\n", MAKE_VARIABLES[i].ldflags, settings.ldflags);
+        fprintf(fp, "%s = %s\n", MAKE_VARIABLES[i].ldlibs, settings.ldlibs);
+    }
+    return writeOutput(fp, &content, &contentLen, outFile);
+}
+
+/* }}} */
+/* {{{ writeShellQuoted
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the given string in single quotes, so it is not subject to any
+ * expansion when evaluated by the shell.
+ */
+void writeShellQuoted(FILE *fp, const char *str) {
+    fputc('\'', fp);
+    for (; *str != '\0'; ++str) {
+        if (*str == '\'') {
+            fputs("'\\''", fp);
+        } else {
+            fputc(*str, fp);
+        }
+    }
+    fputc('\'', fp);
+}
+
+/* }}} */
+/* {{{ composeShellTool
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes a tool of the toolchain options (i.e. the archiver) for the 
+ * shell: with the variables expanded or converted to the shell style.
+ *
+ * \param value     the tool, with the variables as in the platform file
+ * \param expand    RTI_TRUE to expand the environment variables
+ * \param buf       buffer of MAX_CMDLINEARG_SIZE+1 characters that can be
+ *                  used to hold the result
+ * \return          the composed tool
+ */
+static const char * composeShellTool(const char *value, 
+        RTIBool expand, 
+        char *buf) {
+    const char *expanded;
+
+    if (expand) {
+        /* The tools are short: the expansion cannot fail */
+        expanded = expandEnvVar(value);
+        snprintf(buf, MAX_CMDLINEARG_SIZE+1, "%s", (expanded != NULL) ? expanded : value);
+    } else {
+        snprintf(buf, MAX_CMDLINEARG_SIZE+1, "%s", value);
+        convertVarRefsToShell(buf);
+    }
+    return buf;
+}
+
+/* }}} */
+/* {{{ emitShellSettings
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Emits the build settings of an API as shell assignments that can be
+ * evaluated with `eval`:
+ *      CC, LD, CFLAGS, LDFLAGS, LIBS, RTI_LIB_SUFFIX, RTI_TARGET and 
+ *      RTI_TARGET_INSTALLED (yes|no)
+ * and AR and NM if the toolchain options require a specific archiver and
+ * symbol lister (i.e. --profile=lto). CC is prefixed by the launcher, as in
+ * the compiler operations.
+ *
+ * \param apiIdx        the index of the API in API_OPERATIONS
+ * \param extra         the toolchain options added by the modifiers, or NULL
+ * \param launcher      the path of the compiler launcher, or NULL for none
+ * \param outFile       the file to write (only if changed), NULL for stdout
+ * \return              ComposeResult_Ok if success, ComposeResult_Unsupported
+ *                      if the target does not support the API
+ */
+ComposeResult emitShellSettings(struct Architecture *arch,
+        const char *NDDSHOME,
+        int apiIdx,
+        RTIBool isStatic,
+        RTIBool isDebug,
+        RTIBool libMsg,
+        RTIBool expandEnvVar,
+        const struct ToolchainFlags *extra,
+        const char *launcher,
+        const char *outFile) {
+    struct ComposeContext ctx;
+    struct ApiSettings settings;
+    char tool[MAX_CMDLINEARG_SIZE+1];
+    char *content = NULL;
+    size_t contentLen = 0;
+    RTIBool installed;
+    ComposeResult rc;
+    FILE *fp;
+
+    if (!isTargetInstalled(NDDSHOME, arch->target, &installed)) {
+        return ComposeResult_Error;
+    }
+    ComposeContext_init(&ctx, 
+            NDDSHOME, 
+            arch->target, 
+            isStatic, 
+            isDebug, 
+            libMsg, 
+            expandEnvVar, 
+            RTI_TRUE);
+    ComposeContext_setLauncher(&ctx, arch->target, launcher);
+    if (!ComposeContext_addFlags(&ctx, extra)) {
+        return ComposeResult_Error;
+    }
+    rc = composeApiSettings(arch, apiIdx, &ctx, &settings);
+    if (rc != ComposeResult_Ok) {
+        return rc;
+    }
+    if (!expandEnvVar) {
+        convertVarRefsToShell(settings.comp);
+        convertVarRefsToShell(settings.link);
+    }
+
+    fp = open_memstream(&content, &contentLen);
+    if (fp == NULL) {
+        fprintf(stderr, "Out of memory allocating shell settings\n");
+        return ComposeResult_Error;
+    }
+    fprintf(fp, "CC=");
+    writeShellQuoted(fp, settings.comp);
+    fprintf(fp, "\nLD=");
+    writeShellQuoted(fp, settings.link);
+    fprintf(fp, "\nCFLAGS=");
+    writeShellQuoted(fp, settings.flags);
+    fprintf(fp, "\nLDFLAGS=");
+    writeShellQuoted(fp, settings.ldflags);
+    fprintf(fp, "\nLIBS=");
+    writeShellQuoted(fp, settings.ldlibs);
+    if (ctx.extra.ar[0] != '\0') {
+        fprintf(fp, "\nAR=");
+        writeShellQuoted(fp, composeShellTool(ctx.extra.ar, expandEnvVar, tool));
+    }
+    if (ctx.extra.nm[0] != '\0') {
+        fprintf(fp, "\nNM=");
+        writeShellQuoted(fp, composeShellTool(ctx.extra.nm, expandEnvVar, tool));
+    }
+    fprintf(fp, "\nRTI_LIB_SUFFIX=");
+    writeShellQuoted(fp, ctx.libSuffix);
+    fprintf(fp, "\nRTI_TARGET=");
+    writeShellQuoted(fp, arch->target);
+    fprintf(fp, "\nRTI_TARGET_INSTALLED=%s\n", installed ? "yes" : "no");
+    return writeOutput(fp, &content, &contentLen, outFile) ? 
+            ComposeResult_Ok : ComposeResult_Error;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * Whole-matrix Verification
+ **************************************************************************/
+/* --verify-all composes every operation (VALID_WHAT) with every combination
+ * of modifiers (LIB_VARIANTS x VERIFY_EXPAND_MODES) for every target and
+ * reports the compositions that fail, like the overflow of the command
+ * line, unterminated $( references or properties of the wrong type.
+ *
+ * The targets are split across worker processes forked after the platform
+ * file is parsed (the parsed table is shared copy-on-write). Each worker
+ * redirects its stderr to a temporary file to capture the error message of
+ * each failed composition, and writes to its result file one line for each
+ * distinct error of a target:
+ *      <target index> TAB <count> TAB <first combination> TAB <message>
+ * followed by a summary line:
+ *      # TAB <compositions> TAB <failures>
+ * Worker w verifies the targets w, w+jobs, w+2*jobs, ... in order, so the
+ * parent merges the result files in the order of the targets.
+ */
+#define VERIFY_MAX_ERRORS_PER_TARGET    16
+#define VERIFY_MAX_MESSAGE_SIZE         512
+
+/* Expansion modes verified for each library variant */
+static const struct {
+    const char  *label;
+    RTIBool     expandEnvVar;
+    RTIBool     shell;
+} VERIFY_EXPAND_MODES[] = {
+    { "",                   RTI_TRUE,   RTI_FALSE },
+    { " --noexpand",        RTI_FALSE,  RTI_FALSE },
+    { " --noexpand --sh",   RTI_FALSE,  RTI_TRUE },
+    { NULL,                 RTI_FALSE,  RTI_FALSE }
+};
+
+/* A distinct error of a target */
+struct VerifyError {
+    char                        message[VERIFY_MAX_MESSAGE_SIZE];
+    char                        first[MAX_STRING_SIZE];
+    unsigned int                count;
+};
+
+/* {{{ readCapturedError
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Reads the messages printed to stderr (redirected to a file) since the last
+ * call as a single line, then empties the file.
+ */
+static void readCapturedError(char *bufOut, size_t bufSize) {
+    ssize_t rd;
+    ssize_t i;
+
+    rd = pread(STDERR_FILENO, bufOut, bufSize-1, 0);
+    if (rd < 0) {
+        rd = 0;
+    }
+    for (i = 0; i < rd; ++i) {
+        if ((bufOut[i] == '\n') || (bufOut[i] == '\t')) {
+            bufOut[i] = ' ';
+        }
+    }
+    while ((rd > 0) && (bufOut[rd-1] == ' ')) {
+        --rd;
+    }
+    bufOut[rd] = '\0';
+    if (rd == 0) {
+        snprintf(bufOut, bufSize, "composition failed");
+    }
+    if (ftruncate(STDERR_FILENO, 0) == 0) {
+        lseek(STDERR_FILENO, 0, SEEK_SET);
+    }
+}
+
+/* }}} */
+/* {{{ verifyTarget
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes all the operations with all the modifiers for the given target
+ * and writes its distinct errors to the result file of the worker.
+ * Must be called with stderr redirected to a file.
+ *
+ * \param out           the result file of the worker
+ * \param index         the index of the target
+ * \param arch          the target
+ * \param NDDSHOME      the NDDSHOME directory
+ * \param ctx           a ComposeContext to use
+ * \param buf           a buffer of MAX_CMDLINEARG_SIZE+1 bytes to use
+ * \param compositions  incremented by the number of compositions
+ * \param failures      incremented by the number of failed compositions
+ */
+static void verifyTarget(FILE *out,
+        int index,
+        struct Architecture *arch,
+        const char *NDDSHOME,
+        struct ComposeContext *ctx,
+        char *buf,
+        unsigned long *compositions,
+        unsigned long *failures) {
+    struct VerifyError errors[VERIFY_MAX_ERRORS_PER_TARGET];
+    char message[VERIFY_MAX_MESSAGE_SIZE];
+    unsigned int typeErrors;
+    int errorCount = 0;
+    ComposeResult rc;
+    int v;
+    int m;
+    int w;
+    int e;
+
+    for (v = 0; LIB_VARIANTS[v].name != NULL; ++v) {
+        for (m = 0; VERIFY_EXPAND_MODES[m].label != NULL; ++m) {
+            ComposeContext_init(ctx,
+                    NDDSHOME,
+                    arch->target,
+                    LIB_VARIANTS[v].isStatic,
+                    LIB_VARIANTS[v].isDebug,
+                    LIB_VARIANTS[v].libMsg,
+                    VERIFY_EXPAND_MODES[m].expandEnvVar,
+                    VERIFY_EXPAND_MODES[m].shell);
+            for (w = 0; VALID_WHAT[w] != NULL; ++w) {
+                typeErrors = theTypeErrors;
+                rc = composeOperation(arch, 
+                        VALID_WHAT[w], 
+                        ctx, 
+                        buf, 
+                        MAX_CMDLINEARG_SIZE+1);
+                ++*compositions;
+                if ((rc != ComposeResult_Error) && 
+                        (theTypeErrors == typeErrors)) {
+                    continue;
+                }
+                ++*failures;
+                readCapturedError(message, sizeof(message));
+                for (e = 0; e < errorCount; ++e) {
+                    if (strcmp(errors[e].message, message) == 0) {
+                        break;
+                    }
+                }
+                if (e < errorCount) {
+                    ++errors[e].count;
+                    continue;
+                }
+                if (errorCount == VERIFY_MAX_ERRORS_PER_TARGET) {
+                    /* Counted in the last error */
+                    ++errors[errorCount-1].count;
+                    continue;
+                }
+                snprintf(errors[e].message, sizeof(errors[e].message),
+                        "%s", message);
+                snprintf(errors[e].first, sizeof(errors[e].first),
+                        "%s%s%s%s%s",
+                        VALID_WHAT[w],
+                        LIB_VARIANTS[v].isStatic ? " --static" : "",
+                        LIB_VARIANTS[v].isDebug ? " --debug" : "",
+                        LIB_VARIANTS[v].libMsg ? " --libmsg" : "",
+                        VERIFY_EXPAND_MODES[m].label);
+                errors[e].count = 1;
+                ++errorCount;
+            }
+        }
+    }
+    for (e = 0; e < errorCount; ++e) {
+        fprintf(out, "%d\t%u\t%s\t%s\n",
+                index,
+                errors[e].count,
+                errors[e].first,
+                errors[e].message);
+    }
+}
+
+/* }}} */
+/* {{{ verifyWorker
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Body of the worker process 'worker' of 'jobs': verifies its targets and
+ * exits.
+ */
+static void verifyWorker(FILE *out,
+        struct Architecture **archs,
+        int archCount,
+        int worker,
+        int jobs,
+        const char *NDDSHOME) {
+    struct ComposeContext *ctx;
+    char *buf;
+    FILE *errFile;
+    unsigned long compositions = 0;
+    unsigned long failures = 0;
+    int i;
+
+    errFile = tmpfile();
+    ctx = MEM_CALLOC(Compose, 1, sizeof(*ctx));
+    buf = MEM_CALLOC(Compose, MAX_CMDLINEARG_SIZE+1, 1);
+    if ((errFile == NULL) || (ctx == NULL) || (buf == NULL)) {
+        fprintf(stderr, "Error: failed to initialize verification worker %d\n",
+                worker);
+        _exit(APPLICATION_EXIT_FAILURE);
+    }
+    if (dup2(fileno(errFile), STDERR_FILENO) == -1) {
+        fprintf(stderr, "Error: failed to redirect stderr: %s\n",
+                strerror(errno));
+        _exit(APPLICATION_EXIT_FAILURE);
+    }
+    theCountTypeErrors = RTI_TRUE;
+    for (i = worker; i < archCount; i += jobs) {
+        verifyTarget(out, 
+                i, 
+                archs[i], 
+                NDDSHOME, 
+                ctx, 
+                buf, 
+                &compositions, 
+                &failures);
+    }
+    fprintf(out, "#\t%lu\t%lu\n", compositions, failures);
+    _exit((fflush(out) == 0) ? 
+            APPLICATION_EXIT_SUCCESS : APPLICATION_EXIT_FAILURE);
+}
+
+/* }}} */
+/* {{{ verifyAll
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Implements --verify-all: verifies all the targets with the given number
+ * of worker processes (0 = one per online CPU) and prints the errors of
+ * each target and a summary to stdout.
+ *
+ * \param archDef   the list of parsed architectures
+ * \param NDDSHOME  the NDDSHOME directory
+ * \param jobs      the number of worker processes
+ * \return          RTI_TRUE if all the compositions succeeded, RTI_FALSE
+ *                  if any failed or an error occurred
+ */
+static RTIBool verifyAll(struct REDAInlineList *archDef,
+        const char *NDDSHOME,
+        int jobs) {
+    struct REDAInlineListNode *node;
+    struct Architecture **archs = NULL;
+    FILE **results = NULL;
+    pid_t *pids = NULL;
+    char **pending = NULL;
+    size_t *pendingSize = NULL;
+    int archCount = 0;
+    unsigned long compositions = 0;
+    unsigned long failures = 0;
+    int failedTargets = 0;
+    RTIBool ok = RTI_FALSE;
+    int status;
+    int i;
+    int w;
+
+    for (node = REDAInlineList_getFirst(archDef); 
+            node != NULL; 
+            node = REDAInlineListNode_getNext(node)) {
+        ++archCount;
+    }
+    if (archCount == 0) {
+        fprintf(stderr, "Error: no architectures to verify\n");
+        return RTI_FALSE;
+    }
+    if (jobs <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        jobs = (cpus > 0) ? (int)cpus : 1;
+    }
+    if (jobs > archCount) {
+        jobs = archCount;
+    }
+
+    archs = MEM_CALLOC(Compose, (size_t)archCount, sizeof(*archs));
+    results = MEM_CALLOC(Compose, (size_t)jobs, sizeof(*results));
+    pids = MEM_CALLOC(Compose, (size_t)jobs, sizeof(*pids));
+    pending = MEM_CALLOC(Compose, (size_t)jobs, sizeof(*pending));
+    pendingSize = MEM_CALLOC(Compose, (size_t)jobs, sizeof(*pendingSize));
+    if ((archs == NULL) || (results == NULL) || (pids == NULL) ||
+            (pending == NULL) || (pendingSize == NULL)) {
+        fprintf(stderr, "Out of memory allocating the verification workers\n");
+        goto done;
+    }
+    i = 0;
+    for (node = REDAInlineList_getFirst(archDef); 
+            node != NULL; 
+            node = REDAInlineListNode_getNext(node)) {
+        archs[i++] = (struct Architecture *)node;
+    }
+
+    /* Start the workers */
+    fflush(stdout);
+    fflush(stderr);
+    for (w = 0; w < jobs; ++w) {
+        results[w] = tmpfile();
+        if (results[w] == NULL) {
+            fprintf(stderr, "Error: failed to create temporary file: %s\n",
+                    strerror(errno));
+            break;
+        }
+        pids[w] = fork();
+        if (pids[w] == -1) {
+            fprintf(stderr, "Error: fork failed: %s\n", strerror(errno));
+            fclose(results[w]);
+            results[w] = NULL;
+            break;
+        }
+        if (pids[w] == 0) {
+            verifyWorker(results[w], archs, archCount, w, jobs, NDDSHOME);
+        }
+    }
+    ok = (w == jobs) ? RTI_TRUE : RTI_FALSE;
+    jobs = w;
+    for (w = 0; w < jobs; ++w) {
+        if ((waitpid(pids[w], &status, 0) == -1) || 
+                !WIFEXITED(status) || 
+                (WEXITSTATUS(status) != APPLICATION_EXIT_SUCCESS)) {
+            fprintf(stderr, "Error: verification worker %d failed\n", w);
+            ok = RTI_FALSE;
+        }
+    }
+    if (!ok) {
+        goto done;
+    }
+
+    /* Merge the results in the order of the targets */
+    for (w = 0; w < jobs; ++w) {
+        rewind(results[w]);
+        if (getline(&pending[w], &pendingSize[w], results[w]) == -1) {
+            fprintf(stderr, "Error: missing results of worker %d\n", w);
+            ok = RTI_FALSE;
+            goto done;
+        }
+    }
+    for (i = 0; i < archCount; ++i) {
+        RTIBool targetFailed = RTI_FALSE;
+        w = i % jobs;
+        while ((pending[w][0] != '#') && (atoi(pending[w]) == i)) {
+            char *count = strchr(pending[w], '\t') + 1;
+            char *first = strchr(count, '\t') + 1;
+            char *message = strchr(first, '\t') + 1;
+
+            first[-1] = '\0';
+            message[-1] = '\0';
+            message[strcspn(message, "\n")] = '\0';
+            printf("%s: %s\n    (%s compositions, first: %s)\n",
+                    archs[i]->target,
+                    message,
+                    count,
+                    first);
+            targetFailed = RTI_TRUE;
+            if (getline(&pending[w], &pendingSize[w], results[w]) == -1) {
+                fprintf(stderr, "Error: truncated results of worker %d\n", w);
+                ok = RTI_FALSE;
+                goto done;
+            }
+        }
+        if (targetFailed) {
+            ++failedTargets;
+        }
+    }
+    for (w = 0; w < jobs; ++w) {
+        unsigned long c = 0;
+        unsigned long f = 0;
+        if (sscanf(pending[w], "#\t%lu\t%lu", &c, &f) != 2) {
+            fprintf(stderr, "Error: invalid results of worker %d\n", w);
+            ok = RTI_FALSE;
+            goto done;
+        }
+        compositions += c;
+        failures += f;
+    }
+    printf("Verified %lu compositions of %d targets with %d workers: "
+            "%lu failed in %d targets\n",
+            compositions,
+            archCount,
+            jobs,
+            failures,
+            failedTargets);
+    ok = (failures == 0) ? RTI_TRUE : RTI_FALSE;
+
+done:
+    for (w = 0; (results != NULL) && (w < jobs); ++w) {
+        if (results[w] != NULL) {
+            fclose(results[w]);
+        }
+        /* Allocated by getline() */
+        free(pending[w]);
+    }
+    MEM_FREE(archs);
+    MEM_FREE(results);
+    MEM_FREE(pids);
+    MEM_FREE(pending);
+    MEM_FREE(pendingSize);
+    return ok;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * Invocation Trace
+ **************************************************************************/
+/* When the environment variable CONNEXT_CONFIG_TRACE is set to a file path,
+ * every invocation appends one binary record to that file: start time,
+ * duration, pid and process group, exit code, arguments, resolved target,
+ * operation and cache result.
+ *
+ * The file is opened with O_APPEND and each record is written with a single
+ * write() call, so concurrent invocations (i.e. parallel builds) never
+ * interleave their records without requiring any lock.
+ *
+ * Records use the native byte order, and start with a header followed by
+ * the NUL-terminated strings: the arguments (argv[1..argc-1]), the target
+ * and the operation. Arguments that do not fit in TRACE_MAX_RECORD_SIZE are
+ * truncated.
+ *
+ * --trace-report [FILE] aggregates the records in a summary.
+ */
+#define TRACE_ENV_VARIABLE          "CONNEXT_CONFIG_TRACE"
+#define TRACE_RECORD_MAGIC          0x52544343      /* "CCTR" */
+#define TRACE_RECORD_VERSION        1
+#define TRACE_MAX_RECORD_SIZE       4096
+
+/* Number of queries listed as the most duplicated by the report */
+#define TRACE_REPORT_TOP_QUERIES    10
+
+typedef enum {
+    TraceCache_None = 0,        /* No cache involved in the invocation */
+    TraceCache_Hit,
+    TraceCache_Miss
+} TraceCache;
+
+struct TraceRecordHeader {
+    uint32_t                    magic;
+    uint16_t                    version;
+    uint16_t                    size;       /* Header + strings */
+    uint64_t                    timestampNs;    /* CLOCK_REALTIME at start */
+    uint64_t                    durationNs;
+    int32_t                     pid;
+    int32_t                     pgid;
+    int32_t                     exitCode;
+    uint8_t                     cache;      /* TraceCache */
+    uint8_t                     argc;       /* Arguments recorded */
+    uint16_t                    argsLen;    /* NUL included */
+    uint16_t                    targetLen;  /* NUL included */
+    uint16_t                    opLen;      /* NUL included */
+    uint32_t                    reserved;
+};
+
+struct Trace {
+    RTIBool                     enabled;
+    const char                  *path;
+    struct timespec             startReal;
+    struct timespec             startMono;
+    TraceCache                  cache;
+    int                         argc;
+    size_t                      argsLen;
+    char                        args[TRACE_MAX_RECORD_SIZE];
+};
+
+static struct Trace theTrace;
+
+/* {{{ Trace_begin
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Starts tracing the invocation if CONNEXT_CONFIG_TRACE is set.
+ * Must be called before the arguments are modified.
+ */
+static void Trace_begin(int argc, char **argv) {
+    size_t maxArgsLen = TRACE_MAX_RECORD_SIZE - 
+            sizeof(struct TraceRecordHeader) - 2 * MAX_STRING_SIZE;
+    int i;
+
+    theTrace.path = getenv(TRACE_ENV_VARIABLE);
+    if ((theTrace.path == NULL) || (theTrace.path[0] == '\0') || 
+            ((argc > 1) && (strcmp(argv[1], "--trace-report") == 0))) {
+        return;
+    }
+    theTrace.enabled = RTI_TRUE;
+    clock_gettime(CLOCK_REALTIME, &theTrace.startReal);
+    clock_gettime(CLOCK_MONOTONIC, &theTrace.startMono);
+
+    for (i = 1; (i < argc) && (theTrace.argc < UINT8_MAX); ++i) {
+        size_t len = strlen(argv[i]) + 1;
+        if (theTrace.argsLen + len > maxArgsLen) {
+            break;
+        }
+        memcpy(&theTrace.args[theTrace.argsLen], argv[i], len);
+        theTrace.argsLen += len;
+        ++theTrace.argc;
+    }
+}
+
+/* }}} */
+/* {{{ Trace_end
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Appends the record of the invocation to the trace file (if enabled)
+ *
+ * \param op        the operation (NULL if not identified)
+ * \param target    the target (NULL if none)
+ * \param exitCode  the exit code of the application
+ */
+static void Trace_end(const char *op, const char *target, int exitCode) {
+    char record[TRACE_MAX_RECORD_SIZE];
+    struct TraceRecordHeader hdr;
+    struct timespec now;
+    size_t wr;
+    int fd;
+
+    if (!theTrace.enabled) {
+        return;
+    }
+    /* Only one record per invocation: the wrappers write it before exec */
+    theTrace.enabled = RTI_FALSE;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (op == NULL) {
+        op = "";
+    }
+    if (target == NULL) {
+        target = "";
+    }
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = TRACE_RECORD_MAGIC;
+    hdr.version = TRACE_RECORD_VERSION;
+    hdr.timestampNs = (uint64_t)theTrace.startReal.tv_sec * 1000000000ULL + 
+            (uint64_t)theTrace.startReal.tv_nsec;
+    hdr.durationNs = (uint64_t)(now.tv_sec - theTrace.startMono.tv_sec) * 1000000000ULL + 
+            (uint64_t)now.tv_nsec - (uint64_t)theTrace.startMono.tv_nsec;
+    hdr.pid = (int32_t)getpid();
+    hdr.pgid = (int32_t)getpgrp();
+    hdr.exitCode = exitCode;
+    hdr.cache = (uint8_t)theTrace.cache;
+    hdr.argc = (uint8_t)theTrace.argc;
+    hdr.argsLen = (uint16_t)theTrace.argsLen;
+    hdr.targetLen = (uint16_t)(strnlen(target, MAX_STRING_SIZE-1) + 1);
+    hdr.opLen = (uint16_t)(strnlen(op, MAX_STRING_SIZE-1) + 1);
+    hdr.size = (uint16_t)(sizeof(hdr) + hdr.argsLen + hdr.targetLen + hdr.opLen);
+
+    wr = sizeof(hdr);
+    memcpy(&record[wr], theTrace.args, hdr.argsLen);
+    wr += hdr.argsLen;
+    memcpy(&record[wr], target, hdr.targetLen - 1);
+    wr += hdr.targetLen;
+    record[wr-1] = '\0';
+    memcpy(&record[wr], op, hdr.opLen - 1);
+    wr += hdr.opLen;
+    record[wr-1] = '\0';
+    memcpy(record, &hdr, sizeof(hdr));
+
+    fd = open(theTrace.path, O_WRONLY | O_APPEND | O_CREAT, 0666);
+    if (fd == -1) {
+        fprintf(stderr, "Warning: cannot open trace file '%s': %s\n",
+                theTrace.path, 
+                strerror(errno));
+        return;
+    }
+    if (write(fd, record, wr) != (ssize_t)wr) {
+        fprintf(stderr, "Warning: cannot write trace file '%s': %s\n",
+                theTrace.path, 
+                strerror(errno));
+    }
+    close(fd);
+}
+
+/* }}} */
+/* A counter indexed by string, used to aggregate the trace records */
+struct TraceCounter {
+    char                        *key;       /* NULL if the slot is free */
+    unsigned long               count;
+    unsigned long long          totalNs;
+};
+
+struct TraceCounterTable {
+    struct TraceCounter         *slots;
+    size_t                      size;       /* Always a power of 2 */
+    size_t                      count;
+};
+
+#define TRACE_COUNTER_TABLE_INITIAL_SIZE    256
+
+/* {{{ TraceCounterTable_finalize
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+void TraceCounterTable_finalize(struct TraceCounterTable *me) {
+    size_t i;
+    for (i = 0; i < me->size; ++i) {
+        MEM_FREE(me->slots[i].key);
+    }
+    MEM_FREE(me->slots);
+    memset(me, 0, sizeof(*me));
+}
+
+/* }}} */
+/* {{{ TraceCounterTable_get
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the counter of the given key, adding it (with count 0) if not
+ * present. The table grows when half full.
+ *
+ * \return          the counter, or NULL if out of memory
+ */
+struct TraceCounter *TraceCounterTable_get(struct TraceCounterTable *me, 
+        const char *key) {
+    size_t i;
+
+    if (me->count * 2 >= me->size) {
+        size_t newSize = (me->size == 0) ? 
+                TRACE_COUNTER_TABLE_INITIAL_SIZE : me->size * 2;
+        struct TraceCounter *newSlots = MEM_CALLOC(Trace, newSize, sizeof(*newSlots));
+        if (newSlots == NULL) {
+            fprintf(stderr, "Out of memory growing the trace counters\n");
+            return NULL;
+        }
+        for (i = 0; i < me->size; ++i) {
+            if (me->slots[i].key != NULL) {
+                size_t j = hashString(me->slots[i].key) & (newSize-1);
+                while (newSlots[j].key != NULL) {
+                    j = (j + 1) & (newSize-1);
+                }
+                newSlots[j] = me->slots[i];
+            }
+        }
+        MEM_FREE(me->slots);
+        me->slots = newSlots;
+        me->size = newSize;
+    }
+    for (i = hashString(key) & (me->size-1); 
+            me->slots[i].key != NULL; 
+            i = (i + 1) & (me->size-1)) {
+        if (strcmp(me->slots[i].key, key) == 0) {
+            return &me->slots[i];
+        }
+    }
+    me->slots[i].key = MEM_STRDUP(Trace, key);
+    if (me->slots[i].key == NULL) {
+        fprintf(stderr, "Out of memory adding a trace counter\n");
+        return NULL;
+    }
+    ++me->count;
+    return &me->slots[i];
+}
+
+/* }}} */
+/* {{{ compareTraceCountersByCount
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * qsort comparator: free slots last, then by count (descending), then by key
+ */
+static int compareTraceCountersByCount(const void *a, const void *b) {
+    const struct TraceCounter *ca = (const struct TraceCounter *)a;
+    const struct TraceCounter *cb = (const struct TraceCounter *)b;
+    if ((ca->key == NULL) || (cb->key == NULL)) {
+        return (ca->key == NULL) - (cb->key == NULL);
+    }
+    if (ca->count != cb->count) {
+        return (ca->count < cb->count) ? 1 : -1;
+    }
+    return strcmp(ca->key, cb->key);
+}
+
+/* }}} */
+/* {{{ formatTraceQuery
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes in bufOut the arguments of a record separated by spaces, followed
+ * by the target (if it was not in the arguments, i.e. from $NDDSARCH)
+ */
+static void formatTraceQuery(const struct TraceRecordHeader *hdr,
+        const char *args,
+        const char *target,
+        char *bufOut,
+        size_t bufSize) {
+    RTIBool targetInArgs = RTI_FALSE;
+    size_t wr = 0;
+    int i;
+
+    bufOut[0] = '\0';
+    for (i = 0; i < hdr->argc; ++i) {
+        if (strcmp(args, target) == 0) {
+            targetInArgs = RTI_TRUE;
+        }
+        if (wr < bufSize - 1) {
+            /* Truncated queries stop at the end of the buffer */
+            wr += (size_t)snprintf(&bufOut[wr], bufSize - wr,
+                    "%s%s", (i == 0) ? "" : " ", args);
+            if (wr > bufSize - 1) {
+                wr = bufSize - 1;
+            }
+        }
+        args += strlen(args) + 1;
+    }
+    if (!targetInArgs && (target[0] != '\0') && (wr < bufSize - 1)) {
+        snprintf(&bufOut[wr], bufSize - wr, " [NDDSARCH=%s]", target);
+    }
+}
+
+/* }}} */
+/* {{{ traceReport
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Reads the trace file and prints to stdout the summary of the invocations:
+ * totals, runs (invocations from the same process group, i.e. the same
+ * configure or make), duplicate queries and the time of each operation.
+ *
+ * \param path      the trace file
+ * \return          the application exit code
+ */
+int traceReport(const char *path) {
+    struct TraceCounterTable runs;      /* pgid -> invocations */
+    struct TraceCounterTable runQueries; /* pgid + query -> invocations */
+    struct TraceCounterTable queries;   /* query -> invocations */
+    struct TraceCounterTable ops;       /* operation -> invocations */
+    unsigned long records = 0;
+    unsigned long failed = 0;
+    unsigned long cacheHits = 0;
+    unsigned long cacheMisses = 0;
+    unsigned long runDuplicates = 0;
+    unsigned long long runDuplicatesNs = 0;
+    unsigned long long totalNs = 0;
+    unsigned long long maxNs = 0;
+    unsigned long long firstTs = 0;
+    unsigned long long lastTs = 0;
+    unsigned long minPerRun = 0;
+    unsigned long maxPerRun = 0;
+    char *data = NULL;
+    size_t dataLen = 0;
+    size_t rd = 0;
+    char query[MAX_CMDLINEARG_SIZE];
+    char key[MAX_CMDLINEARG_SIZE + 32];
+    int retCode = APPLICATION_EXIT_FAILURE;
+    struct stat info;
+    FILE *fp = NULL;
+    size_t i;
+
+    memset(&runs, 0, sizeof(runs));
+    memset(&runQueries, 0, sizeof(runQueries));
+    memset(&queries, 0, sizeof(queries));
+    memset(&ops, 0, sizeof(ops));
+
+    if ((path == NULL) || (path[0] == '\0')) {
+        fprintf(stderr, "Error: trace file not specified and %s not defined\n",
+                TRACE_ENV_VARIABLE);
+        return APPLICATION_EXIT_INVALID_ARGS;
+    }
+    fp = fopen(path, "rb");
+    if ((fp == NULL) || (fstat(fileno(fp), &info) != 0)) {
+        fprintf(stderr, "Error: cannot open trace file '%s': %s\n",
+                path, 
+                strerror(errno));
+        goto done;
+    }
+    dataLen = (size_t)info.st_size;
+    data = MEM_MALLOC(Trace, dataLen + 1);
+    if (data == NULL) {
+        fprintf(stderr, "Out of memory reading trace file '%s'\n", path);
+        goto done;
+    }
+    if (fread(data, 1, dataLen, fp) != dataLen) {
+        fprintf(stderr, "Error: failed to read trace file '%s'\n", path);
+        goto done;
+    }
+
+    while (rd + sizeof(struct TraceRecordHeader) <= dataLen) {
+        struct TraceRecordHeader hdr;
+        struct TraceCounter *counter;
+        const char *args;
+        const char *target;
+        const char *op;
+
+        memcpy(&hdr, &data[rd], sizeof(hdr));
+        if ((hdr.magic != TRACE_RECORD_MAGIC) || 
+                (hdr.version != TRACE_RECORD_VERSION) ||
+                (hdr.size != sizeof(hdr) + hdr.argsLen + hdr.targetLen + hdr.opLen) ||
+                (hdr.targetLen == 0) || (hdr.opLen == 0) ||
+                (rd + hdr.size > dataLen) ||
+                (data[rd + hdr.size - 1] != '\0')) {
+            break;
+        }
+        args = &data[rd + sizeof(hdr)];
+        target = args + hdr.argsLen;
+        op = target + hdr.targetLen;
+        rd += hdr.size;
+
+        ++records;
+        if (hdr.exitCode != 0) {
+            ++failed;
+        }
+        if (hdr.cache == TraceCache_Hit) {
+            ++cacheHits;
+        } else if (hdr.cache == TraceCache_Miss) {
+            ++cacheMisses;
+        }
+        totalNs += hdr.durationNs;
+        if (hdr.durationNs > maxNs) {
+            maxNs = hdr.durationNs;
+        }
+        if ((firstTs == 0) || (hdr.timestampNs < firstTs)) {
+            firstTs = hdr.timestampNs;
+        }
+        if (hdr.timestampNs > lastTs) {
+            lastTs = hdr.timestampNs;
+        }
+
+        formatTraceQuery(&hdr, args, target, query, sizeof(query));
+        snprintf(key, sizeof(key), "%d", (int)hdr.pgid);
+        if ((counter = TraceCounterTable_get(&runs, key)) == NULL) {
+            goto done;
+        }
+        ++counter->count;
+        counter->totalNs += hdr.durationNs;
+
+        snprintf(key, sizeof(key), "%d %s", (int)hdr.pgid, query);
+        if ((counter = TraceCounterTable_get(&runQueries, key)) == NULL) {
+            goto done;
+        }
+        if (counter->count++ > 0) {
+            ++runDuplicates;
+            runDuplicatesNs += hdr.durationNs;
+        }
+
+        if ((counter = TraceCounterTable_get(&queries, query)) == NULL) {
+            goto done;
+        }
+        ++counter->count;
+        counter->totalNs += hdr.durationNs;
+
+        if ((counter = TraceCounterTable_get(&ops, 
+                    (op[0] != '\0') ? op : "(none)")) == NULL) {
+            goto done;
+        }
+        ++counter->count;
+        counter->totalNs += hdr.durationNs;
+    }
+    if (rd != dataLen) {
+        fprintf(stderr, 
+                "Warning: trace file '%s' truncated or corrupted at offset %lu\n",
+                path, 
+                (unsigned long)rd);
+    }
+
+    printf("Trace file:           %s\n", path);
+    printf("Invocations:          %lu (%lu failed)\n", records, failed);
+    if (records == 0) {
+        retCode = APPLICATION_EXIT_SUCCESS;
+        goto done;
+    }
+    printf("Period:               %.3f s\n", (double)(lastTs - firstTs) / 1e9);
+    printf("Total time:           %.3f ms (avg %.3f ms, max %.3f ms)\n",
+            (double)totalNs / 1e6,
+            (double)totalNs / 1e6 / (double)records,
+            (double)maxNs / 1e6);
+    for (i = 0; i < runs.size; ++i) {
+        if (runs.slots[i].key == NULL) {
+            continue;
+        }
+        if ((minPerRun == 0) || (runs.slots[i].count < minPerRun)) {
+            minPerRun = runs.slots[i].count;
+        }
+        if (runs.slots[i].count > maxPerRun) {
+            maxPerRun = runs.slots[i].count;
+        }
+    }
+    printf("Runs:                 %lu process groups, calls per run min %lu, avg %.1f, max %lu\n",
+            (unsigned long)runs.count,
+            minPerRun,
+            (double)records / (double)runs.count,
+            maxPerRun);
+    printf("Distinct queries:     %lu\n", (unsigned long)queries.count);
+    printf("Duplicate queries:    %lu within the same run (%.1f%%, %.3f ms), "
+            "%lu overall (%.1f%%)\n",
+            runDuplicates,
+            100.0 * (double)runDuplicates / (double)records,
+            (double)runDuplicatesNs / 1e6,
+            records - (unsigned long)queries.count,
+            100.0 * (double)(records - queries.count) / (double)records);
+    printf("Cache:                %lu hits, %lu misses, %lu not cached\n",
+            cacheHits,
+            cacheMisses,
+            records - cacheHits - cacheMisses);
+
+    printf("\n%-24s %10s %14s %12s\n", "operation", "calls", "total (ms)", "avg (ms)");
+    qsort(ops.slots, ops.size, sizeof(*ops.slots), compareTraceCountersByCount);
+    for (i = 0; (i < ops.size) && (ops.slots[i].key != NULL); ++i) {
+        printf("%-24s %10lu %14.3f %12.3f\n",
+                ops.slots[i].key,
+                ops.slots[i].count,
+                (double)ops.slots[i].totalNs / 1e6,
+                (double)ops.slots[i].totalNs / 1e6 / (double)ops.slots[i].count);
+    }
+
+    printf("\n%10s %14s  %s\n", "calls", "total (ms)", "most repeated queries");
+    qsort(queries.slots, queries.size, sizeof(*queries.slots), compareTraceCountersByCount);
+    for (i = 0; (i < TRACE_REPORT_TOP_QUERIES) && (i < queries.size) && 
+            (queries.slots[i].key != NULL); ++i) {
+        printf("%10lu %14.3f  %s\n",
+                queries.slots[i].count,
+                (double)queries.slots[i].totalNs / 1e6,
+                queries.slots[i].key);
+    }
+    retCode = APPLICATION_EXIT_SUCCESS;
+
+done:
+    if (fp != NULL) {
+        fclose(fp);
+    }
+    MEM_FREE(data);
+    TraceCounterTable_finalize(&runs);
+    TraceCounterTable_finalize(&runQueries);
+    TraceCounterTable_finalize(&queries);
+    TraceCounterTable_finalize(&ops);
+    return retCode;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * Toolchain Probes
+ **************************************************************************/
+/* The options that depend on the toolchain (i.e. --profile) are composed 
+ * from the family and the version of the compiler, that are probed by 
+ * running the compiler installed on the host (`<compiler> --version`). When
+ * the compiler of the target is not installed (i.e. cross-compilers on a
+ * build server that does not use them) they are derived from the names of
+ * the compiler and of the target, see getCompilerFamily.
+ *
+ * The results of the probes are cached in the directory given by the 
+ * environment variable CONNEXT_CONFIG_CACHE (default: 
+ * $XDG_CACHE_HOME/connext-config or ~/.cache/connext-config; set it to an
+ * empty string to disable the cache), one file per probe, named after a
+ * hash of the kind of probe and of the path, modification time and size of
+ * the probed executable, so the result is invalidated when the toolchain 
+ * is updated. Cache hits and misses are recorded in the invocation trace.
+ */
+#define PROBE_CACHE_ENV_VARIABLE    "CONNEXT_CONFIG_CACHE"
+#define PROBE_CACHE_DIR_NAME        "connext-config"
+#define PROBE_MAX_OUTPUT            4096
+
+static const char *COMPILER_FAMILY_NAMES[] = {
+    "other",        /* CompilerFamily_Other */
+    "gcc",          /* CompilerFamily_Gcc */
+    "clang",        /* CompilerFamily_Clang */
+    NULL
+};
+
+/* {{{ splitCommandWords
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Splits in place a composed string into words, the same way a POSIX shell
+ * does: words are separated by white spaces, single quotes preserve all 
+ * the characters, double quotes preserve all the characters except the 
+ * backslash escapes of $ ` " \ and an unquoted backslash preserves the next
+ * character. Quotes and backslashes are removed.
+ *
+ * \param str       the string to split, modified to hold the words
+ * \param words     array that receives the pointers to the words
+ * \param maxWords  capacity of words
+ * \return          the number of words or -1 if a quote is not terminated
+ *                  or there are too many words.
+ */
+static int splitCommandWords(char *str, char **words, int maxWords) {
+    char *rd = str;
+    char *wr = str;
+    char quote;
+    int count = 0;
+
+    for (;;) {
+        while (isspace((unsigned char)*rd)) {
+            ++rd;
+        }
+        if (*rd == '\0') {
+            return count;
+        }
+        if (count == maxWords) {
+            return -1;
+        }
+        words[count++] = wr;
+        quote = '\0';
+        for (; *rd != '\0'; ++rd) {
+            if ((quote == '\0') && isspace((unsigned char)*rd)) {
+                break;
+            }
+            if ((quote != '\0') && (*rd == quote)) {
+                quote = '\0';
+                continue;
+            }
+            if ((quote == '\0') && ((*rd == '\'') || (*rd == '"'))) {
+                quote = *rd;
+                continue;
+            }
+            if ((*rd == '\\') && (*(rd+1) != '\0') && ((quote == '\0') || 
+                    ((quote == '"') && (strchr("$`\"\\", *(rd+1)) != NULL)))) {
+                ++rd;
+            }
+            *wr++ = *rd;
+        }
+        if (quote != '\0') {
+            return -1;
+        }
+        if (*rd != '\0') {
+            ++rd;
+        }
+        *wr++ = '\0';
+    }
+}
+
+/* }}} */
+/* {{{ getProbeCacheDir
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Determines the directory of the probe cache.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if the cache is disabled
+ */
+static RTIBool getProbeCacheDir(char *dirOut, size_t dirSize) {
+    const char *dir = getenv(PROBE_CACHE_ENV_VARIABLE);
+    int n;
+
+    if (dir != NULL) {
+        n = snprintf(dirOut, dirSize, "%s", dir);
+    } else if (((dir = getenv("XDG_CACHE_HOME")) != NULL) && (dir[0] != '\0')) {
+        n = snprintf(dirOut, dirSize, "%s/%s", dir, PROBE_CACHE_DIR_NAME);
+    } else if (((dir = getenv("HOME")) != NULL) && (dir[0] != '\0')) {
+        n = snprintf(dirOut, dirSize, "%s/.cache/%s", dir, PROBE_CACHE_DIR_NAME);
+    } else {
+        return RTI_FALSE;
+    }
+    return (n > 0) && (n < (int)dirSize);
+}
+
+/* }}} */
+/* {{{ ProbeCache_getPath
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes the path of the cache file of a probe.
+ *
+ * \param kind      the kind of probe (i.e. "compiler"), used as prefix of
+ *                  the file name
+ * \param tool      the path of the probed executable
+ * \param extra     other parameters of the probe (empty string if none)
+ * \param pathOut   receives the path of the cache file
+ * \param pathSize  the size of pathOut
+ * \return          RTI_TRUE if success, RTI_FALSE if the cache is disabled
+ *                  or the executable cannot be found
+ */
+static RTIBool ProbeCache_getPath(const char *kind,
+        const char *tool,
+        const char *extra,
+        char *pathOut,
+        size_t pathSize) {
+    char dir[PATH_MAX+1];
+    char resolved[PATH_MAX+1];
+    char stamp[MAX_STRING_SIZE];
+    const char *keyParts[4];
+    struct stat info;
+
+    if (!getProbeCacheDir(dir, sizeof(dir)) || 
+            (realpath(tool, resolved) == NULL) ||
+            (stat(resolved, &info) != 0)) {
+        return RTI_FALSE;
+    }
+    snprintf(stamp, sizeof(stamp), "%lld.%09ld %lld",
+            (long long)info.st_mtim.tv_sec,
+            (long)info.st_mtim.tv_nsec,
+            (long long)info.st_size);
+    keyParts[0] = kind;
+    keyParts[1] = resolved;
+    keyParts[2] = stamp;
+    keyParts[3] = extra;
+    return snprintf(pathOut, pathSize, "%s/%s-%016llx", 
+            dir, 
+            kind, 
+            hashStrings(keyParts, 4)) < (int)pathSize;
+}
+
+/* }}} */
+/* {{{ ProbeCache_load
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Reads the result of a probe from the cache (a single line).
+ *
+ * \return          RTI_TRUE if found (cache hit), RTI_FALSE otherwise
+ */
+static RTIBool ProbeCache_load(const char *path, char *valueOut, size_t valueSize) {
+    FILE *fp = fopen(path, "r");
+    RTIBool ok;
+
+    if (fp == NULL) {
+        theTrace.cache = TraceCache_Miss;
+        return RTI_FALSE;
+    }
+    ok = (fgets(valueOut, (int)valueSize, fp) != NULL);
+    fclose(fp);
+    if (ok) {
+        valueOut[strcspn(valueOut, "\n")] = '\0';
+    }
+    theTrace.cache = ok ? TraceCache_Hit : TraceCache_Miss;
+    return ok;
+}
+
+/* }}} */
+/* {{{ ProbeCache_store
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Stores the result of a probe in the cache, creating the cache directory
+ * (and its parent) if needed. Failures are ignored: the probe is simply
+ * repeated by the next invocation.
+ */
+static void ProbeCache_store(const char *path, const char *value) {
+    char dir[PATH_MAX+1];
+    char content[MAX_STRING_SIZE+2];
+    char *slash;
+
+    snprintf(dir, sizeof(dir), "%s", path);
+    slash = strrchr(dir, '/');
+    if (slash == NULL) {
+        return;
+    }
+    *slash = '\0';
+    if (access(dir, F_OK) != 0) {
+        char *parent = strrchr(dir, '/');
+        if (parent != NULL) {
+            *parent = '\0';
+            mkdir(dir, 0755);
+            *parent = '/';
+        }
+        if ((mkdir(dir, 0755) != 0) && (errno != EEXIST)) {
+            return;
+        }
+    }
+    snprintf(content, sizeof(content), "%s\n", value);
+    writeFileIfChanged(path, content, strlen(content), NULL);
+}
+
+/* }}} */
+/* {{{ runCapture
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Runs a command (searched in the PATH) and captures its standard output 
+ * and standard error. The output exceeding the buffer is discarded.
+ *
+ * \param argv      the command and its arguments, NULL-terminated
+ * \param dir       the working directory of the command, NULL for the
+ *                  current one
+ * \param outBuf    receives the output of the command (NUL-terminated)
+ * \param outSize   the size of outBuf
+ * \return          RTI_TRUE if the command has been executed and exited 
+ *                  with status 0, RTI_FALSE otherwise
+ */
+static RTIBool runCapture(char * const *argv, 
+        const char *dir,
+        char *outBuf, 
+        size_t outSize) {
+    size_t len = 0;
+    ssize_t n;
+    int fds[2];
+    int status;
+    char discard[256];
+    pid_t pid;
+
+    outBuf[0] = '\0';
+    if (pipe(fds) != 0) {
+        fprintf(stderr, "Error: pipe failed: %s\n", strerror(errno));
+        return RTI_FALSE;
+    }
+    fflush(stdout);
+    fflush(stderr);
+    pid = fork();
+    if (pid == -1) {
+        fprintf(stderr, "Error: fork failed: %s\n", strerror(errno));
+        close(fds[0]);
+        close(fds[1]);
+        return RTI_FALSE;
+    }
+    if (pid == 0) {
+        dup2(fds[1], 1);
+        dup2(fds[1], 2);
+        close(fds[0]);
+        close(fds[1]);
+        if ((dir != NULL) && (chdir(dir) != 0)) {
+            _exit(127);
+        }
+        execvp(argv[0], argv);
+        _exit(127);
+    }
+    close(fds[1]);
+    for (;;) {
+        if (len + 1 < outSize) {
+            n = read(fds[0], outBuf + len, outSize - len - 1);
+        } else {
+            n = read(fds[0], discard, sizeof(discard));
+        }
+        if ((n == -1) && (errno == EINTR)) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        if (len + 1 < outSize) {
+            len += (size_t)n;
+        }
+    }
+    outBuf[len] = '\0';
+    close(fds[0]);
+    return (waitpid(pid, &status, 0) != -1) && 
+            WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+}
+
+/* }}} */
+/* {{{ parseCompilerVersion
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Identifies the family and the major version of a compiler from the 
+ * output of `--version`, i.e.:
+ *      gcc (GCC) 7.3.0
+ *      Copyright (C) 2017 Free Software Foundation, Inc.
+ * or:
+ *      clang version 9.0.0 (tags/RELEASE_900/final)
+ *
+ * \return          the CompilerFamily (CompilerFamily_Other if the output
+ *                  is not recognized)
+ */
+static CompilerFamily parseCompilerVersion(const char *output, int *versionOut) {
+    const char *ptr = strstr(output, "clang version ");
+    const char *eol;
+
+    *versionOut = -1;
+    if (ptr != NULL) {
+        *versionOut = atoi(ptr + strlen("clang version "));
+        return CompilerFamily_Clang;
+    }
+    if ((strstr(output, "Free Software Foundation") == NULL) &&
+            (strstr(output, "(GCC)") == NULL)) {
+        return CompilerFamily_Other;
+    }
+    /* The version is the last word of the first line */
+    eol = output + strcspn(output, "\n");
+    for (ptr = eol; (ptr > output) && (ptr[-1] != ' '); --ptr) {
+    }
+    if (isdigit((unsigned char)*ptr)) {
+        *versionOut = atoi(ptr);
+    }
+    return CompilerFamily_Gcc;
+}
+
+/* }}} */
+/* {{{ probeCompiler
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Determines the family and the major version of a compiler: by running
+ * `<compiler> --version` (the result is cached) if the compiler is found
+ * on the host, otherwise from the names of the compiler and of the target.
+ *
+ * \param compiler  the composed compiler, with the variables expanded 
+ *                  (i.e. the output of --ccomp)
+ * \param target    the name of the target
+ * \param versionOut receives the major version, or -1 if unknown
+ * \return          the CompilerFamily
+ */
+static CompilerFamily probeCompiler(const char *compiler, 
+        const char *target,
+        int *versionOut) {
+    char name[MAX_STRING_SIZE];
+    char path[PATH_MAX+1];
+    char cachePath[PATH_MAX+1];
+    char value[MAX_STRING_SIZE];
+    char versionArg[] = "--version";
+    char *output = NULL;
+    char *args[3];
+    const char *start = compiler;
+    RTIBool cached;
+    CompilerFamily family = getCompilerFamily(compiler, target, versionOut);
+    int i;
+
+    while (isspace((unsigned char)*start)) {
+        ++start;
+    }
+    snprintf(name, sizeof(name), "%.*s", (int)strcspn(start, " \t"), start);
+    if ((name[0] == '\0') || !findExecutable(name, path, sizeof(path))) {
+        return family;
+    }
+
+    cached = ProbeCache_getPath("compiler", path, "", cachePath, sizeof(cachePath));
+    if (!cached || !ProbeCache_load(cachePath, value, sizeof(value))) {
+        output = MEM_CALLOC(Compose, PROBE_MAX_OUTPUT, 1);
+        if (output == NULL) {
+            fprintf(stderr, "Out of memory allocating the probe output\n");
+            return family;
+        }
+        args[0] = path;
+        args[1] = versionArg;
+        args[2] = NULL;
+        if (!runCapture(args, NULL, output, PROBE_MAX_OUTPUT)) {
+            MEM_FREE(output);
+            return family;
+        }
+        i = parseCompilerVersion(output, versionOut);
+        MEM_FREE(output);
+        snprintf(value, sizeof(value), "%s %d", COMPILER_FAMILY_NAMES[i], *versionOut);
+        if (cached) {
+            ProbeCache_store(cachePath, value);
+        }
+    }
+
+    /* value is "<family> <version>" */
+    for (i = 0; COMPILER_FAMILY_NAMES[i] != NULL; ++i) {
+        size_t len = strlen(COMPILER_FAMILY_NAMES[i]);
+        if ((strncmp(value, COMPILER_FAMILY_NAMES[i], len) == 0) && 
+                (value[len] == ' ')) {
+            if (i == CompilerFamily_Other) {
+                /* Not recognized: keep the result based on the names */
+                break;
+            }
+            *versionOut = atoi(value + len + 1);
+            return (CompilerFamily)i;
+        }
+    }
+    return family;
+}
+
+/* }}} */
+
+/* {{{ removeProbeDir
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Removes the temporary directory of a probe and the files it contains.
+ */
+static void removeProbeDir(const char *dir) {
+    char path[PATH_MAX+1];
+    struct dirent *entry;
+    DIR *d = opendir(dir);
+
+    if (d != NULL) {
+        while ((entry = readdir(d)) != NULL) {
+            if ((strcmp(entry->d_name, ".") == 0) || 
+                    (strcmp(entry->d_name, "..") == 0)) {
+                continue;
+            }
+            if (snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name) < 
+                    (int)sizeof(path)) {
+                unlink(path);
+            }
+        }
+        closedir(d);
+    }
+    rmdir(dir);
+}
+
+/* }}} */
+/* {{{ probeLinkTest
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Checks whether the linker of a target accepts the given options, by 
+ * building a tiny program with them in a temporary directory. The result
+ * and the duration of the link are cached.
+ *
+ * \param linker    the composed linker, with the variables expanded (i.e.
+ *                  the output of --clink), a compiler driver
+ * \param ldflags   the composed linker flags of the target (expanded)
+ * \param options   the options to test (i.e. "-fuse-ld=gold")
+ * \param okOut     receives RTI_TRUE if the link succeeded
+ * \param nsecOut   receives the duration of the link in ns (if not NULL)
+ * \return          RTI_TRUE if the test has been performed, RTI_FALSE if
+ *                  the linker is not installed on the host or the test
+ *                  could not be set up (i.e. no temporary directory)
+ */
+static RTIBool probeLinkTest(const char *linker,
+        const char *ldflags,
+        const char *options,
+        RTIBool *okOut,
+        unsigned long long *nsecOut) {
+    const int maxWords = MAX_CMDLINEARG_SIZE/2 + 1;
+    const char *source = "int main(void) { return 0; }\n";
+    char name[MAX_STRING_SIZE];
+    char path[PATH_MAX+1];
+    char cachePath[PATH_MAX+1];
+    char value[MAX_STRING_SIZE];
+    char dir[PATH_MAX+1];
+    char extra[2*MAX_CMDLINEARG_SIZE+2];
+    char words[3][MAX_CMDLINEARG_SIZE+1];
+    char fixedArgs[6][16] = { "-x", "c", "main.c", "-x", "none", "-o" };
+    char outArg[] = "probe";
+    char **cmd = NULL;
+    char *output = NULL;
+    const char *tmp = getenv("TMPDIR");
+    const char *start = linker;
+    struct timespec begin;
+    struct timespec end;
+    unsigned long long nsec;
+    RTIBool cached;
+    RTIBool performed = RTI_FALSE;
+    int cmdLen = 0;
+    int i;
+    int n;
+
+    *okOut = RTI_FALSE;
+    if (nsecOut != NULL) {
+        *nsecOut = 0;
+    }
+    while (isspace((unsigned char)*start)) {
+        ++start;
+    }
+    snprintf(name, sizeof(name), "%.*s", (int)strcspn(start, " \t"), start);
+    if ((name[0] == '\0') || !findExecutable(name, path, sizeof(path))) {
+        return RTI_FALSE;
+    }
+
+    snprintf(extra, sizeof(extra), "%s\n%s\n%s", linker, ldflags, options);
+    cached = ProbeCache_getPath("link", path, extra, cachePath, sizeof(cachePath));
+    if (cached && ProbeCache_load(cachePath, value, sizeof(value))) {
+        *okOut = (strncmp(value, "ok ", 3) == 0);
+        if (*okOut && (nsecOut != NULL)) {
+            *nsecOut = strtoull(value + 3, NULL, 10);
+        }
+        return RTI_TRUE;
+    }
+
+    snprintf(dir, sizeof(dir), "%s/connext-config-XXXXXX", 
+            ((tmp != NULL) && (tmp[0] != '\0')) ? tmp : "/tmp");
+    if (mkdtemp(dir) == NULL) {
+        fprintf(stderr, 
+                "Error: cannot create a temporary directory: %s\n", 
+                strerror(errno));
+        return RTI_FALSE;
+    }
+    cmd = MEM_CALLOC(Compose, (size_t)(3*maxWords + 8), sizeof(*cmd));
+    output = MEM_CALLOC(Compose, PROBE_MAX_OUTPUT, 1);
+    if ((cmd == NULL) || (output == NULL)) {
+        fprintf(stderr, "Out of memory allocating the link test\n");
+        goto done;
+    }
+    if ((snprintf(path, sizeof(path), "%s/main.c", dir) >= (int)sizeof(path)) ||
+            !writeFileIfChanged(path, source, strlen(source), NULL)) {
+        goto done;
+    }
+
+    /* linker ldflags options -x c main.c -x none -o probe */
+    snprintf(words[0], sizeof(words[0]), "%s", linker);
+    snprintf(words[1], sizeof(words[1]), "%s", ldflags);
+    snprintf(words[2], sizeof(words[2]), "%s", options);
+    for (i = 0; i < 3; ++i) {
+        n = splitCommandWords(words[i], &cmd[cmdLen], maxWords);
+        if (n == -1) {
+            goto done;
+        }
+        cmdLen += n;
+    }
+    for (i = 0; i < 6; ++i) {
+        cmd[cmdLen++] = fixedArgs[i];
+    }
+    cmd[cmdLen++] = outArg;
+    cmd[cmdLen] = NULL;
+
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    *okOut = runCapture(cmd, dir, output, PROBE_MAX_OUTPUT);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    performed = RTI_TRUE;
+    nsec = (unsigned long long)(end.tv_sec - begin.tv_sec) * 1000000000ULL +
+            (unsigned long long)end.tv_nsec - (unsigned long long)begin.tv_nsec;
+    if (nsecOut != NULL) {
+        *nsecOut = nsec;
+    }
+    if (*okOut) {
+        snprintf(value, sizeof(value), "ok %llu", nsec);
+    } else {
+        strcpy(value, "fail");
+    }
+    if (cached) {
+        ProbeCache_store(cachePath, value);
+    }
+
+done:
+    removeProbeDir(dir);
+    if (cmd != NULL) {
+        MEM_FREE(cmd);
+    }
+    if (output != NULL) {
+        MEM_FREE(output);
+    }
+    return performed;
+}
+
+/* }}} */
+
+/***************************************************************************
+ * Build Profiles
+ **************************************************************************/
+/* --profile=PROFILE adds the options of a build profile to the compiler 
+ * flags, the linker flags and the libraries of all the APIs, composed for
+ * the family and the version of the C compiler of the target (see 
+ * probeCompiler):
+ *  - lto: link time optimization, -flto=auto with gcc (using gcc-ar and 
+ *    gcc-nm to archive and list the LTO objects) or -flto=thin with clang
+ *    (using llvm-ar and llvm-nm, except on Darwin).
+ *  - pgo-gen[=DIR]: instrumentation for the profile guided optimization.
+ *    The profiles are written at run-time in DIR/<target> (default DIR: 
+ *    ./pgo). With gcc the counters are updated atomically, as the DDS 
+ *    applications are multi-threaded, and libgcov is added to the 
+ *    libraries, as some build tools (i.e. libtool) drop the linker flags
+ *    they do not know.
+ *  - pgo-use[=DIR]: optimization using the profiles in DIR/<target>. With
+ *    clang the raw profiles (.profraw) must be merged first into 
+ *    DIR/<target>/default.profdata with `llvm-profdata merge`.
+ *
+ * The toolchains that are too old to support the profile are rejected.
+ */
+#define PROFILE_DEFAULT_DIR         "pgo"
+
+static const struct {
+    const char  *name;
+    int         minGcc;         /* Minimum major version of gcc */
+    int         minClang;       /* Minimum major version of clang */
+    RTIBool     hasDir;         /* Accepts =DIR */
+} PROFILES[] = {
+    { "lto",        10, 4,  RTI_FALSE },    /* -flto=auto, ThinLTO */
+    { "pgo-gen",    7,  4,  RTI_TRUE },     /* -fprofile-update=atomic */
+    { "pgo-use",    7,  4,  RTI_TRUE },
+    { NULL,         0,  0,  RTI_FALSE }
+};
+
+/* {{{ getProfileIndex
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Parses the value of --profile.
+ *
+ * \param spec      the value of --profile (i.e. "pgo-gen=/tmp/pgo")
+ * \param dirOut    receives the directory of the profiles (if not NULL)
+ * \return          the index in PROFILES, or -1 if not valid
+ */
+static int getProfileIndex(const char *spec, const char **dirOut) {
+    int i;
+
+    for (i = 0; PROFILES[i].name != NULL; ++i) {
+        size_t len = strlen(PROFILES[i].name);
+        if (strncmp(spec, PROFILES[i].name, len) != 0) {
+            continue;
+        }
+        if (spec[len] == '\0') {
+            if (dirOut != NULL) {
+                *dirOut = PROFILE_DEFAULT_DIR;
+            }
+            return i;
+        }
+        if (PROFILES[i].hasDir && (spec[len] == '=') && (spec[len+1] != '\0')) {
+            if (dirOut != NULL) {
+                *dirOut = spec + len + 1;
+            }
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* }}} */
+/* {{{ getGccTool
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes the name of a gcc wrapper of the binutils (i.e. gcc-ar) that 
+ * matches the given gcc compiler: the last "gcc" in the compiler name is 
+ * replaced with "gcc-<tool>" (i.e. arm-linux-gcc-8 becomes
+ * arm-linux-gcc-ar-8).
+ */
+static void getGccTool(const char *compiler, 
+        const char *tool, 
+        char *out, 
+        size_t outSize) {
+    char name[MAX_STRING_SIZE];
+    const char *start = compiler;
+    const char *ptr;
+    const char *last = NULL;
+
+    while (isspace((unsigned char)*start)) {
+        ++start;
+    }
+    snprintf(name, sizeof(name), "%.*s", (int)strcspn(start, " \t"), start);
+    for (ptr = name; (ptr = strstr(ptr, "gcc")) != NULL; ptr += 3) {
+        last = ptr;
+    }
+    if (last == NULL) {
+        snprintf(out, outSize, "gcc-%s", tool);
+        return;
+    }
+    snprintf(out, outSize, "%.*sgcc-%s%s", 
+            (int)(last - name), 
+            name, 
+            tool, 
+            last + 3);
+}
+
+/* }}} */
+/* {{{ resolveProfile
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes the toolchain options of a build profile for the target.
+ *
+ * \param arch      pointer to the target Architecture
+ * \param spec      the value of --profile
+ * \param flagsOut  receives the options of the profile
+ * \return          RTI_TRUE if success, RTI_FALSE if the profile is not 
+ *                  supported by the toolchain of the target
+ */
+static RTIBool resolveProfile(struct Architecture *arch,
+        const char *spec,
+        struct ToolchainFlags *flagsOut) {
+    char compiler[MAX_CMDLINEARG_SIZE+1];
+    char dir[PATH_MAX+1];
+    char cwd[PATH_MAX+1];
+    const char *profileDir = NULL;
+    const char *name;
+    CompilerFamily family;
+    int idx = getProfileIndex(spec, &profileDir);
+    int version;
+    int minVersion;
+
+    memset(flagsOut, 0, sizeof(*flagsOut));
+    if (idx == -1) {
+        fprintf(stderr, "Error: invalid profile: %s\n", spec);
+        return RTI_FALSE;
+    }
+    name = PROFILES[idx].name;
+    if (composeStringProperty(arch, 
+                "$C_COMPILER", 
+                RTI_TRUE, 
+                compiler, 
+                sizeof(compiler)) != ComposeResult_Ok) {
+        fprintf(stderr, 
+                "Error: --profile=%s requires $C_COMPILER, not defined for "
+                "target '%s'\n",
+                name,
+                arch->target);
+        return RTI_FALSE;
+    }
+    family = probeCompiler(compiler, arch->target, &version);
+    if (family == CompilerFamily_Other) {
+        fprintf(stderr,
+                "Error: --profile=%s is not supported by the compiler of "
+                "target '%s' (%s)\n",
+                name,
+                arch->target,
+                compiler);
+        return RTI_FALSE;
+    }
+    minVersion = (family == CompilerFamily_Gcc) ? 
+            PROFILES[idx].minGcc : PROFILES[idx].minClang;
+    if (version < minVersion) {
+        fprintf(stderr,
+                "Error: --profile=%s requires gcc %d or clang %d or later, "
+                "the compiler of target '%s' is %s",
+                name,
+                PROFILES[idx].minGcc,
+                PROFILES[idx].minClang,
+                arch->target,
+                COMPILER_FAMILY_NAMES[family]);
+        if (version == -1) {
+            fprintf(stderr, " (unknown version)\n");
+        } else {
+            fprintf(stderr, " %d\n", version);
+        }
+        return RTI_FALSE;
+    }
+
+    if (strcmp(name, "lto") == 0) {
+        if (family == CompilerFamily_Gcc) {
+            strcpy(flagsOut->cflags, "-flto=auto");
+            /* Keep the variables, i.e. $(GCC_PREFIX)gcc-ar */
+            composeStringProperty(arch, 
+                    "$C_COMPILER", 
+                    RTI_FALSE, 
+                    compiler, 
+                    sizeof(compiler));
+            getGccTool(compiler, "ar", flagsOut->ar, sizeof(flagsOut->ar));
+            getGccTool(compiler, "nm", flagsOut->nm, sizeof(flagsOut->nm));
+        } else {
+            strcpy(flagsOut->cflags, "-flto=thin");
+            if (strstr(arch->target, "Darwin") == NULL) {
+                strcpy(flagsOut->ar, "llvm-ar");
+                strcpy(flagsOut->nm, "llvm-nm");
+            }
+        }
+        strcpy(flagsOut->ldflags, flagsOut->cflags);
+        return RTI_TRUE;
+    }
+
+    /* PGO: one directory of profiles per target */
+    if (profileDir[0] == '/') {
+        cwd[0] = '\0';
+    } else if (getcwd(cwd, sizeof(cwd)) == NULL) {
+        fprintf(stderr, 
+                "Error: cannot get the current directory: %s\n", 
+                strerror(errno));
+        return RTI_FALSE;
+    }
+    if (snprintf(dir, sizeof(dir), "%s%s%s/%s", 
+                cwd, 
+                (cwd[0] != '\0') ? "/" : "",
+                profileDir, 
+                arch->target) >= (int)sizeof(dir)) {
+        fprintf(stderr, "Error: profile directory too long: %s\n", profileDir);
+        return RTI_FALSE;
+    }
+    if (strcmp(name, "pgo-gen") == 0) {
+        snprintf(flagsOut->ldflags, sizeof(flagsOut->ldflags), 
+                "-fprofile-generate=%s", 
+                dir);
+        if (family == CompilerFamily_Gcc) {
+            snprintf(flagsOut->cflags, sizeof(flagsOut->cflags), 
+                    "-fprofile-generate=%s -fprofile-update=atomic",
+                    dir);
+            strcpy(flagsOut->ldlibs, "-lgcov");
+        } else {
+            strcpy(flagsOut->cflags, flagsOut->ldflags);
+        }
+    } else {
+        snprintf(flagsOut->ldflags, sizeof(flagsOut->ldflags), 
+                "-fprofile-use=%s", 
+                dir);
+        if (family == CompilerFamily_Gcc) {
+            /* The counters of the threads are not always consistent */
+            snprintf(flagsOut->cflags, sizeof(flagsOut->cflags), 
+                    "-fprofile-use=%s -fprofile-correction",
+                    dir);
+        } else {
+            strcpy(flagsOut->cflags, flagsOut->ldflags);
+        }
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * Linker Selection
+ **************************************************************************/
+/* --linker=auto|mold|lld|gold|bfd adds -fuse-ld=<linker> to the linker 
+ * flags of all the APIs. Each linker is tested by building a tiny program
+ * with the linkers of the target ($C_LINKER and $CXX_LINKER, gcc or clang
+ * drivers) and their flags (see probeLinkTest, the results are cached):
+ *  - auto selects the fastest of the alternative linkers accepted by the
+ *    target, or keeps the default linker if none is accepted or the 
+ *    linkers of the target are not installed on the host;
+ *  - an explicit linker is rejected if the target does not accept it. It
+ *    is used without testing when the linkers of the target are not 
+ *    installed on the host.
+ *
+ * The linkers are ranked by their known link speed on large applications:
+ * the duration of the link tests (reported by --probe-linkers) is 
+ * dominated by the startup of the compiler driver, so it is not used to
+ * select them.
+ *
+ * --probe-linkers [target] reports the linkers accepted by the target.
+ */
+
+/* The linkers supported by -fuse-ld, fastest first */
+static const struct {
+    const char  *name;
+    RTIBool     gdbIndex;       /* Supports -Wl,--gdb-index */
+} LINKERS[] = {
+    { "mold",   RTI_TRUE },
+    { "lld",    RTI_TRUE },
+    { "gold",   RTI_TRUE },
+    { "bfd",    RTI_FALSE },    /* GNU ld, usually the default */
+    { NULL,     RTI_FALSE }
+};
+
+/* The linkers of a target, as composed by TargetLinkers_compose */
+struct TargetLinkers {
+    int                         count;
+    const char                  *api[2];        /* "C" or "C++" */
+    char                        linker[2][MAX_CMDLINEARG_SIZE+1];
+    char                        ldflags[2][MAX_CMDLINEARG_SIZE+1];
+};
+
+/* {{{ isValidLinkerMode
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns RTI_TRUE if the given value of --linker is valid: auto or the 
+ * name of one of the LINKERS.
+ */
+static RTIBool isValidLinkerMode(const char *mode) {
+    int i;
+    if (strcmp(mode, "auto") == 0) {
+        return RTI_TRUE;
+    }
+    for (i = 0; LINKERS[i].name != NULL; ++i) {
+        if (strcmp(LINKERS[i].name, mode) == 0) {
+            return RTI_TRUE;
+        }
+    }
+    return RTI_FALSE;
+}
+
+/* }}} */
+/* {{{ TargetLinkers_compose
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes (with the variables expanded) the linkers of the target and 
+ * their flags.
+ *
+ * \param me        the object to initialize
+ * \param arch      pointer to the target Architecture
+ * \param option    the option that requires the linkers (for the errors)
+ * \param isRequired if RTI_FALSE, linkers that are not gcc or clang drivers
+ *                  for ELF targets are reported as a warning (the option is
+ *                  ignored) instead of an error
+ * \return          ComposeResult_Ok if success, ComposeResult_Unsupported
+ *                  if the linkers are not gcc or clang drivers for ELF 
+ *                  targets, ComposeResult_Error if the target has no linkers
+ *                  or an error occurred
+ */
+static ComposeResult TargetLinkers_compose(struct TargetLinkers *me,
+        struct Architecture *arch,
+        const char *option,
+        RTIBool isRequired) {
+    static const char *LINKER_PROPERTIES[][3] = {
+        { "C",      "$C_LINKER",    "$C_LINKER_FLAGS" },
+        { "C++",    "$CXX_LINKER",  "$CXX_LINKER_FLAGS" }
+    };
+    const char *flags[2];
+    int version;
+    int i;
+
+    memset(me, 0, sizeof(*me));
+    for (i = 0; i < 2; ++i) {
+        char *linker = me->linker[me->count];
+        if (composeStringProperty(arch, 
+                    LINKER_PROPERTIES[i][1], 
+                    RTI_TRUE,
+                    linker,
+                    sizeof(me->linker[me->count])) != ComposeResult_Ok) {
+            continue;
+        }
+        if ((probeCompiler(linker, arch->target, &version) == 
+                    CompilerFamily_Other) || 
+                (strstr(arch->target, "Darwin") != NULL)) {
+            fprintf(stderr,
+                    "%s: %s is not supported by the linker of target "
+                    "'%s' (%s)%s\n",
+                    isRequired ? "Error" : "Warning",
+                    option,
+                    arch->target,
+                    linker,
+                    isRequired ? "" : ", ignored");
+            return ComposeResult_Unsupported;
+        }
+        flags[0] = LINKER_PROPERTIES[i][2];
+        flags[1] = NULL;
+        if (composeCompositeFlagsProperties(arch,
+                    flags,
+                    RTI_TRUE,
+                    RTI_FALSE,
+                    me->ldflags[me->count],
+                    sizeof(me->ldflags[me->count])) == ComposeResult_Error) {
+            return ComposeResult_Error;
+        }
+        me->api[me->count] = LINKER_PROPERTIES[i][0];
+        ++me->count;
+    }
+    if (me->count == 0) {
+        fprintf(stderr, 
+                "Error: %s requires a linker, not defined for target '%s'\n",
+                option,
+                arch->target);
+        return ComposeResult_Error;
+    }
+    return ComposeResult_Ok;
+}
+
+/* }}} */
+/* {{{ TargetLinkers_accept
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Checks whether all the linkers of the target accept the given options.
+ *
+ * \param options   the options to test (i.e. "-fuse-ld=gold")
+ * \param probedOut receives RTI_FALSE if a linker is not installed on the
+ *                  host or the link test could not be set up, so the 
+ *                  options cannot be tested
+ * \return          RTI_TRUE if all the linkers accepted the options
+ */
+static RTIBool TargetLinkers_accept(const struct TargetLinkers *me,
+        const char *options,
+        RTIBool *probedOut) {
+    RTIBool ok = RTI_TRUE;
+    int i;
+
+    *probedOut = RTI_TRUE;
+    for (i = 0; ok && (i < me->count); ++i) {
+        *probedOut = probeLinkTest(me->linker[i], me->ldflags[i], options, &ok, NULL);
+        if (!*probedOut) {
+            return RTI_FALSE;
+        }
+    }
+    return ok;
+}
+
+/* }}} */
+/* {{{ resolveLinker
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Selects the linker of --linker for the target.
+ *
+ * \param arch      pointer to the target Architecture
+ * \param mode      the value of --linker
+ * \param flagsOut  receives the options that select the linker
+ * \param idxOut    receives the index in LINKERS of the linker, or -1 if 
+ *                  the default linker is kept
+ * \return          RTI_TRUE if success, RTI_FALSE if the requested linker
+ *                  is not accepted by the target
+ */
+static RTIBool resolveLinker(struct Architecture *arch,
+        const char *mode,
+        struct ToolchainFlags *flagsOut,
+        int *idxOut) {
+    struct TargetLinkers *linkers;
+    char options[MAX_STRING_SIZE];
+    RTIBool probed = RTI_TRUE;
+    RTIBool ok = RTI_FALSE;
+    int i;
+
+    memset(flagsOut, 0, sizeof(*flagsOut));
+    *idxOut = -1;
+    linkers = MEM_CALLOC(Compose, 1, sizeof(*linkers));
+    if (linkers == NULL) {
+        fprintf(stderr, "Out of memory allocating the linkers\n");
+        return RTI_FALSE;
+    }
+    if (TargetLinkers_compose(linkers, arch, "--linker", RTI_TRUE) != 
+            ComposeResult_Ok) {
+        goto done;
+    }
+    for (i = 0; probed && (LINKERS[i].name != NULL); ++i) {
+        if (strcmp(mode, "auto") == 0) {
+            /* Only the alternatives to the default linker */
+            if (strcmp(LINKERS[i].name, "bfd") == 0) {
+                continue;
+            }
+        } else if (strcmp(mode, LINKERS[i].name) != 0) {
+            continue;
+        }
+        snprintf(options, sizeof(options), "-fuse-ld=%s", LINKERS[i].name);
+        if (TargetLinkers_accept(linkers, options, &probed) || 
+                (!probed && (strcmp(mode, "auto") != 0))) {
+            strcpy(flagsOut->ldflags, options);
+            *idxOut = i;
+            break;
+        }
+        if (strcmp(mode, "auto") != 0) {
+            fprintf(stderr,
+                    "Error: the linkers of target '%s' do not accept %s\n",
+                    arch->target,
+                    options);
+            goto done;
+        }
+    }
+    ok = RTI_TRUE;
+
+done:
+    MEM_FREE(linkers);
+    return ok;
+}
+
+/* }}} */
+/* {{{ probeLinkers
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Implements --probe-linkers: prints a table of the linkers accepted by 
+ * the linkers of the target, with the duration of the link tests, followed
+ * by the linker selected by --linker=auto.
+ *
+ * \return          the exit code of the application
+ */
+static int probeLinkers(struct Architecture *arch) {
+    struct TargetLinkers *linkers;
+    char options[MAX_STRING_SIZE];
+    unsigned long long nsec;
+    int selected = -1;
+    int retCode = APPLICATION_EXIT_FAILURE;
+    RTIBool accepted;
+    RTIBool ok;
+    int i;
+    int j;
+
+    linkers = MEM_CALLOC(Compose, 1, sizeof(*linkers));
+    if (linkers == NULL) {
+        fprintf(stderr, "Out of memory allocating the linkers\n");
+        return APPLICATION_EXIT_FAILURE;
+    }
+    if (TargetLinkers_compose(linkers, arch, "--probe-linkers", RTI_TRUE) !=
+            ComposeResult_Ok) {
+        goto done;
+    }
+    printf("Linkers of %s:\n", arch->target);
+    for (j = 0; j < linkers->count; ++j) {
+        printf("  %-4s %s %s\n", 
+                linkers->api[j], 
+                linkers->linker[j], 
+                linkers->ldflags[j]);
+    }
+    printf("\n%-8s", "-fuse-ld");
+    for (j = 0; j < linkers->count; ++j) {
+        printf(" %12s", linkers->api[j]);
+    }
+    printf("\n");
+    for (i = 0; LINKERS[i].name != NULL; ++i) {
+        snprintf(options, sizeof(options), "-fuse-ld=%s", LINKERS[i].name);
+        accepted = RTI_TRUE;
+        printf("%-8s", LINKERS[i].name);
+        for (j = 0; j < linkers->count; ++j) {
+            if (!probeLinkTest(linkers->linker[j], 
+                        linkers->ldflags[j], 
+                        options, 
+                        &ok, 
+                        &nsec)) {
+                printf("\nError: the linker '%s' is not installed or cannot be "
+                        "tested\n", 
+                        linkers->linker[j]);
+                goto done;
+            }
+            if (ok) {
+                printf("   %7.1f ms", (double)nsec / 1e6);
+            } else {
+                printf(" %12s", "no");
+            }
+            accepted = accepted && ok;
+        }
+        printf("\n");
+        if (accepted && (selected == -1) && (strcmp(LINKERS[i].name, "bfd") != 0)) {
+            selected = i;
+        }
+    }
+    printf("\n--linker=auto: %s\n", 
+            (selected != -1) ? LINKERS[selected].name : "default linker");
+    retCode = APPLICATION_EXIT_SUCCESS;
+
+done:
+    MEM_FREE(linkers);
+    return retCode;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * Debug Link Acceleration
+ **************************************************************************/
+/* --fast-debug-link reduces the time to link the debug builds:
+ *  - -g -gsplit-dwarf (compiler flags) keeps most of the debug information
+ *    in separate .dwo files, that are not processed by the linker (-g is
+ *    required: since gcc 11 -gsplit-dwarf alone does not enable it);
+ *  - -fuse-ld=mold|lld|gold (linker flags) selects the fastest of these 
+ *    linkers accepted by the linkers of the target (as --linker=auto), 
+ *    with -Wl,--gdb-index to build at link time the index that gdb would
+ *    otherwise build at every start (not supported by the default GNU ld).
+ *    With --linker, the selected linker is used and -Wl,--gdb-index is 
+ *    added only if the linker supports it.
+ * The options are detected with link tests (see probeLinkTest) run with 
+ * the same linkers and flags, so the compiler and linker flags are always
+ * coherent. When the linkers of the target are not installed on the host 
+ * only -g -gsplit-dwarf is added. Targets that are not ELF, or whose 
+ * linkers are not gcc or clang drivers, get no options (with a warning), so
+ * the same build command works for all the targets.
+ */
+
+/* {{{ resolveFastDebugLink
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes the toolchain options of --fast-debug-link for the target.
+ *
+ * \param arch      pointer to the target Architecture
+ * \param linkerIdx the index in LINKERS of the linker selected by 
+ *                  --linker, -1 if --linker kept the default linker, -2
+ *                  if --linker is not used
+ * \param flagsOut  receives the options, empty if the target does not 
+ *                  support them
+ * \return          RTI_TRUE if success, RTI_FALSE if the target has no 
+ *                  linkers or an error occurred
+ */
+static RTIBool resolveFastDebugLink(struct Architecture *arch,
+        int linkerIdx,
+        struct ToolchainFlags *flagsOut) {
+    struct TargetLinkers *linkers;
+    char options[MAX_STRING_SIZE];
+    const char *splitDwarf = "-g -gsplit-dwarf ";
+    RTIBool probed;
+    RTIBool ok = RTI_FALSE;
+    ComposeResult rc;
+    int i;
+
+    memset(flagsOut, 0, sizeof(*flagsOut));
+    linkers = MEM_CALLOC(Compose, 1, sizeof(*linkers));
+    if (linkers == NULL) {
+        fprintf(stderr, "Out of memory allocating the linkers\n");
+        return RTI_FALSE;
+    }
+    rc = TargetLinkers_compose(linkers, arch, "--fast-debug-link", RTI_FALSE);
+    if (rc == ComposeResult_Error) {
+        goto done;
+    }
+    ok = RTI_TRUE;
+    if (rc == ComposeResult_Unsupported) {
+        goto done;
+    }
+    if (!TargetLinkers_accept(linkers, "-g -gsplit-dwarf", &probed)) {
+        if (probed) {
+            splitDwarf = "";
+        }
+    }
+    if (splitDwarf[0] != '\0') {
+        strcpy(flagsOut->cflags, "-g -gsplit-dwarf");
+    }
+    if (!probed) {
+        /* Not installed on the host: the gcc and clang toolsets support it */
+        goto done;
+    }
+
+    if (linkerIdx != -2) {
+        /* The linker selected by --linker */
+        if ((linkerIdx == -1) || LINKERS[linkerIdx].gdbIndex) {
+            snprintf(options, sizeof(options), "%s%s%s -Wl,--gdb-index",
+                    splitDwarf,
+                    (linkerIdx != -1) ? "-fuse-ld=" : "",
+                    (linkerIdx != -1) ? LINKERS[linkerIdx].name : "");
+            if (TargetLinkers_accept(linkers, options, &probed)) {
+                strcpy(flagsOut->ldflags, "-Wl,--gdb-index");
+            }
+        }
+        goto done;
+    }
+    for (i = 0; LINKERS[i].name != NULL; ++i) {
+        if (!LINKERS[i].gdbIndex) {
+            continue;
+        }
+        snprintf(options, sizeof(options), "%s-fuse-ld=%s -Wl,--gdb-index",
+                splitDwarf,
+                LINKERS[i].name);
+        if (TargetLinkers_accept(linkers, options, &probed)) {
+            snprintf(flagsOut->ldflags, sizeof(flagsOut->ldflags), 
+                    "-fuse-ld=%s -Wl,--gdb-index", 
+                    LINKERS[i].name);
+            break;
+        }
+    }
+
+done:
+    MEM_FREE(linkers);
+    return ok;
+}
+
+/* }}} */
+
+/***************************************************************************
+ * Runtime Library Path
+ **************************************************************************/
+/* --rpath=MODE records in the executables the directory of the shared
+ * RTI Connext DDS libraries, so they start without LD_LIBRARY_PATH (the 
+ * dynamic loader tries every directory of LD_LIBRARY_PATH for every 
+ * library, before its cache):
+ *  - absolute: $NDDSHOME/lib/<target>;
+ *  - origin[:RELPATH]: $ORIGIN/RELPATH, relative to the directory of the
+ *    executable (default: ../lib), for the applications installed 
+ *    together with the libraries;
+ *  - none: no path (the default).
+ * With -Wl,--enable-new-dtags the path is recorded as DT_RUNPATH, that
+ * LD_LIBRARY_PATH can still override. DT_RUNPATH is not used for the 
+ * libraries needed by the other libraries: they are found because the 
+ * executable needs all of them (see --ldlibs, the Linux targets link with
+ * -Wl,--no-as-needed). Nothing is added with --static.
+ *
+ * $ORIGIN must reach the linker unexpanded, so it is written as the 
+ * consumer of each output needs it:
+ *  - RPATH_ORIGIN: the expanded outputs, used through a command 
+ *    substitution (that does not evaluate its result again), the wrappers
+ *    (no shell) and --emit-sh (single-quoted);
+ *  - RPATH_ORIGIN_SHELL: --noexpand --sh, evaluated by the shell that 
+ *    expands ${NDDSHOME};
+ *  - RPATH_ORIGIN_MAKE: the make style outputs (--emit-make, --noexpand 
+ *    without --sh), expanded by make and then by the shell of the recipe.
+ */
+#define RPATH_DEFAULT_ORIGIN_DIR    "../lib"
+#define RPATH_ORIGIN                "$ORIGIN"
+#define RPATH_ORIGIN_SHELL          "\\$ORIGIN"
+#define RPATH_ORIGIN_MAKE           "\\$$ORIGIN"
+
+/* {{{ isValidRpathMode
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns RTI_TRUE if the given value of --rpath is valid. The relative 
+ * path of origin cannot contain commas (they separate the arguments of 
+ * -Wl) and white spaces.
+ */
+static RTIBool isValidRpathMode(const char *mode) {
+    if ((strcmp(mode, "none") == 0) || (strcmp(mode, "absolute") == 0) ||
+            (strcmp(mode, "origin") == 0)) {
+        return RTI_TRUE;
+    }
+    return (strncmp(mode, "origin:", 7) == 0) && 
+            (mode[7] != '\0') && 
+            (mode[7] != '/') &&
+            (mode[7 + strcspn(mode + 7, ", \t\n'\"\\")] == '\0');
+}
+
+/* }}} */
+/* {{{ resolveRpath
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes the linker options of --rpath for the target.
+ *
+ * \param arch      pointer to the target Architecture
+ * \param home      the reference to NDDSHOME in the output: the directory,
+ *                  ${NDDSHOME} or $(NDDSHOME)
+ * \param origin    the reference to $ORIGIN in the output: RPATH_ORIGIN,
+ *                  RPATH_ORIGIN_SHELL or RPATH_ORIGIN_MAKE
+ * \param isStatic  the --static modifier
+ * \param mode      the value of --rpath
+ * \param flagsOut  receives the options
+ * \return          RTI_TRUE if success, RTI_FALSE if the linkers of the 
+ *                  target are not gcc or clang drivers for an ELF target
+ */
+static RTIBool resolveRpath(struct Architecture *arch,
+        const char *home,
+        const char *origin,
+        RTIBool isStatic,
+        const char *mode,
+        struct ToolchainFlags *flagsOut) {
+    struct TargetLinkers *linkers;
+    RTIBool ok;
+
+    memset(flagsOut, 0, sizeof(*flagsOut));
+    if (isStatic || (strcmp(mode, "none") == 0)) {
+        return RTI_TRUE;
+    }
+    linkers = MEM_CALLOC(Compose, 1, sizeof(*linkers));
+    if (linkers == NULL) {
+        fprintf(stderr, "Out of memory allocating the linkers\n");
+        return RTI_FALSE;
+    }
+    ok = (TargetLinkers_compose(linkers, arch, "--rpath", RTI_TRUE) == 
+            ComposeResult_Ok);
+    MEM_FREE(linkers);
+    if (!ok) {
+        return RTI_FALSE;
+    }
+    if (strcmp(mode, "absolute") == 0) {
+        snprintf(flagsOut->ldflags, sizeof(flagsOut->ldflags),
+                "-Wl,-rpath,%s/lib/%s -Wl,--enable-new-dtags",
+                home,
+                arch->target);
+    } else {
+        snprintf(flagsOut->ldflags, sizeof(flagsOut->ldflags),
+                "-Wl,-rpath,%s/%s -Wl,--enable-new-dtags",
+                origin,
+                (mode[6] == ':') ? mode + 7 : RPATH_DEFAULT_ORIGIN_DIR);
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+
+/***************************************************************************
+ * Compiler Driver Wrappers
+ **************************************************************************/
+/* When invoked as connext-cc, connext-c++, connext-ld or connext-ld++ 
+ * (i.e. through a symbolic link installed next to connext-config) or with
+ * --exec=TOOL as first argument, the application composes the compiler (or
+ * the linker) of the target together with its flags and replaces itself
+ * with it, splicing in the arguments of the user:
+ *
+ *      connext-cc ARGS...      ->  $(C_COMPILER) $(CFLAGS) ARGS...
+ *      connext-ld ARGS...      ->  $(C_LINKER) $(LDFLAGS) ARGS... $(LDLIBS)
+ *
+ * The target is taken from $NDDSARCH. The arguments starting with 
+ * --connext- are consumed by the wrapper (see WRAPPER_USAGE), all the 
+ * others are passed unchanged and in the same order to the compiler.
+ *
+ * Since no shell is involved, the environment variables are always 
+ * expanded and the composed strings are split in words the same way a 
+ * POSIX shell does in a make recipe (quotes and backslashes removed).
+ */
+#define WRAPPER_NAME_PREFIX         "connext-"
+#define WRAPPER_OPTION_PREFIX       "--connext-"
+
+static const struct {
+    const char  *name;          /* Tool name (--exec=NAME or connext-NAME) */
+    const char  *op;            /* Operation recorded in the trace */
+    const char  *api;           /* Default API (--connext-api=API) */
+    RTIBool     isLinker;       /* Link step: append the libraries */
+} WRAPPER_TOOLS[] = {
+    { "cc",     "--exec=cc",    "c",    RTI_FALSE },
+    { "c++",    "--exec=c++",   "cxx",  RTI_FALSE },
+    { "ld",     "--exec=ld",    "c",    RTI_TRUE },
+    { "ld++",   "--exec=ld++",  "cxx",  RTI_TRUE },
+    { NULL,     NULL,           NULL,   RTI_FALSE }
+};
+
+/* Options recognized by the wrappers */
+static const char *WRAPPER_USAGE =
+    "    --connext-target=ARCH  target architecture (default: $NDDSARCH)\n"
+    "    --connext-api=API      c, cxx, cxx03 or cxx11 (default: c for cc and\n"
+    "                           ld, cxx for c++ and ld++)\n"
+    "    --connext-static       same as --static\n"
+    "    --connext-debug        same as --debug\n"
+    "    --connext-libmsg       same as --libmsg\n"
+    "    --connext-launcher=L   same as --launcher=L (compilers only)\n"
+    "    --connext-profile=P    same as --profile=P\n"
+    "    --connext-linker=L     same as --linker=L (linkers only)\n"
+    "    --connext-fast-debug-link\n"
+    "                           same as --fast-debug-link\n"
+    "    --connext-rpath=MODE   same as --rpath=MODE (linkers only)\n"
+    "    --connext-print        print the command instead of executing it\n";
+
+/* Wrapper invocation, as parsed by WrapperArgs_parse */
+struct WrapperArgs {
+    int                         toolIdx;
+    int                         apiIdx;
+    const char                  *target;
+    RTIBool                     isStatic;
+    RTIBool                     isDebug;
+    RTIBool                     libMsg;
+    RTIBool                     printOnly;
+    const char                  *launcher;      /* --launcher mode */
+    const char                  *profile;       /* NULL if none */
+    RTIBool                     fastDebugLink;
+    const char                  *linker;        /* NULL if none */
+    const char                  *rpath;         /* NULL if none */
+    int                         userArgc;
+    char                        **userArgv;
+};
+
+/* {{{ getWrapperToolIndex
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the index in WRAPPER_TOOLS of the given tool name or -1 if not 
+ * found
+ */
+static int getWrapperToolIndex(const char *name) {
+    int i;
+    for (i = 0; WRAPPER_TOOLS[i].name != NULL; ++i) {
+        if (strcmp(WRAPPER_TOOLS[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* }}} */
+/* {{{ getWrapperToolFromArgv0
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the index in WRAPPER_TOOLS of the tool the application has been
+ * invoked as (i.e. 2 for /path/to/connext-ld), or -1 if the application 
+ * has been invoked with any other name.
+ */
+static int getWrapperToolFromArgv0(const char *argv0) {
+    const char *base = strrchr(argv0, '/');
+
+    base = (base != NULL) ? base+1 : argv0;
+    if (strncmp(base, WRAPPER_NAME_PREFIX, strlen(WRAPPER_NAME_PREFIX)) != 0) {
+        return -1;
+    }
+    return getWrapperToolIndex(base + strlen(WRAPPER_NAME_PREFIX));
+}
+
+/* }}} */
+/* {{{ WrapperArgs_parse
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Parses the arguments of a wrapper invocation: removes the --connext-* 
+ * options from argv (compacting the remaining arguments in place) and 
+ * stores them into the given WrapperArgs object.
+ *
+ * \param args      the object to initialize
+ * \param toolIdx   the index of the tool in WRAPPER_TOOLS
+ * \param argc      number of arguments in argv
+ * \param argv      the arguments (excluding the program name and --exec)
+ * \return          RTI_TRUE if success, RTI_FALSE if an option is invalid
+ *                  or the target is not specified.
+ */
+static RTIBool WrapperArgs_parse(struct WrapperArgs *args,
+        int toolIdx,
+        int argc,
+        char **argv) {
+    const char *opt;
+    int i;
+
+    memset(args, 0, sizeof(*args));
+    args->toolIdx = toolIdx;
+    args->apiIdx = getApiIndex(WRAPPER_TOOLS[toolIdx].api);
+    args->target = getenv("NDDSARCH");
+    args->launcher = "none";
+    args->userArgv = argv;
+
+    for (i = 0; i < argc; ++i) {
+        if (strncmp(argv[i], WRAPPER_OPTION_PREFIX, strlen(WRAPPER_OPTION_PREFIX)) != 0) {
+            argv[args->userArgc++] = argv[i];
+            continue;
+        }
+        opt = argv[i] + strlen(WRAPPER_OPTION_PREFIX);
+        if (strncmp(opt, "target=", 7) == 0) {
+            args->target = opt+7;
+        } else if (strncmp(opt, "api=", 4) == 0) {
+            args->apiIdx = getApiIndex(opt+4);
+            if (args->apiIdx == -1) {
+                fprintf(stderr, "Error: invalid API: %s\n", opt+4);
+                return RTI_FALSE;
+            }
+        } else if (strncmp(opt, "launcher=", 9) == 0) {
+            args->launcher = opt+9;
+            if (!isValidLauncherMode(args->launcher)) {
+                fprintf(stderr, "Error: invalid launcher: %s\n", args->launcher);
+                return RTI_FALSE;
+            }
+        } else if (strncmp(opt, "profile=", 8) == 0) {
+            args->profile = opt+8;
+            if (getProfileIndex(args->profile, NULL) == -1) {
+                fprintf(stderr, "Error: invalid profile: %s\n", args->profile);
+                return RTI_FALSE;
+            }
+        } else if (strncmp(opt, "linker=", 7) == 0) {
+            args->linker = opt+7;
+            if (!isValidLinkerMode(args->linker)) {
+                fprintf(stderr, "Error: invalid linker: %s\n", args->linker);
+                return RTI_FALSE;
+            }
+        } else if (strncmp(opt, "rpath=", 6) == 0) {
+            args->rpath = opt+6;
+            if (!isValidRpathMode(args->rpath)) {
+                fprintf(stderr, "Error: invalid rpath: %s\n", args->rpath);
+                return RTI_FALSE;
+            }
+        } else if (strcmp(opt, "fast-debug-link") == 0) {
+            args->fastDebugLink = RTI_TRUE;
+        } else if (strcmp(opt, "static") == 0) {
+            args->isStatic = RTI_TRUE;
+        } else if (strcmp(opt, "debug") == 0) {
+            args->isDebug = RTI_TRUE;
+        } else if (strcmp(opt, "libmsg") == 0) {
+            args->libMsg = RTI_TRUE;
+        } else if (strcmp(opt, "print") == 0) {
+            args->printOnly = RTI_TRUE;
+        } else {
+            fprintf(stderr, 
+                    "Error: invalid argument: %s\n"
+                    "Valid options for %s%s are:\n%s", 
+                    argv[i],
+                    WRAPPER_NAME_PREFIX,
+                    WRAPPER_TOOLS[toolIdx].name,
+                    WRAPPER_USAGE);
+            return RTI_FALSE;
+        }
+    }
+    argv[args->userArgc] = NULL;
+
+    if ((args->target == NULL) || (args->target[0] == '\0')) {
+        fprintf(stderr,
+                "Target architecture not specified and NDDSARCH not defined\n"
+                "Use --list-all or --list-installed to print the architectures\n");
+        return RTI_FALSE;
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ printCommandWord
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Prints a word of a command line, single-quoted if it contains any 
+ * character that is special for the shell.
+ */
+static void printCommandWord(FILE *fp, const char *word) {
+    const char *ptr;
+
+    if ((word[0] != '\0') && 
+            (word[strcspn(word, " \t\n'\"\\$`*?[]#~&;|<>(){}")] == '\0')) {
+        fputs(word, fp);
+        return;
+    }
+    fputc('\'', fp);
+    for (ptr = word; *ptr != '\0'; ++ptr) {
+        if (*ptr == '\'') {
+            fputs("'\\''", fp);
+        } else {
+            fputc(*ptr, fp);
+        }
+    }
+    fputc('\'', fp);
+}
+
+/* }}} */
+/* {{{ execWrapper
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes the command line of the wrapped compiler (or linker) for the 
+ * target and executes it, replacing the current process. The executable is
+ * searched in the PATH, as the compilers are rarely defined with an 
+ * absolute path.
+ *
+ * \param arch      pointer to the target Architecture
+ * \param NDDSHOME  the NDDSHOME directory
+ * \param args      the parsed wrapper arguments
+ * \param op        the operation recorded in the invocation trace
+ * \return          APPLICATION_EXIT_SUCCESS if the command has been printed
+ *                  (--connext-print), APPLICATION_EXIT_FAILURE if the 
+ *                  composition or the execution failed. Does not return if
+ *                  the command is executed.
+ */
+static int execWrapper(struct Architecture *arch,
+        const char *NDDSHOME,
+        const struct WrapperArgs *args,
+        const char *op) {
+    /* Each composed string cannot have more than MAX_CMDLINEARG_SIZE/2 words */
+    const int maxWords = MAX_CMDLINEARG_SIZE/2 + 1;
+    const RTIBool isLinker = WRAPPER_TOOLS[args->toolIdx].isLinker;
+    const char *launcherPath = NULL;
+    int linkerIdx = -2;
+    struct ComposeContext ctx;
+    struct ApiSettings *settings;
+    char **cmd = NULL;
+    char *parts[3];
+    const char *partOps[3];
+    int cmdLen = 0;
+    int retCode = APPLICATION_EXIT_FAILURE;
+    int i;
+    int n;
+
+    settings = MEM_CALLOC(Compose, 1, sizeof(*settings));
+    cmd = MEM_CALLOC(Compose, (size_t)(3*maxWords + args->userArgc + 1), sizeof(*cmd));
+    if ((settings == NULL) || (cmd == NULL)) {
+        fprintf(stderr, "Out of memory allocating the command line\n");
+        goto done;
+    }
+    ComposeContext_init(&ctx,
+            NDDSHOME,
+            arch->target,
+            args->isStatic,
+            args->isDebug,
+            args->libMsg,
+            RTI_TRUE,
+            RTI_FALSE);
+    if (!isLinker && !resolveLauncher(args->launcher, &launcherPath, NULL)) {
+        goto done;
+    }
+    ComposeContext_setLauncher(&ctx, arch->target, launcherPath);
+    if (args->profile != NULL) {
+        struct ToolchainFlags profileFlags;
+        if (!resolveProfile(arch, args->profile, &profileFlags) ||
+                !ComposeContext_addFlags(&ctx, &profileFlags)) {
+            goto done;
+        }
+    }
+    if (isLinker && (args->linker != NULL)) {
+        struct ToolchainFlags linkerFlags;
+        if (!resolveLinker(arch, args->linker, &linkerFlags, &linkerIdx) ||
+                !ComposeContext_addFlags(&ctx, &linkerFlags)) {
+            goto done;
+        }
+    }
+    if (args->fastDebugLink) {
+        struct ToolchainFlags debugLinkFlags;
+        if (!resolveFastDebugLink(arch, linkerIdx, &debugLinkFlags) ||
+                !ComposeContext_addFlags(&ctx, &debugLinkFlags)) {
+            goto done;
+        }
+    }
+    if (isLinker && (args->rpath != NULL)) {
+        struct ToolchainFlags rpathFlags;
+        if (!resolveRpath(arch, 
+                    NDDSHOME, 
+                    RPATH_ORIGIN, 
+                    args->isStatic, 
+                    args->rpath, 
+                    &rpathFlags) ||
+                !ComposeContext_addFlags(&ctx, &rpathFlags)) {
+            goto done;
+        }
+    }
+    switch (composeApiSettings(arch, args->apiIdx, &ctx, settings)) {
+        case ComposeResult_Ok:
+            break;
+        case ComposeResult_Unsupported:
+            fprintf(stderr,
+                    "Error: target '%s' does not support the %s\n",
+                    arch->target,
+                    API_OPERATIONS[args->apiIdx].description);
+            goto done;
+        default:
+            goto done;
+    }
+
+    /* The command, the flags placed before the arguments of the user and
+     * (only when linking) the libraries placed after them
+     */
+    if (isLinker) {
+        parts[0] = settings->link;      partOps[0] = API_OPERATIONS[args->apiIdx].link;
+        parts[1] = settings->ldflags;   partOps[1] = API_OPERATIONS[args->apiIdx].ldflags;
+        parts[2] = settings->ldlibs;    partOps[2] = API_OPERATIONS[args->apiIdx].ldlibs;
+    } else {
+        parts[0] = settings->comp;      partOps[0] = API_OPERATIONS[args->apiIdx].comp;
+        parts[1] = settings->flags;     partOps[1] = API_OPERATIONS[args->apiIdx].flags;
+        parts[2] = NULL;                partOps[2] = NULL;
+    }
+    for (i = 0; i < 3; ++i) {
+        if (i == 2) {
+            memcpy(&cmd[cmdLen], args->userArgv, (size_t)args->userArgc * sizeof(*cmd));
+            cmdLen += args->userArgc;
+        }
+        if (parts[i] == NULL) {
+            continue;
+        }
+        n = splitCommandWords(parts[i], &cmd[cmdLen], maxWords);
+        if (n == -1) {
+            fprintf(stderr, 
+                    "Error: unterminated quote in %s for target '%s'\n",
+                    partOps[i],
+                    arch->target);
+            goto done;
+        }
+        if ((i == 0) && (n == 0)) {
+            fprintf(stderr, 
+                    "Error: %s is not defined for target '%s'\n",
+                    partOps[i],
+                    arch->target);
+            goto done;
+        }
+        cmdLen += n;
+    }
+    cmd[cmdLen] = NULL;
+
+    if (args->printOnly) {
+        for (i = 0; i < cmdLen; ++i) {
+            if (i > 0) {
+                putchar(' ');
+            }
+            printCommandWord(stdout, cmd[i]);
+        }
+        putchar('\n');
+        retCode = APPLICATION_EXIT_SUCCESS;
+        goto done;
+    }
+
+    /* The trace record must be written before being replaced */
+    Trace_end(op, arch->target, APPLICATION_EXIT_SUCCESS);
+    fflush(stdout);
+    fflush(stderr);
+    execvp(cmd[0], cmd);
+    fprintf(stderr, 
+            "Error: failed to execute '%s': %s (errno=%d)\n",
+            cmd[0],
+            strerror(errno),
+            errno);
+
+done:
+    if (settings != NULL) {
+        MEM_FREE(settings);
+    }
+    if (cmd != NULL) {
+        MEM_FREE(cmd);
+    }
+    return retCode;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * Precompiled Headers
+ **************************************************************************/
+/* --pch=DIR prepares a precompiled header of the main Connext DDS header of
+ * an API (i.e. ndds/ndds_cpp.h) for a target, built with exactly the 
+ * compiler and the flags composed for the same API and modifiers.
+ *
+ * The PCH is placed in DIR/<target>-<api>-<key>, where the key is a hash 
+ * of the compiler, the flags and the header, so different settings never 
+ * share (and invalidate) the same PCH. The directory contains connext.h, a
+ * header including the Connext DDS header, and the PCH built from it.
+ *
+ * Without --pch-build the shell commands to build the PCH are printed, 
+ * followed by a comment with the flags to use it. With --pch-build the PCH
+ * is built (if it does not exist yet) and only the flags to use it are 
+ * printed, so they can be captured by the build system.
+ *
+ * Only the gcc and clang toolsets are supported.
+ */
+#define PCH_HEADER_NAME             "connext.h"
+
+static const struct {
+    const char  *api;           /* Name of the API in API_OPERATIONS */
+    const char  *header;        /* Header included by the applications */
+    const char  *language;      /* Argument of -x to precompile it */
+} PCH_HEADERS[] = {
+    { "c",      "ndds/ndds_c.h",    "c-header" },
+    { "cxx",    "ndds/ndds_cpp.h",  "c++-header" },
+    { "cxx03",  "dds/dds.hpp",      "c++-header" },
+    { "cxx11",  "dds/dds.hpp",      "c++-header" },
+    { NULL,     NULL,               NULL }
+};
+
+/* The PCH of a target and API, as composed by PchSettings_compose */
+struct PchSettings {
+    struct ApiSettings          api;
+    const char                  *header;        /* Connext DDS header */
+    const char                  *language;
+    CompilerFamily              family;
+    char                        dir[PATH_MAX+1];
+    char                        source[PATH_MAX+1];     /* connext.h */
+    char                        output[PATH_MAX+1];     /* The PCH */
+    char                        useFlags[2*PATH_MAX+MAX_STRING_SIZE];
+};
+
+/* {{{ PchSettings_compose
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes the compiler and flags of the API and determines the paths and
+ * the flags of the PCH.
+ *
+ * \param me        the object to initialize
+ * \param arch      pointer to the target Architecture
+ * \param ctx       the composition context built for the same target
+ * \param apiIdx    the index of the API in API_OPERATIONS
+ * \param baseDir   the directory containing all the PCH (--pch=DIR)
+ * \return          ComposeResult_Ok if success, ComposeResult_Unsupported
+ *                  if the target does not support the API, 
+ *                  ComposeResult_Error if failed.
+ */
+static ComposeResult PchSettings_compose(struct PchSettings *me,
+        struct Architecture *arch,
+        const struct ComposeContext *ctx,
+        int apiIdx,
+        const char *baseDir) {
+    unsigned long long key;
+    const char *keyParts[3];
+    ComposeResult rc;
+    int version;
+    int i;
+
+    memset(me, 0, sizeof(*me));
+    for (i = 0; PCH_HEADERS[i].api != NULL; ++i) {
+        if (strcmp(PCH_HEADERS[i].api, API_OPERATIONS[apiIdx].name) == 0) {
+            me->header = PCH_HEADERS[i].header;
+            me->language = PCH_HEADERS[i].language;
+        }
+    }
+    rc = composeApiSettings(arch, apiIdx, ctx, &me->api);
+    if (rc != ComposeResult_Ok) {
+        return rc;
+    }
+    if (me->api.comp[0] == '\0') {
+        fprintf(stderr, 
+                "Error: %s is not defined for target '%s'\n",
+                API_OPERATIONS[apiIdx].comp,
+                arch->target);
+        return ComposeResult_Error;
+    }
+
+    /* The same verdict on the compiler as --profile (see probeCompiler) */
+    me->family = probeCompiler(me->api.comp, arch->target, &version);
+    if (me->family == CompilerFamily_Other) {
+        fprintf(stderr,
+                "Error: precompiled headers are supported only with gcc and "
+                "clang, not by the compiler of target '%s' (%s)\n",
+                arch->target,
+                me->api.comp);
+        return ComposeResult_Error;
+    }
+
+    /* The key covers everything the content of the PCH depends on */
+    keyParts[0] = me->api.comp;
+    keyParts[1] = me->api.flags;
+    keyParts[2] = me->header;
+    key = hashStrings(keyParts, 3);
+    if ((snprintf(me->dir, sizeof(me->dir), "%s/%s-%s-%016llx", 
+                    baseDir,
+                    arch->target,
+                    API_OPERATIONS[apiIdx].name,
+                    key) >= (int)sizeof(me->dir)) ||
+            (snprintf(me->source, sizeof(me->source), "%s/%s", 
+                    me->dir, 
+                    PCH_HEADER_NAME) >= (int)sizeof(me->source)) ||
+            (snprintf(me->output, sizeof(me->output), "%s.%s", 
+                    me->source, 
+                    (me->family == CompilerFamily_Clang) ? "pch" : "gch") >= (int)sizeof(me->output))) {
+        fprintf(stderr, "Error: path too long for the PCH in '%s'\n", baseDir);
+        return ComposeResult_Error;
+    }
+
+    /* gcc looks for connext.h.gch when connext.h is included */
+    if (me->family == CompilerFamily_Clang) {
+        snprintf(me->useFlags, sizeof(me->useFlags), 
+                "-include-pch %s", 
+                me->output);
+    } else {
+        snprintf(me->useFlags, sizeof(me->useFlags), 
+                "-include %s -Winvalid-pch", 
+                me->source);
+    }
+    return ComposeResult_Ok;
+}
+
+/* }}} */
+/* {{{ PchSettings_printCommands
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Prints the shell commands that build the PCH, followed by a comment with
+ * the flags to use it.
+ */
+static void PchSettings_printCommands(const struct PchSettings *me, FILE *fp) {
+    fprintf(fp, "mkdir -p ");
+    printCommandWord(fp, me->dir);
+    fprintf(fp, "\necho '#include <%s>' > ", me->header);
+    printCommandWord(fp, me->source);
+    fprintf(fp, "\n%s %s -x %s ", me->api.comp, me->api.flags, me->language);
+    printCommandWord(fp, me->source);
+    fprintf(fp, " -o ");
+    printCommandWord(fp, me->output);
+    fprintf(fp, "\n# Compiler flags to use the PCH: %s\n", me->useFlags);
+}
+
+/* }}} */
+/* {{{ PchSettings_build
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Builds the PCH, unless it already exists. The PCH is built in a 
+ * temporary file and then renamed, so parallel builds never use a partial
+ * PCH. The output of the compiler is redirected to stderr.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+static RTIBool PchSettings_build(struct PchSettings *me, const char *baseDir) {
+    const int maxWords = MAX_CMDLINEARG_SIZE/2 + 1;
+    char content[MAX_STRING_SIZE];
+    char tmpOutput[PATH_MAX+1];
+    char language[MAX_STRING_SIZE];
+    char optLanguage[] = "-x";
+    char optOutput[] = "-o";
+    char **cmd = NULL;
+    struct stat info;
+    RTIBool ok = RTI_FALSE;
+    int cmdLen = 0;
+    int status;
+    int n;
+    pid_t pid;
+
+    if ((stat(me->output, &info) == 0) && (info.st_size > 0)) {
+        return RTI_TRUE;
+    }
+    snprintf(content, sizeof(content), "#include <%s>\n", me->header);
+    if (!ensureDirectory(baseDir) || 
+            !ensureDirectory(me->dir) ||
+            !writeFileIfChanged(me->source, content, strlen(content), NULL)) {
+        return RTI_FALSE;
+    }
+    if (snprintf(tmpOutput, sizeof(tmpOutput), "%s.tmp%ld", 
+                me->output, 
+                (long)getpid()) >= (int)sizeof(tmpOutput)) {
+        fprintf(stderr, "Path too long: %s\n", me->output);
+        return RTI_FALSE;
+    }
+    snprintf(language, sizeof(language), "%s", me->language);
+
+    /* compiler flags -x language connext.h -o connext.h.gch.tmpPID */
+    cmd = MEM_CALLOC(Compose, (size_t)(2*maxWords + 6), sizeof(*cmd));
+    if (cmd == NULL) {
+        fprintf(stderr, "Out of memory allocating the command line\n");
+        return RTI_FALSE;
+    }
+    n = splitCommandWords(me->api.comp, &cmd[cmdLen], maxWords);
+    if (n > 0) {
+        cmdLen += n;
+        n = splitCommandWords(me->api.flags, &cmd[cmdLen], maxWords);
+    }
+    if (n == -1) {
+        fprintf(stderr, "Error: unterminated quote in the compiler settings\n");
+        goto done;
+    }
+    cmdLen += n;
+    cmd[cmdLen++] = optLanguage;
+    cmd[cmdLen++] = language;
+    cmd[cmdLen++] = me->source;
+    cmd[cmdLen++] = optOutput;
+    cmd[cmdLen++] = tmpOutput;
+    cmd[cmdLen] = NULL;
+
+    fflush(stdout);
+    fflush(stderr);
+    pid = fork();
+    if (pid == -1) {
+        fprintf(stderr, "Error: fork failed: %s\n", strerror(errno));
+        goto done;
+    }
+    if (pid == 0) {
+        dup2(2, 1);
+        execvp(cmd[0], cmd);
+        fprintf(stderr, "Error: failed to execute '%s': %s\n", cmd[0], strerror(errno));
+        _exit(APPLICATION_EXIT_FAILURE);
+    }
+    if ((waitpid(pid, &status, 0) == -1) || 
+            !WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+        fprintf(stderr, "Error: failed to build the PCH '%s'\n", me->output);
+        unlink(tmpOutput);
+        goto done;
+    }
+    if (rename(tmpOutput, me->output) != 0) {
+        fprintf(stderr, 
+                "Error: cannot rename '%s' to '%s': %s (errno=%d)\n",
+                tmpOutput,
+                me->output,
+                strerror(errno),
+                errno);
+        unlink(tmpOutput);
+        goto done;
+    }
+    ok = RTI_TRUE;
+
+done:
+    MEM_FREE(cmd);
+    return ok;
+}
+
+/* }}} */
+/* {{{ precompileHeaders
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Implements --pch=DIR: prints the commands to build the PCH of the API 
+ * for the target, or builds it and prints the flags to use it.
+ *
+ * \param arch      pointer to the target Architecture
+ * \param NDDSHOME  the NDDSHOME directory
+ * \param apiIdx    the index of the API in API_OPERATIONS
+ * \param isStatic  the --static modifier
+ * \param isDebug   the --debug modifier
+ * \param libMsg    the --libmsg modifier
+ * \param extra     the toolchain options added by the modifiers, or NULL
+ * \param baseDir   the directory containing all the PCH
+ * \param build     RTI_TRUE to build the PCH (--pch-build)
+ * \return          ComposeResult_Ok if success, ComposeResult_Unsupported 
+ *                  if the target does not support the API, 
+ *                  ComposeResult_Error if failed.
+ */
+static ComposeResult precompileHeaders(struct Architecture *arch,
+        const char *NDDSHOME,
+        int apiIdx,
+        RTIBool isStatic,
+        RTIBool isDebug,
+        RTIBool libMsg,
+        const struct ToolchainFlags *extra,
+        const char *baseDir,
+        RTIBool build) {
+    struct ComposeContext *ctx;
+    struct PchSettings *settings;
+    ComposeResult rc = ComposeResult_Error;
+
+    ctx = MEM_CALLOC(Compose, 1, sizeof(*ctx));
+    settings = MEM_CALLOC(Compose, 1, sizeof(*settings));
+    if ((ctx == NULL) || (settings == NULL)) {
+        fprintf(stderr, "Out of memory allocating the PCH settings\n");
+        goto done;
+    }
+    /* The commands are executed without a shell: always expand */
+    ComposeContext_init(ctx,
+            NDDSHOME,
+            arch->target,
+            isStatic,
+            isDebug,
+            libMsg,
+            RTI_TRUE,
+            RTI_FALSE);
+    /* The PCH must be built with the same flags as the translation units */
+    if (!ComposeContext_addFlags(ctx, extra)) {
+        goto done;
+    }
+    rc = PchSettings_compose(settings, arch, ctx, apiIdx, baseDir);
+    if (rc != ComposeResult_Ok) {
+        goto done;
+    }
+    if (!build) {
+        PchSettings_printCommands(settings, stdout);
+    } else if (PchSettings_build(settings, baseDir)) {
+        printf("%s\n", settings->useFlags);
+    } else {
+        rc = ComposeResult_Error;
+    }
+
+done:
+    if (ctx != NULL) {
+        MEM_FREE(ctx);
+    }
+    if (settings != NULL) {
+        MEM_FREE(settings);
+    }
+    return rc;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * C++ Modules
+ **************************************************************************/
+/* --modules=DIR prepares the main Connext DDS header of a C++ API (i.e.
+ * ndds/ndds_cpp.h, with all the headers it includes) to be imported as a
+ * module instead of being parsed by every translation unit. The mechanism
+ * depends on the family of the compiler, identified from $CXX_COMPILER:
+ *  - clang: a module.modulemap with a module wrapping the header. The
+ *    module is built by the compiler on first use, in a cache directory
+ *    next to the module map (-fmodules-cache-path).
+ *  - gcc 11 or later: a C++20 header unit of the header, and the module
+ *    mapper file that maps the header to it, so its #include is
+ *    translated into an import.
+ *
+ * As for the PCH, the files are placed in DIR/<target>-<api>-<key>, where
+ * key is a hash of the compiler, the flags and the header. --modules=DIR
+ * writes the module map (or mapper) and prints the commands to build the
+ * module, followed by a comment with the flags to use it. --cxxmodflags
+ * also builds the module (once) and prints only the flags.
+ */
+#define MODULE_MAP_NAME             "module.modulemap"
+#define MODULE_MAPPER_NAME          "module.mapper"
+#define MODULE_NAME                 "ConnextDDS"
+#define MODULE_STAMP_NAME           "module.stamp"
+#define MODULE_MIN_GCC_VERSION      11
+
+/* The modules of a target and API, as composed by ModuleSettings_compose */
+struct ModuleSettings {
+    struct ApiSettings          api;
+    CompilerFamily              family;
+    char                        header[PATH_MAX+1];     /* Absolute path */
+    char                        dir[PATH_MAX+1];
+    char                        mapFile[PATH_MAX+1];
+    char                        output[PATH_MAX+1];     /* CMI or cache dir */
+    char                        stamp[PATH_MAX+1];      /* Module built */
+    char                        buildFlags[MAX_STRING_SIZE];
+    char                        useFlags[3*PATH_MAX+MAX_STRING_SIZE];
+};
+
+/* {{{ ModuleSettings_compose
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes the compiler and the flags of the API and determines the paths
+ * and the flags of the module.
+ *
+ * \param me        the object to initialize
+ * \param arch      pointer to the target Architecture
+ * \param ctx       the composition context built for the same target
+ * \param apiIdx    the index of the API in API_OPERATIONS (C++ only)
+ * \param baseDir   the absolute path of the directory containing all the
+ *                  modules (--modules=DIR)
+ * \return          ComposeResult_Ok if success, ComposeResult_Unsupported
+ *                  if the target does not support the API,
+ *                  ComposeResult_Error if failed.
+ */
+static ComposeResult ModuleSettings_compose(struct ModuleSettings *me,
+        struct Architecture *arch,
+        const struct ComposeContext *ctx,
+        int apiIdx,
+        const char *baseDir) {
+    const char *header = NULL;
+    const char *keyParts[3];
+    ComposeResult rc;
+    int version;
+    int i;
+
+    memset(me, 0, sizeof(*me));
+    for (i = 0; PCH_HEADERS[i].api != NULL; ++i) {
+        if (strcmp(PCH_HEADERS[i].api, API_OPERATIONS[apiIdx].name) == 0) {
+            header = PCH_HEADERS[i].header;
+        }
+    }
+    rc = composeApiSettings(arch, apiIdx, ctx, &me->api);
+    if (rc != ComposeResult_Ok) {
+        return rc;
+    }
+    /* The same verdict on the compiler as --profile (see probeCompiler) */
+    me->family = probeCompiler(me->api.comp, arch->target, &version);
+    if ((me->family == CompilerFamily_Other) ||
+            ((me->family == CompilerFamily_Gcc) &&
+                (version < MODULE_MIN_GCC_VERSION))) {
+        fprintf(stderr,
+                "Error: modules are supported only with clang and gcc %d or "
+                "later, not by the compiler of target '%s' (%s)\n",
+                MODULE_MIN_GCC_VERSION,
+                arch->target,
+                me->api.comp);
+        return ComposeResult_Error;
+    }
+    if (snprintf(me->header, sizeof(me->header), "%s/include/%s",
+                ctx->NDDSHOME,
+                header) >= (int)sizeof(me->header)) {
+        goto tooLong;
+    }
+
+    keyParts[0] = me->api.comp;
+    keyParts[1] = me->api.flags;
+    keyParts[2] = me->header;
+    if (snprintf(me->dir, sizeof(me->dir), "%s/%s-%s-%016llx",
+                baseDir,
+                arch->target,
+                API_OPERATIONS[apiIdx].name,
+                hashStrings(keyParts, 3)) >= (int)sizeof(me->dir)) {
+        goto tooLong;
+    }
+    if (snprintf(me->stamp, sizeof(me->stamp), "%s/%s",
+                me->dir,
+                MODULE_STAMP_NAME) >= (int)sizeof(me->stamp)) {
+        goto tooLong;
+    }
+
+    if (me->family == CompilerFamily_Clang) {
+        if ((snprintf(me->mapFile, sizeof(me->mapFile), "%s/%s",
+                        me->dir,
+                        MODULE_MAP_NAME) >= (int)sizeof(me->mapFile)) ||
+                (snprintf(me->output, sizeof(me->output), "%s/cache",
+                        me->dir) >= (int)sizeof(me->output))) {
+            goto tooLong;
+        }
+        snprintf(me->useFlags, sizeof(me->useFlags),
+                "-fmodules -fmodule-map-file=%s -fmodules-cache-path=%s",
+                me->mapFile,
+                me->output);
+        /* The module is built by compiling a source that includes it */
+        snprintf(me->buildFlags, sizeof(me->buildFlags), "-fsyntax-only -x c++");
+    } else {
+        const char *base = strrchr(header, '/');
+        if ((snprintf(me->mapFile, sizeof(me->mapFile), "%s/%s",
+                        me->dir,
+                        MODULE_MAPPER_NAME) >= (int)sizeof(me->mapFile)) ||
+                (snprintf(me->output, sizeof(me->output), "%s/%s.gcm",
+                        me->dir,
+                        (base != NULL) ? base+1 : header) >= (int)sizeof(me->output))) {
+            goto tooLong;
+        }
+        snprintf(me->useFlags, sizeof(me->useFlags),
+                "-std=c++20 -fmodules-ts -fmodule-mapper=%s",
+                me->mapFile);
+        snprintf(me->buildFlags, sizeof(me->buildFlags),
+                "-fmodule-header -x c++-header");
+    }
+    return ComposeResult_Ok;
+
+tooLong:
+    fprintf(stderr, "Error: path too long for the module in '%s'\n", baseDir);
+    return ComposeResult_Error;
+}
+
+/* }}} */
+/* {{{ ModuleSettings_writeMap
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes (if changed) the module map (clang) or the module mapper (gcc) 
+ * of the module.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+static RTIBool ModuleSettings_writeMap(const struct ModuleSettings *me,
+        const char *baseDir) {
+    char *content = NULL;
+    size_t contentLen = 0;
+    int written = 0;
+    FILE *fp;
+
+    if (!ensureDirectory(baseDir) || !ensureDirectory(me->dir)) {
+        return RTI_FALSE;
+    }
+    fp = open_memstream(&content, &contentLen);
+    if (fp == NULL) {
+        fprintf(stderr, "Out of memory allocating the module map\n");
+        return RTI_FALSE;
+    }
+    if (me->family == CompilerFamily_Clang) {
+        fprintf(fp, "// Generated by %s v.%s - do not edit\n", 
+                APPLICATION_NAME, 
+                APPLICATION_VERSION);
+        fprintf(fp, "module %s [system] {\n", MODULE_NAME);
+        fprintf(fp, "    header \"%s\"\n", me->header);
+        fprintf(fp, "    export *\n");
+        fprintf(fp, "}\n");
+    } else {
+        fprintf(fp, "# Generated by %s v.%s - do not edit\n", 
+                APPLICATION_NAME, 
+                APPLICATION_VERSION);
+        fprintf(fp, "%s %s\n", me->header, me->output);
+    }
+    return commitGeneratedFile(fp, &content, &contentLen, me->mapFile, &written);
+}
+
+/* }}} */
+/* {{{ ModuleSettings_printCommands
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Prints the shell commands that build the module, followed by a comment 
+ * with the flags to use it.
+ */
+static void ModuleSettings_printCommands(const struct ModuleSettings *me, 
+        FILE *fp) {
+    if (me->family == CompilerFamily_Clang) {
+        fprintf(fp, "echo '#include \"%s\"' | ", me->header);
+        fprintf(fp, "%s %s %s %s -\n", 
+                me->api.comp, 
+                me->api.flags, 
+                me->useFlags, 
+                me->buildFlags);
+    } else {
+        fprintf(fp, "%s %s %s %s ", 
+                me->api.comp, 
+                me->api.flags, 
+                me->useFlags, 
+                me->buildFlags);
+        printCommandWord(fp, me->header);
+        fprintf(fp, "\n");
+    }
+    fprintf(fp, "# Compiler flags to use the module: %s\n", me->useFlags);
+}
+
+/* }}} */
+/* {{{ ModuleSettings_build
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Builds the module, unless it has already been built (the stamp file 
+ * exists). The output of the compiler is redirected to stderr.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+static RTIBool ModuleSettings_build(struct ModuleSettings *me) {
+    const int maxWords = MAX_CMDLINEARG_SIZE/2 + 1;
+    char useFlags[sizeof(me->useFlags)];
+    char buildFlags[sizeof(me->buildFlags)];
+    char source[PATH_MAX+1];
+    char content[PATH_MAX+MAX_STRING_SIZE];
+    char **cmd = NULL;
+    char *parts[4];
+    struct stat info;
+    RTIBool ok = RTI_FALSE;
+    int cmdLen = 0;
+    int status;
+    int i;
+    int n;
+    pid_t pid;
+
+    if (stat(me->stamp, &info) == 0) {
+        return RTI_TRUE;
+    }
+
+    /* clang: compile a source including the header, gcc: the header */
+    if (me->family == CompilerFamily_Clang) {
+        snprintf(content, sizeof(content), "#include \"%s\"\n", me->header);
+        if ((snprintf(source, sizeof(source), "%s/module.cxx", me->dir) >= 
+                    (int)sizeof(source)) ||
+                !writeFileIfChanged(source, content, strlen(content), NULL)) {
+            return RTI_FALSE;
+        }
+    } else {
+        snprintf(source, sizeof(source), "%s", me->header);
+    }
+
+    strcpy(useFlags, me->useFlags);
+    strcpy(buildFlags, me->buildFlags);
+    parts[0] = me->api.comp;
+    parts[1] = me->api.flags;
+    parts[2] = useFlags;
+    parts[3] = buildFlags;
+    cmd = MEM_CALLOC(Compose, (size_t)(4*maxWords + 2), sizeof(*cmd));
+    if (cmd == NULL) {
+        fprintf(stderr, "Out of memory allocating the command line\n");
+        return RTI_FALSE;
+    }
+    for (i = 0; i < 4; ++i) {
+        n = splitCommandWords(parts[i], &cmd[cmdLen], maxWords);
+        if (n == -1) {
+            fprintf(stderr, "Error: unterminated quote in the compiler settings\n");
+            goto done;
+        }
+        cmdLen += n;
+    }
+    cmd[cmdLen++] = source;
+    cmd[cmdLen] = NULL;
+
+    fflush(stdout);
+    fflush(stderr);
+    pid = fork();
+    if (pid == -1) {
+        fprintf(stderr, "Error: fork failed: %s\n", strerror(errno));
+        goto done;
+    }
+    if (pid == 0) {
+        dup2(2, 1);
+        execvp(cmd[0], cmd);
+        fprintf(stderr, "Error: failed to execute '%s': %s\n", cmd[0], strerror(errno));
+        _exit(APPLICATION_EXIT_FAILURE);
+    }
+    if ((waitpid(pid, &status, 0) == -1) || 
+            !WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+        fprintf(stderr, "Error: failed to build the module of '%s'\n", me->header);
+        goto done;
+    }
+    ok = writeFileIfChanged(me->stamp, "", 0, NULL);
+
+done:
+    MEM_FREE(cmd);
+    return ok;
+}
+
+/* }}} */
+/* {{{ prepareModules
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Implements --modules=DIR (writes the module map and prints the commands
+ * to build the module) and --cxxmodflags (also builds the module and 
+ * prints the flags to use it).
+ *
+ * \param arch      pointer to the target Architecture
+ * \param NDDSHOME  the NDDSHOME directory
+ * \param apiIdx    the index of the API in API_OPERATIONS (C++ only)
+ * \param isStatic  the --static modifier
+ * \param isDebug   the --debug modifier
+ * \param libMsg    the --libmsg modifier
+ * \param extra     the toolchain options added by the modifiers, or NULL
+ * \param dir       the directory containing all the modules
+ * \param build     RTI_TRUE to build the module (--cxxmodflags)
+ * \return          ComposeResult_Ok if success, ComposeResult_Unsupported 
+ *                  if the target does not support the API, 
+ *                  ComposeResult_Error if failed.
+ */
+static ComposeResult prepareModules(struct Architecture *arch,
+        const char *NDDSHOME,
+        int apiIdx,
+        RTIBool isStatic,
+        RTIBool isDebug,
+        RTIBool libMsg,
+        const struct ToolchainFlags *extra,
+        const char *dir,
+        RTIBool build) {
+    struct ComposeContext *ctx;
+    struct ModuleSettings *settings;
+    char *baseDir = NULL;
+    ComposeResult rc = ComposeResult_Error;
+
+    ctx = MEM_CALLOC(Compose, 1, sizeof(*ctx));
+    settings = MEM_CALLOC(Compose, 1, sizeof(*settings));
+    if ((ctx == NULL) || (settings == NULL)) {
+        fprintf(stderr, "Out of memory allocating the module settings\n");
+        goto done;
+    }
+
+    /* The gcc module mapper requires absolute paths */
+    if (!ensureDirectory(dir)) {
+        goto done;
+    }
+    baseDir = realpath(dir, NULL);
+    if (baseDir == NULL) {
+        fprintf(stderr, 
+                "Error: cannot resolve '%s': %s (errno=%d)\n",
+                dir,
+                strerror(errno),
+                errno);
+        goto done;
+    }
+
+    ComposeContext_init(ctx,
+            NDDSHOME,
+            arch->target,
+            isStatic,
+            isDebug,
+            libMsg,
+            RTI_TRUE,
+            RTI_FALSE);
+    if (!ComposeContext_addFlags(ctx, extra)) {
+        goto done;
+    }
+    rc = ModuleSettings_compose(settings, arch, ctx, apiIdx, baseDir);
+    if (rc != ComposeResult_Ok) {
+        goto done;
+    }
+    if (!ModuleSettings_writeMap(settings, baseDir)) {
+        rc = ComposeResult_Error;
+    } else if (!build) {
+        ModuleSettings_printCommands(settings, stdout);
+    } else if (ModuleSettings_build(settings)) {
+        printf("%s\n", settings->useFlags);
+    } else {
+        rc = ComposeResult_Error;
+    }
+
+done:
+    /* realpath allocates the output string */
+    free(baseDir);
+    if (ctx != NULL) {
+        MEM_FREE(ctx);
+    }
+    if (settings != NULL) {
+        MEM_FREE(settings);
+    }
+    return rc;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * ELF Symbol Tables
+ **************************************************************************/
+/* A minimal reader of the global symbols of the files of a link: ELF
+ * relocatable objects and shared libraries (32 and 64 bits, both byte
+ * orders), ar archives of ELF objects (System V/GNU and BSD member names)
+ * and the GNU ld scripts that replace some system libraries (i.e. libm.so
+ * on glibc). The files are mapped in memory and stay mapped until the
+ * LinkSet is finalized: the names of the symbols point to the mapped
+ * string tables.
+ *
+ * The unit of a link is a LinkUnit: a relocatable object, a member of an
+ * archive or a whole shared library.
+ */
+
+#define ELF_HEADER_MIN_SIZE         52      /* Size of the 32-bit header */
+#define ELF_CLASS_32                1
+#define ELF_CLASS_64                2
+#define ELF_DATA_LSB                1
+#define ELF_DATA_MSB                2
+#define ELF_TYPE_REL                1
+#define ELF_TYPE_DYN                3
+#define ELF_SECTION_SYMTAB          2
+#define ELF_SECTION_DYNSYM          11
+#define ELF_SECTION_VERSYM          0x6fffffff
+#define ELF_SECTION_INDEX_UNDEF     0
+#define ELF_BIND_GLOBAL             1
+#define ELF_BIND_WEAK               2
+#define ELF_BIND_GNU_UNIQUE         10
+#define ELF_SYMBOL_TYPE_SECTION     3
+#define ELF_SYMBOL_TYPE_FILE        4
+#define ELF_VERSYM_HIDDEN           0x8000  /* Not available to the links */
+
+#define AR_MAGIC                    "!<arch>\n"
+#define AR_THIN_MAGIC               "!<thin>\n"
+#define AR_MAGIC_SIZE               8
+#define AR_HEADER_SIZE              60
+
+/* Max depth of the GNU ld scripts that include other scripts */
+#define LINK_SCRIPT_MAX_DEPTH       4
+
+/* A global symbol of a LinkUnit */
+struct LinkSymbol {
+    const char                  *name;      /* In the mapped file */
+    int                         unit;
+    RTIBool                     defined;
+    RTIBool                     weak;
+};
+
+struct LinkUnit {
+    int                         lib;        /* -1 for the application */
+    int                         firstSymbol;
+    int                         symbolCount;
+    RTIBool                     loaded;     /* Part of the link */
+};
+
+struct LinkLib {
+    char                        name[MAX_STRING_SIZE];  /* As in -l<name> */
+    int                         firstUnit;
+    int                         unitCount;
+};
+
+/* Index of the symbols by name (open addressing, linear probing). The
+ * slots hold the index of the symbol + 1, 0 if free.
+ */
+struct SymbolIndex {
+    int                         *slots;
+    unsigned int                size;       /* Always a power of 2 */
+    unsigned int                count;
+};
+
+#define SYMBOL_INDEX_INITIAL_SIZE   1024
+
+struct LinkMapping {
+    void                        *addr;
+    size_t                      size;
+};
+
+struct LinkSet {
+    struct LinkSymbol           *symbols;
+    int                         symbolCount;
+    int                         symbolSize;
+    struct LinkUnit             *units;
+    int                         unitCount;
+    int                         unitSize;
+    struct LinkLib              *libs;
+    int                         libCount;
+    int                         libSize;
+    struct LinkMapping          *mappings;
+    int                         mappingCount;
+    int                         mappingSize;
+    /* First definition of each symbol in the loaded units */
+    struct SymbolIndex          defined;
+    /* First definition of each symbol in the libraries being resolved */
+    struct SymbolIndex          providers;
+};
+
+/* A mapped ELF file */
+struct ElfFile {
+    const unsigned char         *data;
+    size_t                      size;
+    RTIBool                     is64;
+    RTIBool                     msb;
+};
+
+/* {{{ growArray
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Makes room for one more element in an array of the LinkSet, doubling its
+ * capacity when full.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if out of memory
+ */
+static RTIBool growArray(void **array, int *size, int count, size_t elemSize) {
+    int newSize;
+    void *newArray;
+
+    if (count < *size) {
+        return RTI_TRUE;
+    }
+    newSize = (*size == 0) ? 64 : *size*2;
+    newArray = MEM_REALLOC(Symbols, *array, (size_t)newSize * elemSize);
+    if (newArray == NULL) {
+        fprintf(stderr, "Out of memory allocating the symbol tables\n");
+        return RTI_FALSE;
+    }
+    *array = newArray;
+    *size = newSize;
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ SymbolIndex_find
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the slot of the symbol with the given name, or the free slot
+ * where it should be inserted. The index must have at least one free slot.
+ */
+static int *SymbolIndex_find(const struct SymbolIndex *me,
+        const struct LinkSymbol *symbols,
+        const char *name) {
+    unsigned int i = (unsigned int)hashString(name) & (me->size-1);
+    while ((me->slots[i] != 0) &&
+            (strcmp(symbols[me->slots[i]-1].name, name) != 0)) {
+        i = (i+1) & (me->size-1);
+    }
+    return &me->slots[i];
+}
+
+/* }}} */
+/* {{{ SymbolIndex_lookup
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * \return          the index of the symbol with the given name, -1 if the
+ *                  index does not contain it
+ */
+static int SymbolIndex_lookup(const struct SymbolIndex *me,
+        const struct LinkSymbol *symbols,
+        const char *name) {
+    if (me->count == 0) {
+        return -1;
+    }
+    return *SymbolIndex_find(me, symbols, name) - 1;
+}
+
+/* }}} */
+/* {{{ SymbolIndex_add
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Adds a symbol to the index, unless it already contains one with the
+ * same name (the first one wins, as in a link). The table grows to keep
+ * the load factor below 1/2.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if out of memory
+ */
+static RTIBool SymbolIndex_add(struct SymbolIndex *me,
+        const struct LinkSymbol *symbols,
+        int symbol) {
+    int *slot;
+
+    if ((me->count+1)*2 > me->size) {
+        struct SymbolIndex grown;
+        unsigned int i;
+
+        grown.size = (me->size == 0) ? SYMBOL_INDEX_INITIAL_SIZE : me->size*2;
+        grown.count = me->count;
+        grown.slots = MEM_CALLOC(Symbols, grown.size, sizeof(*grown.slots));
+        if (grown.slots == NULL) {
+            fprintf(stderr, "Out of memory allocating the symbol tables\n");
+            return RTI_FALSE;
+        }
+        for (i = 0; i < me->size; ++i) {
+            if (me->slots[i] != 0) {
+                *SymbolIndex_find(&grown,
+                        symbols,
+                        symbols[me->slots[i]-1].name) = me->slots[i];
+            }
+        }
+        if (me->slots != NULL) {
+            MEM_FREE(me->slots);
+        }
+        *me = grown;
+    }
+    slot = SymbolIndex_find(me, symbols, symbols[symbol].name);
+    if (*slot == 0) {
+        *slot = symbol + 1;
+        ++me->count;
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ SymbolIndex_clear
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void SymbolIndex_clear(struct SymbolIndex *me) {
+    if (me->slots != NULL) {
+        MEM_FREE(me->slots);
+    }
+    memset(me, 0, sizeof(*me));
+}
+
+/* }}} */
+/* {{{ LinkSet_init
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void LinkSet_init(struct LinkSet *me) {
+    memset(me, 0, sizeof(*me));
+}
+
+/* }}} */
+/* {{{ LinkSet_finalize
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Releases the tables and unmaps all the files
+ */
+static void LinkSet_finalize(struct LinkSet *me) {
+    int i;
+
+    for (i = 0; i < me->mappingCount; ++i) {
+        munmap(me->mappings[i].addr, me->mappings[i].size);
+    }
+    if (me->mappings != NULL) {
+        MEM_FREE(me->mappings);
+    }
+    if (me->symbols != NULL) {
+        MEM_FREE(me->symbols);
+    }
+    if (me->units != NULL) {
+        MEM_FREE(me->units);
+    }
+    if (me->libs != NULL) {
+        MEM_FREE(me->libs);
+    }
+    SymbolIndex_clear(&me->defined);
+    SymbolIndex_clear(&me->providers);
+    LinkSet_init(me);
+}
+
+/* }}} */
+/* {{{ LinkSet_addLib
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Adds a library without units: the units are added by LinkSet_addFile.
+ *
+ * \return          the index of the library, -1 if out of memory
+ */
+static int LinkSet_addLib(struct LinkSet *me, const char *name) {
+    struct LinkLib *lib;
+
+    if (!growArray((void **)&me->libs,
+                &me->libSize,
+                me->libCount,
+                sizeof(*me->libs))) {
+        return -1;
+    }
+    lib = &me->libs[me->libCount];
+    snprintf(lib->name, sizeof(lib->name), "%s", name);
+    lib->firstUnit = me->unitCount;
+    lib->unitCount = 0;
+    return me->libCount++;
+}
+
+/* }}} */
+/* {{{ LinkSet_beginUnit
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Adds a unit to the given library (the last one added, -1 for the
+ * application): the following symbols are added to it.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if out of memory
+ */
+static RTIBool LinkSet_beginUnit(struct LinkSet *me, int lib) {
+    struct LinkUnit *unit;
+
+    if (!growArray((void **)&me->units,
+                &me->unitSize,
+                me->unitCount,
+                sizeof(*me->units))) {
+        return RTI_FALSE;
+    }
+    unit = &me->units[me->unitCount++];
+    unit->lib = lib;
+    unit->firstSymbol = me->symbolCount;
+    unit->symbolCount = 0;
+    unit->loaded = RTI_FALSE;
+    if (lib != -1) {
+        ++me->libs[lib].unitCount;
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ LinkSet_addSymbol
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Adds a symbol to the last unit
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if out of memory
+ */
+static RTIBool LinkSet_addSymbol(struct LinkSet *me,
+        const char *name,
+        RTIBool defined,
+        RTIBool weak) {
+    struct LinkSymbol *symbol;
+
+    if (!growArray((void **)&me->symbols,
+                &me->symbolSize,
+                me->symbolCount,
+                sizeof(*me->symbols))) {
+        return RTI_FALSE;
+    }
+    symbol = &me->symbols[me->symbolCount++];
+    symbol->name = name;
+    symbol->unit = me->unitCount-1;
+    symbol->defined = defined;
+    symbol->weak = weak;
+    ++me->units[me->unitCount-1].symbolCount;
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ ElfFile_read
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Reads an unsigned integer of 1, 2, 4 or 8 bytes in the byte order of the
+ * file. The caller checks that it is inside the file.
+ */
+static unsigned long long ElfFile_read(const struct ElfFile *me,
+        size_t offset,
+        int bytes) {
+    unsigned long long value = 0;
+    int i;
+
+    for (i = 0; i < bytes; ++i) {
+        int shift = me->msb ? (bytes-1-i)*8 : i*8;
+        value |= (unsigned long long)me->data[offset + (size_t)i] << shift;
+    }
+    return value;
+}
+
+/* }}} */
+/* {{{ ElfFile_getSection
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Reads the type, the position, the linked section and the entry size of a
+ * section from its header.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if the content of the
+ *                  section is outside the file
+ */
+static RTIBool ElfFile_getSection(const struct ElfFile *me,
+        size_t header,
+        unsigned int *typeOut,
+        size_t *offsetOut,
+        size_t *sizeOut,
+        unsigned int *linkOut,
+        size_t *entSizeOut) {
+    unsigned long long offset;
+    unsigned long long size;
+
+    *typeOut = (unsigned int)ElfFile_read(me, header + 4, 4);
+    if (me->is64) {
+        offset = ElfFile_read(me, header + 24, 8);
+        size = ElfFile_read(me, header + 32, 8);
+        *linkOut = (unsigned int)ElfFile_read(me, header + 40, 4);
+        *entSizeOut = (size_t)ElfFile_read(me, header + 56, 8);
+    } else {
+        offset = ElfFile_read(me, header + 16, 4);
+        size = ElfFile_read(me, header + 20, 4);
+        *linkOut = (unsigned int)ElfFile_read(me, header + 24, 4);
+        *entSizeOut = (size_t)ElfFile_read(me, header + 36, 4);
+    }
+    *offsetOut = (size_t)offset;
+    *sizeOut = (size_t)size;
+    return (offset <= me->size) && (size <= me->size - offset);
+}
+
+/* }}} */
+/* {{{ LinkSet_addElf
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Adds the global symbols of an ELF relocatable object (the symbol table)
+ * or shared library (the dynamic symbol table, without the hidden
+ * versions) to the last unit.
+ *
+ * \param data      the content of the file
+ * \param size      the size of data
+ * \param path      the path of the file (for the errors)
+ * \return          RTI_TRUE if success, RTI_FALSE if the file is not a
+ *                  valid ELF object or shared library
+ */
+static RTIBool LinkSet_addElf(struct LinkSet *me,
+        const unsigned char *data,
+        size_t size,
+        const char *path) {
+    struct ElfFile elf;
+    unsigned long long sectionOffset;
+    size_t headerSize;
+    size_t entSize;
+    size_t offset;
+    size_t count;
+    size_t symOffset = 0;
+    size_t symSize = 0;
+    size_t symEntSize = 0;
+    size_t strOffset;
+    size_t strSize;
+    size_t versymOffset = 0;
+    size_t versymSize = 0;
+    unsigned int sectionCount;
+    unsigned int wanted;
+    unsigned int type;
+    unsigned int link;
+    unsigned int strLink = 0;
+    unsigned int i;
+
+    elf.data = data;
+    elf.size = size;
+    if ((size < ELF_HEADER_MIN_SIZE) ||
+            ((data[4] != ELF_CLASS_32) && (data[4] != ELF_CLASS_64)) ||
+            ((data[5] != ELF_DATA_LSB) && (data[5] != ELF_DATA_MSB))) {
+        goto invalid;
+    }
+    elf.is64 = (data[4] == ELF_CLASS_64);
+    elf.msb = (data[5] == ELF_DATA_MSB);
+    if (elf.is64 && (size < 64)) {
+        goto invalid;
+    }
+    switch (ElfFile_read(&elf, 16, 2)) {
+        case ELF_TYPE_REL:
+            wanted = ELF_SECTION_SYMTAB;
+            break;
+        case ELF_TYPE_DYN:
+            wanted = ELF_SECTION_DYNSYM;
+            break;
+        default:
+            fprintf(stderr,
+                    "Error: %s is not an object file or a shared library\n",
+                    path);
+            return RTI_FALSE;
+    }
+    sectionOffset = ElfFile_read(&elf, elf.is64 ? 0x28 : 0x20, elf.is64 ? 8 : 4);
+    headerSize = (size_t)ElfFile_read(&elf, elf.is64 ? 0x3A : 0x2E, 2);
+    sectionCount = (unsigned int)ElfFile_read(&elf, elf.is64 ? 0x3C : 0x30, 2);
+    if (sectionOffset == 0) {
+        /* No sections: no symbols */
+        return RTI_TRUE;
+    }
+    if ((headerSize < (size_t)(elf.is64 ? 64 : 40)) ||
+            (sectionOffset > size) ||
+            ((size - sectionOffset) / headerSize < 1)) {
+        goto invalid;
+    }
+    if (sectionCount == 0) {
+        /* More than 0xff00 sections: the count is in the first header */
+        sectionCount = (unsigned int)ElfFile_read(&elf,
+                sectionOffset + (elf.is64 ? 32 : 20),
+                elf.is64 ? 8 : 4);
+    }
+    if ((size - sectionOffset) / headerSize < sectionCount) {
+        goto invalid;
+    }
+
+    for (i = 0; i < sectionCount; ++i) {
+        if (!ElfFile_getSection(&elf,
+                    sectionOffset + i*headerSize,
+                    &type,
+                    &offset,
+                    &count,
+                    &link,
+                    &entSize)) {
+            goto invalid;
+        }
+        if ((type == wanted) && (symEntSize == 0)) {
+            symOffset = offset;
+            symSize = count;
+            symEntSize = entSize;
+            strLink = link;
+        } else if ((type == ELF_SECTION_VERSYM) && (wanted == ELF_SECTION_DYNSYM)) {
+            versymOffset = offset;
+            versymSize = count;
+        }
+    }
+    if (symEntSize == 0) {
+        /* Stripped: no symbols */
+        return RTI_TRUE;
+    }
+    if ((symEntSize < (size_t)(elf.is64 ? 24 : 16)) ||
+            (strLink >= sectionCount) ||
+            !ElfFile_getSection(&elf,
+                    sectionOffset + strLink*headerSize,
+                    &type,
+                    &strOffset,
+                    &strSize,
+                    &link,
+                    &entSize) ||
+            (strSize == 0) ||
+            (data[strOffset + strSize - 1] != '\0')) {
+        goto invalid;
+    }
+
+    /* The first symbol is always the undefined one */
+    count = symSize / symEntSize;
+    for (i = 1; i < count; ++i) {
+        size_t sym = symOffset + i*symEntSize;
+        size_t nameOffset = (size_t)ElfFile_read(&elf, sym, 4);
+        unsigned int info = (unsigned int)ElfFile_read(&elf,
+                sym + (elf.is64 ? 4 : 12),
+                1);
+        unsigned int sectionIndex = (unsigned int)ElfFile_read(&elf,
+                sym + (elf.is64 ? 6 : 14),
+                2);
+        unsigned int bind = info >> 4;
+        unsigned int symType = info & 0xf;
+        RTIBool defined = (sectionIndex != ELF_SECTION_INDEX_UNDEF);
+
+        if (((bind != ELF_BIND_GLOBAL) &&
+                    (bind != ELF_BIND_WEAK) &&
+                    (bind != ELF_BIND_GNU_UNIQUE)) ||
+                (symType == ELF_SYMBOL_TYPE_SECTION) ||
+                (symType == ELF_SYMBOL_TYPE_FILE) ||
+                (nameOffset == 0) ||
+                (nameOffset >= strSize)) {
+            continue;
+        }
+        if (defined && (versymSize >= (i+1)*2)) {
+            unsigned int version = (unsigned int)ElfFile_read(&elf,
+                    versymOffset + i*2,
+                    2);
+            /* Local (0) and hidden versions do not resolve references */
+            if ((version == 0) || (version & ELF_VERSYM_HIDDEN)) {
+                continue;
+            }
+        }
+        if (!LinkSet_addSymbol(me,
+                    (const char *)data + strOffset + nameOffset,
+                    defined,
+                    (bind == ELF_BIND_WEAK))) {
+            return RTI_FALSE;
+        }
+    }
+    return RTI_TRUE;
+
+invalid:
+    fprintf(stderr, "Error: invalid ELF file: %s\n", path);
+    return RTI_FALSE;
+}
+
+/* }}} */
+/* {{{ LinkSet_addArchive
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Adds a unit for each ELF member of an ar archive. The symbol indexes,
+ * the tables of the long names and the members that are not ELF files
+ * (i.e. LLVM bitcode) are skipped.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if the archive or one of
+ *                  its members is not valid
+ */
+static RTIBool LinkSet_addArchive(struct LinkSet *me,
+        int lib,
+        const unsigned char *data,
+        size_t size,
+        const char *path) {
+    size_t offset = AR_MAGIC_SIZE;
+    char sizeField[11];
+    char memberPath[PATH_MAX+1];
+
+    while (offset + AR_HEADER_SIZE <= size) {
+        const unsigned char *header = data + offset;
+        const unsigned char *member;
+        size_t memberSize;
+        size_t nameSize = 0;
+        int count = 0;
+
+        if ((header[58] != '`') || (header[59] != '\n')) {
+            goto invalid;
+        }
+        memcpy(sizeField, header + 48, 10);
+        sizeField[10] = '\0';
+        memberSize = (size_t)strtoull(sizeField, NULL, 10);
+        offset += AR_HEADER_SIZE;
+        if (memberSize > size - offset) {
+            goto invalid;
+        }
+        member = data + offset;
+        if (memcmp(header, "#1/", 3) == 0) {
+            /* BSD: the name (of the given size) precedes the content */
+            memcpy(sizeField, header + 3, 10);
+            sizeField[10] = '\0';
+            nameSize = (size_t)strtoull(sizeField, NULL, 10);
+            if (nameSize > memberSize) {
+                goto invalid;
+            }
+        }
+        /* Symbol indexes (/, /SYM64/, __.SYMDEF) and long names (//) */
+        if (((header[0] == '/') &&
+                    ((header[1] == ' ') || (header[1] == '/') || (header[1] == 'S'))) ||
+                (memcmp(header, "__.SYMDEF", 9) == 0) ||
+                ((nameSize >= 9) && (memcmp(member, "__.SYMDEF", 9) == 0))) {
+            count = -1;
+        }
+        if ((count == 0) &&
+                (memberSize - nameSize >= 4) &&
+                (memcmp(member + nameSize, "\177ELF", 4) == 0)) {
+            snprintf(memberPath,
+                    sizeof(memberPath),
+                    "%s(member at offset %lu)",
+                    path,
+                    (unsigned long)(offset - AR_HEADER_SIZE));
+            if (!LinkSet_beginUnit(me, lib) ||
+                    !LinkSet_addElf(me,
+                        member + nameSize,
+                        memberSize - nameSize,
+                        memberPath)) {
+                return RTI_FALSE;
+            }
+        }
+        /* The members are aligned to 2 bytes */
+        offset += memberSize + (memberSize & 1);
+    }
+    return RTI_TRUE;
+
+invalid:
+    fprintf(stderr, "Error: invalid archive: %s\n", path);
+    return RTI_FALSE;
+}
+
+/* }}} */
+/* {{{ LinkSet_addFile
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Maps a file of a link and adds its units to the given library: an ELF
+ * object or shared library (one unit), an archive (one unit per member)
+ * or a GNU ld script of a library (the units of the files it names with
+ * an absolute path, i.e. GROUP ( /lib/libm.so.6 AS_NEEDED ( /lib/libmvec.so.1 ) )).
+ *
+ * \param lib       the library (the last one added, -1 for the
+ *                  application)
+ * \param path      the path of the file
+ * \param depth     the number of ld scripts that include the file
+ * \return          RTI_TRUE if success, RTI_FALSE if the file cannot be
+ *                  read or is not valid
+ */
+static RTIBool LinkSet_addFile(struct LinkSet *me,
+        int lib,
+        const char *path,
+        int depth) {
+    struct stat st;
+    const unsigned char *data;
+    void *addr;
+    size_t size;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        fprintf(stderr, "Error: cannot open %s: %s\n", path, strerror(errno));
+        return RTI_FALSE;
+    }
+    if (fstat(fd, &st) != 0) {
+        fprintf(stderr, "Error: cannot read %s: %s\n", path, strerror(errno));
+        close(fd);
+        return RTI_FALSE;
+    }
+    size = (size_t)st.st_size;
+    if (size == 0) {
+        close(fd);
+        fprintf(stderr, "Error: empty file: %s\n", path);
+        return RTI_FALSE;
+    }
+    addr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        fprintf(stderr, "Error: cannot map %s: %s\n", path, strerror(errno));
+        return RTI_FALSE;
+    }
+    if (!growArray((void **)&me->mappings,
+                &me->mappingSize,
+                me->mappingCount,
+                sizeof(*me->mappings))) {
+        munmap(addr, size);
+        return RTI_FALSE;
+    }
+    me->mappings[me->mappingCount].addr = addr;
+    me->mappings[me->mappingCount].size = size;
+    ++me->mappingCount;
+    data = (const unsigned char *)addr;
+
+    if ((size >= AR_MAGIC_SIZE) && (memcmp(data, AR_MAGIC, AR_MAGIC_SIZE) == 0)) {
+        return LinkSet_addArchive(me, lib, data, size, path);
+    }
+    if ((size >= AR_MAGIC_SIZE) &&
+            (memcmp(data, AR_THIN_MAGIC, AR_MAGIC_SIZE) == 0)) {
+        fprintf(stderr, "Error: thin archives are not supported: %s\n", path);
+        return RTI_FALSE;
+    }
+    if ((size >= 4) && (memcmp(data, "\177ELF", 4) == 0)) {
+        return LinkSet_beginUnit(me, lib) &&
+                LinkSet_addElf(me, data, size, path);
+    }
+    if ((lib != -1) &&
+            (depth < LINK_SCRIPT_MAX_DEPTH) &&
+            (memchr(data, '\0', size) == NULL)) {
+        /* GNU ld script: the absolute paths, outside the comments */
+        char file[PATH_MAX+1];
+        size_t i = 0;
+        size_t len;
+
+        while (i < size) {
+            if ((data[i] == '/') && (i+1 < size) && (data[i+1] == '*')) {
+                for (i += 2;
+                        (i+1 < size) && ((data[i] != '*') || (data[i+1] != '/'));
+                        ++i) {
+                }
+                i += 2;
+                continue;
+            }
+            if ((data[i] != '/') ||
+                    ((i > 0) && !isspace(data[i-1]) && (data[i-1] != '('))) {
+                ++i;
+                continue;
+            }
+            for (len = 0;
+                    (i+len < size) && !isspace(data[i+len]) &&
+                        (data[i+len] != ')') && (data[i+len] != ',');
+                    ++len) {
+            }
+            if (len > PATH_MAX) {
+                goto unknown;
+            }
+            memcpy(file, data + i, len);
+            file[len] = '\0';
+            if (!LinkSet_addFile(me, lib, file, depth+1)) {
+                return RTI_FALSE;
+            }
+            i += len;
+        }
+        return RTI_TRUE;
+    }
+
+unknown:
+    fprintf(stderr, "Error: unknown file format: %s\n", path);
+    return RTI_FALSE;
+}
+
+/* }}} */
+/* {{{ LinkSet_load
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Makes a unit part of the link: its definitions are added to the defined
+ * symbols.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if out of memory
+ */
+static RTIBool LinkSet_load(struct LinkSet *me, int unit) {
+    const struct LinkUnit *u = &me->units[unit];
+    int i;
+
+    me->units[unit].loaded = RTI_TRUE;
+    for (i = u->firstSymbol; i < u->firstSymbol + u->symbolCount; ++i) {
+        if (me->symbols[i].defined &&
+                !SymbolIndex_add(&me->defined, me->symbols, i)) {
+            return RTI_FALSE;
+        }
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ LinkSet_resolve
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Loads the units of the given libraries that define the symbols left
+ * undefined by the loaded units, and the units required by them, as the
+ * linker does with the archives (the libraries are searched as if they
+ * were grouped). The weak references do not load units.
+ *
+ * \param firstLib  the first library to search
+ * \param endLib    the library after the last one to search
+ * \param loadedOut receives RTI_TRUE if a unit of the libraries has been
+ *                  loaded
+ * \return          RTI_TRUE if success, RTI_FALSE if out of memory
+ */
+static RTIBool LinkSet_resolve(struct LinkSet *me,
+        int firstLib,
+        int endLib,
+        RTIBool *loadedOut) {
+    int *queue;
+    int head = 0;
+    int tail = 0;
+    int i;
+    int u;
+
+    *loadedOut = RTI_FALSE;
+    SymbolIndex_clear(&me->providers);
+    for (u = 0; u < me->unitCount; ++u) {
+        const struct LinkUnit *unit = &me->units[u];
+        if ((unit->lib < firstLib) || (unit->lib >= endLib)) {
+            continue;
+        }
+        for (i = unit->firstSymbol; i < unit->firstSymbol + unit->symbolCount; ++i) {
+            if (me->symbols[i].defined &&
+                    !SymbolIndex_add(&me->providers, me->symbols, i)) {
+                return RTI_FALSE;
+            }
+        }
+    }
+
+    queue = MEM_CALLOC(Symbols, (size_t)me->unitCount + 1, sizeof(*queue));
+    if (queue == NULL) {
+        fprintf(stderr, "Out of memory allocating the symbol tables\n");
+        return RTI_FALSE;
+    }
+    for (u = 0; u < me->unitCount; ++u) {
+        if (me->units[u].loaded) {
+            queue[tail++] = u;
+        }
+    }
+    while (head < tail) {
+        const struct LinkUnit *unit = &me->units[queue[head++]];
+        for (i = unit->firstSymbol; i < unit->firstSymbol + unit->symbolCount; ++i) {
+            const struct LinkSymbol *symbol = &me->symbols[i];
+            int provider;
+
+            if (symbol->defined || symbol->weak ||
+                    (SymbolIndex_lookup(&me->defined, me->symbols, symbol->name) != -1)) {
+                continue;
+            }
+            provider = SymbolIndex_lookup(&me->providers, me->symbols, symbol->name);
+            if (provider == -1) {
+                continue;
+            }
+            u = me->symbols[provider].unit;
+            if (!LinkSet_load(me, u)) {
+                MEM_FREE(queue);
+                return RTI_FALSE;
+            }
+            queue[tail++] = u;
+            *loadedOut = RTI_TRUE;
+        }
+    }
+    MEM_FREE(queue);
+    SymbolIndex_clear(&me->providers);
+    return RTI_TRUE;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * Minimal Link Set
+ **************************************************************************/
+/* --ldlibs-minimal [target] -- OBJS... prints the libraries required by
+ * the given objects (relocatable objects, archives or shared libraries of
+ * the application), in place of the fixed list of --ldlibs:
+ *  - the RTI Connext DDS libraries are the libraries of the variant
+ *    (--static, --debug) in $NDDSHOME/lib/<target> that define the symbols
+ *    used by the objects or by the other required libraries. They are
+ *    ordered so that each library precedes the libraries it uses (the
+ *    cycles are linked as a group);
+ *  - the system libraries ($SYSLIBS and the ones of the API, --api) are
+ *    kept only if they define some symbol still undefined. They are
+ *    searched in the -L directories of the system libraries and in the
+ *    search directories of the linker of the target: the libraries that
+ *    cannot be found (i.e. the linker is not installed) are kept.
+ *
+ * The symbols are read with the ELF reader above, without external tools.
+ * The output is always expanded: it depends on the installed files.
+ */
+
+/* The RTI Connext DDS libraries of --ldlibs, in link order. The other
+ * libraries of the target precede them, in alphabetic order.
+ */
+static const char *CONNEXT_LINK_ORDER[] = {
+    "rticonnextmsgcpp2", "rticonnextmsgcpp", "rticonnextmsgc",
+    "nddscpp2", "nddscpp", "nddsc", "nddscore",
+    NULL
+};
+
+/* A library of the target, as found by scanTargetLibs */
+struct TargetLib {
+    char                        stem[MAX_STRING_SIZE];  /* Without suffix */
+    int                         rank;   /* In CONNEXT_LINK_ORDER, -1 if not */
+};
+
+/* {{{ TargetLib_compare
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * qsort comparator: the libraries in link order
+ */
+static int TargetLib_compare(const void *a, const void *b) {
+    const struct TargetLib *libA = (const struct TargetLib *)a;
+    const struct TargetLib *libB = (const struct TargetLib *)b;
+
+    if (libA->rank != libB->rank) {
+        return libA->rank - libB->rank;
+    }
+    return strcmp(libA->stem, libB->stem);
+}
+
+/* }}} */
+/* {{{ scanTargetLibs
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Lists the libraries of the given variant in the directory of the target
+ * libraries (lib<stem><suffix>.a if static, lib<stem><suffix>.so
+ * otherwise), in link order. The release shared libraries lib<stem>d.so
+ * are skipped if lib<stem>.so exists (they are the debug ones).
+ *
+ * \param libDir    the directory of the libraries of the target
+ * \param libsOut   receives the array of the libraries, to release with
+ *                  MEM_FREE
+ * \param countOut  receives the number of libraries
+ * \return          RTI_TRUE if success, RTI_FALSE if the directory cannot
+ *                  be read
+ */
+static RTIBool scanTargetLibs(const char *libDir,
+        RTIBool isStatic,
+        const char *libSuffix,
+        struct TargetLib **libsOut,
+        int *countOut) {
+    const char *ext = isStatic ? ".a" : ".so";
+    size_t extLen = strlen(ext);
+    size_t suffixLen = strlen(libSuffix);
+    struct TargetLib *libs = NULL;
+    struct dirent *entry;
+    char path[PATH_MAX+1];
+    int size = 0;
+    int count = 0;
+    DIR *dir;
+
+    *libsOut = NULL;
+    *countOut = 0;
+    dir = opendir(libDir);
+    if (dir == NULL) {
+        fprintf(stderr,
+                "Error: cannot read the libraries in %s: %s\n",
+                libDir,
+                strerror(errno));
+        return RTI_FALSE;
+    }
+    while ((entry = readdir(dir)) != NULL) {
+        const char *name = entry->d_name;
+        size_t len = strlen(name);
+        size_t stemLen;
+        int i;
+
+        if ((len <= 3 + suffixLen + extLen) ||
+                (strncmp(name, "lib", 3) != 0) ||
+                (strcmp(name + len - extLen, ext) != 0) ||
+                (strncmp(name + len - extLen - suffixLen, libSuffix, suffixLen) != 0)) {
+            continue;
+        }
+        stemLen = len - 3 - suffixLen - extLen;
+        if (stemLen >= MAX_STRING_SIZE) {
+            continue;
+        }
+        if (!isStatic && (suffixLen == 0) && (name[3 + stemLen - 1] == 'd')) {
+            struct stat st;
+            snprintf(path,
+                    sizeof(path),
+                    "%s/lib%.*s%s",
+                    libDir,
+                    (int)stemLen - 1,
+                    name + 3,
+                    ext);
+            if (stat(path, &st) == 0) {
+                continue;
+            }
+        }
+        if (!growArray((void **)&libs, &size, count, sizeof(*libs))) {
+            closedir(dir);
+            if (libs != NULL) {
+                MEM_FREE(libs);
+            }
+            return RTI_FALSE;
+        }
+        memcpy(libs[count].stem, name + 3, stemLen);
+        libs[count].stem[stemLen] = '\0';
+        libs[count].rank = -1;
+        for (i = 0; CONNEXT_LINK_ORDER[i] != NULL; ++i) {
+            if (strcmp(CONNEXT_LINK_ORDER[i], libs[count].stem) == 0) {
+                libs[count].rank = i;
+            }
+        }
+        ++count;
+    }
+    closedir(dir);
+    if (count > 0) {
+        qsort(libs, (size_t)count, sizeof(*libs), TargetLib_compare);
+    }
+    *libsOut = libs;
+    *countOut = count;
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ getLinkerSearchDirs
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Gets the library search directories of the linker of the target (the
+ * gcc and clang drivers print them with -print-search-dirs).
+ *
+ * \param linker    the composed linker, with the variables expanded
+ * \param ldflags   the composed linker flags
+ * \param dirsOut   receives the directories separated by ':' (empty if the
+ *                  linker is not installed on the host or does not print
+ *                  them)
+ * \param dirsSize  the size of dirsOut
+ */
+static void getLinkerSearchDirs(const char *linker,
+        const char *ldflags,
+        char *dirsOut,
+        size_t dirsSize) {
+    const int maxWords = MAX_CMDLINEARG_SIZE/2 + 1;
+    char words[2][MAX_CMDLINEARG_SIZE+1];
+    char printArg[] = "-print-search-dirs";
+    char **cmd = NULL;
+    char *output = NULL;
+    const char *line;
+    int cmdLen = 0;
+    int i;
+    int n;
+
+    dirsOut[0] = '\0';
+    cmd = MEM_CALLOC(Compose, (size_t)(2*maxWords + 2), sizeof(*cmd));
+    output = MEM_CALLOC(Compose, PROBE_MAX_OUTPUT, 1);
+    if ((cmd == NULL) || (output == NULL)) {
+        fprintf(stderr, "Out of memory allocating the linker search\n");
+        goto done;
+    }
+    snprintf(words[0], sizeof(words[0]), "%s", linker);
+    snprintf(words[1], sizeof(words[1]), "%s", ldflags);
+    for (i = 0; i < 2; ++i) {
+        n = splitCommandWords(words[i], &cmd[cmdLen], maxWords);
+        if (n == -1) {
+            goto done;
+        }
+        cmdLen += n;
+    }
+    if (cmdLen == 0) {
+        goto done;
+    }
+    cmd[cmdLen++] = printArg;
+    cmd[cmdLen] = NULL;
+    if (!runCapture(cmd, NULL, output, PROBE_MAX_OUTPUT)) {
+        goto done;
+    }
+    /* libraries: =/usr/lib/gcc/x86_64-linux-gnu/12/:/lib/x86_64-linux-gnu/:... */
+    for (line = output; line != NULL; line = strchr(line, '\n')) {
+        if (*line == '\n') {
+            ++line;
+        }
+        if (strncmp(line, "libraries: =", 12) == 0) {
+            snprintf(dirsOut,
+                    dirsSize,
+                    "%.*s",
+                    (int)strcspn(line + 12, "\n"),
+                    line + 12);
+            break;
+        }
+    }
+
+done:
+    if (cmd != NULL) {
+        MEM_FREE(cmd);
+    }
+    if (output != NULL) {
+        MEM_FREE(output);
+    }
+}
+
+/* }}} */
+/* {{{ findSystemLib
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Finds the file of a system library as the linker does: lib<name>.so,
+ * then lib<name>.a, in each directory (:<file> for -l:<file>).
+ *
+ * \param name      the library, as in -l<name>
+ * \param dirs      the directories, separated by ':'
+ * \param pathOut   receives the path of the library
+ * \return          RTI_TRUE if found
+ */
+static RTIBool findSystemLib(const char *name,
+        const char *dirs,
+        char *pathOut,
+        size_t pathSize) {
+    static const char *EXTENSIONS[] = { ".so", ".a", NULL };
+    struct stat st;
+    const char *dir = dirs;
+    int i;
+
+    while (*dir != '\0') {
+        int dirLen = (int)strcspn(dir, ":");
+        for (i = 0; (dirLen > 0) && (EXTENSIONS[i] != NULL); ++i) {
+            int len = (name[0] == ':') ?
+                    snprintf(pathOut, pathSize, "%.*s/%s", dirLen, dir, name + 1) :
+                    snprintf(pathOut,
+                            pathSize,
+                            "%.*s/lib%s%s",
+                            dirLen,
+                            dir,
+                            name,
+                            EXTENSIONS[i]);
+            if ((len < (int)pathSize) &&
+                    (stat(pathOut, &st) == 0) &&
+                    S_ISREG(st.st_mode)) {
+                return RTI_TRUE;
+            }
+            if (name[0] == ':') {
+                break;
+            }
+        }
+        dir += dirLen;
+        if (*dir == ':') {
+            ++dir;
+        }
+    }
+    return RTI_FALSE;
+}
+
+/* }}} */
+/* {{{ appendLinkOrder
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Appends the used libraries (-l<name>) so that each one precedes the
+ * libraries it uses (uses[a*count+b] if library a uses library b). The
+ * ties are broken by the order of the libraries. If the uses have cycles,
+ * the remaining libraries are linked as a group.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if the output is too long
+ */
+static RTIBool appendLinkOrder(const struct LinkSet *set,
+        const char *libSuffix,
+        const RTIBool *used,
+        const unsigned char *uses,
+        int *usersOut,
+        char *bufOut,
+        size_t bufSize) {
+    int count = set->libCount;
+    int remaining = 0;
+    char option[MAX_STRING_SIZE+8];
+    int a;
+    int b;
+
+    /* usersOut: the number of libraries (not yet appended) using each one */
+    for (a = 0; a < count; ++a) {
+        usersOut[a] = 0;
+        remaining += used[a] ? 1 : 0;
+    }
+    for (a = 0; a < count; ++a) {
+        for (b = 0; b < count; ++b) {
+            if (used[a] && used[b] && (a != b) && uses[a*count+b]) {
+                ++usersOut[b];
+            }
+        }
+    }
+    while (remaining > 0) {
+        for (a = 0; a < count; ++a) {
+            if (used[a] && (usersOut[a] == 0)) {
+                break;
+            }
+        }
+        if (a == count) {
+            break;
+        }
+        snprintf(option, sizeof(option), "-l%s%s", set->libs[a].name, libSuffix);
+        if (!appendFlags(bufOut, bufSize, option)) {
+            return RTI_FALSE;
+        }
+        usersOut[a] = -1;
+        --remaining;
+        for (b = 0; b < count; ++b) {
+            if (used[b] && (a != b) && uses[a*count+b]) {
+                --usersOut[b];
+            }
+        }
+    }
+    if (remaining == 0) {
+        return RTI_TRUE;
+    }
+    if (!appendFlags(bufOut, bufSize, "-Wl,--start-group")) {
+        return RTI_FALSE;
+    }
+    for (a = 0; a < count; ++a) {
+        if (used[a] && (usersOut[a] != -1)) {
+            snprintf(option, sizeof(option), "-l%s%s", set->libs[a].name, libSuffix);
+            if (!appendFlags(bufOut, bufSize, option)) {
+                return RTI_FALSE;
+            }
+        }
+    }
+    return appendFlags(bufOut, bufSize, "-Wl,--end-group");
+}
+
+/* }}} */
+/* The buffers of composeMinimalLibs */
+struct MinimalLibsBuffers {
+    char                        libDir[PATH_MAX+1];
+    char                        path[PATH_MAX+1];
+    char                        sysDirs[PATH_MAX+1];    /* -L of the system libraries */
+    char                        linkerDirs[PATH_MAX+1];
+    char                        linker[MAX_CMDLINEARG_SIZE+1];
+    char                        ldflags[MAX_CMDLINEARG_SIZE+1];
+    char                        sysWords[2*(MAX_CMDLINEARG_SIZE+1)];
+};
+
+/* {{{ composeMinimalLibs
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes the output of --ldlibs-minimal.
+ *
+ * \param arch      pointer to the target Architecture
+ * \param NDDSHOME  the RTI Connext DDS installation
+ * \param apiIdx    the index in API_OPERATIONS of the API (--api), for
+ *                  the system libraries
+ * \param objects   the paths of the objects of the application
+ * \param objectCount the number of objects
+ * \param bufOut    receives the libraries
+ * \param bufSize   the size of bufOut
+ * \return          RTI_TRUE if success, RTI_FALSE if failed
+ */
+static RTIBool composeMinimalLibs(struct Architecture *arch,
+        const char *NDDSHOME,
+        int apiIdx,
+        RTIBool isStatic,
+        RTIBool isDebug,
+        char * const *objects,
+        int objectCount,
+        char *bufOut,
+        size_t bufSize) {
+    const int maxWords = MAX_CMDLINEARG_SIZE/2 + 1;
+    const char *libSuffix = getLibSuffix(isStatic, isDebug);
+    const char *sysLibs[] = {
+        "$SYSLIBS",
+        (apiIdx == 0) ? "$C_SYSLIBS" : "$CXX_SYSLIBS",
+        NULL
+    };
+    const char *linkerFlags[] = {
+        (apiIdx == 0) ? "$C_LINKER_FLAGS" : "$CXX_LINKER_FLAGS",
+        NULL
+    };
+    struct LinkSet set;
+    struct TargetLib *targetLibs = NULL;
+    struct MinimalLibsBuffers *bufs = NULL;
+    char **words = NULL;
+    RTIBool *used = NULL;
+    unsigned char *uses = NULL;
+    int *users = NULL;
+    RTIBool linkerSearched = RTI_FALSE;
+    RTIBool anyUsed = RTI_FALSE;
+    RTIBool loaded;
+    RTIBool ok = RTI_FALSE;
+    int targetLibCount = 0;
+    int wordCount;
+    int i;
+    int u;
+
+    LinkSet_init(&set);
+    bufOut[0] = '\0';
+    bufs = MEM_CALLOC(Compose, 1, sizeof(*bufs));
+    words = MEM_CALLOC(Compose, (size_t)maxWords, sizeof(*words));
+    if ((bufs == NULL) || (words == NULL)) {
+        fprintf(stderr, "Out of memory allocating the link set\n");
+        goto done;
+    }
+
+    /* The objects of the application are always part of the link */
+    for (i = 0; i < objectCount; ++i) {
+        if (!LinkSet_addFile(&set, -1, objects[i], 0)) {
+            goto done;
+        }
+    }
+    for (u = 0; u < set.unitCount; ++u) {
+        if (!LinkSet_load(&set, u)) {
+            goto done;
+        }
+    }
+
+    /* The RTI Connext DDS libraries */
+    snprintf(bufs->libDir, sizeof(bufs->libDir), "%s/lib/%s", NDDSHOME, arch->target);
+    if (!scanTargetLibs(bufs->libDir, isStatic, libSuffix, &targetLibs, &targetLibCount)) {
+        goto done;
+    }
+    for (i = 0; i < targetLibCount; ++i) {
+        snprintf(bufs->path,
+                sizeof(bufs->path),
+                "%s/lib/%s/lib%s%s%s",
+                NDDSHOME,
+                arch->target,
+                targetLibs[i].stem,
+                libSuffix,
+                isStatic ? ".a" : ".so");
+        if ((LinkSet_addLib(&set, targetLibs[i].stem) == -1) ||
+                !LinkSet_addFile(&set, i, bufs->path, 0)) {
+            goto done;
+        }
+    }
+    if (!LinkSet_resolve(&set, 0, targetLibCount, &loaded)) {
+        goto done;
+    }
+
+    /* The uses between the libraries, through the loaded units (the order
+     * of the shared libraries does not matter)
+     */
+    used = MEM_CALLOC(Symbols, (size_t)targetLibCount + 1, sizeof(*used));
+    users = MEM_CALLOC(Symbols, (size_t)targetLibCount + 1, sizeof(*users));
+    uses = MEM_CALLOC(Symbols, (size_t)targetLibCount * (size_t)targetLibCount + 1, 1);
+    if ((used == NULL) || (users == NULL) || (uses == NULL)) {
+        fprintf(stderr, "Out of memory allocating the link set\n");
+        goto done;
+    }
+    for (u = 0; u < set.unitCount; ++u) {
+        const struct LinkUnit *unit = &set.units[u];
+        if (!unit->loaded || (unit->lib == -1)) {
+            continue;
+        }
+        used[unit->lib] = RTI_TRUE;
+        anyUsed = RTI_TRUE;
+        for (i = unit->firstSymbol; i < unit->firstSymbol + unit->symbolCount; ++i) {
+            int def;
+            int lib;
+            if (set.symbols[i].defined || set.symbols[i].weak) {
+                continue;
+            }
+            def = SymbolIndex_lookup(&set.defined, set.symbols, set.symbols[i].name);
+            if (def == -1) {
+                continue;
+            }
+            lib = set.units[set.symbols[def].unit].lib;
+            if (isStatic && (lib != -1)) {
+                uses[unit->lib*targetLibCount + lib] = 1;
+            }
+        }
+    }
+    if (anyUsed) {
+        snprintf(bufs->path, sizeof(bufs->path), "-L%s/lib/%s", NDDSHOME, arch->target);
+        if (!appendFlags(bufOut, bufSize, bufs->path) ||
+                !appendLinkOrder(&set, libSuffix, used, uses, users, bufOut, bufSize)) {
+            goto tooLong;
+        }
+    }
+
+    /* The system libraries: each one can resolve the symbols left
+     * undefined by the previous ones
+     */
+    if (composeCompositeFlagsProperties(arch,
+                sysLibs,
+                RTI_TRUE,
+                RTI_FALSE,
+                bufs->sysWords,
+                sizeof(bufs->sysWords)) == ComposeResult_Error) {
+        goto done;
+    }
+    wordCount = splitCommandWords(bufs->sysWords, words, maxWords);
+    if (wordCount == -1) {
+        fprintf(stderr,
+                "Error: invalid system libraries for target '%s'\n",
+                arch->target);
+        goto done;
+    }
+    bufs->sysDirs[0] = '\0';
+    for (i = 0; i < wordCount; ++i) {
+        if ((strncmp(words[i], "-L", 2) == 0) && (words[i][2] != '\0')) {
+            size_t len = strlen(bufs->sysDirs);
+            snprintf(bufs->sysDirs + len,
+                    sizeof(bufs->sysDirs) - len,
+                    "%s%s",
+                    (len > 0) ? ":" : "",
+                    words[i] + 2);
+        }
+    }
+    for (i = 0; i < wordCount; ++i) {
+        int lib;
+        if ((strncmp(words[i], "-l", 2) != 0) || (words[i][2] == '\0')) {
+            /* Not a library (i.e. -L, --sysroot): always kept */
+            if (!appendFlags(bufOut, bufSize, words[i])) {
+                goto tooLong;
+            }
+            continue;
+        }
+        if (!findSystemLib(words[i] + 2, bufs->sysDirs, bufs->path, sizeof(bufs->path))) {
+            if (!linkerSearched) {
+                linkerSearched = RTI_TRUE;
+                if (composeStringProperty(arch,
+                            (apiIdx == 0) ? "$C_LINKER" : "$CXX_LINKER",
+                            RTI_TRUE,
+                            bufs->linker,
+                            sizeof(bufs->linker)) != ComposeResult_Ok) {
+                    bufs->linker[0] = '\0';
+                }
+                if (composeCompositeFlagsProperties(arch,
+                            linkerFlags,
+                            RTI_TRUE,
+                            RTI_FALSE,
+                            bufs->ldflags,
+                            sizeof(bufs->ldflags)) != ComposeResult_Ok) {
+                    bufs->ldflags[0] = '\0';
+                }
+                getLinkerSearchDirs(bufs->linker,
+                        bufs->ldflags,
+                        bufs->linkerDirs,
+                        sizeof(bufs->linkerDirs));
+            }
+            if (!findSystemLib(words[i] + 2, bufs->linkerDirs, bufs->path, sizeof(bufs->path))) {
+                /* Cannot be checked: kept */
+                if (!appendFlags(bufOut, bufSize, words[i])) {
+                    goto tooLong;
+                }
+                continue;
+            }
+        }
+        lib = LinkSet_addLib(&set, words[i] + 2);
+        if ((lib == -1) ||
+                !LinkSet_addFile(&set, lib, bufs->path, 0) ||
+                !LinkSet_resolve(&set, lib, lib + 1, &loaded)) {
+            goto done;
+        }
+        if (loaded && !appendFlags(bufOut, bufSize, words[i])) {
+            goto tooLong;
+        }
+    }
+    ok = RTI_TRUE;
+    goto done;
+
+tooLong:
+    fprintf(stderr,
+            "Composed --ldlibs-minimal too long for target %s\n",
+            arch->target);
+
+done:
+    LinkSet_finalize(&set);
+    if (targetLibs != NULL) {
+        MEM_FREE(targetLibs);
+    }
+    if (bufs != NULL) {
+        MEM_FREE(bufs);
+    }
+    if (words != NULL) {
+        MEM_FREE(words);
+    }
+    if (used != NULL) {
+        MEM_FREE(used);
+    }
+    if (users != NULL) {
+        MEM_FREE(users);
+    }
+    if (uses != NULL) {
+        MEM_FREE(uses);
+    }
+    return ok;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * Absolute Library Paths
+ **************************************************************************/
+/* --ldlibs-abs replaces each -l<name> of the composed libraries with the
+ * path of the file the linker would choose, so that the link does not
+ * scan the search directories and does not depend on their content:
+ *  - the RTI Connext DDS libraries are the files of the variant (--static,
+ *    --debug) in $NDDSHOME/lib/<target>. A missing file is an error when
+ *    the settings are composed (i.e. by configure) instead of at link
+ *    time. The -L of the directory is removed (replaced by -rpath-link
+ *    for the shared libraries, where the linker finds their dependencies);
+ *  - the system libraries are searched as the linker does (lib<name>.so,
+ *    then lib<name>.a) in the -L directories, in <sysroot>/usr/lib and
+ *    <sysroot>/lib if --sysroot is in the libraries or in the linker
+ *    flags, and in the search directories of the linker of the target.
+ *    The libraries that cannot be found are kept.
+ */
+
+struct AbsoluteLibsBuffers {
+    char                        words[MAX_CMDLINEARG_SIZE+1];
+    char                        out[MAX_CMDLINEARG_SIZE+1];
+    char                        libDir[PATH_MAX+1];
+    char                        path[PATH_MAX+1];
+    char                        dirs[MAX_CMDLINEARG_SIZE+1];    /* -L, sysroot */
+    char                        linkerDirs[PATH_MAX+1];
+    char                        linker[MAX_CMDLINEARG_SIZE+1];
+    char                        ldflags[MAX_CMDLINEARG_SIZE+1];
+};
+
+/* {{{ isConnextLib
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns RTI_TRUE if -l<name> is a RTI Connext DDS library of the variant
+ * with the given suffix (see CONNEXT_LINK_ORDER).
+ */
+static RTIBool isConnextLib(const char *name, const char *libSuffix) {
+    size_t len = strlen(name);
+    size_t suffixLen = strlen(libSuffix);
+    int i;
+
+    if ((len <= suffixLen) || (strcmp(name + len - suffixLen, libSuffix) != 0)) {
+        return RTI_FALSE;
+    }
+    for (i = 0; CONNEXT_LINK_ORDER[i] != NULL; ++i) {
+        if ((strlen(CONNEXT_LINK_ORDER[i]) == len - suffixLen) &&
+                (strncmp(CONNEXT_LINK_ORDER[i], name, len - suffixLen) == 0)) {
+            return RTI_TRUE;
+        }
+    }
+    return RTI_FALSE;
+}
+
+/* }}} */
+/* {{{ addSysrootDirs
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Appends to dirs (separated by ':') the library directories of the
+ * sysroot given by the --sysroot=<dir> options in flags.
+ */
+static void addSysrootDirs(const char *flags, char *dirs, size_t dirsSize) {
+    const char *word = flags;
+
+    while (*word != '\0') {
+        int wordLen = (int)strcspn(word, " \t");
+        if ((wordLen > 10) && (strncmp(word, "--sysroot=", 10) == 0)) {
+            size_t len = strlen(dirs);
+            snprintf(dirs + len,
+                    dirsSize - len,
+                    "%s%.*s/usr/lib:%.*s/lib",
+                    (len > 0) ? ":" : "",
+                    wordLen - 10,
+                    word + 10,
+                    wordLen - 10,
+                    word + 10);
+        }
+        word += wordLen;
+        word += strspn(word, " \t");
+    }
+}
+
+/* }}} */
+/* {{{ canonicalizeLibDir
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Resolves the directory of the path of a library found in the search
+ * directories of the linker (i.e. /usr/lib/gcc/x86_64-linux-gnu/12/../../../).
+ * The name of the file is kept: if it is a symbolic link, it is the name
+ * the linker would use.
+ */
+static void canonicalizeLibDir(char *path, size_t pathSize) {
+    char dir[PATH_MAX+1];
+    char resolved[PATH_MAX+1];
+    char *slash = strrchr(path, '/');
+
+    if ((slash == NULL) || (slash == path) || 
+            ((size_t)(slash - path) >= sizeof(dir))) {
+        return;
+    }
+    memcpy(dir, path, (size_t)(slash - path));
+    dir[slash - path] = '\0';
+    if ((realpath(dir, resolved) != NULL) &&
+            (strlen(resolved) + strlen(slash) < pathSize)) {
+        memmove(path + strlen(resolved), slash, strlen(slash) + 1);
+        memcpy(path, resolved, strlen(resolved));
+    }
+}
+
+/* }}} */
+/* {{{ resolveAbsoluteLibs
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Replaces in place the libraries (-l<name>) of composed libraries with
+ * the paths of their files (--ldlibs-abs).
+ *
+ * \param arch      pointer to the target Architecture
+ * \param NDDSHOME  the RTI Connext DDS installation
+ * \param apiIdx    the index in API_OPERATIONS of the API, for the linker
+ * \param buf       the composed libraries, with the variables expanded
+ * \param bufSize   the size of buf
+ * \return          RTI_TRUE if success, RTI_FALSE if a RTI Connext DDS
+ *                  library is missing or the output is too long
+ */
+static RTIBool resolveAbsoluteLibs(struct Architecture *arch,
+        const char *NDDSHOME,
+        int apiIdx,
+        RTIBool isStatic,
+        RTIBool isDebug,
+        char *buf,
+        size_t bufSize) {
+    const char *libSuffix = getLibSuffix(isStatic, isDebug);
+    const char *linkerFlags[] = {
+        (apiIdx == 0) ? "$C_LINKER_FLAGS" : "$CXX_LINKER_FLAGS",
+        NULL
+    };
+    struct AbsoluteLibsBuffers *bufs = NULL;
+    RTIBool linkerSearched = RTI_FALSE;
+    RTIBool ok = RTI_FALSE;
+    struct stat st;
+    char *word;
+    char *end;
+
+    bufs = MEM_CALLOC(Compose, 1, sizeof(*bufs));
+    if (bufs == NULL) {
+        fprintf(stderr, "Out of memory allocating the library paths\n");
+        goto done;
+    }
+    if (strlen(buf) >= sizeof(bufs->words)) {
+        goto tooLong;
+    }
+    strcpy(bufs->words, buf);
+    snprintf(bufs->libDir, sizeof(bufs->libDir), "%s/lib/%s", NDDSHOME, arch->target);
+    if (composeCompositeFlagsProperties(arch,
+                linkerFlags,
+                RTI_TRUE,
+                RTI_FALSE,
+                bufs->ldflags,
+                sizeof(bufs->ldflags)) != ComposeResult_Ok) {
+        bufs->ldflags[0] = '\0';
+    }
+
+    /* The words, separated by '\0' */
+    end = bufs->words + strlen(bufs->words);
+    for (word = bufs->words; word < end; ++word) {
+        if (isspace((unsigned char)*word)) {
+            *word = '\0';
+        }
+    }
+
+    /* The linker searches all the -L directories, wherever they are */
+    for (word = bufs->words; word < end; word += strlen(word) + 1) {
+        if ((strncmp(word, "-L", 2) == 0) && (word[2] != '\0')) {
+            size_t len = strlen(bufs->dirs);
+            snprintf(bufs->dirs + len,
+                    sizeof(bufs->dirs) - len,
+                    "%s%s",
+                    (len > 0) ? ":" : "",
+                    word + 2);
+        }
+    }
+    addSysrootDirs(buf, bufs->dirs, sizeof(bufs->dirs));
+    addSysrootDirs(bufs->ldflags, bufs->dirs, sizeof(bufs->dirs));
+
+    for (word = bufs->words; word < end; word += strlen(word) + 1) {
+        const char *name = word + 2;
+        if (*word == '\0') {
+            continue;
+        }
+        if ((strncmp(word, "-L", 2) == 0) && (strcmp(name, bufs->libDir) == 0)) {
+            /* The linker still looks for the libraries used by the shared
+             * libraries (DT_NEEDED), without scanning for -l
+             */
+            if (!isStatic) {
+                snprintf(bufs->path, sizeof(bufs->path), "-Wl,-rpath-link,%s", name);
+                if (!appendFlags(bufs->out, sizeof(bufs->out), bufs->path)) {
+                    goto tooLong;
+                }
+            }
+            continue;
+        }
+        if ((strncmp(word, "-l", 2) != 0) || (*name == '\0')) {
+            if (!appendFlags(bufs->out, sizeof(bufs->out), word)) {
+                goto tooLong;
+            }
+            continue;
+        }
+        if (isConnextLib(name, libSuffix)) {
+            snprintf(bufs->path,
+                    sizeof(bufs->path),
+                    "%s/lib/%s/lib%s%s",
+                    NDDSHOME,
+                    arch->target,
+                    name,
+                    isStatic ? ".a" : ".so");
+            if ((stat(bufs->path, &st) != 0) || !S_ISREG(st.st_mode)) {
+                fprintf(stderr,
+                        "Error: %s not found: the %s%s libraries are not installed for target %s\n"
+                        "Use --list-installed --variants to print the installed variants\n",
+                        bufs->path,
+                        isStatic ? "static" : "shared",
+                        isDebug ? " debug" : "",
+                        arch->target);
+                goto done;
+            }
+        } else if (!findSystemLib(name, bufs->dirs, bufs->path, sizeof(bufs->path))) {
+            if (!linkerSearched) {
+                linkerSearched = RTI_TRUE;
+                if (composeStringProperty(arch,
+                            (apiIdx == 0) ? "$C_LINKER" : "$CXX_LINKER",
+                            RTI_TRUE,
+                            bufs->linker,
+                            sizeof(bufs->linker)) != ComposeResult_Ok) {
+                    bufs->linker[0] = '\0';
+                }
+                getLinkerSearchDirs(bufs->linker,
+                        bufs->ldflags,
+                        bufs->linkerDirs,
+                        sizeof(bufs->linkerDirs));
+            }
+            if (!findSystemLib(name, bufs->linkerDirs, bufs->path, sizeof(bufs->path))) {
+                /* Left to the linker */
+                if (!appendFlags(bufs->out, sizeof(bufs->out), word)) {
+                    goto tooLong;
+                }
+                continue;
+            }
+            canonicalizeLibDir(bufs->path, sizeof(bufs->path));
+        }
+        if (!appendFlags(bufs->out, sizeof(bufs->out), bufs->path)) {
+            goto tooLong;
+        }
+    }
+    if (strlen(bufs->out) >= bufSize) {
+        goto tooLong;
+    }
+    strcpy(buf, bufs->out);
+    ok = RTI_TRUE;
+    goto done;
+
+tooLong:
+    fprintf(stderr,
+            "Libraries with absolute paths too long for target %s\n",
+            arch->target);
+
+done:
+    if (bufs != NULL) {
+        MEM_FREE(bufs);
+    }
+    return ok;
+}
+
+/* }}} */
+
+
+/* {{{ usage
+ * -----------------------------------------------------------------------------
+ */
+void usage() {
+    const char *line;
+    const char *end;
+
+    printf("RTI Connext DDS Config version %s\n", 
+            APPLICATION_VERSION); 
+    printf("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
+    printf("Usage:\n");
+    printf("    %s -h|--help        Show this help\n", 
+            APPLICATION_NAME);
+    printf("    %s -V|--version     Prints version number\n", 
+            APPLICATION_NAME);
+    printf("    %s --list-all       List all platform architectures supported\n", 
+            APPLICATION_NAME);
+    printf("    %s --list-installed List the installed architectures\n",
+            APPLICATION_NAME);
+    printf("    %s --list-installed --variants\n"
+           "                                List the installed architectures and the\n"
+           "                                library variants installed for each of them\n",
+            APPLICATION_NAME);
+    printf("    %s --export-json [targetArch...]\n"
+           "                                Export all settings of the given (or all)\n"
+           "                                architectures as a JSON document\n",
+            APPLICATION_NAME);
+    printf("    %s --generate-pkgconfig <dir> [targetArch...]\n"
+           "                                Generate the pkg-config files for the given\n"
+           "                                (or all the installed) architectures\n",
+            APPLICATION_NAME);
+    printf("    %s --generate-cmake <dir> [targetArch...]\n"
+           "                                Generate the CMake package configuration for\n"
+           "                                the given (or all the installed) architectures\n",
+            APPLICATION_NAME);
+    printf("    %s --verify-all [--jobs=N]\n"
+           "                                Compose all the operations with all the\n"
+           "                                modifiers for all the architectures in\n"
+           "                                parallel and report the errors\n",
+            APPLICATION_NAME);
+    printf("    %s --exec=cc|c++|ld|ld++ [args...]\n"
+           "                                Execute the compiler (or linker) of the\n"
+           "                                $NDDSARCH architecture with its flags and\n"
+           "                                the given arguments (same as invoking the\n"
+           "                                connext-cc, connext-c++, connext-ld or\n"
+           "                                connext-ld++ links). Options:\n",
+            APPLICATION_NAME);
+    /* Indented under --exec, not to be confused with the commands */
+    for (line = WRAPPER_USAGE; *line != '\0'; line = end + 1) {
+        end = strchr(line, '\n');
+        printf("    %.*s\n", (int)(end - line), line);
+    }
+    printf("    %s --launcher-show-stats [--launcher=L]\n"
+           "                                Print the global statistics of the compiler\n"
+           "                                launcher (default: auto), the same for all\n"
+           "                                the targets\n",
+            APPLICATION_NAME);
+    printf("    %s --probe-linkers [targetArch]\n"
+           "                                Print the linkers (-fuse-ld) accepted by the\n"
+           "                                toolchain of the target\n",
+            APPLICATION_NAME);
+    printf("    %s [modifiers] --ldlibs-minimal [targetArch] -- OBJS...\n"
+           "                                Print the libraries required by the objects\n"
+           "                                OBJS: the RTI Connext DDS libraries in link\n"
+           "                                order and the system libraries that define\n"
+           "                                some of their symbols (always expanded)\n",
+            APPLICATION_NAME);
+    printf("    %s --trace-report [file]\n"
+           "                                Summarize the invocations recorded in the trace\n"
+           "                                file (default: $%s)\n",
+            APPLICATION_NAME,
+            TRACE_ENV_VARIABLE);
+#ifndef NDEBUG
+    printf("    %s --dump-all       Dump all platforms and all settings (testing only)\n", 
+            APPLICATION_NAME);
+#endif
+    printf("    %s [modifiers] <what> [targetArch]\n", 
+            APPLICATION_NAME);
+    printf("\n");
+    /*      0        1         2         3         4         5         6         7         8 */
+    /*      12345678901234567890123456789012345678901234567890123456789012345678901234567890 */
+    printf("Where [modifiers] are:\n");
+    printf("    --static      use static linking against RTI Connext DDS\n");
+    printf("    --debug       use debug version of the RTI Connext DDS libraries\n");
+    printf("    --sh          use shell-like variable expansion (vs. make-like variables)\n");
+    printf("    --noexpand    do not expand environment variables in output\n");
+    printf("    --libmsg      include libraries for building request/reply apps\n");
+    printf("    --output=FILE write the output of --emit-make or --emit-sh to FILE (only\n");
+    printf("                  if changed)\n");
+    printf("    --api=API     API used by --emit-sh, --pch and --modules: c (default,\n");
+    printf("                  cxx for --modules), cxx, cxx03, cxx11\n");
+    printf("    --pch-build   build the PCH of --pch and print the flags to use it\n");
+    printf("    --launcher=L  prefix the compilers with a compiler cache and make the\n");
+    printf("                  compiler flags stable for it. L is one of: none (default),\n");
+    printf("                  auto (ccache or sccache, if found in PATH), ccache, sccache\n");
+    printf("    --profile=P   add the options of a build profile for the compiler of the\n");
+    printf("                  target: lto, pgo-gen[=DIR] or pgo-use[=DIR] (the profiles\n");
+    printf("                  are in DIR/<target>, default DIR: ./%s)\n", PROFILE_DEFAULT_DIR);
+    printf("    --fast-debug-link  speed up the debug links: split DWARF, gdb index and the\n");
+    printf("                  fastest linker accepted by the target (mold, lld, gold)\n");
+    printf("    --linker=L    link with the given linker (-fuse-ld): auto (the fastest\n");
+    printf("                  accepted by the target, if any), mold, lld, gold, bfd\n");
+    printf("    --rpath=MODE  record in the executables where the shared RTI Connext DDS\n");
+    printf("                  libraries are (linker flags): absolute ($NDDSHOME/lib/\n");
+    printf("                  <target>), origin[:RELPATH] ($ORIGIN/RELPATH, default\n");
+    printf("                  RELPATH: %s), none (default)\n", RPATH_DEFAULT_ORIGIN_DIR);
+    printf("    --ldlibs-abs  output the libraries as absolute paths of their files\n");
+    printf("                  (fails if the RTI Connext DDS libraries are missing)\n");
+#ifdef ENABLE_STATS
+    printf("    --stats       print timings and counters to stderr (same as setting\n");
+    printf("                  the environment variable %s=1)\n", STATS_ENV_VARIABLE);
+    printf("    --stats=perf  also print the hardware counters of parse, lookup and\n");
+    printf("                  compose (same as setting %s=perf)\n", STATS_ENV_VARIABLE);
+    printf("    --mem-report  print the heap allocations of each call site, the peak\n");
+    printf("                  of the live memory and the leaks at exit to stderr\n");
+#endif
+/*    printf("    --librs       include libraries for building Routing Service apps/plugins\n"); */
+/*    printf("    --libsecurity include libraries for building security applications\n"); */
+    printf("\n");
+    printf("Required argument <what> is one of:\n");
+    printf("  C API:\n");
+    printf("    --ccomp       output the C compiler to use\n");
+    printf("    --cflags      output all pre-processor and compiler flags\n");
+    printf("    --clink       output the C linker to use\n");
+    printf("    --ldflags     output the linker flags\n");
+    printf("    --ldlibs      output the required libraries\n");
+    printf("  Traditional C++ API:\n");
+    printf("    --cxxcomp     output the C++ compiler to use\n");
+    printf("    --cxxflags    output all pre-processor and compiler flags\n");
+    printf("    --cxxlink     output the C++ linker to use\n");
+    printf("    --ldxxflags   output the linker flags\n");
+    printf("    --ldxxlibs    output the required libraries\n");
+    printf("  Modern C++ API (C++-03):\n");
+    printf("    --cxx03comp   output the C++ compiler to use\n");
+    printf("    --cxx03flags  output all pre-processor and compiler flags\n");
+    printf("    --cxx03link   output the C++ linker to use\n");
+    printf("    --ldxx03flags output the linker flags\n");
+    printf("    --ldxx03libs  output the required libraries\n");
+    printf("  Modern C++ API (C++-11):\n");
+    printf("    --cxx11comp   output the C++ compiler to use\n");
+    printf("    --cxx11flags  output all pre-processor and compiler flags\n");
+    printf("    --cxx11link   output the C++ linker to use\n");
+    printf("    --ldxx11flags output the linker flags\n");
+    printf("    --ldxx11libs  output the required libraries\n");
+    printf("  Miscellaneous:\n");
+    printf("    --os          output the OS (i.e. UNIX, ANDROID, IOS, ...)\n");
+    printf("    --platform    output the Platform (i.e. i86, x64, armv7a, ...)\n");
+    printf("  Build system fragments:\n");
+    printf("    --emit-make   output a GNU make fragment with all the settings\n");
+    printf("    --emit-sh     output shell assignments (CC, LD, CFLAGS, LDFLAGS, LIBS,\n");
+    printf("                  RTI_LIB_SUFFIX, RTI_TARGET_INSTALLED) for `eval`\n");
+    printf("    --pch=DIR     output the commands to build in DIR a precompiled header\n");
+    printf("                  of the Connext DDS header of the API (gcc and clang)\n");
+    printf("    --modules=DIR output the commands to build in DIR a module of the\n");
+    printf("                  Connext DDS header of the C++ API (clang: module map,\n");
+    printf("                  gcc 11 or later: C++20 header unit)\n");
+    printf("    --cxxmodflags build the module of --modules=DIR (once) and output the\n");
+    printf("                  compiler flags to use it\n");
+    printf("\n");
+    printf("Optional argument [targetArch] is one of the supported target architectures.\n");
+    printf("If not specified, uses environment variable NDDSARCH.\n");
+    printf("Use `--list-all` or `--list-installed` to print a list of architectures\n");
+    printf("\n");
+    printf("Set the environment variable %s to a file path to append a record\n", 
+            TRACE_ENV_VARIABLE);
+    printf("of each invocation to that file (see --trace-report).\n");
+    printf("The results of the toolchain probes (i.e. --profile) are cached in the\n");
+    printf("directory set by %s (default: ~/.cache/%s).\n",
+            PROBE_CACHE_ENV_VARIABLE,
+            PROBE_CACHE_DIR_NAME);
+}
+
+/* }}} */
+/* {{{ main
+ * -----------------------------------------------------------------------------
+ */
+int main(int argc, char **argv) {
+    const char *argOp = NULL;
+    const char *argTarget = NULL;
+    RTIBool argStatic = RTI_FALSE;
+    RTIBool argDebug = RTI_FALSE;
+    RTIBool argShell = RTI_FALSE;
+    RTIBool argExpandEnvVar = RTI_TRUE;
+    RTIBool argMsg = RTI_FALSE;
+    RTIBool argVariants = RTI_FALSE;
+    RTIBool argStats = RTI_FALSE;
+    RTIBool argStatsPerf = RTI_FALSE;
+    RTIBool argMemReport = RTI_FALSE;
+    int argJobs = 0;
+    /*
+    RTIBool argRs = RTI_FALSE;
+    RTIBool argSec = RTI_FALSE;
+    */
+    char *NDDSHOME = NULL;
+    char *platformFile = NULL;
+    int retCode = APPLICATION_EXIT_UNKNOWN;
+    struct REDAInlineList *archDef = NULL;
+    struct Architecture *archTarget;
+    struct PlatformFileInfo platformInfo;
+    struct ComposeContext *composeCtx = NULL;
+    char *outBuf = NULL;
+    char **exportTargets = NULL;
+    int exportTargetCount = 0;
+    const char *argOutDir = NULL;
+    const char *argOutFile = NULL;
+    const char *argApi = "c";
+    const char *argLauncher = "none";
+    const char *argProfile = NULL;
+    const char *argLinker = NULL;
+    RTIBool argFastDebugLink = RTI_FALSE;
+    const char *argRpath = NULL;
+    int linkerIdx = -2;
+    struct ToolchainFlags *toolchainFlags = NULL;
+    const char *argPchDir = NULL;
+    RTIBool argPchBuild = RTI_FALSE;
+    const char *argModulesDir = NULL;
+    RTIBool argModBuild = RTI_FALSE;
+    char **linkObjects = NULL;
+    int linkObjectCount = 0;
+    RTIBool argLdlibsAbs = RTI_FALSE;
+    int ldlibsApiIdx = -1;
+    const char *launcherPath;
+    int argWrapper;
+    struct WrapperArgs wrapperArgs;
+    ComposeResult rc;
+    int i;
+
+    Trace_begin(argc, argv);
+
+    /* Compiler driver wrappers (connext-cc, ... or --exec=TOOL): all the 
+     * arguments but --connext-* belong to the wrapped tool 
+     */
+    argWrapper = getWrapperToolFromArgv0(argv[0]);
+    i = 1;
+    if ((argWrapper == -1) && (argc > 1) && (strncmp(argv[1], "--exec=", 7) == 0)) {
+        argWrapper = getWrapperToolIndex(argv[1]+7);
+        if (argWrapper == -1) {
+            fprintf(stderr, "Error: invalid tool: %s\n", argv[1]+7);
+            retCode = APPLICATION_EXIT_INVALID_ARGS;
+            goto done;
+        }
+        i = 2;
+    }
+    if (argWrapper != -1) {
+        argOp = WRAPPER_TOOLS[argWrapper].op;
+        if (!WrapperArgs_parse(&wrapperArgs, argWrapper, argc-i, &argv[i])) {
+            retCode = APPLICATION_EXIT_INVALID_ARGS;
+            goto done;
+        }
+        argTarget = wrapperArgs.target;
+        goto loadPlatform;
+    }
+
+    /* --stats and --mem-report can be used with any operation: remove them 
+     * from the arguments */
+    for (i = 1; i < argc; ++i) {
+        if ((strcmp(argv[i], "--stats") == 0) || 
+                (strcmp(argv[i], "--stats=perf") == 0)) {
+            argStats = RTI_TRUE;
+            if (argv[i][7] == '=') {
+                argStatsPerf = RTI_TRUE;
+            }
+        } else if (strcmp(argv[i], "--mem-report") == 0) {
+            argMemReport = RTI_TRUE;
+        } else {
+            continue;
+        }
+        memmove(&argv[i], &argv[i+1], (size_t)(argc-i) * sizeof(*argv));
+        --argc;
+        --i;
+    }
+#ifndef ENABLE_STATS
+    if (argStats || argStatsPerf || argMemReport) {
+        fprintf(stderr, "Warning: statistics not available in this build "
+                "(configure with --enable-stats)\n");
+    }
+#endif
+    MEM_ENABLE(argMemReport);
+    STATS_ENABLE(argStats, argStatsPerf);
+
+    if (argc <= 1) {
+        usage();
+        retCode = APPLICATION_EXIT_INVALID_ARGS;
+        goto done;
+    }
+    if ((argc == 2) && ((strcmp(argv[1], "-h") == 0) ||
+                (strcmp(argv[1], "--help") == 0) )) {
+        usage();
+        retCode = APPLICATION_EXIT_SUCCESS;
+        goto done;
+    }
+    if ((argc == 2) && ((strcmp(argv[1], "-V") == 0) ||
+                (strcmp(argv[1], "--version") == 0))) {
+        printf("%s v.%s\n", APPLICATION_NAME, APPLICATION_VERSION);
+        retCode = APPLICATION_EXIT_SUCCESS;
+        goto done;
+    }
+    if ((argc <= 3) && (strcmp(argv[1], "--trace-report") == 0)) {
+        retCode = traceReport((argc == 3) ? argv[2] : getenv(TRACE_ENV_VARIABLE));
+        goto done;
+    }
+    if ((argc <= 3) && (strcmp(argv[1], "--launcher-show-stats") == 0)) {
+        argOp = argv[1];
+        argLauncher = "auto";
+        if (argc == 3) {
+            if ((strncmp(argv[2], "--launcher=", 11) != 0) || 
+                    !isValidLauncherMode(argv[2]+11)) {
+                fprintf(stderr, "Error: invalid argument: %s\n", argv[2]);
+                retCode = APPLICATION_EXIT_INVALID_ARGS;
+                goto done;
+            }
+            argLauncher = argv[2]+11;
+        }
+        retCode = launcherStats(argLauncher);
+        goto done;
+    }
+    if ((argc == 2) && (
+#ifndef NDEBUG
+                (strcmp(argv[1], "--dump-all") == 0) ||
+#endif
+                (strcmp(argv[1], "--list-installed") == 0) ||
+                (strcmp(argv[1], "--list-all") == 0))) {
+        argOp = argv[1];
+
+    } else if ((argc <= 3) && (strcmp(argv[1], "--verify-all") == 0)) {
+        argOp = argv[1];
+        if (argc == 3) {
+            if ((strncmp(argv[2], "--jobs=", 7) != 0) || 
+                    (atoi(argv[2]+7) <= 0)) {
+                fprintf(stderr, "Error: invalid argument: %s\n", argv[2]);
+                retCode = APPLICATION_EXIT_INVALID_ARGS;
+                goto done;
+            }
+            argJobs = atoi(argv[2]+7);
+        }
+
+    } else if (strcmp(argv[1], "--export-json") == 0) {
+        /* All the remaining arguments are the targets to export */
+        argOp = argv[1];
+        exportTargets = &argv[2];
+        exportTargetCount = argc-2;
+
+    } else if ((strcmp(argv[1], "--generate-pkgconfig") == 0) ||
+            (strcmp(argv[1], "--generate-cmake") == 0)) {
+        /* Output directory, followed by the (optional) targets */
+        if (argc < 3) {
+            fprintf(stderr, "Error: missing output directory for %s\n", argv[1]);
+            retCode = APPLICATION_EXIT_INVALID_ARGS;
+            goto done;
+        }
+        argOp = argv[1];
+        argOutDir = argv[2];
+        exportTargets = &argv[3];
+        exportTargetCount = argc-3;
+
+    } else {
+        /* Parse command line with at least 1 arguments */
+        if (argc < 2) {
+            usage();
+            retCode = APPLICATION_EXIT_INVALID_ARGS;
+            goto done;
+        }
+
+        /* The arguments after -- are the objects of --ldlibs-minimal */
+        for (i = 1; i < argc; ++i) {
+            if (strcmp(argv[i], "--") == 0) {
+                linkObjects = &argv[i+1];
+                linkObjectCount = argc-i-1;
+                argc = i;
+                break;
+            }
+        }
+
+        for (i = 1; i < argc; ++i) {
+            if ((strcmp(argv[i], "--static") == 0)) {
+                argStatic = RTI_TRUE;
+                continue;
+            }
+            if ((strcmp(argv[i], "--debug") == 0)) {
+                argDebug = RTI_TRUE;
+                continue;
+            }
+            if ((strcmp(argv[i], "--shell") == 0) || 
+                    (strcmp(argv[i], "--sh") == 0)) {
+                argShell = RTI_TRUE;
+                continue;
             }
             if ((strcmp(argv[i], "--noexpand") == 0)) {
                 argExpandEnvVar = RTI_FALSE;
@@ -1765,6 +11052,106 @@ int main(int argc, char **argv) {
                 argMsg = RTI_TRUE;
                 continue;
             }
+            if (strncmp(argv[i], "--output=", 9) == 0) {
+                argOutFile = argv[i]+9;
+                continue;
+            }
+            if (strncmp(argv[i], "--launcher=", 11) == 0) {
+                argLauncher = argv[i]+11;
+                if (!isValidLauncherMode(argLauncher)) {
+                    fprintf(stderr, "Error: invalid launcher: %s\n", argLauncher);
+                    retCode = APPLICATION_EXIT_INVALID_ARGS;
+                    goto done;
+                }
+                continue;
+            }
+            if (strcmp(argv[i], "--fast-debug-link") == 0) {
+                argFastDebugLink = RTI_TRUE;
+                continue;
+            }
+            if (strncmp(argv[i], "--linker=", 9) == 0) {
+                argLinker = argv[i]+9;
+                if (!isValidLinkerMode(argLinker)) {
+                    fprintf(stderr, "Error: invalid linker: %s\n", argLinker);
+                    retCode = APPLICATION_EXIT_INVALID_ARGS;
+                    goto done;
+                }
+                continue;
+            }
+            if (strncmp(argv[i], "--rpath=", 8) == 0) {
+                argRpath = argv[i]+8;
+                if (!isValidRpathMode(argRpath)) {
+                    fprintf(stderr, "Error: invalid rpath: %s\n", argRpath);
+                    retCode = APPLICATION_EXIT_INVALID_ARGS;
+                    goto done;
+                }
+                continue;
+            }
+            if (strcmp(argv[i], "--probe-linkers") == 0) {
+                argOp = argv[i];
+                continue;
+            }
+            if (strcmp(argv[i], "--list-installed") == 0) {
+                argOp = argv[i];
+                continue;
+            }
+            if (strcmp(argv[i], "--variants") == 0) {
+                argVariants = RTI_TRUE;
+                continue;
+            }
+            if (strcmp(argv[i], "--ldlibs-minimal") == 0) {
+                argOp = argv[i];
+                continue;
+            }
+            if (strcmp(argv[i], "--ldlibs-abs") == 0) {
+                argLdlibsAbs = RTI_TRUE;
+                continue;
+            }
+            if (strncmp(argv[i], "--profile=", 10) == 0) {
+                argProfile = argv[i]+10;
+                if (getProfileIndex(argProfile, NULL) == -1) {
+                    fprintf(stderr, "Error: invalid profile: %s\n", argProfile);
+                    retCode = APPLICATION_EXIT_INVALID_ARGS;
+                    goto done;
+                }
+                continue;
+            }
+            if (strncmp(argv[i], "--api=", 6) == 0) {
+                argApi = argv[i]+6;
+                if (getApiIndex(argApi) == -1) {
+                    fprintf(stderr, "Error: invalid API: %s\n", argApi);
+                    retCode = APPLICATION_EXIT_INVALID_ARGS;
+                    goto done;
+                }
+                continue;
+            }
+            if ((strcmp(argv[i], "--emit-make") == 0) ||
+                    (strcmp(argv[i], "--emit-sh") == 0)) {
+                argOp = argv[i];
+                continue;
+            }
+            if ((strncmp(argv[i], "--pch=", 6) == 0) && (argv[i][6] != '\0')) {
+                argOp = argv[i];
+                argPchDir = argv[i]+6;
+                continue;
+            }
+            if (strcmp(argv[i], "--pch-build") == 0) {
+                argPchBuild = RTI_TRUE;
+                continue;
+            }
+            if ((strncmp(argv[i], "--modules=", 10) == 0) && (argv[i][10] != '\0')) {
+                /* Also a modifier of --cxxmodflags */
+                if (!argModBuild) {
+                    argOp = argv[i];
+                }
+                argModulesDir = argv[i]+10;
+                continue;
+            }
+            if (strcmp(argv[i], "--cxxmodflags") == 0) {
+                argOp = argv[i];
+                argModBuild = RTI_TRUE;
+                continue;
+            }
             if ((strcmp(argv[i], "-h") == 0) || 
                     (strcmp(argv[i], "--help") == 0)) {
                 usage();
@@ -1793,7 +11180,14 @@ int main(int argc, char **argv) {
             retCode = APPLICATION_EXIT_INVALID_ARGS;
             goto done;
         }
-        if (argTarget == NULL) {
+        if ((argOp != NULL) && (strcmp(argOp, "--list-installed") == 0)) {
+            /* Lists all the targets */
+            if (argTarget != NULL) {
+                fprintf(stderr, "Error: --list-installed does not take a target\n");
+                retCode = APPLICATION_EXIT_INVALID_ARGS;
+                goto done;
+            }
+        } else if (argTarget == NULL) {
             /* 
              * argTarget is not defined, look at the environment variable
              * $NDDSARCH
@@ -1815,592 +11209,484 @@ int main(int argc, char **argv) {
         retCode = APPLICATION_EXIT_INVALID_ARGS;
         goto done;
     }
-
-    /* Determine NDDSHOME and platform file */
-    NDDSHOME = calcNDDSHOME(argv[0]);
-    if (NDDSHOME == NULL) {
-        retCode = APPLICATION_EXIT_FAILURE;
-        goto done;
-    }
-    if (validateNDDSHOME(NDDSHOME) == RTI_FALSE) {
-        retCode = APPLICATION_EXIT_FAILURE;
-        goto done;
-    }
-
-    /* Complete building the path to the platform.vm file: */
-    platformFile = calloc(PATH_MAX+1, 1);
-    if (platformFile == NULL) {
-        fprintf(stderr, "Out of memory allocating platformFile path\n");
-        retCode = APPLICATION_EXIT_FAILURE;
-        goto done;
-    }
-    snprintf(platformFile, PATH_MAX, "%s/%s", NDDSHOME, NDDS_PLATFORM_FILE);
-
-    /* Allocate the archDef list */
-    archDef = calloc(1, sizeof(*archDef));
-    if (archDef == NULL) {
-        fprintf(stderr, "Out of memory allocating archDef\n");
-        retCode = APPLICATION_EXIT_FAILURE;
-        goto done;
-    }
-    REDAInlineList_init(archDef);
-
-    /* Read and parse platform file */
-    readPlatformFile(platformFile, archDef);
-#ifndef NDEBUG
-    if ((strcmp(argOp, "--dump-all") == 0)) {
-        dumpArch(archDef);
-        retCode = APPLICATION_EXIT_SUCCESS;
-        goto done;
-    }
-#endif
-
-    if ((strcmp(argOp, "--list-all") == 0)) {
-        struct REDAInlineListNode *archNode;
-        for (archNode = REDAInlineList_getFirst(archDef); 
-                archNode != NULL; 
-                archNode = REDAInlineListNode_getNext(archNode)) {
-            struct Architecture *arch = (struct Architecture *)archNode;
-            printf("%s\n", arch->target);
-        }
-        retCode = APPLICATION_EXIT_SUCCESS;
+    if (argVariants && (strcmp(argOp, "--list-installed") != 0)) {
+        fprintf(stderr, "Error: --variants applies only to --list-installed\n");
+        retCode = APPLICATION_EXIT_INVALID_ARGS;
         goto done;
     }
-    if ((strcmp(argOp, "--list-installed") == 0)) {
-        /* Reuse the platformFile buffer (since is no longer required) to compose
-         * the lib directory path
-         */
-        struct REDAInlineListNode *archNode;
-        struct stat statbuf;
-        int rc;
-        for (archNode = REDAInlineList_getFirst(archDef); 
-                archNode != NULL; 
-                archNode = REDAInlineListNode_getNext(archNode)) {
-            struct Architecture *arch = (struct Architecture *)archNode;
-            snprintf(platformFile, PATH_MAX, "%s/lib/%s", NDDSHOME, arch->target);
-            rc = stat(platformFile, &statbuf);
-            if (rc != 0) {
-                if (errno == ENOENT) {
-                    // target is not installed
-                    continue;
-                }
-                fprintf(stderr, "Error stat() failed: %s (errno=%d)\n", strerror(errno), errno);
-                retCode = APPLICATION_EXIT_FAILURE;
-                goto done;
-            }
-            if (S_ISDIR(statbuf.st_mode)) {
-                printf("%s\n", arch->target);
-            }
-            // else it must be a file, ignore it
-        }
-        retCode = APPLICATION_EXIT_SUCCESS;
+    if ((argOutFile != NULL) && 
+            (strcmp(argOp, "--emit-make") != 0) && 
+            (strcmp(argOp, "--emit-sh") != 0)) {
+        fprintf(stderr, "Error: --output applies only to --emit-make and --emit-sh\n");
+        retCode = APPLICATION_EXIT_INVALID_ARGS;
         goto done;
     }
-
-
-    /* Find target */
-    archTarget = NULL;
-    struct REDAInlineListNode *node;
-    for (node = REDAInlineList_getFirst(archDef); 
-            node != NULL; 
-            node = REDAInlineListNode_getNext(node)) {
-        struct Architecture *arch = (struct Architecture *)node;
-        if ((strcmp(arch->target, argTarget) == 0)) {
-            archTarget = arch;
-            break;
-        }
-    }
-    if (archTarget == NULL) {
-        fprintf(stderr,
-                "Error: requested architecture '%s' is not supported\n",
-                argTarget);
-        fprintf(stderr,
-                "Use --list-all or --list-installed to print all the architectures\n");
+    if (argModBuild && (argModulesDir == NULL)) {
+        fprintf(stderr, "Error: --cxxmodflags requires --modules=DIR\n");
         retCode = APPLICATION_EXIT_INVALID_ARGS;
         goto done;
     }
-
-    /* Compose the NDDS-related includes and libraries */
-    libSuffix = "";
-    if ((argStatic == RTI_TRUE) && (argDebug == RTI_FALSE)) {
-        libSuffix = "z";
-    } else if ((argStatic == RTI_FALSE) && (argDebug == RTI_TRUE)) {
-        libSuffix = "d";
-    } else if ((argStatic == RTI_TRUE) && (argDebug == RTI_TRUE)) {
-        libSuffix = "zd";
-    }
-    nddsFlags = calloc(MAX_CMDLINEARG_SIZE+1, 1);
-    nddsCPP03Flags = calloc(MAX_CMDLINEARG_SIZE+1, 1);
-    nddsCLibs = calloc(MAX_CMDLINEARG_SIZE+1, 1);
-    nddsCPPLibs = calloc(MAX_CMDLINEARG_SIZE+1, 1);
-    nddsCPP03Libs = calloc(MAX_CMDLINEARG_SIZE+1, 1);
-    nddsExtraLib = calloc(MAX_CMDLINEARG_SIZE+1, 1);
-    nddsExtraLibCPP = calloc(MAX_CMDLINEARG_SIZE+1, 1);
-    nddsExtraLibCPP03 = calloc(MAX_CMDLINEARG_SIZE+1, 1);
-    if (    (nddsFlags == NULL) || 
-            (nddsCPP03Flags == NULL) ||
-            (nddsCLibs == NULL) || 
-            (nddsCPPLibs == NULL) || 
-            (nddsCPP03Libs == NULL) ||
-            (nddsExtraLib == NULL) ||
-            (nddsExtraLibCPP == NULL) ||
-            (nddsExtraLibCPP03 == NULL) ) {
-        fprintf(stderr, "Out of memory allocating command-line arguments");
-        retCode = APPLICATION_EXIT_FAILURE;
+    if ((strcmp(argOp, "--ldlibs-minimal") == 0) != (linkObjectCount > 0)) {
+        fprintf(stderr, (linkObjectCount == 0) ?
+                "Error: --ldlibs-minimal requires the objects after --\n" :
+                "Error: the objects after -- require --ldlibs-minimal\n");
+        retCode = APPLICATION_EXIT_INVALID_ARGS;
         goto done;
     }
-
-
-    if (argMsg == RTI_TRUE) {
-        snprintf(nddsExtraLib,
-                MAX_CMDLINEARG_SIZE,
-                "-lrticonnextmsgc%s ",
-                libSuffix);
-        snprintf(nddsExtraLibCPP,
-                MAX_CMDLINEARG_SIZE,
-                "-lrticonnextmsgcpp%s ",
-                libSuffix);
-        snprintf(nddsExtraLibCPP03,
-                MAX_CMDLINEARG_SIZE,
-                "-lrticonnextmsgcpp2%s ",
-                libSuffix);
-    } else {
-        nddsExtraLib[0] = '\0';
-        nddsExtraLibCPP[0] = '\0';
-        nddsExtraLibCPP03[0] = '\0';
-    }
-
-    if (argExpandEnvVar == RTI_TRUE) {
-        /* Expand NDDSHOME */
-        snprintf(nddsFlags,
-                MAX_CMDLINEARG_SIZE,
-                "-I%s/include -I%s/include/ndds",
-                NDDSHOME,
-                NDDSHOME);
-        snprintf(nddsCPP03Flags,
-                MAX_CMDLINEARG_SIZE,
-                "-I%s/include -I%s/include/ndds -I%s/include/ndds/hpp",
-                NDDSHOME,
-                NDDSHOME,
-                NDDSHOME);
-        snprintf(nddsCLibs,
-                MAX_CMDLINEARG_SIZE,
-                "-L%s/lib/%s %s-lnddsc%s -lnddscore%s",
-                NDDSHOME,
-                argTarget,
-                nddsExtraLib,
-                libSuffix,
-                libSuffix);
-        snprintf(nddsCPPLibs,
-                MAX_CMDLINEARG_SIZE,
-                "-L%s/lib/%s %s-lnddscpp%s -lnddsc%s -lnddscore%s",
-                NDDSHOME,
-                argTarget,
-                nddsExtraLibCPP,
-                libSuffix,
-                libSuffix,
-                libSuffix);
-        snprintf(nddsCPP03Libs,
-                MAX_CMDLINEARG_SIZE,
-                "-L%s/lib/%s %s-lnddscpp2%s -lnddsc%s -lnddscore%s",
-                NDDSHOME,
-                argTarget,
-                nddsExtraLibCPP03,
-                libSuffix,
-                libSuffix,
-                libSuffix);
-    } else {
-        /* Do not expand variables */
-        if (argShell == RTI_TRUE) {
-            /* Use shell style */
-            snprintf(nddsFlags,
-                    MAX_CMDLINEARG_SIZE,
-                    "-I${NDDSHOME}/include -I${NDDSHOME}/include/ndds");
-            snprintf(nddsCPP03Flags,
-                    MAX_CMDLINEARG_SIZE,
-                    "-I${NDDSHOME}/include -I${NDDSHOME}/include/ndds -I${NDDSHOME}/include/ndds/hpp");
-            snprintf(nddsCLibs,
-                    MAX_CMDLINEARG_SIZE,
-                    "-L${NDDSHOME}/lib/%s %s-lnddsc%s -lnddscore%s",
-                    argTarget,
-                    nddsExtraLib,
-                    libSuffix,
-                    libSuffix);
-            snprintf(nddsCPPLibs,
-                    MAX_CMDLINEARG_SIZE,
-                    "-L${NDDSHOME}/lib/%s %s-lnddscpp%s -lnddsc%s -lnddscore%s",
-                    argTarget,
-                    nddsExtraLibCPP,
-                    libSuffix,
-                    libSuffix,
-                    libSuffix);
-            snprintf(nddsCPP03Libs,
-                    MAX_CMDLINEARG_SIZE,
-                    "-L${NDDSHOME}/lib/%s %s-lnddscpp2%s -lnddsc%s -lnddscore%s",
-                    argTarget,
-                    nddsExtraLibCPP03,
-                    libSuffix,
-                    libSuffix,
-                    libSuffix);
-        } else {
-            /* Use makefile style */
-            snprintf(nddsFlags,
-                    MAX_CMDLINEARG_SIZE,
-                    "-I$(NDDSHOME)/include -I$(NDDSHOME)/include/ndds");
-            snprintf(nddsCPP03Flags,
-                    MAX_CMDLINEARG_SIZE,
-                    "-I$(NDDSHOME)/include -I$(NDDSHOME)/include/ndds, -I$(NDDSHOME)/include/ndds/hpp");
-            snprintf(nddsCLibs,
-                    MAX_CMDLINEARG_SIZE,
-                    "-L$(NDDSHOME)/lib/%s %s-lnddsc%s -lnddscore%s",
-                    argTarget,
-                    nddsExtraLib,
-                    libSuffix,
-                    libSuffix);
-            snprintf(nddsCPPLibs,
-                    MAX_CMDLINEARG_SIZE,
-                    "-L$(NDDSHOME)/lib/%s %s-lnddscpp%s -lnddsc%s -lnddscore%s",
-                    argTarget,
-                    nddsExtraLibCPP,
-                    libSuffix,
-                    libSuffix,
-                    libSuffix);
-            snprintf(nddsCPP03Libs,
-                    MAX_CMDLINEARG_SIZE,
-                    "-L$(NDDSHOME)/lib/%s %s-lnddscpp2%s -lnddsc%s -lnddscore%s",
-                    argTarget,
-                    nddsExtraLibCPP03,
-                    libSuffix,
-                    libSuffix,
-                    libSuffix);
-        }
-    } 
-
-    /* Process request operation */
-    retCode = APPLICATION_EXIT_SUCCESS;
-
-    /******************* C API ***************************/
-    if ((strcmp(argOp, "--ccomp") == 0)) {
-        if (printStringProperty(archTarget, 
-                    "$C_COMPILER", 
-                    argExpandEnvVar) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
-
-    } else if ((strcmp(argOp, "--cflags") == 0)) {
-        const char *FLAGS[] = {
-            "$C_COMPILER_FLAGS",
-            "$DEFINES",
-            "$INCLUDES",
-            nddsFlags,
-            NULL
-        };
-        if (printCompositeFlagsProperties(archTarget,
-                    FLAGS,
-                    argExpandEnvVar,
-                    argShell) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
-
-    } else if ((strcmp(argOp, "--clink") == 0)) {
-        if (printStringProperty(archTarget,
-                    "$C_LINKER",
-                    argExpandEnvVar) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
-
-    } else if ((strcmp(argOp, "--ldflags") == 0)) {
-        const char *FLAGS[] = {
-            "$C_LINKER_FLAGS",
-            NULL
-        };
-        if (printCompositeFlagsProperties(archTarget,
-                    FLAGS,
-                    argExpandEnvVar,
-                    argShell) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
-
-    } else if ((strcmp(argOp, "--ldlibs") == 0)) {
-        const char *FLAGS[] = {
-            nddsCLibs,
-            "$SYSLIBS",
-            "$C_SYSLIBS",
-            NULL
-        };
-        if (printCompositeFlagsProperties(archTarget,
-                    FLAGS,
-                    argExpandEnvVar,
-                    argShell) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
-
-
-    /*************** Traditional C++ API *****************/
-    
-    } else if ((strcmp(argOp, "--cxxcomp") == 0)) {
-        if (printStringProperty(archTarget,
-                    "$CXX_COMPILER",
-                    argExpandEnvVar) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
+    if (argLdlibsAbs) {
+        ldlibsApiIdx = (strcmp(argOp, "--ldlibs-minimal") == 0) ? getApiIndex(argApi) : -1;
+        for (i = 0; API_OPERATIONS[i].name != NULL; ++i) {
+            if (strcmp(argOp, API_OPERATIONS[i].ldlibs) == 0) {
+                ldlibsApiIdx = i;
+            }
         }
-
-    } else if ((strcmp(argOp, "--cxxflags") == 0)) {
-        const char *FLAGS[] = {
-            "$CXX_COMPILER_FLAGS",
-            "$DEFINES",
-            "$INCLUDES",
-            nddsFlags,
-            NULL
-        };
-        if (printCompositeFlagsProperties(archTarget,
-                    FLAGS,
-                    argExpandEnvVar,
-                    argShell) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
+        if (ldlibsApiIdx == -1) {
+            fprintf(stderr,
+                    "Error: --ldlibs-abs applies only to the libraries "
+                    "(--ldlibs, --ldxxlibs, ..., --ldlibs-minimal)\n");
+            retCode = APPLICATION_EXIT_INVALID_ARGS;
             goto done;
         }
-
-    } else if ((strcmp(argOp, "--cxxlink") == 0)) {
-        if (printStringProperty(archTarget,
-                    "$CXX_LINKER",
-                    argExpandEnvVar) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
+        if (!argExpandEnvVar) {
+            fprintf(stderr, "Error: --ldlibs-abs cannot be used with --noexpand\n");
+            retCode = APPLICATION_EXIT_INVALID_ARGS;
             goto done;
         }
+    }
 
-    } else if ((strcmp(argOp, "--ldxxflags") == 0)) {
-        const char *FLAGS[] = {
-            "$CXX_LINKER_FLAGS",
-            NULL
-        };
-        if (printCompositeFlagsProperties(archTarget,
-                    FLAGS,
-                    argExpandEnvVar,
-                    argShell) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
+loadPlatform:
+    /* Determine NDDSHOME and platform file */
+    STATS_BEGIN(NddsHome);
+    NDDSHOME = calcNDDSHOME(argv[0]);
+    if (NDDSHOME == NULL) {
+        retCode = APPLICATION_EXIT_FAILURE;
+        goto done;
+    }
+    if (validateNDDSHOME(NDDSHOME) == RTI_FALSE) {
+        retCode = APPLICATION_EXIT_FAILURE;
+        goto done;
+    }
+    STATS_END(NddsHome);
 
-    } else if ((strcmp(argOp, "--ldxxlibs") == 0)) {
-        const char *FLAGS[] = {
-            nddsCPPLibs,
-            "$SYSLIBS",
-            "$CXX_SYSLIBS",
-            NULL
-        };
-        if (printCompositeFlagsProperties(archTarget,
-                    FLAGS,
-                    argExpandEnvVar,
-                    argShell) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
+    /* Complete building the path to the platform.vm file: */
+    platformFile = MEM_CALLOC(Path, PATH_MAX+1, 1);
+    if (platformFile == NULL) {
+        fprintf(stderr, "Out of memory allocating platformFile path\n");
+        retCode = APPLICATION_EXIT_FAILURE;
+        goto done;
+    }
+    snprintf(platformFile, PATH_MAX, "%s/%s", NDDSHOME, NDDS_PLATFORM_FILE);
 
+    /* Allocate the archDef list */
+    archDef = MEM_CALLOC(ArchList, 1, sizeof(*archDef));
+    if (archDef == NULL) {
+        fprintf(stderr, "Out of memory allocating archDef\n");
+        retCode = APPLICATION_EXIT_FAILURE;
+        goto done;
+    }
+    REDAInlineList_init(archDef);
 
-    /***************** Modern C++ API *******************/
+    /* Read and parse platform file */
+    STATS_BEGIN(Parse);
+    readPlatformFile(platformFile, archDef, &platformInfo);
+    STATS_END(Parse);
+#ifndef NDEBUG
+    if ((strcmp(argOp, "--dump-all") == 0)) {
+        dumpArch(stdout, archDef);
+        retCode = APPLICATION_EXIT_SUCCESS;
+        goto done;
+    }
+#endif
 
-    } else if ((strcmp(argOp, "--cxx03comp") == 0)) {
-        if (!ensureTargetSupportsCxx03(archTarget)) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
-        if (printStringProperty(archTarget,
-                    "$CXX_COMPILER",
-                    argExpandEnvVar) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
+    /* The operations on multiple targets interleave composition and output:
+     * they are measured as composition
+     */
+    STATS_BEGIN(Compose);
+    if ((strcmp(argOp, "--list-all") == 0)) {
+        struct REDAInlineListNode *archNode;
+        for (archNode = REDAInlineList_getFirst(archDef); 
+                archNode != NULL; 
+                archNode = REDAInlineListNode_getNext(archNode)) {
+            struct Architecture *arch = (struct Architecture *)archNode;
+            printf("%s\n", arch->target);
         }
+        retCode = APPLICATION_EXIT_SUCCESS;
+        goto done;
+    }
+    if ((strcmp(argOp, "--list-installed") == 0)) {
+        struct REDAInlineListNode *archNode;
+        struct InstalledTargets installed;
+        unsigned int variants;
+        int v;
 
-    } else if ((strcmp(argOp, "--cxx03flags") == 0)) {
-        const char *FLAGS[] = {
-            "$CXX_COMPILER_FLAGS",
-            "$CPP03_COMPILER_FLAGS",
-            "$DEFINES",
-            "$INCLUDES",
-            nddsCPP03Flags,
-            NULL
-        };
-        if (!ensureTargetSupportsCxx03(archTarget)) {
+        InstalledTargets_init(&installed);
+        if (!InstalledTargets_scan(&installed, NDDSHOME)) {
+            InstalledTargets_finalize(&installed);
             retCode = APPLICATION_EXIT_FAILURE;
             goto done;
         }
-        if (printCompositeFlagsProperties(archTarget,
-                    FLAGS,
-                    argExpandEnvVar,
-                    argShell) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
+        retCode = APPLICATION_EXIT_SUCCESS;
+        for (archNode = REDAInlineList_getFirst(archDef); 
+                archNode != NULL; 
+                archNode = REDAInlineListNode_getNext(archNode)) {
+            struct Architecture *arch = (struct Architecture *)archNode;
+            if (!InstalledTargets_contains(&installed, arch->target)) {
+                continue;
+            }
+            if (!argVariants) {
+                printf("%s\n", arch->target);
+                continue;
+            }
+            if (!scanInstalledVariants(NDDSHOME, arch->target, &variants)) {
+                retCode = APPLICATION_EXIT_FAILURE;
+                break;
+            }
+            printf("%s", arch->target);
+            for (v = 0; LIB_VARIANTS[v].name != NULL; ++v) {
+                if (variants & (1u << v)) {
+                    printf(" %s", LIB_VARIANTS[v].name);
+                }
+            }
+            printf("\n");
         }
+        InstalledTargets_finalize(&installed);
+        goto done;
+    }
+    if ((strcmp(argOp, "--verify-all") == 0)) {
+        retCode = verifyAll(archDef, NDDSHOME, argJobs) ? 
+                APPLICATION_EXIT_SUCCESS : APPLICATION_EXIT_FAILURE;
+        goto done;
+    }
+    if ((strcmp(argOp, "--export-json") == 0)) {
+        /* Output can be large: use a large stdout buffer */
+        setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+        retCode = exportJson(archDef,
+                    NDDSHOME,
+                    platformFile,
+                    &platformInfo,
+                    exportTargets,
+                    exportTargetCount) ? 
+                APPLICATION_EXIT_SUCCESS : APPLICATION_EXIT_FAILURE;
+        goto done;
+    }
+    if ((strcmp(argOp, "--generate-cmake") == 0)) {
+        retCode = generateCMake(archDef,
+                    NDDSHOME,
+                    argOutDir,
+                    exportTargets,
+                    exportTargetCount) ? 
+                APPLICATION_EXIT_SUCCESS : APPLICATION_EXIT_FAILURE;
+        goto done;
+    }
+    if ((strcmp(argOp, "--generate-pkgconfig") == 0)) {
+        retCode = generatePkgConfig(archDef,
+                    NDDSHOME,
+                    argOutDir,
+                    exportTargets,
+                    exportTargetCount) ? 
+                APPLICATION_EXIT_SUCCESS : APPLICATION_EXIT_FAILURE;
+        goto done;
+    }
 
-    } else if ((strcmp(argOp, "--cxx03link") == 0)) {
-        if (!ensureTargetSupportsCxx03(archTarget)) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
-        if (printStringProperty(archTarget,
-                    "$CXX_LINKER",
-                    argExpandEnvVar) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
 
-    } else if ((strcmp(argOp, "--ldxx03flags") == 0)) {
-        const char *FLAGS[] = {
-            "$CXX_LINKER_FLAGS",
-            NULL
-        };
-        if (!ensureTargetSupportsCxx03(archTarget)) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
-        if (printCompositeFlagsProperties(archTarget,
-                    FLAGS,
-                    argExpandEnvVar,
-                    argShell) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
+    STATS_END(Compose);
 
-    } else if ((strcmp(argOp, "--ldxx03libs") == 0)) {
-        const char *FLAGS[] = {
-            nddsCPP03Libs,
-            "$SYSLIBS",
-            "$CXX_SYSLIBS",
-            NULL
-        };
-        if (!ensureTargetSupportsCxx03(archTarget)) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
-        if (printCompositeFlagsProperties(archTarget,
-                    FLAGS,
-                    argExpandEnvVar,
-                    argShell) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
+    /* Find target */
+    STATS_BEGIN(Lookup);
+    archTarget = findArchitecture(archDef, argTarget);
+    STATS_END(Lookup);
+    STATS_BEGIN(Compose);
+    if (archTarget == NULL) {
+        fprintf(stderr,
+                "Error: requested architecture '%s' is not supported\n",
+                argTarget);
+        fprintf(stderr,
+                "Use --list-all or --list-installed to print all the architectures\n");
+        retCode = APPLICATION_EXIT_INVALID_ARGS;
+        goto done;
+    }
 
+    if (argWrapper != -1) {
+        retCode = execWrapper(archTarget, NDDSHOME, &wrapperArgs, argOp);
+        goto done;
+    }
 
-    /************ Ultra Modern C++ API *****************/
+    if ((strcmp(argOp, "--probe-linkers") == 0)) {
+        retCode = probeLinkers(archTarget);
+        goto done;
+    }
 
-    } else if ((strcmp(argOp, "--cxx11comp") == 0)) {
-        if (!ensureTargetSupportsCxx11(archTarget)) {
+    /* Toolchain options of the modifiers, added to all the operations */
+    toolchainFlags = MEM_CALLOC(Compose, 1, sizeof(*toolchainFlags));
+    if (toolchainFlags == NULL) {
+        fprintf(stderr, "Out of memory allocating the toolchain options\n");
+        retCode = APPLICATION_EXIT_FAILURE;
+        goto done;
+    }
+    if (argProfile != NULL) {
+        struct ToolchainFlags profileFlags;
+        if (!resolveProfile(archTarget, argProfile, &profileFlags) ||
+                !ToolchainFlags_add(toolchainFlags, &profileFlags)) {
             retCode = APPLICATION_EXIT_FAILURE;
             goto done;
         }
-        if (printStringProperty(archTarget,
-                    "$CXX_COMPILER",
-                    argExpandEnvVar) == RTI_FALSE) {
+    }
+    if (argLinker != NULL) {
+        struct ToolchainFlags linkerFlags;
+        if (!resolveLinker(archTarget, argLinker, &linkerFlags, &linkerIdx) ||
+                !ToolchainFlags_add(toolchainFlags, &linkerFlags)) {
             retCode = APPLICATION_EXIT_FAILURE;
             goto done;
         }
-
-    } else if ((strcmp(argOp, "--cxx11flags") == 0)) {
-        const char *FLAGS[] = {
-            "$CXX_COMPILER_FLAGS",
-            "$CPP11_COMPILER_FLAGS",
-            "$DEFINES",
-            "$INCLUDES",
-            nddsCPP03Flags,     // Use same as CPP03 flags
-            NULL
-        };
-        if (!ensureTargetSupportsCxx11(archTarget)) {
+    }
+    if (argFastDebugLink) {
+        struct ToolchainFlags debugLinkFlags;
+        if (!resolveFastDebugLink(archTarget, linkerIdx, &debugLinkFlags) ||
+                !ToolchainFlags_add(toolchainFlags, &debugLinkFlags)) {
             retCode = APPLICATION_EXIT_FAILURE;
             goto done;
         }
-        if (printCompositeFlagsProperties(archTarget,
-                    FLAGS,
-                    argExpandEnvVar,
-                    argShell) == RTI_FALSE) {
+    }
+    if (argRpath != NULL) {
+        /* NDDSHOME is referenced as in the other settings: --emit-make
+         * composes in the shell style and converts to make afterwards
+         */
+        struct ToolchainFlags rpathFlags;
+        RTIBool emitMake = (strcmp(argOp, "--emit-make") == 0);
+        RTIBool emitSh = (strcmp(argOp, "--emit-sh") == 0);
+        RTIBool shellStyle = argShell || emitMake || emitSh;
+        const char *home = NDDSHOME;
+        const char *origin = RPATH_ORIGIN;
+        if (!argExpandEnvVar || emitMake) {
+            home = shellStyle ? "${NDDSHOME}" : "$(NDDSHOME)";
+        }
+        if (emitMake || (!argExpandEnvVar && !shellStyle)) {
+            origin = RPATH_ORIGIN_MAKE;
+        } else if (!argExpandEnvVar && !emitSh) {
+            origin = RPATH_ORIGIN_SHELL;
+        }
+        if (!resolveRpath(archTarget,
+                    home,
+                    origin,
+                    argStatic,
+                    argRpath,
+                    &rpathFlags) ||
+                !ToolchainFlags_add(toolchainFlags, &rpathFlags)) {
             retCode = APPLICATION_EXIT_FAILURE;
             goto done;
         }
+    }
 
-    } else if ((strcmp(argOp, "--cxx11link") == 0)) {
-        if (!ensureTargetSupportsCxx11(archTarget)) {
+    if ((strcmp(argOp, "--ldlibs-minimal") == 0)) {
+        outBuf = MEM_CALLOC(Compose, MAX_CMDLINEARG_SIZE+1, 1);
+        if (outBuf == NULL) {
+            fprintf(stderr, "Out of memory allocating command-line arguments");
             retCode = APPLICATION_EXIT_FAILURE;
             goto done;
         }
-        if (printStringProperty(archTarget,
-                    "$CXX_LINKER",
-                    argExpandEnvVar) == RTI_FALSE) {
+        if (!composeMinimalLibs(archTarget,
+                    NDDSHOME,
+                    getApiIndex(argApi),
+                    argStatic,
+                    argDebug,
+                    linkObjects,
+                    linkObjectCount,
+                    outBuf,
+                    MAX_CMDLINEARG_SIZE+1) ||
+                !appendFlags(outBuf, MAX_CMDLINEARG_SIZE+1, toolchainFlags->ldlibs) ||
+                (argLdlibsAbs && !resolveAbsoluteLibs(archTarget,
+                    NDDSHOME,
+                    ldlibsApiIdx,
+                    argStatic,
+                    argDebug,
+                    outBuf,
+                    MAX_CMDLINEARG_SIZE+1))) {
             retCode = APPLICATION_EXIT_FAILURE;
             goto done;
         }
+        puts(outBuf);
+        retCode = APPLICATION_EXIT_SUCCESS;
+        goto done;
+    }
 
-    } else if ((strcmp(argOp, "--ldxx11flags") == 0)) {
-        const char *FLAGS[] = {
-            "$CXX_LINKER_FLAGS",
-            NULL
-        };
-        if (!ensureTargetSupportsCxx11(archTarget)) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
-        if (printCompositeFlagsProperties(archTarget,
-                    FLAGS,
+    if (((strcmp(argOp, "--emit-make") == 0) || 
+                (strcmp(argOp, "--emit-sh") == 0)) &&
+            !resolveLauncher(argLauncher, &launcherPath, NULL)) {
+        retCode = APPLICATION_EXIT_FAILURE;
+        goto done;
+    }
+    if ((strcmp(argOp, "--emit-make") == 0)) {
+        retCode = emitMakeFragment(archTarget,
+                    NDDSHOME,
+                    argStatic,
+                    argDebug,
+                    argMsg,
+                    toolchainFlags,
+                    launcherPath,
+                    argOutFile) ? 
+                APPLICATION_EXIT_SUCCESS : APPLICATION_EXIT_FAILURE;
+        goto done;
+    }
+
+    if ((strcmp(argOp, "--emit-sh") == 0)) {
+        switch(emitShellSettings(archTarget,
+                    NDDSHOME,
+                    getApiIndex(argApi),
+                    argStatic,
+                    argDebug,
+                    argMsg,
                     argExpandEnvVar,
-                    argShell) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
+                    toolchainFlags,
+                    launcherPath,
+                    argOutFile)) {
+            case ComposeResult_Ok:
+                retCode = APPLICATION_EXIT_SUCCESS;
+                break;
+            case ComposeResult_Unsupported:
+                fprintf(stderr,
+                        "Error: target '%s' does not support the %s\n",
+                        archTarget->target,
+                        API_OPERATIONS[getApiIndex(argApi)].description);
+                retCode = APPLICATION_EXIT_FAILURE;
+                break;
+            default:
+                retCode = APPLICATION_EXIT_FAILURE;
         }
+        goto done;
+    }
 
-    } else if ((strcmp(argOp, "--ldxx11libs") == 0)) {
-        const char *FLAGS[] = {
-            nddsCPP03Libs,
-            "$SYSLIBS",
-            "$CXX_SYSLIBS",
-            NULL
-        };
-        if (!ensureTargetSupportsCxx11(archTarget)) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
+    if (argPchDir != NULL) {
+        switch(precompileHeaders(archTarget,
+                    NDDSHOME,
+                    getApiIndex(argApi),
+                    argStatic,
+                    argDebug,
+                    argMsg,
+                    toolchainFlags,
+                    argPchDir,
+                    argPchBuild)) {
+            case ComposeResult_Ok:
+                retCode = APPLICATION_EXIT_SUCCESS;
+                break;
+            case ComposeResult_Unsupported:
+                fprintf(stderr,
+                        "Error: target '%s' does not support the %s\n",
+                        archTarget->target,
+                        API_OPERATIONS[getApiIndex(argApi)].description);
+                retCode = APPLICATION_EXIT_FAILURE;
+                break;
+            default:
+                retCode = APPLICATION_EXIT_FAILURE;
         }
-        if (printCompositeFlagsProperties(archTarget,
-                    FLAGS,
-                    argExpandEnvVar,
-                    argShell) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
+        goto done;
+    }
+
+    if (argModulesDir != NULL) {
+        /* Modules are for the C++ APIs only: the default is the traditional one */
+        if (strcmp(argApi, "c") == 0) {
+            argApi = "cxx";
+        }
+        switch(prepareModules(archTarget,
+                    NDDSHOME,
+                    getApiIndex(argApi),
+                    argStatic,
+                    argDebug,
+                    argMsg,
+                    toolchainFlags,
+                    argModulesDir,
+                    argModBuild)) {
+            case ComposeResult_Ok:
+                retCode = APPLICATION_EXIT_SUCCESS;
+                break;
+            case ComposeResult_Unsupported:
+                fprintf(stderr,
+                        "Error: target '%s' does not support the %s\n",
+                        archTarget->target,
+                        API_OPERATIONS[getApiIndex(argApi)].description);
+                retCode = APPLICATION_EXIT_FAILURE;
+                break;
+            default:
+                retCode = APPLICATION_EXIT_FAILURE;
         }
+        goto done;
+    }
 
+    /* Compose the NDDS-related includes and libraries */
+    composeCtx = MEM_CALLOC(Compose, 1, sizeof(*composeCtx));
+    outBuf = MEM_CALLOC(Compose, MAX_CMDLINEARG_SIZE+1, 1);
+    if ((composeCtx == NULL) || (outBuf == NULL)) {
+        fprintf(stderr, "Out of memory allocating command-line arguments");
+        retCode = APPLICATION_EXIT_FAILURE;
+        goto done;
+    }
+    ComposeContext_init(composeCtx,
+            NDDSHOME,
+            argTarget,
+            argStatic,
+            argDebug,
+            argMsg,
+            argExpandEnvVar,
+            argShell);
+    if (!resolveLauncher(argLauncher, &launcherPath, NULL)) {
+        retCode = APPLICATION_EXIT_FAILURE;
+        goto done;
+    }
+    ComposeContext_setLauncher(composeCtx, argTarget, launcherPath);
+    if (!ComposeContext_addFlags(composeCtx, toolchainFlags)) {
+        retCode = APPLICATION_EXIT_FAILURE;
+        goto done;
+    }
 
-    /****************** Miscellaneous *******************/
+    /* Process request operation */
+    rc = composeOperation(archTarget, 
+            argOp, 
+            composeCtx, 
+            outBuf, 
+            MAX_CMDLINEARG_SIZE+1);
+    if ((rc == ComposeResult_Ok) && argLdlibsAbs &&
+            !resolveAbsoluteLibs(archTarget,
+                NDDSHOME,
+                ldlibsApiIdx,
+                argStatic,
+                argDebug,
+                outBuf,
+                MAX_CMDLINEARG_SIZE+1)) {
+        rc = ComposeResult_Error;
+    }
+    STATS_END(Compose);
+    switch(rc) {
+        case ComposeResult_Ok:
+            STATS_BEGIN(Output);
+            puts(outBuf);
+            fflush(stdout);
+            STATS_END(Output);
+            retCode = APPLICATION_EXIT_SUCCESS;
+            break;
 
-    } else if ((strcmp(argOp, "--os") == 0)) {
-        if (printStringProperty(archTarget,
-                    "$OS",
-                    argExpandEnvVar) == RTI_FALSE) {
-            retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
+        case ComposeResult_NotDefined:
+            /* Property not defined for the target: print nothing */
+            retCode = APPLICATION_EXIT_SUCCESS;
+            break;
 
-    } else if ((strcmp(argOp, "--platform") == 0)) {
-        if (printStringProperty(archTarget,
-                    "$PLATFORM",
-                    argExpandEnvVar) == RTI_FALSE) {
+        case ComposeResult_Unsupported:
+            fprintf(stderr,
+                    "Error: target '%s' does not support %s\n",
+                    archTarget->target,
+                    getOperationApiName(argOp));
             retCode = APPLICATION_EXIT_FAILURE;
-            goto done;
-        }
+            break;
 
-    } else {
-        fprintf(stderr, "Error: invalid operation: %s\n", argOp);
-        retCode = APPLICATION_EXIT_INVALID_ARGS;
+        default:
+            retCode = APPLICATION_EXIT_FAILURE;
     }
 
 done:
+    STATS_REPORT();
     if (NDDSHOME != NULL) {
-        free(NDDSHOME);
+        MEM_FREE(NDDSHOME);
     }
     if (platformFile != NULL) {
-        free(platformFile);
+        MEM_FREE(platformFile);
     }
     if (archDef != NULL) {
         struct REDAInlineListNode *next;
@@ -2410,20 +11696,19 @@ done:
             Architecture_delete((struct Architecture *)node);
             node = next;
         }
-        free(archDef);
-    }
-    if (nddsFlags != NULL) {
-        free(nddsFlags);
+        MEM_FREE(archDef);
     }
-    if (nddsCLibs != NULL) {
-        free(nddsCLibs);
+    if (composeCtx != NULL) {
+        MEM_FREE(composeCtx);
     }
-    if (nddsCPPLibs != NULL) {
-        free(nddsCPPLibs);
+    if (toolchainFlags != NULL) {
+        MEM_FREE(toolchainFlags);
     }
-    if (nddsCPP03Libs != NULL) {
-        free(nddsCPP03Libs);
+    if (outBuf != NULL) {
+        MEM_FREE(outBuf);
     }
+    MEM_REPORT();
+    Trace_end(argOp, argTarget, retCode);
     return retCode;
 }
 /* }}} */
@@ -0,0 +1,798 @@
+/*****************************************************************************
+ * Copyright (c) 2020 Real-Time Innovations, Inc.  All rights reserved.      *
+ *                                                                           *
+ * Permission to modify and use for internal purposes granted.               *
+ * This software is provided "as is", without warranty, express or implied.  *
+ *****************************************************************************/
+
+/*
+ * Microbenchmarks for the parser and the composition functions of
+ * connext-config.
+ *
+ * The benchmark includes the source of connext-config directly, so it can
+ * exercise the internal (static) functions without changing them.
+ *
+ * Every benchmark is first calibrated (the number of calls per repetition is
+ * doubled until a repetition takes at least --min-time), then run for the
+ * warmup repetitions (discarded) and the measured repetitions.
+ * The reported times (min, median, p99) are per call.
+ *
+ * Usage:
+ *      connext-config-bench [--platform-file=<platforms.vm>] [--json]
+ *              [--reps=N] [--warmup=N] [--min-time=USEC] [--filter=STR]
+ *              [--synthetic-arches=N]
+ *
+ * The benchmarks on the real platform file are skipped if the file is not
+ * specified.
+ * ---------------------------------------------------------------------------
+ */
+
+/* Rename the main of connext-config, this file provides its own */
+#define main connextConfigMain
+#include "connext-config.c"
+#undef main
+
+#include <time.h>
+
+#define BENCH_DEFAULT_REPS              100
+#define BENCH_DEFAULT_WARMUP            10
+#define BENCH_DEFAULT_MIN_TIME_USEC     1000
+#define BENCH_DEFAULT_SYNTHETIC_ARCHES  100
+#define BENCH_MAX_INNER                 (1u << 24)
+
+/* Name of the target of the real platform file used for the composition */
+#define BENCH_REAL_TARGET               "x64Linux4gcc7.3.0"
+
+/* The env variable used by the expandEnvVar benchmarks */
+#define BENCH_ENV_VARIABLE              "CONNEXT_CONFIG_BENCH_VAR"
+
+/***************************************************************************
+ * Harness
+ **************************************************************************/
+typedef void (*BenchFunction)(void *arg);
+
+struct BenchOptions {
+    int                         reps;
+    int                         warmup;
+    unsigned long long          minTimeNs;
+    const char                  *filter;
+    RTIBool                     json;
+};
+
+struct BenchResult {
+    char                        name[MAX_STRING_SIZE];
+    unsigned int                inner;      /* Calls per repetition */
+    double                      minNs;
+    double                      medianNs;
+    double                      p99Ns;
+};
+
+/* All the results, printed at the end in JSON mode */
+#define BENCH_MAX_RESULTS               256
+static struct BenchResult theResults[BENCH_MAX_RESULTS];
+static int theResultCount = 0;
+
+/* {{{ nowNs
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static unsigned long long nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL +
+            (unsigned long long)ts.tv_nsec;
+}
+
+/* }}} */
+/* {{{ runRepetition
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the time (ns) taken by inner calls of the function
+ */
+static unsigned long long runRepetition(BenchFunction fn,
+        void *arg,
+        unsigned int inner) {
+    unsigned long long start = nowNs();
+    unsigned int i;
+    for (i = 0; i < inner; ++i) {
+        fn(arg);
+    }
+    return nowNs() - start;
+}
+
+/* }}} */
+/* {{{ compareDouble
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static int compareDouble(const void *a, const void *b) {
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+    return (da < db) ? -1 : ((da > db) ? 1 : 0);
+}
+
+/* }}} */
+/* {{{ runBenchmark
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Calibrates, warms up and measures the given function, then records and
+ * (in text mode) prints the result.
+ */
+static void runBenchmark(const struct BenchOptions *opt,
+        const char *name,
+        BenchFunction fn,
+        void *arg) {
+    struct BenchResult *res;
+    double *samples;
+    unsigned int inner = 1;
+    int i;
+
+    if ((opt->filter != NULL) && (strstr(name, opt->filter) == NULL)) {
+        return;
+    }
+    if (theResultCount == BENCH_MAX_RESULTS) {
+        fprintf(stderr, "Too many benchmarks, '%s' skipped\n", name);
+        return;
+    }
+    samples = calloc((size_t)opt->reps, sizeof(*samples));
+    if (samples == NULL) {
+        fprintf(stderr, "Out of memory allocating samples\n");
+        return;
+    }
+
+    /* Calibration */
+    while ((runRepetition(fn, arg, inner) < opt->minTimeNs) &&
+            (inner < BENCH_MAX_INNER)) {
+        inner *= 2;
+    }
+    for (i = 0; i < opt->warmup; ++i) {
+        runRepetition(fn, arg, inner);
+    }
+    for (i = 0; i < opt->reps; ++i) {
+        samples[i] = (double)runRepetition(fn, arg, inner) / inner;
+    }
+    qsort(samples, (size_t)opt->reps, sizeof(*samples), compareDouble);
+
+    res = &theResults[theResultCount++];
+    snprintf(res->name, sizeof(res->name), "%s", name);
+    res->inner = inner;
+    res->minNs = samples[0];
+    res->medianNs = samples[opt->reps / 2];
+    res->p99Ns = samples[((opt->reps * 99 + 99) / 100) - 1];
+    free(samples);
+
+    if (!opt->json) {
+        printf("%-44s %12.1f %12.1f %12.1f %10u\n",
+                res->name,
+                res->minNs,
+                res->medianNs,
+                res->p99Ns,
+                res->inner);
+        fflush(stdout);
+    }
+}
+
+/* }}} */
+/* {{{ writeJsonTime
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes a time in ns as a JSON number with one decimal
+ */
+static void writeJsonTime(struct JsonWriter *jw, double ns) {
+    JsonWriter_beginValue(jw);
+    fprintf(jw->fp, "%.1f", ns);
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * Inputs
+ **************************************************************************/
+/* {{{ readWholeFile
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Reads the whole file in memory. Returns NULL if an error occurred.
+ */
+static char *readWholeFile(const char *path, size_t *lenOut) {
+    char *content = NULL;
+    size_t contentLen = 0;
+    char buf[4096];
+    size_t rd;
+    FILE *in;
+    FILE *out;
+
+    in = fopen(path, "r");
+    if (in == NULL) {
+        fprintf(stderr, "Cannot open '%s': %s\n", path, strerror(errno));
+        return NULL;
+    }
+    out = open_memstream(&content, &contentLen);
+    if (out == NULL) {
+        fclose(in);
+        return NULL;
+    }
+    while ((rd = fread(buf, 1, sizeof(buf), in)) > 0) {
+        fwrite(buf, 1, rd, out);
+    }
+    fclose(in);
+    fclose(out);
+    *lenOut = contentLen;
+    return content;
+}
+
+/* }}} */
+/* {{{ generateSyntheticPlatform
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Generates the content of a platform file with the given number of
+ * architectures, using all the constructs of the real file (comments,
+ * #macro, booleans, strings, env values, single and multi-line arrays).
+ */
+static char *generateSyntheticPlatform(int archCount, size_t *lenOut) {
+    char *content = NULL;
+    size_t contentLen = 0;
+    FILE *fp;
+    int i;
+
+    fp = open_memstream(&content, &contentLen);
+    if (fp == NULL) {
+        return NULL;
+    }
+    fprintf(fp,
+            "## Synthetic platform file generated by connext-config-bench\n"
+            "#macro (arch $name $compiler $params)\n"
+            "  #set($dummy = $params)\n"
+            "#end\n\n");
+    for (i = 0; i < archCount; ++i) {
+        fprintf(fp,
+                "#arch(\"x64Synthetic%d\",\"gcc%d.0\", {\n"
+                "    $OS : $OS.UNIX,\n"
+                "    $PLATFORM : $PLATFORM.x64,\n"
+                "    $C_COMPILER : \"$(COMPILER_PATH)gcc\",\n"
+                "    $C_COMPILER_FLAGS : [\"m64\", \"Wall\", \"I$(SYNTHETIC_SDK)/include\"],\n"
+                "    $C_LINKER : \"gcc\",\n"
+                "    $C_LINKER_FLAGS : [\"m64\", \"Wl,--no-as-needed\"],\n"
+                "    $CXX_COMPILER : \"g++\",\n"
+                "    $CXX_COMPILER_FLAGS : [\"m64\", \"Wall\"],\n"
+                "    $CXX_LINKER : \"g++\",\n"
+                "    $CXX_LINKER_FLAGS : [\"m64\"],\n"
+                "    $SYSLIBS : [\"ldl\",\n"
+                "        \"lm\",\n"
+                "        \"lpthread\",\n"
+                "        \"lrt\"],\n"
+                "    $DEFINES : [\"DRTI_UNIX\", \"DRTI_LINUX\", \"DRTI_64BIT\"],\n"
+                "    $INCLUDES : [],\n"
+                "    $SUPPORTS_JAVA : true,\n"
+                "    $CPP03_COMPILER_FLAGS : [],\n"
+                "    $SUPPORTS_CPP03 : true,\n"
+                "    $CPP11_COMPILER_FLAGS : [\"std=c++14\"],\n"
+                "    $SUPPORTS_CPP11 : %s,\n"
+                "    \"TARGET_ID\" : \"%d\",\n"
+                "})\n\n",
+                i,
+                4 + (i % 8),
+                (i % 4 == 3) ? "false" : "true",
+                i);
+    }
+    fclose(fp);
+    *lenOut = contentLen;
+    return content;
+}
+
+/* }}} */
+/* {{{ writeTempFile
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the content into a new temporary file, returns RTI_FALSE if failed
+ */
+static RTIBool writeTempFile(const char *content,
+        size_t len,
+        char *pathOut,
+        size_t pathSize) {
+    const char *tmpDir = getenv("TMPDIR");
+    int fd;
+
+    snprintf(pathOut, pathSize, "%s/connext-config-bench-XXXXXX",
+            (tmpDir != NULL) ? tmpDir : "/tmp");
+    fd = mkstemp(pathOut);
+    if (fd == -1) {
+        fprintf(stderr, "Cannot create temp file: %s\n", strerror(errno));
+        return RTI_FALSE;
+    }
+    if (write(fd, content, len) != (ssize_t)len) {
+        fprintf(stderr, "Cannot write temp file: %s\n", strerror(errno));
+        close(fd);
+        unlink(pathOut);
+        return RTI_FALSE;
+    }
+    close(fd);
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ freeArchList
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void freeArchList(struct REDAInlineList *archDef) {
+    struct REDAInlineListNode *next;
+    struct REDAInlineListNode *node = REDAInlineList_getFirst(archDef);
+    while (node != NULL) {
+        next = REDAInlineListNode_getNext(node);
+        Architecture_delete((struct Architecture *)node);
+        node = next;
+    }
+    REDAInlineList_init(archDef);
+}
+
+/* }}} */
+/* {{{ createArchWithParams
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Creates an architecture with paramCount string parameters ($KEY_<n>)
+ */
+static struct Architecture *createArchWithParams(int paramCount) {
+    struct Architecture *arch = Architecture_new();
+    int i;
+
+    if (arch == NULL) {
+        return NULL;
+    }
+    snprintf(arch->target, MAX_STRING_SIZE, "x64Params%d", paramCount);
+    for (i = 0; i < paramCount; ++i) {
+        struct ArchParameter *param = ArchParameter_new();
+        if (param == NULL) {
+            Architecture_delete(arch);
+            return NULL;
+        }
+        snprintf(param->key, MAX_STRING_SIZE, "$KEY_%d", i);
+        snprintf(param->value.as_string, MAX_STRING_SIZE, "value%d", i);
+        param->valueType = APVT_String;
+        REDAInlineList_addNodeToBackEA(&arch->paramList, &param->parent);
+    }
+    return arch;
+}
+
+/* }}} */
+
+
+/***************************************************************************
+ * Benchmarks
+ **************************************************************************/
+/* Input of the benchmarks working on the content of a platform file */
+struct PlatformInput {
+    const char                  *path;
+    char                        *content;
+    size_t                      len;
+};
+
+/* {{{ benchAppendNextLine
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Reads all the lines of the (in-memory) platform file
+ */
+static void benchAppendNextLine(void *arg) {
+    struct PlatformInput *input = (struct PlatformInput *)arg;
+    struct PlatformFileInfo info;
+    char *line;
+    FILE *fp;
+
+    PlatformFileInfo_init(&info);
+    fp = fmemopen(input->content, input->len, "r");
+    if (fp == NULL) {
+        return;
+    }
+    while ((line = appendNextLine(fp, NULL, &info)) != NULL) {
+        free(line);
+    }
+    fclose(fp);
+}
+
+/* }}} */
+/* {{{ benchReadPlatformFile
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Parses the whole platform file (from the page cache) and releases it
+ */
+static void benchReadPlatformFile(void *arg) {
+    struct PlatformInput *input = (struct PlatformInput *)arg;
+    struct PlatformFileInfo info;
+    struct REDAInlineList archDef;
+
+    REDAInlineList_init(&archDef);
+    readPlatformFile(input->path, &archDef, &info);
+    freeArchList(&archDef);
+}
+
+/* }}} */
+/* Input of the benchmarks of a single line */
+struct LineInput {
+    const char                  *line;
+    char                        buf[MAX_CMDLINEARG_SIZE];
+    struct ArchParameter        *param;
+};
+
+/* {{{ benchProcessKeyValuePairLine
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void benchProcessKeyValuePairLine(void *arg) {
+    struct LineInput *input = (struct LineInput *)arg;
+    /* The line is modified while parsed */
+    strcpy(input->buf, input->line);
+    processKeyValuePairLine(input->buf, input->param);
+}
+
+/* }}} */
+/* {{{ benchParseStringInQuotes
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void benchParseStringInQuotes(void *arg) {
+    struct LineInput *input = (struct LineInput *)arg;
+    char value[MAX_STRING_SIZE];
+    const char *err;
+
+    strcpy(input->buf, input->line);
+    parseStringInQuotes(input->buf, value, MAX_STRING_SIZE, &err);
+}
+
+/* }}} */
+/* {{{ benchExpandEnvVar
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void benchExpandEnvVar(void *arg) {
+    struct LineInput *input = (struct LineInput *)arg;
+    expandEnvVar(input->line);
+}
+
+/* }}} */
+/* {{{ benchUnescapeString
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void benchUnescapeString(void *arg) {
+    struct LineInput *input = (struct LineInput *)arg;
+    unescapeString(input->buf);
+}
+
+/* }}} */
+/* Input of the archGetParam benchmarks */
+struct LookupInput {
+    struct Architecture         *arch;
+    const char                  *key;
+};
+
+/* {{{ benchArchGetParam
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void benchArchGetParam(void *arg) {
+    struct LookupInput *input = (struct LookupInput *)arg;
+    archGetParam(input->arch, input->key);
+}
+
+/* }}} */
+/* Input of the composition benchmarks */
+struct ComposeInput {
+    struct Architecture         *arch;
+    const char                  *op;
+    struct ComposeContext       ctx;
+    char                        buf[MAX_CMDLINEARG_SIZE+1];
+};
+
+/* {{{ benchComposeOperation
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void benchComposeOperation(void *arg) {
+    struct ComposeInput *input = (struct ComposeInput *)arg;
+    composeOperation(input->arch,
+            input->op,
+            &input->ctx,
+            input->buf,
+            sizeof(input->buf));
+}
+
+/* }}} */
+/* {{{ runPlatformBenchmarks
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Runs the benchmarks working on a platform file: reading, parsing, and the
+ * composition of all the operations for the given target
+ */
+static void runPlatformBenchmarks(const struct BenchOptions *opt,
+        const char *label,
+        struct PlatformInput *input,
+        const char *target) {
+    struct REDAInlineList archDef;
+    struct PlatformFileInfo info;
+    struct ComposeInput *compose;
+    struct LookupInput lookup;
+    char name[MAX_STRING_SIZE];
+    int i;
+
+    snprintf(name, sizeof(name), "appendNextLine/%s", label);
+    runBenchmark(opt, name, benchAppendNextLine, input);
+    snprintf(name, sizeof(name), "readPlatformFile/%s", label);
+    runBenchmark(opt, name, benchReadPlatformFile, input);
+
+    REDAInlineList_init(&archDef);
+    readPlatformFile(input->path, &archDef, &info);
+
+    lookup.arch = findArchitecture(&archDef, target);
+    if (lookup.arch == NULL) {
+        fprintf(stderr, "Target '%s' not found in '%s': composition skipped\n",
+                target,
+                input->path);
+        freeArchList(&archDef);
+        return;
+    }
+    lookup.key = "$SUPPORTS_CPP11";
+    snprintf(name, sizeof(name), "archGetParam/%s", label);
+    runBenchmark(opt, name, benchArchGetParam, &lookup);
+
+    compose = calloc(1, sizeof(*compose));
+    if (compose == NULL) {
+        freeArchList(&archDef);
+        return;
+    }
+    compose->arch = lookup.arch;
+    ComposeContext_init(&compose->ctx,
+            "/opt/rti_connext_dds",
+            target,
+            RTI_FALSE,
+            RTI_FALSE,
+            RTI_FALSE,
+            RTI_TRUE,
+            RTI_FALSE);
+    for (i = 0; VALID_WHAT[i] != NULL; ++i) {
+        compose->op = VALID_WHAT[i];
+        snprintf(name, sizeof(name), "compose/%s/%s", label, VALID_WHAT[i]+2);
+        runBenchmark(opt, name, benchComposeOperation, compose);
+    }
+    free(compose);
+    freeArchList(&archDef);
+}
+
+/* }}} */
+
+
+/* {{{ benchUsage
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void benchUsage(const char *argv0) {
+    printf("Usage: %s [options]\n", argv0);
+    printf("Options:\n");
+    printf("    --platform-file=PATH    real platform file (i.e. Connext 6.0.1)\n");
+    printf("    --synthetic-arches=N    arches of the synthetic file (default: %d)\n",
+            BENCH_DEFAULT_SYNTHETIC_ARCHES);
+    printf("    --reps=N                measured repetitions (default: %d)\n",
+            BENCH_DEFAULT_REPS);
+    printf("    --warmup=N              warmup repetitions (default: %d)\n",
+            BENCH_DEFAULT_WARMUP);
+    printf("    --min-time=USEC         min duration of a repetition (default: %d)\n",
+            BENCH_DEFAULT_MIN_TIME_USEC);
+    printf("    --filter=STR            run only the benchmarks containing STR\n");
+    printf("    --json                  print the results as JSON\n");
+}
+
+/* }}} */
+/* {{{ main
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+int main(int argc, char **argv) {
+    static const struct {
+        const char *name;
+        const char *line;
+    } KEY_VALUE_LINES[] = {
+        { "string",     "$C_COMPILER : \"arm-linux-androideabi-gcc\"," },
+        { "array",      "$SYSLIBS : [\"ldl\", \"lnsl\", \"lsocket\", \"lgen\", \"lposix4\", \"lpthread\", \"lm\", \"lc\"]," },
+        { "env",        "$OS : $OS.UNIX," },
+        { "boolean",    "$SUPPORTS_CPP03 : true," },
+        { NULL,         NULL }
+    };
+    static const struct {
+        const char *name;
+        const char *value;
+    } ENV_VALUES[] = {
+        { "none",       "-m64 -Wall -DRTI_UNIX -DRTI_LINUX -DRTI_64BIT" },
+        { "one",        "-I$(" BENCH_ENV_VARIABLE ")/include -m64 -Wall" },
+        { "three",      "$(" BENCH_ENV_VARIABLE ")/bin/gcc --sysroot=$(" BENCH_ENV_VARIABLE
+                        ")/sysroot -L$(" BENCH_ENV_VARIABLE ")/lib" },
+        { NULL,         NULL }
+    };
+    static const struct {
+        const char *name;
+        const char *value;
+    } UNESCAPE_VALUES[] = {
+        { "plain",      "-m64 -Wall -DRTI_UNIX -DRTI_LINUX -DRTI_64BIT -I/opt/rti/include" },
+        { "escaped",    "-DNAME=\\\"value\\\" -DTAB=\\t -DPATH=\\\"C:\\\\rti\\\\include\\\"" },
+        { NULL,         NULL }
+    };
+    static const int LOOKUP_SIZES[] = { 8, 32, 128, 0 };
+
+    struct BenchOptions opt;
+    struct PlatformInput real;
+    struct PlatformInput synthetic;
+    struct LineInput *lineInput = NULL;
+    char syntheticPath[PATH_MAX+1];
+    char name[MAX_STRING_SIZE];
+    int syntheticArches = BENCH_DEFAULT_SYNTHETIC_ARCHES;
+    int retCode = 1;
+    int i;
+
+    opt.reps = BENCH_DEFAULT_REPS;
+    opt.warmup = BENCH_DEFAULT_WARMUP;
+    opt.minTimeNs = BENCH_DEFAULT_MIN_TIME_USEC * 1000ULL;
+    opt.filter = NULL;
+    opt.json = RTI_FALSE;
+    memset(&real, 0, sizeof(real));
+    memset(&synthetic, 0, sizeof(synthetic));
+    syntheticPath[0] = '\0';
+
+    for (i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--platform-file=", 16) == 0) {
+            real.path = argv[i]+16;
+        } else if (strncmp(argv[i], "--synthetic-arches=", 19) == 0) {
+            syntheticArches = atoi(argv[i]+19);
+        } else if (strncmp(argv[i], "--reps=", 7) == 0) {
+            opt.reps = atoi(argv[i]+7);
+        } else if (strncmp(argv[i], "--warmup=", 9) == 0) {
+            opt.warmup = atoi(argv[i]+9);
+        } else if (strncmp(argv[i], "--min-time=", 11) == 0) {
+            opt.minTimeNs = strtoull(argv[i]+11, NULL, 10) * 1000ULL;
+        } else if (strncmp(argv[i], "--filter=", 9) == 0) {
+            opt.filter = argv[i]+9;
+        } else if (strcmp(argv[i], "--json") == 0) {
+            opt.json = RTI_TRUE;
+        } else if ((strcmp(argv[i], "-h") == 0) ||
+                (strcmp(argv[i], "--help") == 0)) {
+            benchUsage(argv[0]);
+            return 0;
+        } else {
+            fprintf(stderr, "Invalid argument: %s\n", argv[i]);
+            benchUsage(argv[0]);
+            return 1;
+        }
+    }
+    if ((opt.reps <= 0) || (opt.warmup < 0) || (syntheticArches <= 0)) {
+        fprintf(stderr, "Invalid number of repetitions or arches\n");
+        return 1;
+    }
+
+    /* Inputs */
+    if ((real.path != NULL) && (real.path[0] != '\0')) {
+        real.content = readWholeFile(real.path, &real.len);
+        if (real.content == NULL) {
+            goto done;
+        }
+    }
+    synthetic.content = generateSyntheticPlatform(syntheticArches, &synthetic.len);
+    if ((synthetic.content == NULL) ||
+            !writeTempFile(synthetic.content,
+                synthetic.len,
+                syntheticPath,
+                sizeof(syntheticPath))) {
+        syntheticPath[0] = '\0';
+        goto done;
+    }
+    synthetic.path = syntheticPath;
+    setenv(BENCH_ENV_VARIABLE, "/opt/toolchains/x64Linux", 1);
+    setenv("COMPILER_PATH", "/usr/bin/", 1);
+    setenv("SYNTHETIC_SDK", "/opt/sdk", 1);
+
+    if (!opt.json) {
+        printf("%-44s %12s %12s %12s %10s\n",
+                "benchmark (ns/call)", "min", "median", "p99", "calls/rep");
+    }
+
+    /* Platform file benchmarks */
+    if (real.content != NULL) {
+        runPlatformBenchmarks(&opt, "real", &real, BENCH_REAL_TARGET);
+    }
+    snprintf(name, sizeof(name), "synthetic%d", syntheticArches);
+    runPlatformBenchmarks(&opt, name, &synthetic, "x64Synthetic0gcc4.0");
+
+    /* Line level benchmarks */
+    lineInput = calloc(1, sizeof(*lineInput));
+    if (lineInput == NULL) {
+        goto done;
+    }
+    lineInput->param = ArchParameter_new();
+    if (lineInput->param == NULL) {
+        goto done;
+    }
+    for (i = 0; KEY_VALUE_LINES[i].name != NULL; ++i) {
+        lineInput->line = KEY_VALUE_LINES[i].line;
+        snprintf(name, sizeof(name), "processKeyValuePairLine/%s",
+                KEY_VALUE_LINES[i].name);
+        runBenchmark(&opt, name, benchProcessKeyValuePairLine, lineInput);
+    }
+    lineInput->line = "\"arm-linux-androideabi-gcc\",";
+    runBenchmark(&opt,
+            "parseStringInQuotes",
+            benchParseStringInQuotes,
+            lineInput);
+    for (i = 0; ENV_VALUES[i].name != NULL; ++i) {
+        lineInput->line = ENV_VALUES[i].value;
+        snprintf(name, sizeof(name), "expandEnvVar/%s", ENV_VALUES[i].name);
+        runBenchmark(&opt, name, benchExpandEnvVar, lineInput);
+    }
+    for (i = 0; UNESCAPE_VALUES[i].name != NULL; ++i) {
+        /* unescapeString does not modify the input */
+        strcpy(lineInput->buf, UNESCAPE_VALUES[i].value);
+        snprintf(name, sizeof(name), "unescapeString/%s", UNESCAPE_VALUES[i].name);
+        runBenchmark(&opt, name, benchUnescapeString, lineInput);
+    }
+
+    /* Lookup at varying list lengths: first, last and missing key */
+    for (i = 0; LOOKUP_SIZES[i] != 0; ++i) {
+        struct LookupInput lookup;
+        char lastKey[MAX_STRING_SIZE];
+
+        lookup.arch = createArchWithParams(LOOKUP_SIZES[i]);
+        if (lookup.arch == NULL) {
+            goto done;
+        }
+        lookup.key = "$KEY_0";
+        snprintf(name, sizeof(name), "archGetParam/%d/first", LOOKUP_SIZES[i]);
+        runBenchmark(&opt, name, benchArchGetParam, &lookup);
+        snprintf(lastKey, sizeof(lastKey), "$KEY_%d", LOOKUP_SIZES[i]-1);
+        lookup.key = lastKey;
+        snprintf(name, sizeof(name), "archGetParam/%d/last", LOOKUP_SIZES[i]);
+        runBenchmark(&opt, name, benchArchGetParam, &lookup);
+        lookup.key = "$MISSING";
+        snprintf(name, sizeof(name), "archGetParam/%d/missing", LOOKUP_SIZES[i]);
+        runBenchmark(&opt, name, benchArchGetParam, &lookup);
+        Architecture_delete(lookup.arch);
+    }
+
+    if (opt.json) {
+        struct JsonWriter jw;
+        char hash[MAX_STRING_SIZE];
+
+        JsonWriter_init(&jw, stdout);
+        JsonWriter_beginObject(&jw);
+        JsonWriter_key(&jw, "version");
+        JsonWriter_string(&jw, APPLICATION_VERSION);
+        JsonWriter_key(&jw, "platformFile");
+        if (real.content != NULL) {
+            struct PlatformFileInfo info;
+            PlatformFileInfo_init(&info);
+            PlatformFileInfo_hashData(&info, real.content, real.len);
+            snprintf(hash, sizeof(hash), "fnv1a64:%016llx", info.hash);
+            JsonWriter_beginObject(&jw);
+            JsonWriter_key(&jw, "path");
+            JsonWriter_string(&jw, real.path);
+            JsonWriter_key(&jw, "hash");
+            JsonWriter_string(&jw, hash);
+            JsonWriter_endObject(&jw);
+        } else {
+            JsonWriter_null(&jw);
+        }
+        JsonWriter_key(&jw, "reps");
+        JsonWriter_unsigned(&jw, (unsigned int)opt.reps);
+        JsonWriter_key(&jw, "warmup");
+        JsonWriter_unsigned(&jw, (unsigned int)opt.warmup);
+        JsonWriter_key(&jw, "benchmarks");
+        JsonWriter_beginArray(&jw);
+        for (i = 0; i < theResultCount; ++i) {
+            JsonWriter_beginObject(&jw);
+            JsonWriter_key(&jw, "name");
+            JsonWriter_string(&jw, theResults[i].name);
+            JsonWriter_key(&jw, "calls");
+            JsonWriter_unsigned(&jw, theResults[i].inner);
+            JsonWriter_key(&jw, "min_ns");
+            writeJsonTime(&jw, theResults[i].minNs);
+            JsonWriter_key(&jw, "median_ns");
+            writeJsonTime(&jw, theResults[i].medianNs);
+            JsonWriter_key(&jw, "p99_ns");
+            writeJsonTime(&jw, theResults[i].p99Ns);
+            JsonWriter_endObject(&jw);
+        }
+        JsonWriter_endArray(&jw);
+        JsonWriter_endObject(&jw);
+        fputc('\n', stdout);
+    }
+    retCode = 0;
+
+done:
+    if (lineInput != NULL) {
+        if (lineInput->param != NULL) {
+            ArchParameter_delete(lineInput->param);
+        }
+        free(lineInput);
+    }
+    if (syntheticPath[0] != '\0') {
+        unlink(syntheticPath);
+    }
+    free(real.content);
+    free(synthetic.content);
+    return retCode;
+}
+
+/* }}} */
@@ -0,0 +1,671 @@
+/*****************************************************************************
+ * Copyright (c) 2020 Real-Time Innovations, Inc.  All rights reserved.      *
+ *                                                                           *
+ * Permission to modify and use for internal purposes granted.               *
+ * This software is provided "as is", without warranty, express or implied.  *
+ *****************************************************************************/
+
+/*
+ * End-to-end latency benchmark of the connext-config command line.
+ *
+ * The benchmark executes the given connext-config binary multiple times for
+ * each combination of (operation, target, modifiers) and measures the wall
+ * time from the spawn of the process to its termination, that is the cost
+ * paid by every compiler invocation of a build that uses connext-config.
+ *
+ * Two sets of runs are measured for each combination:
+ *  - warm: the binary and the platform file are in the page cache
+ *  - cold: before each run the command given with --drop-caches (i.e.
+ *    "sync; echo 3 > /proc/sys/vm/drop_caches") is executed through the
+ *    shell. The cold runs are skipped if no command is specified.
+ *
+ * The results (p50, p90, p99 in microseconds) can be saved as a baseline
+ * with --save-baseline and compared with a baseline with --baseline: the
+ * program fails (exit code 1) if the p50 or p90 of any combination exceeds
+ * the value of the baseline by more than --max-regression percent (and by
+ * more than --min-delta microseconds, to ignore the noise on fast runs).
+ *
+ * The baseline is a JSON document with one benchmark object per line, as
+ * written by --save-baseline: the reader relies on this layout.
+ * ---------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define MAX_STRING_SIZE                 200
+#define MAX_ARGS                        16
+#define MAX_BENCHMARKS                  512
+#define MAX_LIST_SIZE                   64
+
+#define DEFAULT_WARM_RUNS               30
+#define DEFAULT_COLD_RUNS               5
+#define DEFAULT_WARMUP_RUNS             3
+#define DEFAULT_MAX_REGRESSION_PCT      20.0
+#define DEFAULT_MIN_DELTA_USEC          100.0
+#define DEFAULT_TARGETS                 "x64Linux4gcc7.3.0"
+#define DEFAULT_OPERATIONS              "--ccomp,--cflags,--ldflags,--ldlibs,--cxx11flags,--ldxx11libs,--emit-sh"
+
+/* Env variable with the command used to drop the page cache */
+#define DROP_CACHES_ENV_VARIABLE        "CONNEXT_CONFIG_DROP_CACHES"
+
+/* The binary of the exec floor benchmark (no connext-config involved) */
+#define EXEC_FLOOR_BINARY               "/bin/true"
+
+extern char **environ;
+
+/* The modifiers combined with each operation and target */
+static const char *MODIFIERS[] = {
+    "",
+    "--static",
+    "--static --debug",
+    "--noexpand --sh",
+    NULL
+};
+
+/* The commands that do not require a target */
+static const char *STANDALONE_COMMANDS[] = {
+    "--version",
+    "--list-all",
+    "--list-installed",
+    NULL
+};
+
+typedef enum {
+    RUN_MODE_WARM,
+    RUN_MODE_COLD
+} RunMode;
+
+static const char *RUN_MODE_NAMES[] = { "warm", "cold" };
+
+struct Options {
+    const char                  *binary;
+    const char                  *baselineFile;
+    const char                  *saveBaselineFile;
+    const char                  *dropCachesCmd;
+    int                         warmRuns;
+    int                         coldRuns;
+    int                         warmupRuns;
+    double                      maxRegressionPct;
+    double                      minDeltaUsec;
+    int                         json;
+};
+
+struct Benchmark {
+    RunMode                     mode;
+    char                        binary[PATH_MAX];
+    char                        target[MAX_STRING_SIZE];
+    char                        args[MAX_STRING_SIZE];
+    char                        argsBuf[MAX_STRING_SIZE];   /* Split args */
+    char                        *argv[MAX_ARGS];
+    double                      *samples;
+    int                         runs;
+    int                         failures;   /* Runs with exit code != 0 */
+    double                      p50Usec;
+    double                      p90Usec;
+    double                      p99Usec;
+};
+
+static struct Benchmark theBenchmarks[MAX_BENCHMARKS];
+static int theBenchmarkCount = 0;
+
+/* {{{ nowNs
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static unsigned long long nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL +
+            (unsigned long long)ts.tv_nsec;
+}
+
+/* }}} */
+/* {{{ splitList
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Splits in place a list of items separated by the given separators.
+ * Returns the number of items stored in itemsOut (NULL-terminated).
+ */
+static int splitList(char *list,
+        const char *separators,
+        char **itemsOut,
+        int maxItems) {
+    int count = 0;
+    char *item = strtok(list, separators);
+    while ((item != NULL) && (count < maxItems-1)) {
+        itemsOut[count++] = item;
+        item = strtok(NULL, separators);
+    }
+    itemsOut[count] = NULL;
+    return count;
+}
+
+/* }}} */
+/* {{{ compareDouble
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static int compareDouble(const void *a, const void *b) {
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+    return (da < db) ? -1 : ((da > db) ? 1 : 0);
+}
+
+/* }}} */
+/* {{{ percentile
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Nearest-rank percentile of the sorted samples
+ */
+static double percentile(const double *sorted, int count, int pct) {
+    int rank = (count * pct + 99) / 100;
+    if (rank < 1) {
+        rank = 1;
+    }
+    return sorted[rank-1];
+}
+
+/* }}} */
+/* {{{ dropCaches
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Runs the command to drop the page cache. Returns 0 if succeeded.
+ */
+static int dropCaches(const char *cmd) {
+    int rc = system(cmd);
+    if ((rc == -1) || !WIFEXITED(rc) || (WEXITSTATUS(rc) != 0)) {
+        fprintf(stderr, "Error: the drop caches command failed: %s\n", cmd);
+        return -1;
+    }
+    return 0;
+}
+
+/* }}} */
+/* {{{ runOnce
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Spawns the command (output discarded) and waits for its termination.
+ *
+ * \param argv      the NULL-terminated command line
+ * \param usecOut   the wall time of the run in microseconds
+ * \param exitOut   the exit code of the command (-1 if it did not exit)
+ * \return          0 if the command was executed, -1 otherwise
+ */
+static int runOnce(char **argv, double *usecOut, int *exitOut) {
+    posix_spawn_file_actions_t actions;
+    unsigned long long start;
+    int status;
+    pid_t pid;
+    int rc;
+
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO,
+            "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO,
+            "/dev/null", O_WRONLY, 0);
+
+    start = nowNs();
+    rc = posix_spawn(&pid, argv[0], &actions, NULL, argv, environ);
+    if (rc == 0) {
+        while (waitpid(pid, &status, 0) == -1) {
+            if (errno != EINTR) {
+                rc = errno;
+                break;
+            }
+        }
+    }
+    *usecOut = (double)(nowNs() - start) / 1000.0;
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (rc != 0) {
+        fprintf(stderr, "Error: cannot execute '%s': %s\n",
+                argv[0], strerror(rc));
+        return -1;
+    }
+    *exitOut = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    return 0;
+}
+
+/* }}} */
+/* {{{ addBenchmark
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Adds a command line (binary, args, target) to measure with the given mode.
+ * Returns 0 if succeeded.
+ */
+static int addBenchmark(const struct Options *opt,
+        RunMode mode,
+        const char *binary,
+        const char *target,
+        const char *args) {
+    struct Benchmark *bm;
+    int argc;
+
+    if (theBenchmarkCount == MAX_BENCHMARKS) {
+        fprintf(stderr, "Error: too many benchmarks\n");
+        return -1;
+    }
+    bm = &theBenchmarks[theBenchmarkCount];
+    memset(bm, 0, sizeof(*bm));
+    bm->mode = mode;
+    bm->runs = (mode == RUN_MODE_WARM) ? opt->warmRuns : opt->coldRuns;
+    bm->samples = calloc((size_t)bm->runs, sizeof(*bm->samples));
+    if (bm->samples == NULL) {
+        fprintf(stderr, "Error: out of memory\n");
+        return -1;
+    }
+    snprintf(bm->binary, sizeof(bm->binary), "%s", binary);
+    snprintf(bm->target, sizeof(bm->target), "%s", target);
+    snprintf(bm->args, sizeof(bm->args), "%s", args);
+    snprintf(bm->argsBuf, sizeof(bm->argsBuf), "%s", args);
+
+    bm->argv[0] = bm->binary;
+    argc = 1 + splitList(bm->argsBuf, " ", &bm->argv[1], MAX_ARGS-2);
+    if (bm->target[0] != '\0') {
+        bm->argv[argc++] = bm->target;
+    }
+    bm->argv[argc] = NULL;
+    ++theBenchmarkCount;
+    return 0;
+}
+
+/* }}} */
+/* {{{ runBenchmarks
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Runs all the benchmarks of the given mode.
+ *
+ * The runs are interleaved (one run of each benchmark per round), so that
+ * a drift of the system (frequency scaling, other load) affects all the
+ * benchmarks in the same way instead of the ones measured last.
+ *
+ * Returns 0 if succeeded.
+ */
+static int runBenchmarks(const struct Options *opt, RunMode mode) {
+    int rounds = (mode == RUN_MODE_WARM) ? opt->warmupRuns + opt->warmRuns :
+            opt->coldRuns;
+    int first = (mode == RUN_MODE_WARM) ? opt->warmupRuns : 0;
+    int r, i;
+
+    for (r = 0; r < rounds; ++r) {
+        for (i = 0; i < theBenchmarkCount; ++i) {
+            struct Benchmark *bm = &theBenchmarks[i];
+            double usec;
+            int exitCode;
+
+            if (bm->mode != mode) {
+                continue;
+            }
+            if ((mode == RUN_MODE_COLD) && (dropCaches(opt->dropCachesCmd) != 0)) {
+                return -1;
+            }
+            if (runOnce(bm->argv, &usec, &exitCode) != 0) {
+                return -1;
+            }
+            if (r < first) {
+                /* Warmup run */
+                continue;
+            }
+            bm->samples[r - first] = usec;
+            if (exitCode != 0) {
+                ++bm->failures;
+            }
+        }
+    }
+
+    for (i = 0; i < theBenchmarkCount; ++i) {
+        struct Benchmark *bm = &theBenchmarks[i];
+        if (bm->mode != mode) {
+            continue;
+        }
+        qsort(bm->samples, (size_t)bm->runs, sizeof(*bm->samples), compareDouble);
+        bm->p50Usec = percentile(bm->samples, bm->runs, 50);
+        bm->p90Usec = percentile(bm->samples, bm->runs, 90);
+        bm->p99Usec = percentile(bm->samples, bm->runs, 99);
+
+        if (!opt->json) {
+            printf("%-4s %-20s %-28s %10.1f %10.1f %10.1f%s\n",
+                    RUN_MODE_NAMES[mode],
+                    (bm->target[0] != '\0') ? bm->target : "-",
+                    (bm->args[0] != '\0') ? bm->args : "(" EXEC_FLOOR_BINARY ")",
+                    bm->p50Usec,
+                    bm->p90Usec,
+                    bm->p99Usec,
+                    (bm->failures > 0) ? "  (failed)" : "");
+        }
+    }
+    fflush(stdout);
+    return 0;
+}
+
+/* }}} */
+/* {{{ writeResults
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the results as JSON, one benchmark per line (the layout is
+ * required by readBaseline)
+ */
+static void writeResults(FILE *fp, const struct Options *opt) {
+    int i;
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"warmRuns\": %d,\n", opt->warmRuns);
+    fprintf(fp, "  \"coldRuns\": %d,\n", (opt->dropCachesCmd != NULL) ? opt->coldRuns : 0);
+    fprintf(fp, "  \"benchmarks\": [\n");
+    for (i = 0; i < theBenchmarkCount; ++i) {
+        const struct Benchmark *bm = &theBenchmarks[i];
+        fprintf(fp, "    {\"mode\": \"%s\", \"target\": \"%s\", \"args\": \"%s\", "
+                "\"runs\": %d, \"failures\": %d, "
+                "\"p50_us\": %.1f, \"p90_us\": %.1f, \"p99_us\": %.1f}%s\n",
+                RUN_MODE_NAMES[bm->mode],
+                bm->target,
+                bm->args,
+                bm->runs,
+                bm->failures,
+                bm->p50Usec,
+                bm->p90Usec,
+                bm->p99Usec,
+                (i == theBenchmarkCount-1) ? "" : ",");
+    }
+    fprintf(fp, "  ]\n");
+    fprintf(fp, "}\n");
+}
+
+/* }}} */
+/* {{{ getJsonString
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Extracts the string value of the given key from a line of the baseline.
+ * Returns 0 if found.
+ */
+static int getJsonString(const char *line,
+        const char *key,
+        char *valueOut,
+        size_t valueSize) {
+    char pattern[MAX_STRING_SIZE];
+    const char *start;
+    const char *end;
+
+    snprintf(pattern, sizeof(pattern), "\"%s\": \"", key);
+    start = strstr(line, pattern);
+    if (start == NULL) {
+        return -1;
+    }
+    start += strlen(pattern);
+    end = strchr(start, '"');
+    if ((end == NULL) || ((size_t)(end - start) >= valueSize)) {
+        return -1;
+    }
+    memcpy(valueOut, start, (size_t)(end - start));
+    valueOut[end - start] = '\0';
+    return 0;
+}
+
+/* }}} */
+/* {{{ getJsonNumber
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Extracts the numeric value of the given key from a line of the baseline.
+ * Returns 0 if found.
+ */
+static int getJsonNumber(const char *line, const char *key, double *valueOut) {
+    char pattern[MAX_STRING_SIZE];
+    const char *start;
+
+    snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+    start = strstr(line, pattern);
+    if (start == NULL) {
+        return -1;
+    }
+    return (sscanf(start + strlen(pattern), "%lf", valueOut) == 1) ? 0 : -1;
+}
+
+/* }}} */
+/* {{{ compareWithBaseline
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Compares the results with the baseline file.
+ * Returns the number of regressions, or -1 if the baseline cannot be read.
+ */
+static int compareWithBaseline(const struct Options *opt) {
+    char line[1024];
+    int regressions = 0;
+    int compared = 0;
+    FILE *fp;
+    int i;
+
+    fp = fopen(opt->baselineFile, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "Error: cannot open baseline '%s': %s\n",
+                opt->baselineFile, strerror(errno));
+        return -1;
+    }
+    fprintf(stderr, "\nComparing with baseline %s "
+            "(max regression %.0f%%, min delta %.0fus):\n",
+            opt->baselineFile,
+            opt->maxRegressionPct,
+            opt->minDeltaUsec);
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char mode[MAX_STRING_SIZE];
+        char target[MAX_STRING_SIZE];
+        char args[MAX_STRING_SIZE];
+        double baseP50;
+        double baseP90;
+
+        if ((getJsonString(line, "mode", mode, sizeof(mode)) != 0) ||
+                (getJsonString(line, "target", target, sizeof(target)) != 0) ||
+                (getJsonString(line, "args", args, sizeof(args)) != 0) ||
+                (getJsonNumber(line, "p50_us", &baseP50) != 0) ||
+                (getJsonNumber(line, "p90_us", &baseP90) != 0)) {
+            continue;
+        }
+        for (i = 0; i < theBenchmarkCount; ++i) {
+            const struct Benchmark *bm = &theBenchmarks[i];
+            const double pct = 1.0 + opt->maxRegressionPct / 100.0;
+            if ((strcmp(RUN_MODE_NAMES[bm->mode], mode) != 0) ||
+                    (strcmp(bm->target, target) != 0) ||
+                    (strcmp(bm->args, args) != 0)) {
+                continue;
+            }
+            ++compared;
+            if (((bm->p50Usec > baseP50 * pct) &&
+                        (bm->p50Usec - baseP50 > opt->minDeltaUsec)) ||
+                    ((bm->p90Usec > baseP90 * pct) &&
+                        (bm->p90Usec - baseP90 > opt->minDeltaUsec))) {
+                ++regressions;
+                fprintf(stderr, "  REGRESSION %s %s %s: p50 %.1fus (baseline %.1fus, %+.0f%%), "
+                        "p90 %.1fus (baseline %.1fus, %+.0f%%)\n",
+                        mode,
+                        (target[0] != '\0') ? target : "-",
+                        args,
+                        bm->p50Usec, baseP50, (bm->p50Usec / baseP50 - 1.0) * 100.0,
+                        bm->p90Usec, baseP90, (bm->p90Usec / baseP90 - 1.0) * 100.0);
+            }
+            break;
+        }
+    }
+    fclose(fp);
+    fprintf(stderr, "  %d benchmarks compared, %d regressions\n",
+            compared, regressions);
+    return regressions;
+}
+
+/* }}} */
+/* {{{ usage
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void usage(const char *argv0) {
+    printf("Usage: %s --binary=PATH [options]\n", argv0);
+    printf("Options:\n");
+    printf("    --binary=PATH           the connext-config binary to measure\n");
+    printf("    --targets=LIST          comma-separated targets (default: %s)\n",
+            DEFAULT_TARGETS);
+    printf("    --ops=LIST              comma-separated operations (default: %s)\n",
+            DEFAULT_OPERATIONS);
+    printf("    --runs=N                warm runs per combination (default: %d)\n",
+            DEFAULT_WARM_RUNS);
+    printf("    --cold-runs=N           cold runs per combination (default: %d)\n",
+            DEFAULT_COLD_RUNS);
+    printf("    --warmup=N              discarded runs before the warm runs (default: %d)\n",
+            DEFAULT_WARMUP_RUNS);
+    printf("    --drop-caches=CMD       shell command to drop the page cache before\n"
+           "                            each cold run (default: $%s, if\n"
+           "                            not set the cold runs are skipped)\n",
+            DROP_CACHES_ENV_VARIABLE);
+    printf("    --baseline=FILE         compare with the baseline, fail if regressed\n");
+    printf("    --save-baseline=FILE    save the results as the new baseline\n");
+    printf("    --max-regression=PCT    max allowed increase of p50/p90 (default: %.0f)\n",
+            DEFAULT_MAX_REGRESSION_PCT);
+    printf("    --min-delta=USEC        ignore increases below USEC (default: %.0f)\n",
+            DEFAULT_MIN_DELTA_USEC);
+    printf("    --json                  print the results as JSON\n");
+}
+
+/* }}} */
+/* {{{ main
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+int main(int argc, char **argv) {
+    struct Options opt;
+    char targetList[1024];
+    char opList[1024];
+    char *targets[MAX_LIST_SIZE];
+    char *ops[MAX_LIST_SIZE];
+    char args[MAX_STRING_SIZE];
+    int failures = 0;
+    int mode;
+    int t, o, m, i;
+
+    memset(&opt, 0, sizeof(opt));
+    opt.warmRuns = DEFAULT_WARM_RUNS;
+    opt.coldRuns = DEFAULT_COLD_RUNS;
+    opt.warmupRuns = DEFAULT_WARMUP_RUNS;
+    opt.maxRegressionPct = DEFAULT_MAX_REGRESSION_PCT;
+    opt.minDeltaUsec = DEFAULT_MIN_DELTA_USEC;
+    opt.dropCachesCmd = getenv(DROP_CACHES_ENV_VARIABLE);
+    snprintf(targetList, sizeof(targetList), "%s", DEFAULT_TARGETS);
+    snprintf(opList, sizeof(opList), "%s", DEFAULT_OPERATIONS);
+
+    for (i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--binary=", 9) == 0) {
+            opt.binary = argv[i]+9;
+        } else if (strncmp(argv[i], "--targets=", 10) == 0) {
+            snprintf(targetList, sizeof(targetList), "%s", argv[i]+10);
+        } else if (strncmp(argv[i], "--ops=", 6) == 0) {
+            snprintf(opList, sizeof(opList), "%s", argv[i]+6);
+        } else if (strncmp(argv[i], "--runs=", 7) == 0) {
+            opt.warmRuns = atoi(argv[i]+7);
+        } else if (strncmp(argv[i], "--cold-runs=", 12) == 0) {
+            opt.coldRuns = atoi(argv[i]+12);
+        } else if (strncmp(argv[i], "--warmup=", 9) == 0) {
+            opt.warmupRuns = atoi(argv[i]+9);
+        } else if (strncmp(argv[i], "--drop-caches=", 14) == 0) {
+            opt.dropCachesCmd = argv[i]+14;
+        } else if (strncmp(argv[i], "--baseline=", 11) == 0) {
+            opt.baselineFile = argv[i]+11;
+        } else if (strncmp(argv[i], "--save-baseline=", 16) == 0) {
+            opt.saveBaselineFile = argv[i]+16;
+        } else if (strncmp(argv[i], "--max-regression=", 17) == 0) {
+            opt.maxRegressionPct = atof(argv[i]+17);
+        } else if (strncmp(argv[i], "--min-delta=", 12) == 0) {
+            opt.minDeltaUsec = atof(argv[i]+12);
+        } else if (strcmp(argv[i], "--json") == 0) {
+            opt.json = 1;
+        } else if ((strcmp(argv[i], "-h") == 0) ||
+                (strcmp(argv[i], "--help") == 0)) {
+            usage(argv[0]);
+            return 0;
+        } else {
+            fprintf(stderr, "Invalid argument: %s\n", argv[i]);
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (opt.binary == NULL) {
+        fprintf(stderr, "Error: missing --binary\n");
+        usage(argv[0]);
+        return 2;
+    }
+    if ((opt.warmRuns <= 0) || (opt.coldRuns <= 0) || (opt.warmupRuns < 0)) {
+        fprintf(stderr, "Error: invalid number of runs\n");
+        return 2;
+    }
+    if ((opt.dropCachesCmd != NULL) && (opt.dropCachesCmd[0] == '\0')) {
+        opt.dropCachesCmd = NULL;
+    }
+    splitList(targetList, ",", targets, MAX_LIST_SIZE);
+    splitList(opList, ",", ops, MAX_LIST_SIZE);
+
+    if (!opt.json) {
+        printf("%-4s %-20s %-28s %10s %10s %10s\n",
+                "mode", "target", "arguments", "p50 (us)", "p90 (us)", "p99 (us)");
+    }
+    for (mode = RUN_MODE_WARM; mode <= RUN_MODE_COLD; ++mode) {
+        if ((mode == RUN_MODE_COLD) && (opt.dropCachesCmd == NULL)) {
+            fprintf(stderr, "Cold runs skipped: no drop caches command "
+                    "(use --drop-caches or $%s)\n",
+                    DROP_CACHES_ENV_VARIABLE);
+            break;
+        }
+        /* The cost of spawning a process that does nothing */
+        if (addBenchmark(&opt, (RunMode)mode, EXEC_FLOOR_BINARY, "", "") != 0) {
+            return 2;
+        }
+        for (i = 0; STANDALONE_COMMANDS[i] != NULL; ++i) {
+            if (addBenchmark(&opt, (RunMode)mode, opt.binary, "",
+                        STANDALONE_COMMANDS[i]) != 0) {
+                return 2;
+            }
+        }
+        for (t = 0; targets[t] != NULL; ++t) {
+            for (o = 0; ops[o] != NULL; ++o) {
+                for (m = 0; MODIFIERS[m] != NULL; ++m) {
+                    snprintf(args, sizeof(args), "%s%s%s",
+                            MODIFIERS[m],
+                            (MODIFIERS[m][0] != '\0') ? " " : "",
+                            ops[o]);
+                    if (addBenchmark(&opt, (RunMode)mode, opt.binary,
+                                targets[t], args) != 0) {
+                        return 2;
+                    }
+                }
+            }
+        }
+        if (runBenchmarks(&opt, (RunMode)mode) != 0) {
+            return 2;
+        }
+    }
+
+    for (i = 0; i < theBenchmarkCount; ++i) {
+        if (theBenchmarks[i].failures > 0) {
+            fprintf(stderr, "Error: '%s %s' (%s) failed in %d runs\n",
+                    theBenchmarks[i].args,
+                    theBenchmarks[i].target,
+                    RUN_MODE_NAMES[theBenchmarks[i].mode],
+                    theBenchmarks[i].failures);
+            ++failures;
+        }
+    }
+    if (opt.json) {
+        writeResults(stdout, &opt);
+    }
+    if (opt.saveBaselineFile != NULL) {
+        FILE *fp = fopen(opt.saveBaselineFile, "w");
+        if (fp == NULL) {
+            fprintf(stderr, "Error: cannot write baseline '%s': %s\n",
+                    opt.saveBaselineFile, strerror(errno));
+            return 2;
+        }
+        writeResults(fp, &opt);
+        fclose(fp);
+        fprintf(stderr, "Baseline saved to %s\n", opt.saveBaselineFile);
+    }
+    if (opt.baselineFile != NULL) {
+        int regressions = compareWithBaseline(&opt);
+        if (regressions < 0) {
+            return 2;
+        }
+        if (regressions > 0) {
+            return 1;
+        }
+    }
+    return (failures > 0) ? 1 : 0;
+}
+
+/* }}} */
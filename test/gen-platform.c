@@ -0,0 +1,485 @@
+/*****************************************************************************
+ * Copyright (c) 2020 Real-Time Innovations, Inc.  All rights reserved.      *
+ *                                                                           *
+ * Permission to modify and use for internal purposes granted.               *
+ * This software is provided "as is", without warranty, express or implied.  *
+ *****************************************************************************/
+
+/*
+ * Generator of synthetic platform files.
+ *
+ * Writes a platforms.vm in the same dialect accepted by readPlatformFile:
+ * comments (full line and trailing), #macro blocks, #set directives,
+ * #arch blocks with strings, booleans, env-variable values ($OS.UNIX),
+ * strings and arrays referencing env variables ($(VAR)), single and
+ * multi-line arrays and hidden targets ($HIDDEN : true).
+ *
+ * The architectures can be split in sections, each one with its own
+ * #macro and #set directives, like a platform file obtained by merging the
+ * files of multiple Connext DDS versions.
+ *
+ * The output is written while it is generated, so the size of the file is
+ * not limited by the available memory.
+ *
+ * Usage:
+ *      connext-config-gen-platform [--arches=N] [--keys=N] [--array-len=N]
+ *              [--string-len=N] [--hidden-every=N] [--multiline-every=N]
+ *              [--sections=N] [--output=FILE]
+ *
+ * The generator is also included by the scaling test: define
+ * SYNTHETIC_PLATFORM_NO_MAIN to leave out its main.
+ * ---------------------------------------------------------------------------
+ */
+
+#ifndef SYNTHETIC_PLATFORM_NO_MAIN
+/* Rename the main of connext-config, this file provides its own */
+#define main connextConfigMain
+#include "connext-config.c"
+#undef main
+#endif
+
+#define SYNTHETIC_DEFAULT_ARCHES            100
+#define SYNTHETIC_DEFAULT_ARRAY_LEN         4
+#define SYNTHETIC_DEFAULT_HIDDEN_EVERY      10
+#define SYNTHETIC_DEFAULT_MULTILINE_EVERY   3
+#define SYNTHETIC_DEFAULT_SECTIONS          1
+
+/* The keys required by readPlatformFile come first: --keys cannot be less
+ * than SYNTHETIC_REQUIRED_KEYS
+ */
+#define SYNTHETIC_REQUIRED_KEYS             4
+
+typedef enum {
+    SKT_String,
+    SKT_Array,
+    SKT_Boolean,
+    SKT_EnvVariable
+} SyntheticKeyType;
+
+struct SyntheticKey {
+    const char                  *name;
+    SyntheticKeyType            type;
+    const char                  *prefix;    /* Of the string or elements */
+};
+
+/* The keys of a real architecture, the additional keys (--keys) are
+ * "CUSTOM_KEY_<n>", alternating strings and arrays
+ */
+static const struct SyntheticKey SYNTHETIC_KEYS[] = {
+    { "$C_COMPILER",            SKT_String,         "$(SYNTH_TOOLS)/bin/gcc" },
+    { "$C_LINKER",              SKT_String,         "$(SYNTH_TOOLS)/bin/gcc" },
+    { "$CXX_COMPILER",          SKT_String,         "$(SYNTH_TOOLS)/bin/g++" },
+    { "$CXX_LINKER",            SKT_String,         "$(SYNTH_TOOLS)/bin/g++" },
+    { "$OS",                    SKT_EnvVariable,    "UNIX" },
+    { "$PLATFORM",              SKT_EnvVariable,    "x64" },
+    { "$C_COMPILER_FLAGS",      SKT_Array,          "I$(SYNTH_SDK)/include" },
+    { "$C_LINKER_FLAGS",        SKT_Array,          "Wl,--synth" },
+    { "$CXX_COMPILER_FLAGS",    SKT_Array,          "I$(SYNTH_SDK)/include" },
+    { "$CXX_LINKER_FLAGS",      SKT_Array,          "Wl,--synth" },
+    { "$SYSLIBS",               SKT_Array,          "lsynth" },
+    { "$DEFINES",               SKT_Array,          "DRTI_SYNTH" },
+    { "$INCLUDES",              SKT_Array,          "$(SYNTH_SDK)/include" },
+    { "$SUPPORTS_JAVA",         SKT_Boolean,        NULL },
+    { "$CPP03_COMPILER_FLAGS",  SKT_Array,          "pthread" },
+    { "$SUPPORTS_CPP03",        SKT_Boolean,        NULL },
+    { "$CPP11_COMPILER_FLAGS",  SKT_Array,          "std=c++14" },
+    { "$SUPPORTS_CPP11",        SKT_Boolean,        NULL },
+    { "\"TARGET_ID\"",          SKT_String,         "synth" },
+    { NULL,                     SKT_String,         NULL }
+};
+
+struct SyntheticPlatformParams {
+    int                         arches;
+    int                         keys;           /* Per arch, w/o $HIDDEN */
+    int                         arrayLen;
+    int                         stringLen;      /* 0 = natural length */
+    int                         hiddenEvery;    /* 0 = no hidden targets */
+    int                         multilineEvery; /* 0 = no multi-line arrays */
+    int                         sections;
+};
+
+/* {{{ SyntheticPlatformParams_init
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Initializes the parameters with the default values (all the keys of a
+ * real architecture)
+ */
+static void SyntheticPlatformParams_init(struct SyntheticPlatformParams *me) {
+    me->arches = SYNTHETIC_DEFAULT_ARCHES;
+    me->keys = (int)(sizeof(SYNTHETIC_KEYS) / sizeof(SYNTHETIC_KEYS[0])) - 1;
+    me->arrayLen = SYNTHETIC_DEFAULT_ARRAY_LEN;
+    me->stringLen = 0;
+    me->hiddenEvery = SYNTHETIC_DEFAULT_HIDDEN_EVERY;
+    me->multilineEvery = SYNTHETIC_DEFAULT_MULTILINE_EVERY;
+    me->sections = SYNTHETIC_DEFAULT_SECTIONS;
+}
+
+/* }}} */
+/* {{{ SyntheticPlatformParams_parseArg
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Parses one command line argument of the generator.
+ *
+ * \return          RTI_TRUE if the argument is one of the generator
+ *                  parameters, RTI_FALSE otherwise
+ */
+static RTIBool SyntheticPlatformParams_parseArg(
+        struct SyntheticPlatformParams *me,
+        const char *arg) {
+    const struct {
+        const char *name;
+        int *value;
+    } ARGS[] = {
+        { "--arches=",          &me->arches },
+        { "--keys=",            &me->keys },
+        { "--array-len=",       &me->arrayLen },
+        { "--string-len=",      &me->stringLen },
+        { "--hidden-every=",    &me->hiddenEvery },
+        { "--multiline-every=", &me->multilineEvery },
+        { "--sections=",        &me->sections },
+        { NULL,                 NULL }
+    };
+    int i;
+
+    for (i = 0; ARGS[i].name != NULL; ++i) {
+        size_t len = strlen(ARGS[i].name);
+        if (strncmp(arg, ARGS[i].name, len) == 0) {
+            *ARGS[i].value = atoi(arg + len);
+            return RTI_TRUE;
+        }
+    }
+    return RTI_FALSE;
+}
+
+/* }}} */
+/* {{{ SyntheticPlatformParams_validate
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Checks the parameters against the limits of the parser.
+ *
+ * \return          RTI_TRUE if valid, RTI_FALSE (error printed) otherwise
+ */
+static RTIBool SyntheticPlatformParams_validate(
+        const struct SyntheticPlatformParams *me) {
+    if (me->arches <= 0) {
+        fprintf(stderr, "Invalid number of arches: %d\n", me->arches);
+        return RTI_FALSE;
+    }
+    if (me->keys < SYNTHETIC_REQUIRED_KEYS) {
+        fprintf(stderr, "Invalid number of keys: %d (min %d)\n",
+                me->keys,
+                SYNTHETIC_REQUIRED_KEYS);
+        return RTI_FALSE;
+    }
+    if ((me->arrayLen < 0) || (me->arrayLen >= MAX_ARRAY_SIZE)) {
+        fprintf(stderr, "Invalid array length: %d (max %d)\n",
+                me->arrayLen,
+                MAX_ARRAY_SIZE-1);
+        return RTI_FALSE;
+    }
+    if ((me->stringLen < 0) || (me->stringLen >= MAX_STRING_SIZE)) {
+        fprintf(stderr, "Invalid string length: %d (max %d)\n",
+                me->stringLen,
+                MAX_STRING_SIZE-1);
+        return RTI_FALSE;
+    }
+    if ((me->hiddenEvery < 0) || (me->multilineEvery < 0) ||
+            (me->sections <= 0) || (me->sections > me->arches)) {
+        fprintf(stderr, "Invalid hidden, multi-line or section parameter\n");
+        return RTI_FALSE;
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ SyntheticPlatform_isHidden
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns RTI_TRUE if the given arch is generated with $HIDDEN : true
+ */
+static RTIBool SyntheticPlatform_isHidden(
+        const struct SyntheticPlatformParams *me,
+        int arch) {
+    return ((me->hiddenEvery > 0) &&
+            ((arch % me->hiddenEvery) == me->hiddenEvery - 1)) ?
+        RTI_TRUE : RTI_FALSE;
+}
+
+/* }}} */
+/* {{{ SyntheticPlatform_visibleCount
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the number of arches that the parser is expected to keep
+ */
+static int SyntheticPlatform_visibleCount(
+        const struct SyntheticPlatformParams *me) {
+    if (me->hiddenEvery <= 0) {
+        return me->arches;
+    }
+    return me->arches - (me->arches / me->hiddenEvery);
+}
+
+/* }}} */
+/* {{{ SyntheticPlatform_targetName
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the target name of the given arch (as listed by --list-all).
+ * The odd arches are generated with a separate compiler string, like
+ *      #arch("x64Synth1Linux4","gcc7.3.0", {
+ * the even ones with an empty compiler string.
+ */
+static void SyntheticPlatform_targetName(
+        const struct SyntheticPlatformParams *me,
+        int arch,
+        char *bufOut,
+        size_t bufSize) {
+    snprintf(bufOut, bufSize, "x64Synth%dLinux4gcc%d.%d.0",
+            arch,
+            4 + (arch * me->sections / me->arches),
+            arch % 10);
+}
+
+/* }}} */
+/* {{{ SyntheticPlatform_writeValue
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes a quoted string made of the prefix and of a unique suffix, padded
+ * to the requested string length.
+ */
+static void SyntheticPlatform_writeValue(FILE *fp,
+        const struct SyntheticPlatformParams *me,
+        const char *prefix,
+        int arch,
+        int index) {
+    char value[MAX_STRING_SIZE];
+    int len;
+
+    len = snprintf(value, sizeof(value), "%s_%d_%d", prefix, arch, index);
+    if (len >= (int)sizeof(value)) {
+        len = (int)sizeof(value) - 1;
+    }
+    while (len < me->stringLen) {
+        value[len] = (char)('a' + ((arch + index + len) % 26));
+        ++len;
+    }
+    value[len] = '\0';
+    fprintf(fp, "\"%s\"", value);
+}
+
+/* }}} */
+/* {{{ SyntheticPlatform_writeArch
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void SyntheticPlatform_writeArch(FILE *fp,
+        const struct SyntheticPlatformParams *me,
+        int arch) {
+    char target[MAX_STRING_SIZE];
+    char *compiler;
+    int k;
+    int i;
+
+    SyntheticPlatform_targetName(me, arch, target, sizeof(target));
+    if (arch % 2) {
+        compiler = strstr(target, "gcc");
+        fprintf(fp, "#arch(\"%.*s\",\"%s\", {\n",
+                (int)(compiler - target),
+                target,
+                compiler);
+    } else {
+        fprintf(fp, "#arch(\"%s\",\"\", {\n", target);
+    }
+    if (SyntheticPlatform_isHidden(me, arch)) {
+        fprintf(fp, "    $HIDDEN : true,\n");
+    }
+
+    for (k = 0; k < me->keys; ++k) {
+        static const struct SyntheticKey CUSTOM_STRING = {
+            NULL, SKT_String, "custom"
+        };
+        static const struct SyntheticKey CUSTOM_ARRAY = {
+            NULL, SKT_Array, "custom"
+        };
+        const struct SyntheticKey *key;
+        RTIBool multiline;
+
+        if (k < (int)(sizeof(SYNTHETIC_KEYS) / sizeof(SYNTHETIC_KEYS[0])) - 1) {
+            key = &SYNTHETIC_KEYS[k];
+            fprintf(fp, "    %s : ", key->name);
+        } else {
+            key = (k % 2) ? &CUSTOM_ARRAY : &CUSTOM_STRING;
+            fprintf(fp, "    \"CUSTOM_KEY_%d\" : ", k);
+        }
+
+        switch(key->type) {
+            case SKT_String:
+                SyntheticPlatform_writeValue(fp, me, key->prefix, arch, k);
+                break;
+
+            case SKT_Boolean:
+                fprintf(fp, "%s", ((arch + k) % 4 == 3) ? "false" : "true");
+                break;
+
+            case SKT_EnvVariable:
+                fprintf(fp, "%s.%s", key->name, key->prefix);
+                break;
+
+            case SKT_Array:
+                multiline = ((me->multilineEvery > 0) &&
+                        ((arch + k) % me->multilineEvery == 0)) ?
+                    RTI_TRUE : RTI_FALSE;
+                fprintf(fp, "[");
+                for (i = 0; i < me->arrayLen; ++i) {
+                    if (i > 0) {
+                        fprintf(fp, multiline ? ",\n        " : ", ");
+                    }
+                    SyntheticPlatform_writeValue(fp,
+                            me,
+                            key->prefix,
+                            arch,
+                            i);
+                }
+                fprintf(fp, "]");
+                break;
+        }
+        /* Add a trailing comment to some of the lines */
+        fprintf(fp, (k % 7 == 6) ? ",    ## key %d\n" : ",\n", k);
+    }
+    fprintf(fp, "})\n\n");
+}
+
+/* }}} */
+/* {{{ SyntheticPlatform_write
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the synthetic platform file to the given stream.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if a write error occurred
+ */
+static RTIBool SyntheticPlatform_write(FILE *fp,
+        const struct SyntheticPlatformParams *me) {
+    int section = -1;
+    int i;
+
+    fprintf(fp,
+            "## Synthetic platform file generated by connext-config-gen-platform\n"
+            "## arches=%d keys=%d array-len=%d string-len=%d hidden-every=%d\n"
+            "## multiline-every=%d sections=%d\n",
+            me->arches,
+            me->keys,
+            me->arrayLen,
+            me->stringLen,
+            me->hiddenEvery,
+            me->multilineEvery,
+            me->sections);
+    for (i = 0; i < me->arches; ++i) {
+        if (i * me->sections / me->arches != section) {
+            /* Each section looks like the platform file of one release */
+            section = i * me->sections / me->arches;
+            fprintf(fp,
+                    "\n"
+                    "##########################################################\n"
+                    "## Section %d\n"
+                    "##########################################################\n"
+                    "#macro (arch $name $compiler $params)\n"
+                    "  #set($dummy = $params)\n"
+                    "#end\n"
+                    "\n"
+                    "#set($OS = 'os')\n"
+                    "#set($PLATFORM = 'platform')\n"
+                    "\n",
+                    section);
+        }
+        SyntheticPlatform_writeArch(fp, me, i);
+        if (ferror(fp)) {
+            return RTI_FALSE;
+        }
+    }
+    return (fflush(fp) == 0) ? RTI_TRUE : RTI_FALSE;
+}
+
+/* }}} */
+
+#ifndef SYNTHETIC_PLATFORM_NO_MAIN
+/* {{{ genPlatformUsage
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void genPlatformUsage(const char *argv0) {
+    printf("Usage: %s [options]\n", argv0);
+    printf("Options:\n");
+    printf("    --arches=N          number of arches (default: %d)\n",
+            SYNTHETIC_DEFAULT_ARCHES);
+    printf("    --keys=N            keys per arch, %d to %d are the keys of a real\n",
+            SYNTHETIC_REQUIRED_KEYS,
+            (int)(sizeof(SYNTHETIC_KEYS) / sizeof(SYNTHETIC_KEYS[0])) - 1);
+    printf("                        arch, more are custom keys (default: %d)\n",
+            (int)(sizeof(SYNTHETIC_KEYS) / sizeof(SYNTHETIC_KEYS[0])) - 1);
+    printf("    --array-len=N       elements of the arrays (default: %d, max %d)\n",
+            SYNTHETIC_DEFAULT_ARRAY_LEN,
+            MAX_ARRAY_SIZE-1);
+    printf("    --string-len=N      min length of strings and elements (max %d)\n",
+            MAX_STRING_SIZE-1);
+    printf("    --hidden-every=N    every N-th arch is hidden (default: %d, 0=none)\n",
+            SYNTHETIC_DEFAULT_HIDDEN_EVERY);
+    printf("    --multiline-every=N every N-th array spans multiple lines (default: %d)\n",
+            SYNTHETIC_DEFAULT_MULTILINE_EVERY);
+    printf("    --sections=N        number of merged sections (default: %d)\n",
+            SYNTHETIC_DEFAULT_SECTIONS);
+    printf("    --output=FILE       output file (default: stdout)\n");
+}
+
+/* }}} */
+/* {{{ main
+ * -----------------------------------------------------------------------------
+ */
+int main(int argc, char **argv) {
+    struct SyntheticPlatformParams params;
+    const char *outputFile = NULL;
+    FILE *fp = stdout;
+    int retCode = 1;
+    int i;
+
+    SyntheticPlatformParams_init(&params);
+    for (i = 1; i < argc; ++i) {
+        if (SyntheticPlatformParams_parseArg(&params, argv[i])) {
+            continue;
+        }
+        if (strncmp(argv[i], "--output=", 9) == 0) {
+            outputFile = argv[i]+9;
+        } else if ((strcmp(argv[i], "-h") == 0) ||
+                (strcmp(argv[i], "--help") == 0)) {
+            genPlatformUsage(argv[0]);
+            return 0;
+        } else {
+            fprintf(stderr, "Invalid argument: %s\n", argv[i]);
+            genPlatformUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (!SyntheticPlatformParams_validate(&params)) {
+        return 1;
+    }
+
+    if (outputFile != NULL) {
+        fp = fopen(outputFile, "w");
+        if (fp == NULL) {
+            fprintf(stderr, "Cannot open '%s': %s\n",
+                    outputFile,
+                    strerror(errno));
+            return 1;
+        }
+    }
+    setvbuf(fp, NULL, _IOFBF, 1 << 16);
+    if (!SyntheticPlatform_write(fp, &params)) {
+        fprintf(stderr, "Failed to write the platform file: %s\n",
+                strerror(errno));
+        goto done;
+    }
+    retCode = 0;
+
+done:
+    if (outputFile != NULL) {
+        if (fclose(fp) != 0) {
+            retCode = 1;
+        } else if (retCode == 0) {
+            printf("Wrote %d arches (%d visible) to %s\n",
+                    params.arches,
+                    SyntheticPlatform_visibleCount(&params),
+                    outputFile);
+        }
+    }
+    return retCode;
+}
+/* }}} */
+#endif
@@ -0,0 +1,636 @@
+/*****************************************************************************
+ * Copyright (c) 2020 Real-Time Innovations, Inc.  All rights reserved.      *
+ *                                                                           *
+ * Permission to modify and use for internal purposes granted.               *
+ * This software is provided "as is", without warranty, express or implied.  *
+ *****************************************************************************/
+
+/*
+ * Golden regression test of connext-config.
+ *
+ * Generates in-process the same report produced by dump-all.sh (list of
+ * the architectures, internal table dump, all the operations with all the
+ * modifiers for every target) and compares it line by line with the
+ * compressed reference of the Connext DDS version in use.
+ *
+ * The test includes the source of connext-config directly, like the
+ * microbenchmarks, so no process is spawned.
+ *
+ * Usage:
+ *      connext-config-golden [--nddshome=DIR] [--reference=FILE]
+ *              [--reference-nddshome=DIR] [--output=FILE]
+ *
+ * --nddshome           the Connext DDS installation providing the platform
+ *                      file (default: $NDDSHOME)
+ * --reference          the compressed reference (default:
+ *                      $CONNEXT_CONFIG_GOLDEN_DIR/reference-<version>.txt.gz
+ *                      where <version> is the version of the installation
+ *                      without the dots, i.e. 601)
+ * --reference-nddshome the NDDSHOME used to generate the reference, that
+ *                      appears in the expanded outputs (default:
+ *                      GOLDEN_REFERENCE_HOME_PREFIX<version>)
+ * --output             also write the generated report to the given file
+ *
+ * Exit code is 0 if the report matches, 1 if it differs, 77 (skipped by
+ * automake) if there is no reference for the installation and 99 if an
+ * error occurred.
+ * ---------------------------------------------------------------------------
+ */
+
+/* The internal table dump is available only in debug builds */
+#undef NDEBUG
+
+/* Rename the main of connext-config, this file provides its own */
+#define main connextConfigMain
+#include "connext-config.c"
+#undef main
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#define GOLDEN_EXIT_PASS                0
+#define GOLDEN_EXIT_FAIL                1
+#define GOLDEN_EXIT_SKIP                77
+#define GOLDEN_EXIT_ERROR               99
+
+/* The references were generated from an installation in this directory,
+ * followed by the version (i.e. 'rti_connext_dds-6.0.1')
+ */
+#define GOLDEN_REFERENCE_HOME_PREFIX    "/home/fabrizio/rti/working/rti_connext_dds-"
+
+/* The env variable with the directory of the references */
+#define GOLDEN_DIR_ENV_VARIABLE         "CONNEXT_CONFIG_GOLDEN_DIR"
+
+/* Lines of context printed around the first mismatch */
+#define GOLDEN_CONTEXT_LINES            3
+
+#define GOLDEN_SEPARATOR \
+    "---------------------------------------------------------------------"
+
+/* The operations and modifiers of dump-all.sh */
+static const char * const GOLDEN_OPERATIONS[] = {
+    "--ccomp",
+    "--clink",
+    "--cxxcomp",
+    "--cxxlink",
+    "--cflags",
+    "--cxxflags",
+    "--ldflags",
+    "--ldxxflags",
+    "--ldlibs",
+    "--ldxxlibs",
+    "--os",
+    "--platform",
+    NULL
+};
+
+struct GoldenModifier {
+    const char                  *label;
+    RTIBool                     isStatic;
+    RTIBool                     isDebug;
+    RTIBool                     expandEnvVar;
+    RTIBool                     shell;
+};
+
+/* Applied to every operation */
+static const struct GoldenModifier GOLDEN_OPERATION_MODIFIERS[] = {
+    { "",                   RTI_FALSE,  RTI_FALSE,  RTI_TRUE,   RTI_FALSE },
+    { " (ne)",              RTI_FALSE,  RTI_FALSE,  RTI_FALSE,  RTI_FALSE },
+    { " (ne)",              RTI_FALSE,  RTI_FALSE,  RTI_FALSE,  RTI_TRUE },
+    { NULL,                 RTI_FALSE,  RTI_FALSE,  RTI_FALSE,  RTI_FALSE }
+};
+
+/* Applied to --ldlibs only, after all the operations */
+static const struct GoldenModifier GOLDEN_LDLIBS_MODIFIERS[] = {
+    { " (debug)",           RTI_FALSE,  RTI_TRUE,   RTI_FALSE,  RTI_FALSE },
+    { " (static)",          RTI_TRUE,   RTI_FALSE,  RTI_FALSE,  RTI_FALSE },
+    { " (static,debug)",    RTI_TRUE,   RTI_TRUE,   RTI_FALSE,  RTI_FALSE },
+    { NULL,                 RTI_FALSE,  RTI_FALSE,  RTI_FALSE,  RTI_FALSE }
+};
+
+/***************************************************************************
+ * Report
+ **************************************************************************/
+/* {{{ nowNs
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static unsigned long long nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL +
+            (unsigned long long)ts.tv_nsec;
+}
+
+/* }}} */
+/* {{{ writeComposed
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes one line of the report with the output of the given operation,
+ * like dump-all.sh does with the output of the command (the trailing
+ * newlines are removed, undefined properties produce an empty output).
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if the composition failed
+ */
+static RTIBool writeComposed(FILE *fp,
+        struct Architecture *arch,
+        const char *NDDSHOME,
+        const char *op,
+        const struct GoldenModifier *mod,
+        struct ComposeContext *ctx,
+        char *buf) {
+    size_t len;
+
+    ComposeContext_init(ctx,
+            NDDSHOME,
+            arch->target,
+            mod->isStatic,
+            mod->isDebug,
+            RTI_FALSE,
+            mod->expandEnvVar,
+            mod->shell);
+    switch(composeOperation(arch, op, ctx, buf, MAX_CMDLINEARG_SIZE+1)) {
+        case ComposeResult_Ok:
+            break;
+        case ComposeResult_NotDefined:
+            buf[0] = '\0';
+            break;
+        default:
+            fprintf(stderr, "Failed operation %s%s on target %s\n",
+                    op,
+                    mod->label,
+                    arch->target);
+            return RTI_FALSE;
+    }
+    len = strlen(buf);
+    while ((len > 0) && (buf[len-1] == '\n')) {
+        buf[--len] = '\0';
+    }
+    fprintf(fp, "\t%s%s = %s\n", op, mod->label, buf);
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ writeReport
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the full report of dump-all.sh to the given stream.
+ *
+ * \param fp        The output stream
+ * \param archDef   The parsed platform file
+ * \param NDDSHOME  The NDDSHOME used for the expanded outputs
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+static RTIBool writeReport(FILE *fp,
+        struct REDAInlineList *archDef,
+        const char *NDDSHOME) {
+    struct REDAInlineListNode *node;
+    struct ComposeContext *ctx;
+    char *buf;
+    RTIBool ok = RTI_FALSE;
+    int i;
+    int j;
+
+    ctx = malloc(sizeof(*ctx));
+    buf = malloc(MAX_CMDLINEARG_SIZE+1);
+    if ((ctx == NULL) || (buf == NULL)) {
+        fprintf(stderr, "Out of memory allocating the composition buffers\n");
+        goto done;
+    }
+
+    fprintf(fp, "%s\nAll Architectures:\n%s\n",
+            GOLDEN_SEPARATOR,
+            GOLDEN_SEPARATOR);
+    for (node = REDAInlineList_getFirst(archDef);
+            node != NULL;
+            node = REDAInlineListNode_getNext(node)) {
+        fprintf(fp, "%s\n", ((struct Architecture *)node)->target);
+    }
+    fprintf(fp, "\n%s\nInternal Table Dump\n%s\n",
+            GOLDEN_SEPARATOR,
+            GOLDEN_SEPARATOR);
+    dumpArch(fp, archDef);
+    fprintf(fp, "\n");
+
+    for (node = REDAInlineList_getFirst(archDef);
+            node != NULL;
+            node = REDAInlineListNode_getNext(node)) {
+        struct Architecture *arch = (struct Architecture *)node;
+
+        fprintf(fp, "%s\n%s:\n", GOLDEN_SEPARATOR, arch->target);
+        for (i = 0; GOLDEN_OPERATIONS[i] != NULL; ++i) {
+            for (j = 0; GOLDEN_OPERATION_MODIFIERS[j].label != NULL; ++j) {
+                if (!writeComposed(fp,
+                            arch,
+                            NDDSHOME,
+                            GOLDEN_OPERATIONS[i],
+                            &GOLDEN_OPERATION_MODIFIERS[j],
+                            ctx,
+                            buf)) {
+                    goto done;
+                }
+            }
+        }
+        for (j = 0; GOLDEN_LDLIBS_MODIFIERS[j].label != NULL; ++j) {
+            if (!writeComposed(fp,
+                        arch,
+                        NDDSHOME,
+                        "--ldlibs",
+                        &GOLDEN_LDLIBS_MODIFIERS[j],
+                        ctx,
+                        buf)) {
+                goto done;
+            }
+        }
+        fprintf(fp, "\n");
+    }
+    ok = RTI_TRUE;
+
+done:
+    free(ctx);
+    free(buf);
+    return ok;
+}
+
+/* }}} */
+
+/***************************************************************************
+ * Reference
+ **************************************************************************/
+/* Reads the lines of the compressed reference: with zlib if available,
+ * otherwise through 'gzip -dc'
+ */
+struct Reference {
+#ifdef HAVE_ZLIB
+    gzFile                      gz;
+#else
+    FILE                        *pipe;
+#endif
+    char                        *line;
+    size_t                      lineSize;
+};
+
+/* {{{ Reference_open
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static RTIBool Reference_open(struct Reference *me, const char *path) {
+    memset(me, 0, sizeof(*me));
+#ifdef HAVE_ZLIB
+    me->gz = gzopen(path, "rb");
+    if (me->gz == NULL) {
+        fprintf(stderr, "Failed to open reference '%s'\n", path);
+        return RTI_FALSE;
+    }
+    gzbuffer(me->gz, 1 << 16);
+#else
+    {
+        char cmd[PATH_MAX+32];
+        snprintf(cmd, sizeof(cmd), "gzip -dc '%s'", path);
+        me->pipe = popen(cmd, "r");
+        if (me->pipe == NULL) {
+            fprintf(stderr, "Failed to run '%s': %s\n", cmd, strerror(errno));
+            return RTI_FALSE;
+        }
+    }
+#endif
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ Reference_readLine
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Reads the next line of the reference, without the newline.
+ *
+ * \return          the line (valid until the next call), or NULL at the
+ *                  end of the reference
+ */
+static const char *Reference_readLine(struct Reference *me) {
+    size_t len;
+#ifdef HAVE_ZLIB
+    len = 0;
+    for (;;) {
+        if (me->lineSize - len < 2) {
+            size_t newSize = (me->lineSize == 0) ? 4096 : me->lineSize * 2;
+            char *tmp = realloc(me->line, newSize);
+            if (tmp == NULL) {
+                fprintf(stderr, "Out of memory reading the reference\n");
+                return NULL;
+            }
+            me->line = tmp;
+            me->lineSize = newSize;
+        }
+        if (gzgets(me->gz, me->line + len, (int)(me->lineSize - len)) == NULL) {
+            if (len == 0) {
+                return NULL;
+            }
+            break;
+        }
+        len += strlen(me->line + len);
+        if (me->line[len-1] == '\n') {
+            break;
+        }
+    }
+#else
+    ssize_t rd = getline(&me->line, &me->lineSize, me->pipe);
+    if (rd <= 0) {
+        return NULL;
+    }
+    len = (size_t)rd;
+#endif
+    if ((len > 0) && (me->line[len-1] == '\n')) {
+        me->line[len-1] = '\0';
+    }
+    return me->line;
+}
+
+/* }}} */
+/* {{{ Reference_close
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void Reference_close(struct Reference *me) {
+#ifdef HAVE_ZLIB
+    if (me->gz != NULL) {
+        gzclose(me->gz);
+    }
+#else
+    if (me->pipe != NULL) {
+        pclose(me->pipe);
+    }
+#endif
+    free(me->line);
+}
+
+/* }}} */
+
+/***************************************************************************
+ * Comparison
+ **************************************************************************/
+/* {{{ nextReportLine
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Splits in place the next line of the report.
+ *
+ * \return          the line, or NULL at the end of the report
+ */
+static char *nextReportLine(char **cursor) {
+    char *line = *cursor;
+    char *eol;
+
+    if (*line == '\0') {
+        return NULL;
+    }
+    eol = strchr(line, '\n');
+    if (eol == NULL) {
+        *cursor = line + strlen(line);
+    } else {
+        *eol = '\0';
+        *cursor = eol+1;
+    }
+    return line;
+}
+
+/* }}} */
+/* {{{ compareReport
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Compares the report line by line with the reference and prints the first
+ * mismatch with some context.
+ *
+ * \param report        the report (modified to split the lines)
+ * \param ref           the opened reference
+ * \param lineCountOut  the number of lines compared
+ * \return              GOLDEN_EXIT_PASS or GOLDEN_EXIT_FAIL
+ */
+static int compareReport(char *report,
+        struct Reference *ref,
+        unsigned int *lineCountOut) {
+    const char *before[GOLDEN_CONTEXT_LINES];
+    char *cursor = report;
+    const char *actual;
+    const char *expected;
+    unsigned int lineNo = 0;
+    unsigned int i;
+
+    for (;;) {
+        actual = nextReportLine(&cursor);
+        expected = Reference_readLine(ref);
+        if ((actual == NULL) && (expected == NULL)) {
+            *lineCountOut = lineNo;
+            return GOLDEN_EXIT_PASS;
+        }
+        ++lineNo;
+        if ((actual == NULL) || (expected == NULL) ||
+                (strcmp(actual, expected) != 0)) {
+            break;
+        }
+        before[(lineNo-1) % GOLDEN_CONTEXT_LINES] = actual;
+    }
+
+    /* Mismatch: the lines before are the same in both */
+    fprintf(stderr, "Mismatch at line %u:\n", lineNo);
+    i = (lineNo > GOLDEN_CONTEXT_LINES) ? lineNo - GOLDEN_CONTEXT_LINES : 1;
+    for (; i < lineNo; ++i) {
+        fprintf(stderr, "  %6u  %s\n", i, before[(i-1) % GOLDEN_CONTEXT_LINES]);
+    }
+    if (expected == NULL) {
+        fprintf(stderr, "- %6u  <end of reference>\n", lineNo);
+    } else {
+        fprintf(stderr, "- %6u  %s\n", lineNo, expected);
+        for (i = 1; i < GOLDEN_CONTEXT_LINES; ++i) {
+            if ((expected = Reference_readLine(ref)) == NULL) {
+                break;
+            }
+            fprintf(stderr, "- %6u  %s\n", lineNo+i, expected);
+        }
+    }
+    if (actual == NULL) {
+        fprintf(stderr, "+ %6u  <end of report>\n", lineNo);
+    } else {
+        fprintf(stderr, "+ %6u  %s\n", lineNo, actual);
+        for (i = 1; i < GOLDEN_CONTEXT_LINES; ++i) {
+            if ((actual = nextReportLine(&cursor)) == NULL) {
+                break;
+            }
+            fprintf(stderr, "+ %6u  %s\n", lineNo+i, actual);
+        }
+    }
+    return GOLDEN_EXIT_FAIL;
+}
+
+/* }}} */
+/* {{{ clearEnvironment
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Removes all the environment variables: the references are generated
+ * without the variables used in the platform file (i.e. $(WIND_BASE)).
+ */
+static void clearEnvironment(void) {
+    extern char **environ;
+    char name[MAX_STRING_SIZE];
+    const char *eq;
+
+    while ((environ != NULL) && (environ[0] != NULL)) {
+        eq = strchr(environ[0], '=');
+        if ((eq == NULL) || ((size_t)(eq - environ[0]) >= sizeof(name))) {
+            /* Cannot be removed by name */
+            environ[0] = NULL;
+            break;
+        }
+        memcpy(name, environ[0], (size_t)(eq - environ[0]));
+        name[eq - environ[0]] = '\0';
+        unsetenv(name);
+    }
+}
+
+/* }}} */
+/* {{{ goldenUsage
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void goldenUsage(const char *argv0) {
+    printf("Usage: %s [--nddshome=DIR] [--reference=FILE]\n", argv0);
+    printf("        [--reference-nddshome=DIR] [--output=FILE]\n");
+    printf("Compares the output of all the operations of all the targets\n");
+    printf("with the reference of the Connext DDS version in use.\n");
+}
+
+/* }}} */
+/* {{{ main
+ * -----------------------------------------------------------------------------
+ */
+int main(int argc, char **argv) {
+    const char *nddsHome = getenv("NDDSHOME");
+    const char *goldenDir = getenv(GOLDEN_DIR_ENV_VARIABLE);
+    const char *reference = NULL;
+    const char *referenceHome = NULL;
+    const char *outputFile = NULL;
+    char version[MAX_STRING_SIZE];
+    char versionDigits[MAX_STRING_SIZE];
+    char referencePath[PATH_MAX+1];
+    char referenceHomeBuf[PATH_MAX+1];
+    char platformFile[PATH_MAX+1];
+    struct REDAInlineList archDef;
+    struct PlatformFileInfo platformInfo;
+    struct Reference ref;
+    RTIBool refOpened = RTI_FALSE;
+    char *report = NULL;
+    size_t reportLen = 0;
+    FILE *fp;
+    unsigned long long start;
+    unsigned int lineCount = 0;
+    int retCode = GOLDEN_EXIT_ERROR;
+    int i;
+    int j;
+
+    start = nowNs();
+    REDAInlineList_init(&archDef);
+    for (i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--nddshome=", 11) == 0) {
+            nddsHome = argv[i]+11;
+        } else if (strncmp(argv[i], "--reference=", 12) == 0) {
+            reference = argv[i]+12;
+        } else if (strncmp(argv[i], "--reference-nddshome=", 21) == 0) {
+            referenceHome = argv[i]+21;
+        } else if (strncmp(argv[i], "--output=", 9) == 0) {
+            outputFile = argv[i]+9;
+        } else if ((strcmp(argv[i], "-h") == 0) ||
+                (strcmp(argv[i], "--help") == 0)) {
+            goldenUsage(argv[0]);
+            return GOLDEN_EXIT_PASS;
+        } else {
+            fprintf(stderr, "Invalid argument: %s\n", argv[i]);
+            goldenUsage(argv[0]);
+            return GOLDEN_EXIT_ERROR;
+        }
+    }
+    if (nddsHome == NULL) {
+        fprintf(stderr, "NDDSHOME not defined (use --nddshome)\n");
+        return GOLDEN_EXIT_ERROR;
+    }
+
+    /* The reference and its NDDSHOME depend on the version */
+    getConnextVersion(nddsHome, version, sizeof(version));
+    for (i = 0, j = 0; version[i] != '\0'; ++i) {
+        if (isdigit((unsigned char)version[i])) {
+            versionDigits[j++] = version[i];
+        }
+    }
+    versionDigits[j] = '\0';
+    if (reference == NULL) {
+        snprintf(referencePath, sizeof(referencePath),
+                "%s/reference-%s.txt.gz",
+                (goldenDir != NULL) ? goldenDir : ".",
+                versionDigits);
+        reference = referencePath;
+    }
+    if (access(reference, R_OK) != 0) {
+        printf("SKIP: no reference '%s' for Connext DDS %s\n",
+                reference,
+                version);
+        return GOLDEN_EXIT_SKIP;
+    }
+    if (referenceHome == NULL) {
+        snprintf(referenceHomeBuf, sizeof(referenceHomeBuf),
+                "%s%s",
+                GOLDEN_REFERENCE_HOME_PREFIX,
+                version);
+        referenceHome = referenceHomeBuf;
+    }
+    snprintf(platformFile, sizeof(platformFile),
+            "%s/%s",
+            nddsHome,
+            NDDS_PLATFORM_FILE);
+
+    /* All the variables are read: clear them before the expansion */
+    clearEnvironment();
+
+    if (!readPlatformFile(platformFile, &archDef, &platformInfo) ||
+            (REDAInlineList_getFirst(&archDef) == NULL)) {
+        fprintf(stderr, "Failed to parse platform file '%s'\n", platformFile);
+        goto done;
+    }
+
+    fp = open_memstream(&report, &reportLen);
+    if (fp == NULL) {
+        fprintf(stderr, "Failed to create the report stream: %s\n",
+                strerror(errno));
+        goto done;
+    }
+    if (!writeReport(fp, &archDef, referenceHome)) {
+        fclose(fp);
+        goto done;
+    }
+    if (fclose(fp) != 0) {
+        fprintf(stderr, "Failed to write the report\n");
+        goto done;
+    }
+    if ((outputFile != NULL) &&
+            !writeFileIfChanged(outputFile, report, reportLen, NULL)) {
+        goto done;
+    }
+
+    if (!Reference_open(&ref, reference)) {
+        goto done;
+    }
+    refOpened = RTI_TRUE;
+    retCode = compareReport(report, &ref, &lineCount);
+    if (retCode == GOLDEN_EXIT_PASS) {
+        printf("PASS: %u lines match %s (%.1f ms)\n",
+                lineCount,
+                reference,
+                (double)(nowNs() - start) / 1e6);
+    } else {
+        printf("FAIL: report differs from %s\n", reference);
+    }
+
+done:
+    if (refOpened) {
+        Reference_close(&ref);
+    }
+    free(report);
+    {
+        struct REDAInlineListNode *next;
+        struct REDAInlineListNode *node = REDAInlineList_getFirst(&archDef);
+        while (node != NULL) {
+            next = REDAInlineListNode_getNext(node);
+            Architecture_delete((struct Architecture *)node);
+            node = next;
+        }
+    }
+    return retCode;
+}
+/* }}} */
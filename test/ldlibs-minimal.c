@@ -0,0 +1,688 @@
+/*****************************************************************************
+ * Copyright (c) 2020 Real-Time Innovations, Inc.  All rights reserved.      *
+ *                                                                           *
+ * Permission to modify and use for internal purposes granted.               *
+ * This software is provided "as is", without warranty, express or implied.  *
+ *****************************************************************************/
+
+/*
+ * Test of --ldlibs-minimal and of its ELF symbol table reader, and of the
+ * absolute paths of --ldlibs-abs.
+ *
+ * Builds in a temporary directory a synthetic installation: a platform
+ * file with two targets, the libraries of the targets and a directory of
+ * system libraries. The objects and the libraries are ELF files written
+ * by the test itself (32 and 64 bits, both byte orders, relocatable
+ * objects, shared libraries, archives with long member names and a GNU ld
+ * script), so no toolchain is required. Then it checks the libraries
+ * composed for several sets of objects:
+ *  - only the used libraries of the variant are listed, in link order;
+ *  - a cycle between the libraries is linked as a group;
+ *  - the system libraries are dropped if they do not define a symbol
+ *    still undefined, and kept if they cannot be found;
+ *  - an invalid object is an error.
+ *
+ * The absolute paths of --ldlibs-abs are checked on the same installation
+ * (and on a sysroot): the libraries of the variant are replaced by their
+ * files, a missing variant is an error.
+ *
+ * The test includes the source of connext-config directly, like the
+ * golden test.
+ *
+ * Usage:
+ *      connext-config-ldlibs-minimal [--keep]
+ *
+ * --keep               do not remove the temporary directory
+ *
+ * Exit code is 0 if all the cases pass, 1 if one fails and 99 if an error
+ * occurred.
+ * ---------------------------------------------------------------------------
+ */
+
+/* Rename the main of connext-config, this file provides its own */
+#define main connextConfigMain
+#include "connext-config.c"
+#undef main
+
+#include "testutil.h"
+
+#define LDMIN_EXIT_PASS                 0
+#define LDMIN_EXIT_FAIL                 1
+#define LDMIN_EXIT_ERROR                99
+
+#define LDMIN_MAX_FILE_SIZE             4096
+#define LDMIN_MAX_ARCHIVE_SIZE          16384
+
+/* A symbol of a synthetic ELF file: 'D' defined, 'U' undefined, 'W' weak
+ * undefined
+ */
+struct TestSymbol {
+    const char                  *name;
+    char                        kind;
+};
+
+/* The format of a synthetic ELF file */
+struct TestElfFormat {
+    RTIBool                     is64;
+    RTIBool                     msb;
+    RTIBool                     shared;
+};
+
+static const struct TestElfFormat ELF64_LSB = { RTI_TRUE, RTI_FALSE, RTI_FALSE };
+static const struct TestElfFormat ELF64_MSB = { RTI_TRUE, RTI_TRUE, RTI_FALSE };
+static const struct TestElfFormat ELF32_LSB = { RTI_FALSE, RTI_FALSE, RTI_FALSE };
+static const struct TestElfFormat ELF32_MSB = { RTI_FALSE, RTI_TRUE, RTI_FALSE };
+static const struct TestElfFormat ELF64_LSB_SHARED = { RTI_TRUE, RTI_FALSE, RTI_TRUE };
+static const struct TestElfFormat ELF32_MSB_SHARED = { RTI_FALSE, RTI_TRUE, RTI_TRUE };
+
+/* A member of a synthetic archive */
+struct TestMember {
+    const char                  *name;
+    const struct TestElfFormat  *format;
+    const struct TestSymbol     *symbols;   /* Terminated by a NULL name */
+};
+
+/* {{{ putValue
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes an unsigned integer of the given size in the given byte order
+ */
+static void putValue(unsigned char *buf,
+        size_t offset,
+        unsigned long long value,
+        int bytes,
+        RTIBool msb) {
+    int i;
+    for (i = 0; i < bytes; ++i) {
+        int shift = msb ? (bytes-1-i)*8 : i*8;
+        buf[offset+i] = (unsigned char)(value >> shift);
+    }
+}
+
+/* }}} */
+/* {{{ buildElf
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Builds an ELF file with the given symbols: the header, the string table,
+ * the symbol table (the dynamic one for a shared library) and the headers
+ * of the three sections (null, symbols, strings).
+ *
+ * \return          the size of the file, 0 if it does not fit in buf
+ */
+static size_t buildElf(unsigned char *buf,
+        size_t bufSize,
+        const struct TestElfFormat *format,
+        const struct TestSymbol *symbols) {
+    const RTIBool msb = format->msb;
+    const size_t headerSize = format->is64 ? 64 : 52;
+    const size_t symSize = format->is64 ? 24 : 16;
+    const size_t sectionSize = format->is64 ? 64 : 40;
+    size_t strOffset = headerSize;
+    size_t strSize = 1;
+    size_t symOffset;
+    size_t sectionOffset;
+    size_t total;
+    size_t nameOffset = 1;
+    int count = 0;
+    int i;
+
+    for (i = 0; symbols[i].name != NULL; ++i) {
+        strSize += strlen(symbols[i].name) + 1;
+        ++count;
+    }
+    symOffset = (strOffset + strSize + 7) & ~(size_t)7;
+    sectionOffset = (symOffset + (count+1)*symSize + 7) & ~(size_t)7;
+    total = sectionOffset + 3*sectionSize;
+    if (total > bufSize) {
+        return 0;
+    }
+    memset(buf, 0, total);
+
+    /* Header */
+    memcpy(buf, "\177ELF", 4);
+    buf[4] = format->is64 ? ELF_CLASS_64 : ELF_CLASS_32;
+    buf[5] = msb ? ELF_DATA_MSB : ELF_DATA_LSB;
+    buf[6] = 1;
+    putValue(buf, 16, format->shared ? ELF_TYPE_DYN : ELF_TYPE_REL, 2, msb);
+    putValue(buf, 18, format->is64 ? 62 : 3, 2, msb);
+    putValue(buf, 20, 1, 4, msb);
+    if (format->is64) {
+        putValue(buf, 0x28, sectionOffset, 8, msb);
+        putValue(buf, 0x34, headerSize, 2, msb);
+        putValue(buf, 0x3A, sectionSize, 2, msb);
+        putValue(buf, 0x3C, 3, 2, msb);
+    } else {
+        putValue(buf, 0x20, sectionOffset, 4, msb);
+        putValue(buf, 0x28, headerSize, 2, msb);
+        putValue(buf, 0x2E, sectionSize, 2, msb);
+        putValue(buf, 0x30, 3, 2, msb);
+    }
+
+    /* Strings and symbols (the first symbol is the null one) */
+    for (i = 0; i < count; ++i) {
+        size_t sym = symOffset + (i+1)*symSize;
+        unsigned int bind = (symbols[i].kind == 'W') ?
+                ELF_BIND_WEAK : ELF_BIND_GLOBAL;
+        unsigned int info = (bind << 4) | 2;    /* Function */
+        unsigned int sectionIndex = (symbols[i].kind == 'D') ? 0xfff1 : 0;
+
+        strcpy((char *)buf + strOffset + nameOffset, symbols[i].name);
+        putValue(buf, sym, nameOffset, 4, msb);
+        if (format->is64) {
+            buf[sym + 4] = (unsigned char)info;
+            putValue(buf, sym + 6, sectionIndex, 2, msb);
+        } else {
+            buf[sym + 12] = (unsigned char)info;
+            putValue(buf, sym + 14, sectionIndex, 2, msb);
+        }
+        nameOffset += strlen(symbols[i].name) + 1;
+    }
+
+    /* Section headers: symbols (1), strings (2) */
+    if (format->is64) {
+        size_t sh = sectionOffset + sectionSize;
+        putValue(buf, sh + 4, format->shared ?
+                ELF_SECTION_DYNSYM : ELF_SECTION_SYMTAB, 4, msb);
+        putValue(buf, sh + 24, symOffset, 8, msb);
+        putValue(buf, sh + 32, (count+1)*symSize, 8, msb);
+        putValue(buf, sh + 40, 2, 4, msb);
+        putValue(buf, sh + 56, symSize, 8, msb);
+        sh += sectionSize;
+        putValue(buf, sh + 4, 3, 4, msb);
+        putValue(buf, sh + 24, strOffset, 8, msb);
+        putValue(buf, sh + 32, strSize, 8, msb);
+    } else {
+        size_t sh = sectionOffset + sectionSize;
+        putValue(buf, sh + 4, format->shared ?
+                ELF_SECTION_DYNSYM : ELF_SECTION_SYMTAB, 4, msb);
+        putValue(buf, sh + 16, symOffset, 4, msb);
+        putValue(buf, sh + 20, (count+1)*symSize, 4, msb);
+        putValue(buf, sh + 24, 2, 4, msb);
+        putValue(buf, sh + 36, symSize, 4, msb);
+        sh += sectionSize;
+        putValue(buf, sh + 4, 3, 4, msb);
+        putValue(buf, sh + 16, strOffset, 4, msb);
+        putValue(buf, sh + 20, strSize, 4, msb);
+    }
+    return total;
+}
+
+/* }}} */
+/* {{{ writeElf
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes an ELF object or shared library with the given symbols
+ */
+static RTIBool writeElf(const char *dir,
+        const char *name,
+        const struct TestElfFormat *format,
+        const struct TestSymbol *symbols) {
+    unsigned char buf[LDMIN_MAX_FILE_SIZE];
+    size_t size = buildElf(buf, sizeof(buf), format, symbols);
+    return (size > 0) && writeTestFile(dir, name, buf, size);
+}
+
+/* }}} */
+/* {{{ appendMember
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Appends a member (header and content, padded to 2 bytes) to an archive
+ *
+ * \return          the new size of the archive, 0 if it does not fit
+ */
+static size_t appendMember(unsigned char *buf,
+        size_t bufSize,
+        size_t len,
+        const char *name,
+        const void *data,
+        size_t size) {
+    char header[AR_HEADER_SIZE+1];
+
+    if (len + AR_HEADER_SIZE + size + 1 > bufSize) {
+        return 0;
+    }
+    snprintf(header, sizeof(header), "%-16s%-12s%-6s%-6s%-8s%-10lu`\n",
+            name, "0", "0", "0", "644", (unsigned long)size);
+    memcpy(buf + len, header, AR_HEADER_SIZE);
+    memcpy(buf + len + AR_HEADER_SIZE, data, size);
+    len += AR_HEADER_SIZE + size;
+    if (size & 1) {
+        buf[len++] = '\n';
+    }
+    return len;
+}
+
+/* }}} */
+/* {{{ writeArchive
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes an archive in the GNU format: an (empty) symbol index, the table
+ * of the long names and the members. memberCount can be 0.
+ */
+static RTIBool writeArchive(const char *dir,
+        const char *name,
+        const struct TestMember *members,
+        int memberCount) {
+    static unsigned char buf[LDMIN_MAX_ARCHIVE_SIZE];
+    unsigned char elf[LDMIN_MAX_FILE_SIZE];
+    char longNames[MAX_STRING_SIZE];
+    char memberName[MAX_STRING_SIZE];
+    const unsigned char emptyIndex[4] = { 0, 0, 0, 0 };
+    size_t longLen = 0;
+    size_t len = AR_MAGIC_SIZE;
+    size_t size;
+    int i;
+
+    memcpy(buf, AR_MAGIC, AR_MAGIC_SIZE);
+    if (memberCount == 0) {
+        return writeTestFile(dir, name, buf, len);
+    }
+    len = appendMember(buf, sizeof(buf), len, "/", emptyIndex, sizeof(emptyIndex));
+    longNames[0] = '\0';
+    for (i = 0; i < memberCount; ++i) {
+        if (strlen(members[i].name) > 15) {
+            longLen += snprintf(longNames + longLen,
+                    sizeof(longNames) - longLen,
+                    "%s/\n",
+                    members[i].name);
+        }
+    }
+    if (longLen > 0) {
+        len = appendMember(buf, sizeof(buf), len, "//", longNames, longLen);
+    }
+    longLen = 0;
+    for (i = 0; (len > 0) && (i < memberCount); ++i) {
+        if (strlen(members[i].name) > 15) {
+            snprintf(memberName, sizeof(memberName), "/%lu", (unsigned long)longLen);
+            longLen += strlen(members[i].name) + 2;
+        } else {
+            snprintf(memberName, sizeof(memberName), "%s/", members[i].name);
+        }
+        size = buildElf(elf, sizeof(elf), members[i].format, members[i].symbols);
+        if (size == 0) {
+            return RTI_FALSE;
+        }
+        len = appendMember(buf, sizeof(buf), len, memberName, elf, size);
+    }
+    return (len > 0) && writeTestFile(dir, name, buf, len);
+}
+
+/* }}} */
+/* {{{ Synthetic installation
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * The toolchain of the targets is not installed: the system libraries
+ * are searched only in the -L directories.
+ *
+ * Target T1 (static and shared libraries):
+ *      nddsc:          dds_create -> core_init
+ *      nddscore:       core_init -> sys_need, sys_script
+ *                      core_unused -> sys_unused (long member name)
+ *      rtimonitoring:  mon_start -> dds_create
+ *  system libraries (in the -L directory of $SYSLIBS):
+ *      dl (empty archive), need (archive), unused (shared), script (ld
+ *      script of a shared library), missing (not found)
+ *
+ * Target T2 (static libraries with a cycle):
+ *      nddsc:          dds_create -> core_init, c_callback
+ *      nddscore:       core_init -> c_callback
+ *
+ * Sysroot (root/usr/lib):
+ *      root (shared)
+ */
+static const struct TestSymbol C_SYMBOLS[] = {
+    { "dds_create", 'D' }, { "core_init", 'U' }, { NULL, 0 }
+};
+static const struct TestSymbol CORE_INIT_SYMBOLS[] = {
+    { "core_init", 'D' }, { "sys_need", 'U' }, { "sys_script", 'U' },
+    { NULL, 0 }
+};
+static const struct TestSymbol CORE_UNUSED_SYMBOLS[] = {
+    { "core_unused", 'D' }, { "sys_unused", 'U' }, { NULL, 0 }
+};
+static const struct TestSymbol CORE_SHARED_SYMBOLS[] = {
+    { "core_init", 'D' }, { "core_unused", 'D' }, { "sys_need", 'U' },
+    { NULL, 0 }
+};
+static const struct TestSymbol MON_SYMBOLS[] = {
+    { "mon_start", 'D' }, { "dds_create", 'U' }, { NULL, 0 }
+};
+static const struct TestSymbol NEED_SYMBOLS[] = {
+    { "sys_need", 'D' }, { NULL, 0 }
+};
+static const struct TestSymbol UNUSED_SYMBOLS[] = {
+    { "sys_unused", 'D' }, { NULL, 0 }
+};
+static const struct TestSymbol SCRIPT_SYMBOLS[] = {
+    { "sys_script", 'D' }, { NULL, 0 }
+};
+static const struct TestSymbol CYCLE_C_SYMBOLS[] = {
+    { "dds_create", 'D' }, { "c_callback", 'D' }, { "core_init", 'U' },
+    { NULL, 0 }
+};
+static const struct TestSymbol CYCLE_CORE_SYMBOLS[] = {
+    { "core_init", 'D' }, { "c_callback", 'U' }, { NULL, 0 }
+};
+static const struct TestSymbol APP_SYMBOLS[] = {
+    { "main", 'D' }, { "dds_create", 'U' }, { "mon_start", 'W' },
+    { "printf", 'U' }, { NULL, 0 }
+};
+static const struct TestSymbol MONAPP_SYMBOLS[] = {
+    { "use_monitoring", 'D' }, { "mon_start", 'U' }, { NULL, 0 }
+};
+
+/* }}} */
+/* {{{ createInstallation
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Creates the synthetic installation in dir
+ */
+static RTIBool createInstallation(const char *dir) {
+    static const char * const TARGETS[] = { "T1", "T2", NULL };
+    char t1[PATH_MAX+1];
+    char t2[PATH_MAX+1];
+    char sys[PATH_MAX+1];
+    char root[PATH_MAX+1];
+    char usr[PATH_MAX+1];
+    char rootLib[PATH_MAX+1];
+    char text[2*PATH_MAX];
+    const struct TestMember c[] = {
+        { "c.o", &ELF64_MSB, C_SYMBOLS }
+    };
+    const struct TestMember core[] = {
+        { "core_init.o", &ELF32_LSB, CORE_INIT_SYMBOLS },
+        { "core_with_a_long_member_name.o", &ELF64_LSB, CORE_UNUSED_SYMBOLS }
+    };
+    const struct TestMember mon[] = {
+        { "mon.o", &ELF32_MSB, MON_SYMBOLS }
+    };
+    const struct TestMember need[] = {
+        { "need.o", &ELF64_LSB, NEED_SYMBOLS }
+    };
+    const struct TestMember cycleC[] = {
+        { "c.o", &ELF64_LSB, CYCLE_C_SYMBOLS }
+    };
+    const struct TestMember cycleCore[] = {
+        { "core.o", &ELF64_LSB, CYCLE_CORE_SYMBOLS }
+    };
+    int len;
+
+    snprintf(t1, sizeof(t1), "%s/home/lib/T1", dir);
+    snprintf(t2, sizeof(t2), "%s/home/lib/T2", dir);
+    if (!makeDir(sys, dir, "sys") ||
+            !makeDir(root, dir, "root") ||
+            !makeDir(usr, root, "usr") ||
+            !makeDir(rootLib, usr, "lib")) {
+        return RTI_FALSE;
+    }
+    len = snprintf(text, sizeof(text),
+            "#arch(\"T1\",\"\", {\n"
+            "    $OS : $OS.UNIX,\n"
+            "    $C_COMPILER : \"/nonexistent/gcc\",\n"
+            "    $C_LINKER : \"/nonexistent/gcc\",\n"
+            "    $CXX_COMPILER : \"/nonexistent/g++\",\n"
+            "    $CXX_LINKER : \"/nonexistent/g++\",\n"
+            "    $SYSLIBS : [\"L%s\", \"ldl\", \"lneed\", \"lunused\", \"lscript\", "
+                    "\"lmissing\"],\n"
+            "})\n"
+            "\n"
+            "#arch(\"T2\",\"\", {\n"
+            "    $OS : $OS.UNIX,\n"
+            "    $C_COMPILER : \"/nonexistent/gcc\",\n"
+            "    $C_LINKER : \"/nonexistent/gcc\",\n"
+            "    $CXX_COMPILER : \"/nonexistent/g++\",\n"
+            "    $CXX_LINKER : \"/nonexistent/g++\",\n"
+            "    $SYSLIBS : [\"lmissing\"],\n"
+            "})\n",
+            sys);
+    if ((len >= (int)sizeof(text)) ||
+            !createTestHome(dir, TARGETS, text) ||
+            !writeArchive(t1, "libnddscz.a", c, 1) ||
+            !writeArchive(t1, "libnddscorez.a", core, 2) ||
+            !writeArchive(t1, "librtimonitoringz.a", mon, 1) ||
+            !writeElf(t1, "libnddsc.so", &ELF32_MSB_SHARED, C_SYMBOLS) ||
+            !writeElf(t1, "libnddscore.so", &ELF64_LSB_SHARED, CORE_SHARED_SYMBOLS) ||
+            /* The debug libraries are not used by the release variant */
+            !writeElf(t1, "libnddscored.so", &ELF64_LSB_SHARED, CORE_SHARED_SYMBOLS) ||
+            !writeArchive(t2, "libnddscz.a", cycleC, 1) ||
+            !writeArchive(t2, "libnddscorez.a", cycleCore, 1) ||
+            !writeArchive(sys, "libdl.a", NULL, 0) ||
+            !writeArchive(sys, "libneed.a", need, 1) ||
+            !writeElf(sys, "libunused.so", &ELF64_LSB_SHARED, UNUSED_SYMBOLS) ||
+            !writeElf(sys, "libreal.so.1", &ELF64_LSB_SHARED, SCRIPT_SYMBOLS) ||
+            !writeElf(rootLib, "libroot.so", &ELF64_LSB_SHARED, NEED_SYMBOLS)) {
+        return RTI_FALSE;
+    }
+    len = snprintf(text, sizeof(text),
+            "/* GNU ld script */\n"
+            "OUTPUT_FORMAT(elf64-x86-64)\n"
+            "GROUP ( %s/libreal.so.1 )\n",
+            sys);
+    return writeTestFile(sys, "libscript.so", text, len) &&
+            writeElf(dir, "app.o", &ELF64_LSB, APP_SYMBOLS) &&
+            writeElf(dir, "monapp.o", &ELF32_LSB, MONAPP_SYMBOLS) &&
+            writeTestFile(dir, "truncated.o", "\177ELF\002\001\001", 7);
+}
+
+/* }}} */
+/* {{{ expandPaths
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Copies text to bufOut replacing %H, %S and %D with the installation, the
+ * directory of the system libraries and the temporary directory.
+ */
+static void expandPaths(const char *text,
+        const char *dir,
+        char *bufOut,
+        size_t bufSize) {
+    size_t len = 0;
+
+    bufOut[0] = '\0';
+    for (; *text != '\0'; ++text) {
+        if ((text[0] == '%') && (text[1] != '\0') && (strchr("HSD", text[1]) != NULL)) {
+            len += snprintf(bufOut + len,
+                    bufSize - len,
+                    (text[1] == 'H') ? "%s/home" : (text[1] == 'S') ? "%s/sys" : "%s",
+                    dir);
+            ++text;
+        } else if (len + 1 < bufSize) {
+            bufOut[len++] = *text;
+            bufOut[len] = '\0';
+        }
+    }
+}
+
+/* }}} */
+/* {{{ checkCase
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Composes the libraries of the given objects and compares them with the
+ * expected ones (NULL if the composition must fail), see expandPaths.
+ *
+ * \return          RTI_TRUE if the case passes
+ */
+static RTIBool checkCase(const char *title,
+        struct REDAInlineList *archDef,
+        const char *dir,
+        const char *target,
+        RTIBool isStatic,
+        const char *objectNames,
+        const char *expected) {
+    char home[PATH_MAX+1];
+    char want[MAX_CMDLINEARG_SIZE+1];
+    char got[MAX_CMDLINEARG_SIZE+1];
+    char objectPaths[4][PATH_MAX+1];
+    char *objects[4];
+    char names[MAX_STRING_SIZE];
+    char *name;
+    char *save = NULL;
+    struct Architecture *arch = findArchitecture(archDef, target);
+    int count = 0;
+    RTIBool ok;
+
+    snprintf(home, sizeof(home), "%s/home", dir);
+    snprintf(names, sizeof(names), "%s", objectNames);
+    for (name = strtok_r(names, " ", &save);
+            (name != NULL) && (count < 4);
+            name = strtok_r(NULL, " ", &save)) {
+        snprintf(objectPaths[count], PATH_MAX+1, "%s/%s", dir, name);
+        objects[count] = objectPaths[count];
+        ++count;
+    }
+    expandPaths((expected != NULL) ? expected : "", dir, want, sizeof(want));
+
+    if (arch == NULL) {
+        printf("FAIL: %s: target %s not found\n", title, target);
+        return RTI_FALSE;
+    }
+    ok = composeMinimalLibs(arch,
+            home,
+            0,
+            isStatic,
+            RTI_FALSE,
+            objects,
+            count,
+            got,
+            sizeof(got));
+    if (expected == NULL) {
+        if (ok) {
+            printf("FAIL: %s: expected an error, got: %s\n", title, got);
+            return RTI_FALSE;
+        }
+    } else if (!ok || (strcmp(got, want) != 0)) {
+        printf("FAIL: %s\n  expected: %s\n  got:      %s\n",
+                title,
+                want,
+                ok ? got : "(error)");
+        return RTI_FALSE;
+    }
+    printf("PASS: %s\n", title);
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ checkAbsoluteCase
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Replaces the libraries with their paths (--ldlibs-abs) and compares the
+ * result with the expected one (NULL if it must fail), see expandPaths.
+ *
+ * \return          RTI_TRUE if the case passes
+ */
+static RTIBool checkAbsoluteCase(const char *title,
+        struct REDAInlineList *archDef,
+        const char *dir,
+        const char *target,
+        RTIBool isStatic,
+        RTIBool isDebug,
+        const char *libs,
+        const char *expected) {
+    char home[PATH_MAX+1];
+    char want[MAX_CMDLINEARG_SIZE+1];
+    char got[MAX_CMDLINEARG_SIZE+1];
+    struct Architecture *arch = findArchitecture(archDef, target);
+    RTIBool ok;
+
+    if (arch == NULL) {
+        printf("FAIL: %s: target %s not found\n", title, target);
+        return RTI_FALSE;
+    }
+    snprintf(home, sizeof(home), "%s/home", dir);
+    expandPaths(libs, dir, got, sizeof(got));
+    expandPaths((expected != NULL) ? expected : "", dir, want, sizeof(want));
+    ok = resolveAbsoluteLibs(arch,
+            home,
+            0,
+            isStatic,
+            isDebug,
+            got,
+            sizeof(got));
+    if (expected == NULL) {
+        if (ok) {
+            printf("FAIL: %s: expected an error, got: %s\n", title, got);
+            return RTI_FALSE;
+        }
+    } else if (!ok || (strcmp(got, want) != 0)) {
+        printf("FAIL: %s\n  expected: %s\n  got:      %s\n",
+                title,
+                want,
+                ok ? got : "(error)");
+        return RTI_FALSE;
+    }
+    printf("PASS: %s\n", title);
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ main
+ * -----------------------------------------------------------------------------
+ */
+int main(int argc, char **argv) {
+    struct REDAInlineList archDef;
+    struct PlatformFileInfo info;
+    char dir[PATH_MAX+1];
+    char path[PATH_MAX+1];
+    RTIBool keep = RTI_FALSE;
+    RTIBool ok = RTI_TRUE;
+    int i;
+
+    for (i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--keep") == 0) {
+            keep = RTI_TRUE;
+        } else {
+            fprintf(stderr, "Usage: %s [--keep]\n", argv[0]);
+            return LDMIN_EXIT_ERROR;
+        }
+    }
+    if (!createTestDir(dir, sizeof(dir), "ldmin")) {
+        return LDMIN_EXIT_ERROR;
+    }
+    REDAInlineList_init(&archDef);
+    snprintf(path, sizeof(path), "%s/platforms.vm", dir);
+    if (!createInstallation(dir) || !readPlatformFile(path, &archDef, &info)) {
+        if (!keep) {
+            removeTestDir(dir);
+        }
+        return LDMIN_EXIT_ERROR;
+    }
+
+    ok = checkCase("static: used libraries and system libraries",
+                &archDef, dir, "T1", RTI_TRUE, "app.o",
+                "-L%H/lib/T1 -lnddscz -lnddscorez -L%S -lneed -lscript -lmissing") && ok;
+    ok = checkCase("static: optional library before the core ones",
+                &archDef, dir, "T1", RTI_TRUE, "monapp.o app.o",
+                "-L%H/lib/T1 -lrtimonitoringz -lnddscz -lnddscorez "
+                "-L%S -lneed -lscript -lmissing") && ok;
+    ok = checkCase("invalid object",
+                &archDef, dir, "T1", RTI_TRUE, "truncated.o",
+                NULL) && ok;
+    ok = checkCase("shared: release libraries",
+                &archDef, dir, "T1", RTI_FALSE, "app.o",
+                "-L%H/lib/T1 -lnddsc -lnddscore -L%S -lneed -lmissing") && ok;
+    ok = checkCase("static: cycle linked as a group",
+                &archDef, dir, "T2", RTI_TRUE, "app.o",
+                "-L%H/lib/T2 -Wl,--start-group -lnddscz -lnddscorez "
+                "-Wl,--end-group -lmissing") && ok;
+    ok = checkCase("static: objects without RTI symbols",
+                &archDef, dir, "T2", RTI_TRUE, "monapp.o",
+                "-lmissing") && ok;
+
+    ok = checkAbsoluteCase("absolute: static libraries",
+                &archDef, dir, "T1", RTI_TRUE, RTI_FALSE,
+                "-L%H/lib/T1 -lnddscz -lnddscorez -L%S -ldl -lneed -lscript -lmissing",
+                "%H/lib/T1/libnddscz.a %H/lib/T1/libnddscorez.a "
+                "-L%S %S/libdl.a %S/libneed.a %S/libscript.so -lmissing") && ok;
+    ok = checkAbsoluteCase("absolute: shared libraries",
+                &archDef, dir, "T1", RTI_FALSE, RTI_FALSE,
+                "-L%H/lib/T1 -lnddsc -lnddscore -L%S -lunused",
+                "-Wl,-rpath-link,%H/lib/T1 %H/lib/T1/libnddsc.so "
+                "%H/lib/T1/libnddscore.so -L%S %S/libunused.so") && ok;
+    ok = checkAbsoluteCase("absolute: missing variant",
+                &archDef, dir, "T1", RTI_FALSE, RTI_TRUE,
+                "-L%H/lib/T1 -lnddscd -lnddscored",
+                NULL) && ok;
+    ok = checkAbsoluteCase("absolute: sysroot",
+                &archDef, dir, "T2", RTI_TRUE, RTI_FALSE,
+                "-L%H/lib/T2 -lnddscz --sysroot=%D/root -lroot -lmissing",
+                "%H/lib/T2/libnddscz.a --sysroot=%D/root %D/root/usr/lib/libroot.so "
+                "-lmissing") && ok;
+
+    if (!keep) {
+        removeTestDir(dir);
+    } else {
+        printf("Installation kept in %s\n", dir);
+    }
+    return ok ? LDMIN_EXIT_PASS : LDMIN_EXIT_FAIL;
+}
+
+/* }}} */
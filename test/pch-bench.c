@@ -0,0 +1,489 @@
+/*****************************************************************************
+ * Copyright (c) 2020 Real-Time Innovations, Inc.  All rights reserved.      *
+ *                                                                           *
+ * Permission to modify and use for internal purposes granted.               *
+ * This software is provided "as is", without warranty, express or implied.  *
+ *****************************************************************************/
+
+/*
+ * Benchmark of the precompiled headers built by connext-config --pch.
+ *
+ * The sources of an example (by default autoconf-hello-idl-cpp) are copied
+ * in a work directory, where the type support code is generated from the
+ * IDL files with $NDDSHOME/bin/rtiddsgen. Then:
+ *  - the PCH of the API is built with `connext-config --pch-build`
+ *  - every translation unit is compiled --runs times with the compiler and
+ *    the flags composed by connext-config, without and with the flags to
+ *    use the PCH, and the median wall time of each is reported
+ *
+ * The summary reports the total compile time of the example in both cases,
+ * the time to build the PCH, and the number of translation units that must
+ * be compiled to pay back the build of the PCH.
+ *
+ * The benchmark is skipped (exit code 77) if rtiddsgen is not available.
+ * ---------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <dirent.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#define MAX_STRING_SIZE                 200
+#define MAX_CMDLINE_SIZE                8192
+#define MAX_SOURCES                     64
+
+#define DEFAULT_RUNS                    5
+#define DEFAULT_API                     "cxx"
+#define DEFAULT_TARGET                  "x64Linux4gcc7.3.0"
+
+/* Exit code of a skipped test (automake convention) */
+#define EXIT_SKIP                       77
+
+/* The operations giving the compiler and the flags of each API */
+static const struct {
+    const char  *api;
+    const char  *compOp;
+    const char  *flagsOp;
+    const char  *language;      /* rtiddsgen -language */
+} APIS[] = {
+    { "c",      "--ccomp",      "--cflags",     "C" },
+    { "cxx",    "--cxxcomp",    "--cxxflags",   "C++" },
+    { "cxx03",  "--cxx03comp",  "--cxx03flags", "C++03" },
+    { "cxx11",  "--cxx11comp",  "--cxx11flags", "C++11" },
+    { NULL,     NULL,           NULL,           NULL }
+};
+
+struct Options {
+    const char                  *binary;
+    const char                  *sourceDir;
+    const char                  *target;
+    const char                  *workDir;
+    int                         apiIdx;
+    int                         runs;
+    int                         keep;
+    int                         json;
+};
+
+struct Source {
+    char                        name[NAME_MAX+1];
+    double                      baselineMs;
+    double                      pchMs;
+};
+
+/* {{{ nowNs
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static unsigned long long nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL +
+            (unsigned long long)ts.tv_nsec;
+}
+
+/* }}} */
+/* {{{ compareDouble
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static int compareDouble(const void *a, const void *b) {
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+    return (da < db) ? -1 : ((da > db) ? 1 : 0);
+}
+
+/* }}} */
+/* {{{ runShell
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Runs the command through the shell and returns its wall time in ms, or
+ * a negative value if it failed.
+ */
+static double runShell(const char *cmd) {
+    unsigned long long start = nowNs();
+    int rc = system(cmd);
+    if ((rc == -1) || !WIFEXITED(rc) || (WEXITSTATUS(rc) != 0)) {
+        fprintf(stderr, "Error: command failed: %s\n", cmd);
+        return -1.0;
+    }
+    return (double)(nowNs() - start) / 1e6;
+}
+
+/* }}} */
+/* {{{ captureShell
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Runs the command through the shell and stores the first line of its
+ * output in bufOut. Returns the wall time in ms, or a negative value if it
+ * failed.
+ */
+static double captureShell(const char *cmd, char *bufOut, size_t bufSize) {
+    unsigned long long start = nowNs();
+    FILE *fp = popen(cmd, "r");
+    size_t len;
+    int rc;
+
+    bufOut[0] = '\0';
+    if (fp == NULL) {
+        fprintf(stderr, "Error: cannot run: %s\n", cmd);
+        return -1.0;
+    }
+    if (fgets(bufOut, bufSize, fp) == NULL) {
+        bufOut[0] = '\0';
+    }
+    rc = pclose(fp);
+    if ((rc == -1) || !WIFEXITED(rc) || (WEXITSTATUS(rc) != 0)) {
+        fprintf(stderr, "Error: command failed: %s\n", cmd);
+        return -1.0;
+    }
+    len = strlen(bufOut);
+    while ((len > 0) && ((bufOut[len-1] == '\n') || (bufOut[len-1] == '\r'))) {
+        bufOut[--len] = '\0';
+    }
+    return (double)(nowNs() - start) / 1e6;
+}
+
+/* }}} */
+/* {{{ hasSuffix
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static int hasSuffix(const char *name, const char *suffix) {
+    size_t len = strlen(name);
+    size_t suffixLen = strlen(suffix);
+    return (len > suffixLen) && (strcmp(name + len - suffixLen, suffix) == 0);
+}
+
+/* }}} */
+/* {{{ prepareWorkDir
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Copies the sources and the IDL files in the work directory and generates
+ * the type support code. Returns 0 if success, EXIT_SKIP if rtiddsgen is
+ * required but not available, -1 if failed.
+ */
+static int prepareWorkDir(const struct Options *opt) {
+    char cmd[MAX_CMDLINE_SIZE];
+    char rtiddsgen[PATH_MAX];
+    const char *home = getenv("NDDSHOME");
+    struct dirent *entry;
+    DIR *dir;
+    int idlCount = 0;
+
+    snprintf(cmd, sizeof(cmd),
+            "cp '%s'/*.c* '%s'/*.h* '%s' 2>/dev/null; cp '%s'/*.idl '%s' 2>/dev/null; true",
+            opt->sourceDir,
+            opt->sourceDir,
+            opt->workDir,
+            opt->sourceDir,
+            opt->workDir);
+    if (runShell(cmd) < 0) {
+        return -1;
+    }
+
+    dir = opendir(opt->workDir);
+    if (dir == NULL) {
+        fprintf(stderr, "Error: cannot open '%s': %s\n", opt->workDir, strerror(errno));
+        return -1;
+    }
+    while ((entry = readdir(dir)) != NULL) {
+        if (!hasSuffix(entry->d_name, ".idl")) {
+            continue;
+        }
+        if (idlCount++ == 0) {
+            snprintf(rtiddsgen, sizeof(rtiddsgen), "%s/bin/rtiddsgen",
+                    (home != NULL) ? home : "");
+            if ((home == NULL) || (access(rtiddsgen, X_OK) != 0)) {
+                closedir(dir);
+                fprintf(stderr,
+                        "Skipped: %s is required to generate the type support code\n",
+                        rtiddsgen);
+                return EXIT_SKIP;
+            }
+        }
+        snprintf(cmd, sizeof(cmd),
+                "cd '%s' && '%s' -language %s -replace '%s' > /dev/null",
+                opt->workDir,
+                rtiddsgen,
+                APIS[opt->apiIdx].language,
+                entry->d_name);
+        if (runShell(cmd) < 0) {
+            closedir(dir);
+            return -1;
+        }
+    }
+    closedir(dir);
+    return 0;
+}
+
+/* }}} */
+/* {{{ compareSources
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static int compareSources(const void *a, const void *b) {
+    return strcmp(((const struct Source *)a)->name, ((const struct Source *)b)->name);
+}
+
+/* }}} */
+/* {{{ findSources
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Lists the translation units of the work directory (sorted by name): the 
+ * .c files for the C API, the .cxx and .cpp files for the C++ APIs.
+ * Returns the number of sources found.
+ */
+static int findSources(const struct Options *opt, struct Source *sources) {
+    int isC = (strcmp(APIS[opt->apiIdx].api, "c") == 0);
+    struct dirent *entry;
+    DIR *dir = opendir(opt->workDir);
+    int count = 0;
+
+    if (dir == NULL) {
+        return 0;
+    }
+    while (((entry = readdir(dir)) != NULL) && (count < MAX_SOURCES)) {
+        if (isC ? hasSuffix(entry->d_name, ".c") : 
+                (hasSuffix(entry->d_name, ".cxx") || hasSuffix(entry->d_name, ".cpp"))) {
+            memset(&sources[count], 0, sizeof(*sources));
+            snprintf(sources[count].name, sizeof(sources[count].name), "%s", entry->d_name);
+            ++count;
+        }
+    }
+    closedir(dir);
+    qsort(sources, count, sizeof(*sources), compareSources);
+    return count;
+}
+
+/* }}} */
+/* {{{ measureCompile
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Compiles the source --runs times with the given command prefix (compiler
+ * and flags) and returns the median wall time in ms, or a negative value
+ * if the compilation failed.
+ */
+static double measureCompile(const struct Options *opt,
+        const char *compile,
+        const char *source) {
+    char cmd[MAX_CMDLINE_SIZE];
+    double samples[64];
+    int runs = (opt->runs < 64) ? opt->runs : 64;
+    int i;
+
+    if (snprintf(cmd, sizeof(cmd), "cd '%s' && %s -c '%s' -o bench.o",
+                opt->workDir,
+                compile,
+                source) >= (int)sizeof(cmd)) {
+        fprintf(stderr, "Error: compile command too long\n");
+        return -1.0;
+    }
+    for (i = 0; i < runs; ++i) {
+        samples[i] = runShell(cmd);
+        if (samples[i] < 0) {
+            return -1.0;
+        }
+    }
+    qsort(samples, runs, sizeof(*samples), compareDouble);
+    return samples[runs/2];
+}
+
+/* }}} */
+/* {{{ usage
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void usage(const char *argv0) {
+    printf("Usage: %s --binary=<connext-config> --sources=<dir> [options]\n", argv0);
+    printf("Options:\n");
+    printf("    --target=ARCH       target architecture (default: $NDDSARCH or %s)\n",
+            DEFAULT_TARGET);
+    printf("    --api=API           c, cxx, cxx03 or cxx11 (default: %s)\n", DEFAULT_API);
+    printf("    --runs=N            compilations of each source (default: %d)\n",
+            DEFAULT_RUNS);
+    printf("    --work-dir=DIR      work directory (default: a temporary directory)\n");
+    printf("    --keep              do not remove the work directory\n");
+    printf("    --json              print the results as JSON\n");
+}
+
+/* }}} */
+/* {{{ main
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+int main(int argc, char **argv) {
+    struct Options opt;
+    struct Source sources[MAX_SOURCES];
+    char workDirBuf[PATH_MAX];
+    char cmd[MAX_CMDLINE_SIZE];
+    char compiler[MAX_CMDLINE_SIZE];
+    char flags[MAX_CMDLINE_SIZE];
+    char pchFlags[MAX_CMDLINE_SIZE];
+    char baseline[3*MAX_CMDLINE_SIZE];
+    char withPch[4*MAX_CMDLINE_SIZE];
+    double pchBuildMs;
+    double totalBaseline = 0.0;
+    double totalPch = 0.0;
+    int sourceCount;
+    int retCode = 2;
+    int createdWorkDir = 0;
+    int i;
+
+    memset(&opt, 0, sizeof(opt));
+    opt.runs = DEFAULT_RUNS;
+    opt.target = getenv("NDDSARCH");
+    if ((opt.target == NULL) || (opt.target[0] == '\0')) {
+        opt.target = DEFAULT_TARGET;
+    }
+    for (i = 0; APIS[i].api != NULL; ++i) {
+        if (strcmp(APIS[i].api, DEFAULT_API) == 0) {
+            opt.apiIdx = i;
+        }
+    }
+
+    for (i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--binary=", 9) == 0) {
+            opt.binary = argv[i]+9;
+        } else if (strncmp(argv[i], "--sources=", 10) == 0) {
+            opt.sourceDir = argv[i]+10;
+        } else if (strncmp(argv[i], "--target=", 9) == 0) {
+            opt.target = argv[i]+9;
+        } else if (strncmp(argv[i], "--api=", 6) == 0) {
+            int a;
+            opt.apiIdx = -1;
+            for (a = 0; APIS[a].api != NULL; ++a) {
+                if (strcmp(APIS[a].api, argv[i]+6) == 0) {
+                    opt.apiIdx = a;
+                }
+            }
+            if (opt.apiIdx == -1) {
+                fprintf(stderr, "Invalid API: %s\n", argv[i]+6);
+                return 2;
+            }
+        } else if (strncmp(argv[i], "--runs=", 7) == 0) {
+            opt.runs = atoi(argv[i]+7);
+        } else if (strncmp(argv[i], "--work-dir=", 11) == 0) {
+            opt.workDir = argv[i]+11;
+        } else if (strcmp(argv[i], "--keep") == 0) {
+            opt.keep = 1;
+        } else if (strcmp(argv[i], "--json") == 0) {
+            opt.json = 1;
+        } else if ((strcmp(argv[i], "-h") == 0) ||
+                (strcmp(argv[i], "--help") == 0)) {
+            usage(argv[0]);
+            return 0;
+        } else {
+            fprintf(stderr, "Invalid argument: %s\n", argv[i]);
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if ((opt.binary == NULL) || (opt.sourceDir == NULL)) {
+        fprintf(stderr, "Error: missing --binary or --sources\n");
+        usage(argv[0]);
+        return 2;
+    }
+    if (opt.runs <= 0) {
+        fprintf(stderr, "Error: invalid number of runs\n");
+        return 2;
+    }
+    if (opt.workDir == NULL) {
+        snprintf(workDirBuf, sizeof(workDirBuf), "/tmp/connext-pch-bench.XXXXXX");
+        if (mkdtemp(workDirBuf) == NULL) {
+            fprintf(stderr, "Error: cannot create work directory: %s\n", strerror(errno));
+            return 2;
+        }
+        opt.workDir = workDirBuf;
+        createdWorkDir = 1;
+    } else if ((mkdir(opt.workDir, 0755) != 0) && (errno != EEXIST)) {
+        fprintf(stderr, "Error: cannot create '%s': %s\n", opt.workDir, strerror(errno));
+        return 2;
+    }
+
+    i = prepareWorkDir(&opt);
+    if (i != 0) {
+        retCode = (i == EXIT_SKIP) ? EXIT_SKIP : 2;
+        goto done;
+    }
+    sourceCount = findSources(&opt, sources);
+    if (sourceCount == 0) {
+        fprintf(stderr, "Error: no sources found in '%s'\n", opt.sourceDir);
+        goto done;
+    }
+
+    /* The compiler and flags composed by connext-config */
+    snprintf(cmd, sizeof(cmd), "'%s' %s %s",
+            opt.binary, APIS[opt.apiIdx].compOp, opt.target);
+    if (captureShell(cmd, compiler, sizeof(compiler)) < 0) {
+        goto done;
+    }
+    snprintf(cmd, sizeof(cmd), "'%s' %s %s",
+            opt.binary, APIS[opt.apiIdx].flagsOp, opt.target);
+    if (captureShell(cmd, flags, sizeof(flags)) < 0) {
+        goto done;
+    }
+    snprintf(cmd, sizeof(cmd), "'%s' --api=%s --pch='%s/pch' --pch-build %s",
+            opt.binary, APIS[opt.apiIdx].api, opt.workDir, opt.target);
+    pchBuildMs = captureShell(cmd, pchFlags, sizeof(pchFlags));
+    if (pchBuildMs < 0) {
+        goto done;
+    }
+    snprintf(baseline, sizeof(baseline), "%s %s", compiler, flags);
+    snprintf(withPch, sizeof(withPch), "%s %s %s", compiler, flags, pchFlags);
+
+    for (i = 0; i < sourceCount; ++i) {
+        sources[i].baselineMs = measureCompile(&opt, baseline, sources[i].name);
+        sources[i].pchMs = measureCompile(&opt, withPch, sources[i].name);
+        if ((sources[i].baselineMs < 0) || (sources[i].pchMs < 0)) {
+            goto done;
+        }
+        totalBaseline += sources[i].baselineMs;
+        totalPch += sources[i].pchMs;
+    }
+
+    if (opt.json) {
+        printf("{\n  \"target\": \"%s\",\n  \"api\": \"%s\",\n  \"runs\": %d,\n"
+                "  \"pch_build_ms\": %.1f,\n  \"sources\": [\n",
+                opt.target, APIS[opt.apiIdx].api, opt.runs, pchBuildMs);
+        for (i = 0; i < sourceCount; ++i) {
+            printf("    { \"name\": \"%s\", \"baseline_ms\": %.1f, \"pch_ms\": %.1f }%s\n",
+                    sources[i].name,
+                    sources[i].baselineMs,
+                    sources[i].pchMs,
+                    (i < sourceCount-1) ? "," : "");
+        }
+        printf("  ],\n  \"total_baseline_ms\": %.1f,\n  \"total_pch_ms\": %.1f\n}\n",
+                totalBaseline, totalPch);
+    } else {
+        printf("Target %s, API %s, median of %d compilations\n",
+                opt.target, APIS[opt.apiIdx].api, opt.runs);
+        printf("PCH flags: %s\n\n", pchFlags);
+        printf("%-28s %14s %14s %9s\n", "source", "baseline (ms)", "pch (ms)", "speedup");
+        for (i = 0; i < sourceCount; ++i) {
+            printf("%-28s %14.1f %14.1f %8.2fx\n",
+                    sources[i].name,
+                    sources[i].baselineMs,
+                    sources[i].pchMs,
+                    sources[i].baselineMs / sources[i].pchMs);
+        }
+        printf("%-28s %14.1f %14.1f %8.2fx\n",
+                "total", totalBaseline, totalPch, totalBaseline / totalPch);
+        printf("\nPCH build: %.1f ms", pchBuildMs);
+        if (totalBaseline > totalPch) {
+            printf(", paid back after %.1f translation units\n",
+                    pchBuildMs / ((totalBaseline - totalPch) / sourceCount));
+        } else {
+            printf(", never paid back\n");
+        }
+    }
+    retCode = 0;
+
+done:
+    if (createdWorkDir && !opt.keep) {
+        snprintf(cmd, sizeof(cmd), "rm -rf '%s'", opt.workDir);
+        if (system(cmd) != 0) {
+            fprintf(stderr, "Warning: cannot remove '%s'\n", opt.workDir);
+        }
+    } else if (createdWorkDir) {
+        fprintf(stderr, "Work directory: %s\n", opt.workDir);
+    }
+    return retCode;
+}
+
+/* }}} */
@@ -0,0 +1,280 @@
+/*****************************************************************************
+ * Copyright (c) 2020 Real-Time Innovations, Inc.  All rights reserved.      *
+ *                                                                           *
+ * Permission to modify and use for internal purposes granted.               *
+ * This software is provided "as is", without warranty, express or implied.  *
+ *****************************************************************************/
+
+/*
+ * Test of the keys of the precompiled headers (--pch) and of the C++
+ * modules (--modules).
+ *
+ * Builds in a temporary directory a synthetic installation with a gcc and
+ * a clang target (the compilers are not installed: their family and
+ * version come from the names), then prints the commands of --pch and
+ * --modules without and with --profile=lto and checks that:
+ *  - the commands are composed with the flags of the profile;
+ *  - the key of the directory of the PCH (or module) changes with the
+ *    profile, so a PCH is never used by translation units compiled with
+ *    different flags;
+ *  - the key does not change if the flags do not change.
+ *
+ * The test includes the source of connext-config directly, like the
+ * golden test. Nothing is compiled.
+ *
+ * Usage:
+ *      connext-config-pch [--keep]
+ *
+ * --keep               do not remove the temporary directory
+ *
+ * Exit code is 0 if all the cases pass, 1 if one fails and 99 if an error
+ * occurred.
+ * ---------------------------------------------------------------------------
+ */
+
+/* Rename the main of connext-config, this file provides its own */
+#define main connextConfigMain
+#include "connext-config.c"
+#undef main
+
+#include "testutil.h"
+
+#define PCH_EXIT_PASS                   0
+#define PCH_EXIT_FAIL                   1
+#define PCH_EXIT_ERROR                  99
+
+/* The length of the key in the name of the directory (%016llx) */
+#define PCH_KEY_LENGTH                  16
+
+#define PCH_MAX_OUTPUT                  (2*MAX_CMDLINEARG_SIZE)
+
+/* A target of the synthetic installation and the flag of --profile=lto */
+struct PchTarget {
+    const char                  *name;
+    const char                  *ltoFlag;
+};
+
+static const struct PchTarget PCH_TARGETS[] = {
+    { "x64Linux4gcc12.1.0", "-flto=auto" },
+    { "x64Darwin20clang12.0", "-flto=thin" },
+    { NULL, NULL }
+};
+
+static const char * const TARGET_NAMES[] = {
+    "x64Linux4gcc12.1.0", "x64Darwin20clang12.0", NULL
+};
+
+static const char *PLATFORMS =
+    "#arch(\"x64Linux4gcc12.1.0\",\"\", {\n"
+    "    $OS : $OS.UNIX,\n"
+    "    $C_COMPILER : \"/nonexistent/gcc\",\n"
+    "    $C_LINKER : \"/nonexistent/gcc\",\n"
+    "    $CXX_COMPILER : \"/nonexistent/g++\",\n"
+    "    $CXX_LINKER : \"/nonexistent/g++\",\n"
+    "    $C_COMPILER_FLAGS : [\"m64\", \"Wall\"],\n"
+    "})\n"
+    "\n"
+    "#arch(\"x64Darwin20clang12.0\",\"\", {\n"
+    "    $OS : $OS.UNIX,\n"
+    "    $C_COMPILER : \"/nonexistent/clang\",\n"
+    "    $C_LINKER : \"/nonexistent/clang\",\n"
+    "    $CXX_COMPILER : \"/nonexistent/clang++\",\n"
+    "    $CXX_LINKER : \"/nonexistent/clang++\",\n"
+    "    $C_COMPILER_FLAGS : [\"m64\", \"Wall\"],\n"
+    "})\n";
+
+/* {{{ printCommands
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Runs --pch=dir/pch (or --modules=dir/modules) for the C++ API of the
+ * target, with the given profile (NULL for none), and captures the
+ * commands printed to stdout.
+ *
+ * \return          RTI_TRUE if success
+ */
+static RTIBool printCommands(struct Architecture *arch,
+        const char *dir,
+        RTIBool modules,
+        const char *profile,
+        char *bufOut,
+        size_t bufSize) {
+    struct ToolchainFlags flags;
+    char home[PATH_MAX+1];
+    char baseDir[PATH_MAX+1];
+    char outPath[PATH_MAX+1];
+    ComposeResult rc;
+    ssize_t len;
+    int savedStdout;
+    int fd;
+
+    bufOut[0] = '\0';
+    if ((profile != NULL) && !resolveProfile(arch, profile, &flags)) {
+        return RTI_FALSE;
+    }
+    snprintf(home, sizeof(home), "%s/home", dir);
+    snprintf(baseDir, sizeof(baseDir), "%s/%s", dir, modules ? "modules" : "pch");
+    snprintf(outPath, sizeof(outPath), "%s/commands.txt", dir);
+    fd = open(outPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        fprintf(stderr, "Error: cannot create %s: %s\n", outPath, strerror(errno));
+        return RTI_FALSE;
+    }
+    fflush(stdout);
+    savedStdout = dup(1);
+    dup2(fd, 1);
+    close(fd);
+    if (modules) {
+        rc = prepareModules(arch, home, getApiIndex("cxx"), RTI_FALSE,
+                RTI_FALSE, RTI_FALSE, (profile != NULL) ? &flags : NULL,
+                baseDir, RTI_FALSE);
+    } else {
+        rc = precompileHeaders(arch, home, getApiIndex("cxx"), RTI_FALSE,
+                RTI_FALSE, RTI_FALSE, (profile != NULL) ? &flags : NULL,
+                baseDir, RTI_FALSE);
+    }
+    fflush(stdout);
+    dup2(savedStdout, 1);
+    close(savedStdout);
+    if (rc != ComposeResult_Ok) {
+        return RTI_FALSE;
+    }
+
+    fd = open(outPath, O_RDONLY);
+    if (fd == -1) {
+        fprintf(stderr, "Error: cannot read %s: %s\n", outPath, strerror(errno));
+        return RTI_FALSE;
+    }
+    len = read(fd, bufOut, bufSize - 1);
+    close(fd);
+    if (len < 0) {
+        fprintf(stderr, "Error: cannot read %s: %s\n", outPath, strerror(errno));
+        return RTI_FALSE;
+    }
+    bufOut[len] = '\0';
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ getKey
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Extracts the key from the directory <target>-cxx-<key> in the commands.
+ *
+ * \return          RTI_TRUE if found
+ */
+static RTIBool getKey(const char *commands,
+        const char *target,
+        char *keyOut) {
+    char prefix[MAX_STRING_SIZE];
+    const char *ptr;
+
+    snprintf(prefix, sizeof(prefix), "/%s-cxx-", target);
+    ptr = strstr(commands, prefix);
+    if ((ptr == NULL) || (strlen(ptr + strlen(prefix)) < PCH_KEY_LENGTH)) {
+        return RTI_FALSE;
+    }
+    snprintf(keyOut, PCH_KEY_LENGTH + 1, "%s", ptr + strlen(prefix));
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ checkKeys
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Checks the commands and the keys of the PCH (or module) of the target
+ * without a profile (twice) and with --profile=lto.
+ *
+ * \return          RTI_TRUE if the case passes
+ */
+static RTIBool checkKeys(struct REDAInlineList *archDef,
+        const char *dir,
+        const struct PchTarget *target,
+        RTIBool modules) {
+    static char base[PCH_MAX_OUTPUT];
+    static char again[PCH_MAX_OUTPUT];
+    static char lto[PCH_MAX_OUTPUT];
+    const char *what = modules ? "modules" : "pch";
+    char baseKey[PCH_KEY_LENGTH + 1];
+    char againKey[PCH_KEY_LENGTH + 1];
+    char ltoKey[PCH_KEY_LENGTH + 1];
+    struct Architecture *arch = findArchitecture(archDef, target->name);
+
+    if ((arch == NULL) ||
+            !printCommands(arch, dir, modules, NULL, base, sizeof(base)) ||
+            !printCommands(arch, dir, modules, NULL, again, sizeof(again)) ||
+            !printCommands(arch, dir, modules, "lto", lto, sizeof(lto))) {
+        printf("FAIL: %s: %s: cannot print the commands\n", what, target->name);
+        return RTI_FALSE;
+    }
+    if (!getKey(base, target->name, baseKey) ||
+            !getKey(again, target->name, againKey) ||
+            !getKey(lto, target->name, ltoKey)) {
+        printf("FAIL: %s: %s: no key in the commands:\n%s\n", what, target->name, lto);
+        return RTI_FALSE;
+    }
+    if ((strstr(base, target->ltoFlag) != NULL) ||
+            (strstr(lto, target->ltoFlag) == NULL)) {
+        printf("FAIL: %s: %s: %s not only in the commands of the profile:\n%s\n%s\n",
+                what, target->name, target->ltoFlag, base, lto);
+        return RTI_FALSE;
+    }
+    if (strcmp(baseKey, againKey) != 0) {
+        printf("FAIL: %s: %s: the key changes with the same flags (%s, %s)\n",
+                what, target->name, baseKey, againKey);
+        return RTI_FALSE;
+    }
+    if (strcmp(baseKey, ltoKey) == 0) {
+        printf("FAIL: %s: %s: the key does not change with --profile=lto (%s)\n",
+                what, target->name, baseKey);
+        return RTI_FALSE;
+    }
+    printf("PASS: %s: %s: key %s, with --profile=lto %s\n",
+            what, target->name, baseKey, ltoKey);
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ main
+ * -----------------------------------------------------------------------------
+ */
+int main(int argc, char **argv) {
+    struct REDAInlineList archDef;
+    struct PlatformFileInfo info;
+    char dir[PATH_MAX/2];      /* Room for the paths of the files */
+    char path[PATH_MAX+1];
+    RTIBool keep = RTI_FALSE;
+    RTIBool ok = RTI_TRUE;
+    int i;
+
+    for (i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--keep") == 0) {
+            keep = RTI_TRUE;
+        } else {
+            fprintf(stderr, "Usage: %s [--keep]\n", argv[0]);
+            return PCH_EXIT_ERROR;
+        }
+    }
+    if (!createTestDir(dir, sizeof(dir), "pch")) {
+        return PCH_EXIT_ERROR;
+    }
+    REDAInlineList_init(&archDef);
+    snprintf(path, sizeof(path), "%s/platforms.vm", dir);
+    if (!createTestHome(dir, TARGET_NAMES, PLATFORMS) ||
+            !readPlatformFile(path, &archDef, &info)) {
+        if (!keep) {
+            removeTestDir(dir);
+        }
+        return PCH_EXIT_ERROR;
+    }
+
+    for (i = 0; PCH_TARGETS[i].name != NULL; ++i) {
+        ok = checkKeys(&archDef, dir, &PCH_TARGETS[i], RTI_FALSE) && ok;
+        ok = checkKeys(&archDef, dir, &PCH_TARGETS[i], RTI_TRUE) && ok;
+    }
+
+    if (!keep) {
+        removeTestDir(dir);
+    } else {
+        printf("Installation kept in %s\n", dir);
+    }
+    return ok ? PCH_EXIT_PASS : PCH_EXIT_FAIL;
+}
+
+/* }}} */
@@ -0,0 +1,526 @@
+/*****************************************************************************
+ * Copyright (c) 2020 Real-Time Innovations, Inc.  All rights reserved.      *
+ *                                                                           *
+ * Permission to modify and use for internal purposes granted.               *
+ * This software is provided "as is", without warranty, express or implied.  *
+ *****************************************************************************/
+
+/*
+ * Test of --rpath.
+ *
+ * Builds in a temporary directory a synthetic installation with a target
+ * using the compiler of the host (cc) and -Wl,--no-as-needed, as the Linux
+ * targets: two shared libraries, libnddsc.so using libnddscore.so,
+ * compiled by the test. Then it links a small
+ * application with the linker flags and the libraries composed for each
+ * mode of --rpath, runs it with LD_DEBUG=libs and counts the files tried
+ * by the dynamic loader ("trying file=" lines):
+ *  - none: the application does not start without LD_LIBRARY_PATH, and
+ *    with LD_LIBRARY_PATH (some directories before the one of the
+ *    libraries) the loader tries every directory for every library;
+ *  - absolute and origin:../lib (with the application and the libraries
+ *    moved to bin and lib): the application starts without
+ *    LD_LIBRARY_PATH, with fewer probes. origin:../lib is linked in each
+ *    way its outputs are used (see RPATH_LINK_NAMES), and the RUNPATH of
+ *    the application must be $ORIGIN/../lib (if readelf is installed).
+ *
+ * The test includes the source of connext-config directly, like the
+ * golden test. It is skipped if the host has no C compiler or if its
+ * dynamic loader does not support LD_DEBUG (i.e. not glibc).
+ *
+ * Usage:
+ *      connext-config-rpath [--keep]
+ *
+ * --keep               do not remove the temporary directory
+ *
+ * Exit code is 0 if all the cases pass, 1 if one fails, 77 (skipped by
+ * automake) if the test cannot run on the host and 99 if an error
+ * occurred.
+ * ---------------------------------------------------------------------------
+ */
+
+/* Rename the main of connext-config, this file provides its own */
+#define main connextConfigMain
+#include "connext-config.c"
+#undef main
+
+#include "testutil.h"
+
+#define RPATH_EXIT_PASS                 0
+#define RPATH_EXIT_FAIL                 1
+#define RPATH_EXIT_SKIP                 77
+#define RPATH_EXIT_ERROR                99
+
+/* The directories of LD_LIBRARY_PATH before the one of the libraries */
+#define RPATH_LD_PATH_DIRS              16
+
+/* LD_DEBUG=libs prints a few lines for each directory tried */
+#define RPATH_MAX_OUTPUT                (1 << 18)
+
+/* How the application is linked: with the expanded output split in words
+ * (as the wrappers do) or inserted by a command substitution, $(...), with
+ * the --noexpand --sh output evaluated by `sh -c`, or with the make style
+ * output (--noexpand) in a Makefile run by make
+ */
+#define RPATH_LINK_WORDS                0
+#define RPATH_LINK_SUBST                1
+#define RPATH_LINK_SHELL                2
+#define RPATH_LINK_MAKE                 3
+
+static const char *RPATH_LINK_NAMES[] = { "words", "$(...)", "sh -c", "make" };
+
+static const char *CORE_SOURCE =
+    "int core_init(void) { return 0; }\n";
+static const char *C_SOURCE =
+    "extern int core_init(void);\n"
+    "int dds_create(void) { return core_init(); }\n";
+static const char *APP_SOURCE =
+    "extern int dds_create(void);\n"
+    "int main(void) { return dds_create(); }\n";
+
+/* {{{ buildLibrary
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Builds lib<name>.so in libDir from dir/<source>, linked with the
+ * libraries already in libDir given by ldlibs (NULL if none).
+ *
+ * \return          RTI_TRUE if success
+ */
+static RTIBool buildLibrary(const char *dir,
+        const char *libDir,
+        const char *name,
+        const char *source,
+        const char *ldlibs) {
+    char soname[MAX_STRING_SIZE];
+    char path[PATH_MAX+1];
+    char sourcePath[PATH_MAX+1];
+    char linkDir[PATH_MAX+1];
+    char output[4096];
+    char *cmd[] = {
+        (char *)"cc", (char *)"-shared", (char *)"-fPIC", soname, 
+        (char *)"-o", path, sourcePath, linkDir, (char *)ldlibs, NULL
+    };
+
+    snprintf(soname, sizeof(soname), "-Wl,-soname,lib%s.so", name);
+    snprintf(path, sizeof(path), "%s/lib%s.so", libDir, name);
+    snprintf(sourcePath, sizeof(sourcePath), "%s/%s", dir, source);
+    snprintf(linkDir, sizeof(linkDir), "-L%s", libDir);
+    if (!runCapture(cmd, NULL, output, sizeof(output))) {
+        printf("SKIP: cannot build a shared library with cc:\n%s", output);
+        return RTI_FALSE;
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ createInstallation
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Creates the synthetic installation in dir and builds its libraries.
+ *
+ * \param skipOut   receives RTI_TRUE if the libraries cannot be built
+ */
+static RTIBool createInstallation(const char *dir, RTIBool *skipOut) {
+    static const char * const TARGETS[] = { "T", NULL };
+    char target[PATH_MAX+1];
+    char path[PATH_MAX+1];
+    char sub[PATH_MAX+1];
+    int i;
+
+    *skipOut = RTI_FALSE;
+    snprintf(target, sizeof(target), "%s/home/lib/T", dir);
+    if (!createTestHome(dir, TARGETS,
+                "#arch(\"T\",\"\", {\n"
+                "    $OS : $OS.UNIX,\n"
+                "    $C_COMPILER : \"cc\",\n"
+                "    $C_LINKER : \"cc\",\n"
+                "    $CXX_COMPILER : \"c++\",\n"
+                "    $CXX_LINKER : \"c++\",\n"
+                "    $C_LINKER_FLAGS : [\"Wl,--no-as-needed\"],\n"
+                "})\n") ||
+            !makeDir(path, dir, "ldpath")) {
+        return RTI_FALSE;
+    }
+    for (i = 0; i < RPATH_LD_PATH_DIRS; ++i) {
+        char name[16];
+        snprintf(name, sizeof(name), "%d", i);
+        if (!makeDir(sub, path, name)) {
+            return RTI_FALSE;
+        }
+    }
+    if (!writeTestText(dir, "core.c", CORE_SOURCE) ||
+            !writeTestText(dir, "c.c", C_SOURCE) ||
+            !writeTestText(dir, "app.c", APP_SOURCE)) {
+        return RTI_FALSE;
+    }
+
+    if (!buildLibrary(dir, target, "nddscore", "core.c", NULL) ||
+            !buildLibrary(dir, target, "nddsc", "c.c", "-lnddscore")) {
+        *skipOut = RTI_TRUE;
+        return RTI_FALSE;
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ linkApplication
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Links the application with the linker, the linker flags and the
+ * libraries composed for the given mode of --rpath, in the given way
+ * (RPATH_LINK_WORDS, RPATH_LINK_SUBST, RPATH_LINK_SHELL or RPATH_LINK_MAKE).
+ *
+ * \return          RTI_TRUE if success
+ */
+static RTIBool linkApplication(struct Architecture *arch,
+        const char *dir,
+        const char *mode,
+        int how,
+        const char *exe) {
+    const int maxWords = MAX_CMDLINEARG_SIZE/2 + 1;
+    static const char *OPS[] = { "--clink", "--ldflags", "--ldlibs" };
+    static const char *ORIGINS[] = {
+        RPATH_ORIGIN, RPATH_ORIGIN, RPATH_ORIGIN_SHELL, RPATH_ORIGIN_MAKE
+    };
+    static char parts[3][MAX_CMDLINEARG_SIZE+1];
+    static char script[3*MAX_CMDLINEARG_SIZE + 2*PATH_MAX + MAX_STRING_SIZE];
+    static char output[RPATH_MAX_OUTPUT];
+    struct ComposeContext ctx;
+    struct ToolchainFlags flags;
+    char home[PATH_MAX+1];
+    char homeArg[PATH_MAX+16];
+    char source[PATH_MAX+1];
+    RTIBool expand = (how == RPATH_LINK_WORDS) || (how == RPATH_LINK_SUBST);
+    RTIBool shellStyle = (how == RPATH_LINK_SHELL);
+    const char *homeRef = home;
+    char **cmd;
+    int cmdLen = 0;
+    RTIBool ok = RTI_FALSE;
+    int i;
+    int n;
+
+    cmd = MEM_CALLOC(Compose, 3*maxWords + 4, sizeof(*cmd));
+    if (cmd == NULL) {
+        fprintf(stderr, "Out of memory allocating the command line\n");
+        return RTI_FALSE;
+    }
+    snprintf(home, sizeof(home), "%s/home", dir);
+    snprintf(source, sizeof(source), "%s/app.c", dir);
+    if (!expand) {
+        homeRef = shellStyle ? "${NDDSHOME}" : "$(NDDSHOME)";
+    }
+    ComposeContext_init(&ctx, home, arch->target, RTI_FALSE, RTI_FALSE,
+            RTI_FALSE, expand, shellStyle);
+    if (!resolveRpath(arch,
+                homeRef,
+                ORIGINS[how],
+                RTI_FALSE,
+                mode,
+                &flags) ||
+            !ComposeContext_addFlags(&ctx, &flags)) {
+        goto done;
+    }
+    for (i = 0; i < 3; ++i) {
+        if (composeOperation(arch,
+                    OPS[i],
+                    &ctx,
+                    parts[i],
+                    sizeof(parts[i])) == ComposeResult_Error) {
+            goto done;
+        }
+        if (how != RPATH_LINK_WORDS) {
+            continue;
+        }
+        n = splitCommandWords(parts[i], &cmd[cmdLen], maxWords);
+        if (n == -1) {
+            fprintf(stderr, "Error: invalid %s: %s\n", OPS[i], parts[i]);
+            goto done;
+        }
+        cmdLen += n;
+        if (i == 0) {
+            cmd[cmdLen++] = (char *)"-o";
+            cmd[cmdLen++] = (char *)exe;
+            cmd[cmdLen++] = source;
+        }
+    }
+    snprintf(homeArg, sizeof(homeArg), "NDDSHOME=%s", home);
+    if (how == RPATH_LINK_SUBST) {
+        /* The outputs are read with $(cat FILE), like $(connext-config ...) */
+        if (!writeTestText(dir, "clink.txt", parts[0]) ||
+                !writeTestText(dir, "ldflags.txt", parts[1]) ||
+                !writeTestText(dir, "ldlibs.txt", parts[2])) {
+            goto done;
+        }
+        snprintf(script, sizeof(script),
+                "cd '%s' && $(cat clink.txt) -o '%s' '%s' "
+                "$(cat ldflags.txt) $(cat ldlibs.txt)",
+                dir, exe, source);
+        cmd[cmdLen++] = (char *)"sh";
+        cmd[cmdLen++] = (char *)"-c";
+        cmd[cmdLen++] = script;
+    } else if (how == RPATH_LINK_SHELL) {
+        snprintf(script, sizeof(script), "%s; %s -o '%s' '%s' %s %s",
+                homeArg, parts[0], exe, source, parts[1], parts[2]);
+        cmd[cmdLen++] = (char *)"sh";
+        cmd[cmdLen++] = (char *)"-c";
+        cmd[cmdLen++] = script;
+    } else if (how == RPATH_LINK_MAKE) {
+        snprintf(script, sizeof(script),
+                "CLINK = %s\nLDFLAGS = %s\nLDLIBS = %s\n\n"
+                "%s: %s\n\t$(CLINK) -o $@ $< $(LDFLAGS) $(LDLIBS)\n",
+                parts[0], parts[1], parts[2], exe, source);
+        if (!writeTestText(dir, "Makefile", script)) {
+            goto done;
+        }
+        cmd[cmdLen++] = (char *)"make";
+        cmd[cmdLen++] = (char *)"-s";
+        cmd[cmdLen++] = homeArg;
+        cmd[cmdLen++] = (char *)exe;
+    }
+    cmd[cmdLen] = NULL;
+    ok = runCapture(cmd, (how == RPATH_LINK_MAKE) ? dir : NULL, output, sizeof(output));
+    if (!ok) {
+        fprintf(stderr, "Error: link failed (--rpath=%s, %s):\n%s",
+                mode, RPATH_LINK_NAMES[how], output);
+    }
+
+done:
+    MEM_FREE(cmd);
+    return ok;
+}
+
+/* }}} */
+/* {{{ getRunpath
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Reads with readelf the DT_RUNPATH recorded in the executable.
+ *
+ * \param runpathOut receives the path, empty if the executable has none
+ * \return          RTI_TRUE if success, RTI_FALSE if readelf failed
+ */
+static RTIBool getRunpath(const char *exe, char *runpathOut, size_t runpathSize) {
+    static char output[RPATH_MAX_OUTPUT];
+    char *cmd[] = { (char *)"readelf", (char *)"-d", (char *)exe, NULL };
+    const char *start;
+    const char *end;
+
+    runpathOut[0] = '\0';
+    if (!runCapture(cmd, NULL, output, sizeof(output))) {
+        return RTI_FALSE;
+    }
+    start = strstr(output, "(RUNPATH)");
+    if ((start == NULL) || ((start = strchr(start, '[')) == NULL) ||
+            ((end = strchr(start, ']')) == NULL)) {
+        return RTI_TRUE;
+    }
+    snprintf(runpathOut, runpathSize, "%.*s", (int)(end - start - 1), start + 1);
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ runApplication
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Runs the application with LD_DEBUG=libs and counts the files tried by
+ * the dynamic loader.
+ *
+ * \param ldLibraryPath the value of LD_LIBRARY_PATH, NULL to unset it
+ * \param probesOut receives the number of files tried
+ * \return          RTI_TRUE if the application exited with status 0
+ */
+static RTIBool runApplication(const char *exe,
+        const char *ldLibraryPath,
+        int *probesOut) {
+    static char output[RPATH_MAX_OUTPUT];
+    char *cmd[] = { (char *)exe, NULL };
+    const char *line;
+    RTIBool ok;
+
+    setenv("LD_DEBUG", "libs", 1);
+    if (ldLibraryPath != NULL) {
+        setenv("LD_LIBRARY_PATH", ldLibraryPath, 1);
+    } else {
+        unsetenv("LD_LIBRARY_PATH");
+    }
+    ok = runCapture(cmd, NULL, output, sizeof(output));
+    unsetenv("LD_DEBUG");
+    unsetenv("LD_LIBRARY_PATH");
+
+    *probesOut = 0;
+    for (line = strstr(output, "trying file=");
+            line != NULL;
+            line = strstr(line + 1, "trying file=")) {
+        ++*probesOut;
+    }
+    return ok;
+}
+
+/* }}} */
+/* {{{ main
+ * -----------------------------------------------------------------------------
+ */
+int main(int argc, char **argv) {
+    struct REDAInlineList archDef;
+    struct PlatformFileInfo info;
+    struct ToolchainFlags flags;
+    struct Architecture *arch;
+    char dir[PATH_MAX/2];      /* Room for the paths of the files */
+    char path[PATH_MAX+1];
+    char exe[PATH_MAX+1];
+    char libDir[PATH_MAX+1];
+    char lib[PATH_MAX+1];
+    char ldLibraryPath[RPATH_LD_PATH_DIRS*(PATH_MAX+1)];
+    char output[4096];
+    char runpath[PATH_MAX+1];
+    RTIBool hasReadelf;
+    RTIBool keep = RTI_FALSE;
+    RTIBool skip = RTI_FALSE;
+    RTIBool ok = RTI_TRUE;
+    int ldPathProbes;
+    int probes;
+    int len = 0;
+    int i;
+
+    for (i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--keep") == 0) {
+            keep = RTI_TRUE;
+        } else {
+            fprintf(stderr, "Usage: %s [--keep]\n", argv[0]);
+            return RPATH_EXIT_ERROR;
+        }
+    }
+    if (!createTestDir(dir, sizeof(dir), "rpath")) {
+        return RPATH_EXIT_ERROR;
+    }
+    REDAInlineList_init(&archDef);
+    snprintf(path, sizeof(path), "%s/platforms.vm", dir);
+    if (!createInstallation(dir, &skip) ||
+            !readPlatformFile(path, &archDef, &info) ||
+            ((arch = findArchitecture(&archDef, "T")) == NULL)) {
+        if (!keep) {
+            removeTestDir(dir);
+        }
+        return skip ? RPATH_EXIT_SKIP : RPATH_EXIT_ERROR;
+    }
+    snprintf(libDir, sizeof(libDir), "%s/home/lib/T", dir);
+    for (i = 0; i < RPATH_LD_PATH_DIRS; ++i) {
+        len += snprintf(ldLibraryPath + len, sizeof(ldLibraryPath) - len,
+                "%s/ldpath/%d:", dir, i);
+    }
+    snprintf(ldLibraryPath + len, sizeof(ldLibraryPath) - len, "%s", libDir);
+
+    /* The options of the modes */
+    ok = resolveRpath(arch, "/h", RPATH_ORIGIN, RTI_FALSE, "origin", &flags) &&
+            (strcmp(flags.ldflags,
+                    "-Wl,-rpath,$ORIGIN/../lib -Wl,--enable-new-dtags") == 0) &&
+            resolveRpath(arch, "${NDDSHOME}", RPATH_ORIGIN_SHELL, RTI_FALSE, "origin", &flags) &&
+            (strcmp(flags.ldflags,
+                    "-Wl,-rpath,\\$ORIGIN/../lib -Wl,--enable-new-dtags") == 0) &&
+            resolveRpath(arch, "$(NDDSHOME)", RPATH_ORIGIN_MAKE, RTI_FALSE, "origin", &flags) &&
+            (strcmp(flags.ldflags,
+                    "-Wl,-rpath,\\$$ORIGIN/../lib -Wl,--enable-new-dtags") == 0) &&
+            resolveRpath(arch, "$(NDDSHOME)", RPATH_ORIGIN_MAKE, RTI_TRUE, "absolute", &flags) &&
+            (flags.ldflags[0] == '\0') &&
+            !isValidRpathMode("origin:/lib") &&
+            !isValidRpathMode("origin:a,b") &&
+            isValidRpathMode("origin:lib");
+    printf("%s: options of the modes\n", ok ? "PASS" : "FAIL");
+
+    /* none */
+    if (!makeDir(path, dir, "none") ||
+            !makeDir(path, dir, "absolute") ||
+            !makeDir(path, dir, "origin") ||
+            !makeDir(path, dir, "origin/bin") ||
+            !makeDir(path, dir, "origin/lib")) {
+        goto error;
+    }
+    snprintf(exe, sizeof(exe), "%s/none/app", dir);
+    if (!linkApplication(arch, dir, "none", RPATH_LINK_WORDS, exe)) {
+        goto error;
+    }
+    if (!runApplication(exe, ldLibraryPath, &ldPathProbes)) {
+        printf("FAIL: none: the application does not start with LD_LIBRARY_PATH\n");
+        ok = RTI_FALSE;
+    } else if (ldPathProbes == 0) {
+        printf("SKIP: the dynamic loader does not support LD_DEBUG\n");
+        skip = RTI_TRUE;
+        goto done;
+    } else {
+        printf("PASS: none: %d loader probes with LD_LIBRARY_PATH (%d directories)\n",
+                ldPathProbes,
+                RPATH_LD_PATH_DIRS + 1);
+    }
+    if (runApplication(exe, NULL, &probes)) {
+        printf("FAIL: none: the application starts without LD_LIBRARY_PATH\n");
+        ok = RTI_FALSE;
+    } else {
+        printf("PASS: none: the application does not start without LD_LIBRARY_PATH\n");
+    }
+
+    /* absolute */
+    snprintf(exe, sizeof(exe), "%s/absolute/app", dir);
+    if (!linkApplication(arch, dir, "absolute", RPATH_LINK_WORDS, exe)) {
+        goto error;
+    }
+    if (!runApplication(exe, NULL, &probes) || (probes >= ldPathProbes)) {
+        printf("FAIL: absolute: %d loader probes\n", probes);
+        ok = RTI_FALSE;
+    } else {
+        printf("PASS: absolute: %d loader probes without LD_LIBRARY_PATH\n", probes);
+    }
+
+    /* origin: the application and the libraries are moved together */
+    snprintf(path, sizeof(path), "%s/origin/lib", dir);
+    for (i = 0; i < 2; ++i) {
+        snprintf(lib, sizeof(lib), "%s/home/lib/T/%s", dir,
+                (i == 0) ? "libnddsc.so" : "libnddscore.so");
+        char *cmd[] = { (char *)"cp", (char *)"-p", lib, path, NULL };
+        if (!runCapture(cmd, NULL, output, sizeof(output))) {
+            fprintf(stderr, "Error: cannot copy %s:\n%s", lib, output);
+            goto error;
+        }
+    }
+    /* $ORIGIN must reach the linker as is in every way (see RPATH_ORIGIN) */
+    hasReadelf = findExecutable("readelf", lib, sizeof(lib));
+    for (i = RPATH_LINK_WORDS; i <= RPATH_LINK_MAKE; ++i) {
+        if ((i == RPATH_LINK_MAKE) && !findExecutable("make", lib, sizeof(lib))) {
+            printf("SKIP: origin:../lib (make): make not found\n");
+            continue;
+        }
+        snprintf(exe, sizeof(exe), "%s/origin/bin/app%d", dir, i);
+        if (!linkApplication(arch, dir, "origin:../lib", i, exe)) {
+            goto error;
+        }
+        if (hasReadelf && (!getRunpath(exe, runpath, sizeof(runpath)) ||
+                    (strcmp(runpath, "$ORIGIN/../lib") != 0))) {
+            printf("FAIL: origin:../lib (%s): RUNPATH [%s]\n",
+                    RPATH_LINK_NAMES[i],
+                    runpath);
+            ok = RTI_FALSE;
+        } else if (!runApplication(exe, NULL, &probes) || (probes >= ldPathProbes)) {
+            printf("FAIL: origin:../lib (%s): %d loader probes\n",
+                    RPATH_LINK_NAMES[i],
+                    probes);
+            ok = RTI_FALSE;
+        } else {
+            printf("PASS: origin:../lib (%s): %d loader probes without LD_LIBRARY_PATH\n",
+                    RPATH_LINK_NAMES[i],
+                    probes);
+        }
+    }
+    goto done;
+
+error:
+    if (!keep) {
+        removeTestDir(dir);
+    }
+    return RPATH_EXIT_ERROR;
+
+done:
+    if (!keep) {
+        removeTestDir(dir);
+    } else {
+        printf("Installation kept in %s\n", dir);
+    }
+    if (skip) {
+        return RPATH_EXIT_SKIP;
+    }
+    return ok ? RPATH_EXIT_PASS : RPATH_EXIT_FAIL;
+}
+
+/* }}} */
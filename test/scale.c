@@ -0,0 +1,531 @@
+/*****************************************************************************
+ * Copyright (c) 2020 Real-Time Innovations, Inc.  All rights reserved.      *
+ *                                                                           *
+ * Permission to modify and use for internal purposes granted.               *
+ * This software is provided "as is", without warranty, express or implied.  *
+ *****************************************************************************/
+
+/*
+ * Scaling test of the parser and of the queries.
+ *
+ * For each size, generates a synthetic platform file (see gen-platform.c),
+ * then parses it in a child process and measures:
+ *  - the parse time
+ *  - the peak RSS of the child
+ *  - the lookup latency of the first, middle, last and of a missing target
+ *  - the composition latency of --cflags for the last target
+ *
+ * Every size runs in its own process, so the RSS is not affected by the
+ * previous sizes, and under a memory limit (--max-memory, default half of
+ * the physical memory): a size that exceeds it is reported as failed
+ * instead of exhausting the memory of the machine. A size whose RSS, 
+ * projected from the RSS per arch of the largest size measured, exceeds
+ * the limit is skipped (reported as SKIP with the projection) and is not
+ * a failure.
+ *
+ * The test also verifies that the parser keeps all the arches that are not
+ * hidden.
+ *
+ * Usage:
+ *      connext-config-scale [--sizes=N,N,...] [--queries=N]
+ *              [--max-memory=MB] [--keep] [--json] [generator options]
+ *
+ * The generator options (--keys, --array-len, ...) are the same of
+ * connext-config-gen-platform, except --arches.
+ * ---------------------------------------------------------------------------
+ */
+
+/* Rename the main of connext-config, this file provides its own */
+#define main connextConfigMain
+#include "connext-config.c"
+#undef main
+
+#define SYNTHETIC_PLATFORM_NO_MAIN
+#include "gen-platform.c"
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/* 100000 arches need more than 4 GB (i.e. --sizes=10000,100000) */
+#define SCALE_DEFAULT_SIZES             "100,1000,10000"
+#define SCALE_DEFAULT_QUERIES           1000
+
+/* Max time spent measuring each query: with the largest sizes a single
+ * lookup can take milliseconds
+ */
+#define SCALE_QUERY_BUDGET_NS           200000000ULL
+#define SCALE_MAX_SIZES                 32
+
+/* Query positions measured for every size */
+typedef enum {
+    SQ_First,
+    SQ_Middle,
+    SQ_Last,
+    SQ_Missing,
+    SQ_COUNT
+} ScaleQuery;
+
+static const char * const SCALE_QUERY_NAMES[SQ_COUNT] = {
+    "first",
+    "middle",
+    "last",
+    "missing"
+};
+
+/* The result of a size, written by the child to the parent */
+struct ScaleResult {
+    int                         arches;
+    int                         parsed;
+    double                      fileMB;
+    double                      genMs;
+    double                      parseMs;
+    double                      rssMB;
+    double                      lookupNs[SQ_COUNT];
+    double                      composeNs;  /* < 0 if composition failed */
+};
+
+/* {{{ nowNs
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static unsigned long long nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL +
+            (unsigned long long)ts.tv_nsec;
+}
+
+/* }}} */
+/* {{{ lastVisibleArch
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Returns the index of the last arch not hidden before or at the given one
+ */
+static int lastVisibleArch(const struct SyntheticPlatformParams *params,
+        int arch) {
+    while ((arch > 0) && SyntheticPlatform_isHidden(params, arch)) {
+        --arch;
+    }
+    return arch;
+}
+
+/* }}} */
+/* {{{ measureSize
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Runs in the child process: parses the platform file and measures the
+ * queries.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+static RTIBool measureSize(const char *path,
+        const struct SyntheticPlatformParams *params,
+        int queries,
+        struct ScaleResult *res) {
+    struct REDAInlineList archDef;
+    struct REDAInlineListNode *node;
+    struct PlatformFileInfo info;
+    struct ComposeContext *ctx = NULL;
+    struct Architecture *arch = NULL;
+    char *buf = NULL;
+    char targets[SQ_COUNT][MAX_STRING_SIZE];
+    struct rusage usage;
+    unsigned long long start;
+    RTIBool ok = RTI_FALSE;
+    int q;
+    int i;
+    int j;
+
+    REDAInlineList_init(&archDef);
+
+    start = nowNs();
+    if (!readPlatformFile(path, &archDef, &info)) {
+        goto done;
+    }
+    res->parseMs = (double)(nowNs() - start) / 1e6;
+    res->parsed = 0;
+    for (node = REDAInlineList_getFirst(&archDef);
+            node != NULL;
+            node = REDAInlineListNode_getNext(node)) {
+        ++res->parsed;
+    }
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        /* ru_maxrss is in kilobytes on Linux (bytes on Darwin) */
+#ifdef __APPLE__
+        res->rssMB = (double)usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+        res->rssMB = (double)usage.ru_maxrss / 1024.0;
+#endif
+    }
+
+    SyntheticPlatform_targetName(params, 0, targets[SQ_First], MAX_STRING_SIZE);
+    SyntheticPlatform_targetName(params,
+            lastVisibleArch(params, params->arches / 2),
+            targets[SQ_Middle],
+            MAX_STRING_SIZE);
+    SyntheticPlatform_targetName(params,
+            lastVisibleArch(params, params->arches - 1),
+            targets[SQ_Last],
+            MAX_STRING_SIZE);
+    snprintf(targets[SQ_Missing], MAX_STRING_SIZE, "x64MissingLinux4gcc0.0.0");
+
+    for (q = 0; q < SQ_COUNT; ++q) {
+        start = nowNs();
+        for (i = 0; (i < queries) && (nowNs() - start < SCALE_QUERY_BUDGET_NS); ) {
+            /* Read the clock every 16 lookups */
+            for (j = 0; (j < 16) && (i < queries); ++j, ++i) {
+                arch = findArchitecture(&archDef, targets[q]);
+            }
+        }
+        res->lookupNs[q] = (double)(nowNs() - start) / i;
+        if ((arch == NULL) != (q == SQ_Missing)) {
+            fprintf(stderr, "Unexpected lookup result for target %s\n",
+                    targets[q]);
+            goto done;
+        }
+    }
+
+    /* Composition of the last target: the lookup is not included */
+    arch = findArchitecture(&archDef, targets[SQ_Last]);
+    ctx = malloc(sizeof(*ctx));
+    buf = malloc(MAX_CMDLINEARG_SIZE+1);
+    if ((ctx == NULL) || (buf == NULL)) {
+        fprintf(stderr, "Out of memory allocating the composition buffers\n");
+        goto done;
+    }
+    res->composeNs = -1.0;
+    start = nowNs();
+    for (i = 0; i < queries; ++i) {
+        ComposeContext_init(ctx,
+                "/opt/rti_connext_dds",
+                arch->target,
+                RTI_FALSE,
+                RTI_FALSE,
+                RTI_FALSE,
+                RTI_TRUE,
+                RTI_FALSE);
+        if (composeOperation(arch, "--cflags", ctx, buf,
+                    MAX_CMDLINEARG_SIZE+1) != ComposeResult_Ok) {
+            break;
+        }
+    }
+    if (i == queries) {
+        res->composeNs = (double)(nowNs() - start) / queries;
+    }
+    ok = RTI_TRUE;
+
+done:
+    free(ctx);
+    free(buf);
+    node = REDAInlineList_getFirst(&archDef);
+    while (node != NULL) {
+        struct REDAInlineListNode *next = REDAInlineListNode_getNext(node);
+        Architecture_delete((struct Architecture *)node);
+        node = next;
+    }
+    return ok;
+}
+
+/* }}} */
+/* {{{ runSize
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Generates the platform file of the given size and measures it in a child
+ * process limited to maxMemoryMB.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if the size failed
+ */
+static RTIBool runSize(struct SyntheticPlatformParams *params,
+        int queries,
+        unsigned long maxMemoryMB,
+        RTIBool keep,
+        struct ScaleResult *res) {
+    const char *tmpDir = getenv("TMPDIR");
+    char path[PATH_MAX+1];
+    unsigned long long start;
+    struct stat info;
+    RTIBool ok = RTI_FALSE;
+    int fds[2] = { -1, -1 };
+    FILE *fp = NULL;
+    pid_t pid;
+    int status;
+    int fd;
+
+    snprintf(path, sizeof(path), "%s/connext-config-scale-%d-XXXXXX",
+            (tmpDir != NULL) ? tmpDir : "/tmp",
+            params->arches);
+    fd = mkstemp(path);
+    if (fd == -1) {
+        fprintf(stderr, "Cannot create temp file: %s\n", strerror(errno));
+        return RTI_FALSE;
+    }
+    fp = fdopen(fd, "w");
+    if (fp == NULL) {
+        close(fd);
+        goto done;
+    }
+    setvbuf(fp, NULL, _IOFBF, 1 << 16);
+    start = nowNs();
+    if (!SyntheticPlatform_write(fp, params) || (fclose(fp) != 0)) {
+        fp = NULL;
+        fprintf(stderr, "Failed to write '%s'\n", path);
+        goto done;
+    }
+    fp = NULL;
+    res->genMs = (double)(nowNs() - start) / 1e6;
+    if (stat(path, &info) == 0) {
+        res->fileMB = (double)info.st_size / (1024.0 * 1024.0);
+    }
+
+    if (pipe(fds) != 0) {
+        fprintf(stderr, "pipe failed: %s\n", strerror(errno));
+        goto done;
+    }
+    fflush(stdout);
+    pid = fork();
+    if (pid == -1) {
+        fprintf(stderr, "fork failed: %s\n", strerror(errno));
+        goto done;
+    }
+    if (pid == 0) {
+        struct rlimit limit;
+        close(fds[0]);
+        if (maxMemoryMB > 0) {
+            limit.rlim_cur = limit.rlim_max = (rlim_t)maxMemoryMB << 20;
+            setrlimit(RLIMIT_AS, &limit);
+        }
+        if (!measureSize(path, params, queries, res) ||
+                (write(fds[1], res, sizeof(*res)) != (ssize_t)sizeof(*res))) {
+            _exit(1);
+        }
+        _exit(0);
+    }
+    close(fds[1]);
+    fds[1] = -1;
+    if (read(fds[0], res, sizeof(*res)) != (ssize_t)sizeof(*res)) {
+        res->parsed = -1;
+    }
+    if (waitpid(pid, &status, 0) == -1) {
+        fprintf(stderr, "waitpid failed: %s\n", strerror(errno));
+        goto done;
+    }
+    if (WIFSIGNALED(status)) {
+        fprintf(stderr, "%d arches: killed by signal %d\n",
+                params->arches,
+                WTERMSIG(status));
+        goto done;
+    }
+    if ((WEXITSTATUS(status) != 0) || (res->parsed < 0)) {
+        fprintf(stderr, "%d arches: failed (memory limit: %lu MB)\n",
+                params->arches,
+                maxMemoryMB);
+        goto done;
+    }
+    if (res->parsed != SyntheticPlatform_visibleCount(params)) {
+        fprintf(stderr, "%d arches: parsed %d arches, expected %d\n",
+                params->arches,
+                res->parsed,
+                SyntheticPlatform_visibleCount(params));
+        goto done;
+    }
+    ok = RTI_TRUE;
+
+done:
+    if (fds[0] != -1) {
+        close(fds[0]);
+    }
+    if (fds[1] != -1) {
+        close(fds[1]);
+    }
+    if (keep) {
+        printf("Platform file: %s\n", path);
+    } else {
+        unlink(path);
+    }
+    return ok;
+}
+
+/* }}} */
+/* {{{ printResult
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void printResult(const struct ScaleResult *res, RTIBool json) {
+    int q;
+
+    if (json) {
+        printf("{\"arches\": %d, \"parsed\": %d, \"file_mb\": %.2f, "
+                "\"parse_ms\": %.2f, \"rss_mb\": %.1f",
+                res->arches,
+                res->parsed,
+                res->fileMB,
+                res->parseMs,
+                res->rssMB);
+        for (q = 0; q < SQ_COUNT; ++q) {
+            printf(", \"lookup_%s_ns\": %.1f",
+                    SCALE_QUERY_NAMES[q],
+                    res->lookupNs[q]);
+        }
+        if (res->composeNs < 0) {
+            printf(", \"compose_ns\": null}\n");
+        } else {
+            printf(", \"compose_ns\": %.1f}\n", res->composeNs);
+        }
+        return;
+    }
+    printf("%8d %8d %9.2f %10.2f %9.1f",
+            res->arches,
+            res->parsed,
+            res->fileMB,
+            res->parseMs,
+            res->rssMB);
+    for (q = 0; q < SQ_COUNT; ++q) {
+        printf(" %11.1f", res->lookupNs[q]);
+    }
+    if (res->composeNs < 0) {
+        printf(" %11s\n", "n/a");
+    } else {
+        printf(" %11.1f\n", res->composeNs);
+    }
+}
+
+/* }}} */
+/* {{{ printSkipped
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void printSkipped(int arches,
+        double projectedMB,
+        unsigned long maxMemoryMB,
+        RTIBool json) {
+    if (json) {
+        printf("{\"arches\": %d, \"skipped\": true, "
+                "\"projected_rss_mb\": %.1f, \"max_memory_mb\": %lu}\n",
+                arches,
+                projectedMB,
+                maxMemoryMB);
+        return;
+    }
+    printf("%8d SKIP: projected RSS %.1f MB over the memory limit (%lu MB)\n",
+            arches,
+            projectedMB,
+            maxMemoryMB);
+}
+
+/* }}} */
+/* {{{ scaleUsage
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+static void scaleUsage(const char *argv0) {
+    printf("Usage: %s [options]\n", argv0);
+    printf("Options:\n");
+    printf("    --sizes=N,N,...     number of arches to test (default: %s)\n",
+            SCALE_DEFAULT_SIZES);
+    printf("    --queries=N         calls per measured query (default: %d)\n",
+            SCALE_DEFAULT_QUERIES);
+    printf("    --max-memory=MB     memory limit of each size (default: half of\n");
+    printf("                        the physical memory, 0=none): the sizes\n");
+    printf("                        projected over it are skipped\n");
+    printf("    --keep              keep the generated platform files\n");
+    printf("    --json              print the results as JSON (one per line)\n");
+    printf("The options of connext-config-gen-platform (except --arches) set\n");
+    printf("the content of the generated files.\n");
+}
+
+/* }}} */
+/* {{{ main
+ * -----------------------------------------------------------------------------
+ */
+int main(int argc, char **argv) {
+    struct SyntheticPlatformParams params;
+    struct ScaleResult res;
+    const char *sizesArg = SCALE_DEFAULT_SIZES;
+    int sizes[SCALE_MAX_SIZES];
+    int sizeCount = 0;
+    int queries = SCALE_DEFAULT_QUERIES;
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    unsigned long maxMemoryMB = 0;
+    RTIBool keep = RTI_FALSE;
+    RTIBool json = RTI_FALSE;
+    double rssPerArchMB = 0.0;  /* Of the largest size measured */
+    int measuredArches = 0;
+    int failed = 0;
+    int sections;
+    const char *tok;
+    char *end;
+    int q;
+    int i;
+
+    if ((pages > 0) && (pageSize > 0)) {
+        maxMemoryMB = (unsigned long)(pages / 2) / (1048576UL / (unsigned long)pageSize);
+    }
+    SyntheticPlatformParams_init(&params);
+    for (i = 1; i < argc; ++i) {
+        if ((strncmp(argv[i], "--arches=", 9) != 0) &&
+                SyntheticPlatformParams_parseArg(&params, argv[i])) {
+            continue;
+        }
+        if (strncmp(argv[i], "--sizes=", 8) == 0) {
+            sizesArg = argv[i]+8;
+        } else if (strncmp(argv[i], "--queries=", 10) == 0) {
+            queries = atoi(argv[i]+10);
+        } else if (strncmp(argv[i], "--max-memory=", 13) == 0) {
+            maxMemoryMB = strtoul(argv[i]+13, NULL, 10);
+        } else if (strcmp(argv[i], "--keep") == 0) {
+            keep = RTI_TRUE;
+        } else if (strcmp(argv[i], "--json") == 0) {
+            json = RTI_TRUE;
+        } else if ((strcmp(argv[i], "-h") == 0) ||
+                (strcmp(argv[i], "--help") == 0)) {
+            scaleUsage(argv[0]);
+            return 0;
+        } else {
+            fprintf(stderr, "Invalid argument: %s\n", argv[i]);
+            scaleUsage(argv[0]);
+            return 1;
+        }
+    }
+    for (tok = sizesArg; *tok != '\0'; tok = (*end == ',') ? end+1 : end) {
+        long size = strtol(tok, &end, 10);
+        if ((end == tok) || (size <= 0) || (sizeCount == SCALE_MAX_SIZES)) {
+            fprintf(stderr, "Invalid sizes: %s\n", sizesArg);
+            return 1;
+        }
+        sizes[sizeCount++] = (int)size;
+    }
+    if (queries <= 0) {
+        fprintf(stderr, "Invalid number of queries: %d\n", queries);
+        return 1;
+    }
+
+    if (!json) {
+        printf("%8s %8s %9s %10s %9s", "arches", "parsed", "file MB",
+                "parse ms", "RSS MB");
+        for (q = 0; q < SQ_COUNT; ++q) {
+            printf(" %8s ns", SCALE_QUERY_NAMES[q]);
+        }
+        printf(" %11s\n", "cflags ns");
+    }
+    sections = params.sections;
+    for (i = 0; i < sizeCount; ++i) {
+        params.arches = sizes[i];
+        params.sections = (sections > sizes[i]) ? sizes[i] : sections;
+        if (!SyntheticPlatformParams_validate(&params)) {
+            return 1;
+        }
+        if ((maxMemoryMB > 0) && 
+                (rssPerArchMB * sizes[i] > (double)maxMemoryMB)) {
+            printSkipped(sizes[i], rssPerArchMB * sizes[i], maxMemoryMB, json);
+            continue;
+        }
+        memset(&res, 0, sizeof(res));
+        if (!runSize(&params, queries, maxMemoryMB, keep, &res)) {
+            ++failed;
+            continue;
+        }
+        res.arches = sizes[i];
+        if (sizes[i] > measuredArches) {
+            measuredArches = sizes[i];
+            rssPerArchMB = res.rssMB / sizes[i];
+        }
+        printResult(&res, json);
+        fflush(stdout);
+    }
+    return (failed == 0) ? 0 : 1;
+}
+/* }}} */
@@ -0,0 +1,169 @@
+/*****************************************************************************
+ * Copyright (c) 2020 Real-Time Innovations, Inc.  All rights reserved.      *
+ *                                                                           *
+ * Permission to modify and use for internal purposes granted.               *
+ * This software is provided "as is", without warranty, express or implied.  *
+ *****************************************************************************/
+
+/*
+ * Helpers shared by the tests that build a synthetic installation in a
+ * temporary directory: the directory itself, the files of the test and
+ * the skeleton of the installation (the platform file and the library
+ * directories of the targets).
+ * ---------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "testutil.h"
+
+/* {{{ createTestDir
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Creates a new temporary directory named connext-config-<name>-XXXXXX in
+ * $TMPDIR (or /tmp).
+ *
+ * \param dirOut    receives the path of the directory
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+RTIBool createTestDir(char *dirOut, size_t dirSize, const char *name) {
+    const char *tmp = getenv("TMPDIR");
+
+    if (snprintf(dirOut, dirSize, "%s/connext-config-%s-XXXXXX",
+                ((tmp != NULL) && (tmp[0] != '\0')) ? tmp : "/tmp",
+                name) >= (int)dirSize) {
+        fprintf(stderr, "Error: temporary directory path too long\n");
+        return RTI_FALSE;
+    }
+    if (mkdtemp(dirOut) == NULL) {
+        fprintf(stderr, "Error: cannot create a temporary directory: %s\n",
+                strerror(errno));
+        return RTI_FALSE;
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ removeTestDir
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Removes a directory with all its content. Symbolic links are removed,
+ * not followed.
+ */
+void removeTestDir(const char *dir) {
+    char path[PATH_MAX+1];
+    struct dirent *entry;
+    struct stat st;
+    DIR *d = opendir(dir);
+
+    if (d != NULL) {
+        while ((entry = readdir(d)) != NULL) {
+            if ((strcmp(entry->d_name, ".") == 0) ||
+                    (strcmp(entry->d_name, "..") == 0) ||
+                    (snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name) >=
+                        (int)sizeof(path))) {
+                continue;
+            }
+            if ((lstat(path, &st) == 0) && S_ISDIR(st.st_mode)) {
+                removeTestDir(path);
+            } else {
+                unlink(path);
+            }
+        }
+        closedir(d);
+    }
+    rmdir(dir);
+}
+
+/* }}} */
+/* {{{ makeDir
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Creates the directory base/name.
+ *
+ * \param pathOut   receives the path of the directory (PATH_MAX+1 bytes)
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+RTIBool makeDir(char *pathOut, const char *base, const char *name) {
+    snprintf(pathOut, PATH_MAX+1, "%s/%s", base, name);
+    if (mkdir(pathOut, 0755) != 0) {
+        fprintf(stderr, "Error: cannot create %s: %s\n", pathOut, strerror(errno));
+        return RTI_FALSE;
+    }
+    return RTI_TRUE;
+}
+
+/* }}} */
+/* {{{ writeTestFile
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the file dir/name with the given content.
+ *
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+RTIBool writeTestFile(const char *dir,
+        const char *name,
+        const void *data,
+        size_t size) {
+    char path[PATH_MAX+1];
+    FILE *fp;
+    RTIBool ok;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    fp = fopen(path, "wb");
+    if (fp == NULL) {
+        fprintf(stderr, "Error: cannot create %s: %s\n", path, strerror(errno));
+        return RTI_FALSE;
+    }
+    ok = (fwrite(data, 1, size, fp) == size);
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok) {
+        fprintf(stderr, "Error: cannot write %s\n", path);
+    }
+    return ok;
+}
+
+/* }}} */
+/* {{{ writeTestText
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the file dir/name with the given text (see writeTestFile).
+ */
+RTIBool writeTestText(const char *dir, const char *name, const char *text) {
+    return writeTestFile(dir, name, text, strlen(text));
+}
+
+/* }}} */
+/* {{{ createTestHome
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Creates the skeleton of a synthetic installation in dir: the platform
+ * file dir/platforms.vm and the directory of the libraries of each target,
+ * dir/home/lib/<target>.
+ *
+ * \param targets   the names of the targets, terminated by NULL
+ * \param platforms the content of the platform file
+ * \return          RTI_TRUE if success, RTI_FALSE if an error occurred
+ */
+RTIBool createTestHome(const char *dir,
+        const char * const *targets,
+        const char *platforms) {
+    char home[PATH_MAX+1];
+    char lib[PATH_MAX+1];
+    char path[PATH_MAX+1];
+    int i;
+
+    if (!makeDir(home, dir, "home") || !makeDir(lib, home, "lib")) {
+        return RTI_FALSE;
+    }
+    for (i = 0; targets[i] != NULL; ++i) {
+        if (!makeDir(path, lib, targets[i])) {
+            return RTI_FALSE;
+        }
+    }
+    return writeTestText(dir, "platforms.vm", platforms);
+}
+
+/* }}} */
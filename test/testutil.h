@@ -0,0 +1,37 @@
+/*****************************************************************************
+ * Copyright (c) 2020 Real-Time Innovations, Inc.  All rights reserved.      *
+ *                                                                           *
+ * Permission to modify and use for internal purposes granted.               *
+ * This software is provided "as is", without warranty, express or implied.  *
+ *****************************************************************************/
+
+/*
+ * Helpers shared by the tests that build a synthetic installation in a
+ * temporary directory (see testutil.c).
+ * ---------------------------------------------------------------------------
+ */
+
+#ifndef testutil_h
+#define testutil_h
+
+#include <stddef.h>
+#include <ndds/reda/reda_inlineList.h>  /* For RTIBool */
+
+RTIBool createTestDir(char *dirOut, size_t dirSize, const char *name);
+
+void removeTestDir(const char *dir);
+
+RTIBool makeDir(char *pathOut, const char *base, const char *name);
+
+RTIBool writeTestFile(const char *dir,
+        const char *name,
+        const void *data,
+        size_t size);
+
+RTIBool writeTestText(const char *dir, const char *name, const char *text);
+
+RTIBool createTestHome(const char *dir,
+        const char * const *targets,
+        const char *platforms);
+
+#endif